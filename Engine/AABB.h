@@ -0,0 +1,10 @@
+#pragma once
+
+/**
+ * \brief Axis aligned box stored as its min and max corners
+ */
+struct AABB
+{
+	XMFLOAT3 m_Min{};
+	XMFLOAT3 m_Max{};
+};
@@ -0,0 +1,426 @@
+#include "AssetPack.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include "JobSystem.h"
+#include "LZ4.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	[[nodiscard]] constexpr uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+}
+
+AssetPack::~AssetPack()
+{
+	Close();
+}
+
+bool AssetPack::Open(const std::filesystem::path& path)
+{
+	Close();
+
+#ifdef _WIN32
+	const HANDLE file{ CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr) };
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	m_pFileHandle = file;
+
+	LARGE_INTEGER size{};
+	if (!GetFileSizeEx(file, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(AssetPackHeader)))
+	{
+		Close();
+		return false;
+	}
+	m_Size = static_cast<uint64_t>(size.QuadPart);
+
+	m_pMappingHandle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!m_pMappingHandle)
+	{
+		Close();
+		return false;
+	}
+
+	m_pBase = static_cast<const uint8_t*>(MapViewOfFile(m_pMappingHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+	const int file{ open(path.c_str(), O_RDONLY) };
+	if (file < 0)
+		return false;
+
+	struct stat status{};
+	if (fstat(file, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(AssetPackHeader)))
+	{
+		close(file);
+		return false;
+	}
+	m_Size = static_cast<uint64_t>(status.st_size);
+
+	void* pMapping{ mmap(nullptr, static_cast<size_t>(m_Size), PROT_READ, MAP_PRIVATE, file, 0) };
+	close(file);
+	m_pBase = pMapping != MAP_FAILED ? static_cast<const uint8_t*>(pMapping) : nullptr;
+#endif
+
+	if (!m_pBase)
+	{
+		Close();
+		return false;
+	}
+
+	m_pHeader = reinterpret_cast<const AssetPackHeader*>(m_pBase);
+	m_pEntries = reinterpret_cast<const AssetPackEntry*>(m_pBase + m_pHeader->m_TocOffset);
+	m_pBlocks = reinterpret_cast<const AssetPackBlock*>(m_pBase + m_pHeader->m_BlocksOffset);
+	if (!Validate())
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void AssetPack::Close()
+{
+#ifdef _WIN32
+	if (m_pBase)
+		UnmapViewOfFile(m_pBase);
+	if (m_pMappingHandle)
+		CloseHandle(m_pMappingHandle);
+	if (m_pFileHandle)
+		CloseHandle(m_pFileHandle);
+#else
+	if (m_pBase)
+		munmap(const_cast<uint8_t*>(m_pBase), static_cast<size_t>(m_Size));
+#endif
+
+	m_pBase = nullptr;
+	m_Size = 0;
+	m_pHeader = nullptr;
+	m_pEntries = nullptr;
+	m_pBlocks = nullptr;
+	m_pFileHandle = nullptr;
+	m_pMappingHandle = nullptr;
+}
+
+bool AssetPack::IsOpen() const
+{
+	return m_pBase != nullptr;
+}
+
+const AssetPackEntry* AssetPack::Find(std::string_view name) const
+{
+	if (!m_pBase)
+		return nullptr;
+
+	const uint64_t nameHash{ Hash(name.data(), name.size()) };
+	const std::span<const AssetPackEntry> entries{ GetEntries() };
+
+	auto it{ std::lower_bound(entries.begin(), entries.end(), nameHash,
+		[](const AssetPackEntry& entry, uint64_t hash) { return entry.m_NameHash < hash; }) };
+
+	// Colliding hashes are adjacent, the names settle them
+	for (; it != entries.end() && it->m_NameHash == nameHash; ++it)
+	{
+		if (GetName(*it) == name)
+			return &*it;
+	}
+
+	return nullptr;
+}
+
+std::span<const AssetPackEntry> AssetPack::GetEntries() const
+{
+	if (!m_pBase)
+		return {};
+
+	return { m_pEntries, m_pHeader->m_EntryCount };
+}
+
+const void* AssetPack::GetData(const AssetPackEntry& entry) const
+{
+	return IsCompressed() ? nullptr : m_pBase + entry.m_Offset;
+}
+
+std::string_view AssetPack::GetName(const AssetPackEntry& entry) const
+{
+	return { reinterpret_cast<const char*>(m_pBase + m_pHeader->m_NamesOffset + entry.m_NameOffset), entry.m_NameSize };
+}
+
+uint64_t AssetPack::GetFileSize() const
+{
+	return m_Size;
+}
+
+bool AssetPack::IsCompressed() const
+{
+	return m_pBase && m_pHeader->m_BlockCount > 0;
+}
+
+std::span<const AssetPackBlock> AssetPack::GetBlocks() const
+{
+	if (!m_pBase)
+		return {};
+
+	return { m_pBlocks, m_pHeader->m_BlockCount };
+}
+
+const void* AssetPack::GetBlockData(const AssetPackBlock& block) const
+{
+	return m_pBase + block.m_Offset;
+}
+
+uint32_t AssetPack::GetBlockSize() const
+{
+	return m_pBase ? m_pHeader->m_BlockSize : 0;
+}
+
+uint32_t AssetPack::GetBlockUncompressedSize(uint32_t blockIndex) const
+{
+	const uint64_t blockStart{ static_cast<uint64_t>(blockIndex) * m_pHeader->m_BlockSize };
+	return static_cast<uint32_t>(std::min<uint64_t>(m_pHeader->m_StreamSize - blockStart, m_pHeader->m_BlockSize));
+}
+
+uint64_t AssetPack::Hash(const void* pData, size_t size, uint64_t seed)
+{
+	const auto pBytes = static_cast<const uint8_t*>(pData);
+
+	uint64_t hash{ seed };
+	for (size_t i{}; i < size; ++i)
+	{
+		hash ^= pBytes[i];
+		hash *= 0x100000001B3ull;
+	}
+
+	return hash;
+}
+
+bool AssetPack::Validate() const
+{
+	const AssetPackHeader& header{ *m_pHeader };
+	if (header.m_Magic != s_Magic || header.m_Version != s_Version || header.m_FileSize != m_Size)
+		return false;
+
+	// Only the table of contents is checked, the assets themselves are left untouched until used
+	const uint64_t tocSize{ static_cast<uint64_t>(header.m_EntryCount) * sizeof(AssetPackEntry) };
+	if (header.m_TocOffset % alignof(AssetPackEntry) != 0 || header.m_TocOffset > m_Size || tocSize > m_Size - header.m_TocOffset)
+		return false;
+	if (header.m_NamesOffset > m_Size)
+		return false;
+
+	// Assets of compressed packs are bounded by the uncompressed stream the blocks add up to
+	uint64_t dataSize{ m_Size };
+	if (header.m_BlockCount > 0)
+	{
+		const uint64_t blocksSize{ static_cast<uint64_t>(header.m_BlockCount) * sizeof(AssetPackBlock) };
+		if (header.m_BlockSize == 0 || header.m_BlocksOffset % alignof(AssetPackBlock) != 0 || header.m_BlocksOffset > m_Size
+			|| blocksSize > m_Size - header.m_BlocksOffset)
+			return false;
+		if (header.m_StreamSize == 0 || (header.m_StreamSize - 1) / header.m_BlockSize + 1 != header.m_BlockCount)
+			return false;
+
+		for (uint32_t i{}; i < header.m_BlockCount; ++i)
+		{
+			const AssetPackBlock& block{ m_pBlocks[i] };
+			if (block.m_Offset > m_Size || block.m_StoredSize > m_Size - block.m_Offset)
+				return false;
+			if (block.m_Compression != AssetCompression::None && block.m_Compression != AssetCompression::LZ4)
+				return false;
+		}
+
+		dataSize = header.m_StreamSize;
+	}
+
+	const uint64_t namesSize{ m_Size - header.m_NamesOffset };
+	for (uint32_t i{}; i < header.m_EntryCount; ++i)
+	{
+		const AssetPackEntry& entry{ m_pEntries[i] };
+		if (entry.m_Offset > dataSize || entry.m_Size > dataSize - entry.m_Offset)
+			return false;
+		if (entry.m_NameOffset > namesSize || entry.m_NameSize > namesSize - entry.m_NameOffset)
+			return false;
+		if (i > 0 && m_pEntries[i - 1].m_NameHash > entry.m_NameHash)
+			return false;
+	}
+
+	return true;
+}
+
+bool AssetPackBuilder::Add(std::string_view name, AssetType type, const void* pData, size_t size)
+{
+	const auto sameName{ [name](const Asset& asset) { return asset.m_Name == name; } };
+	if (std::any_of(m_Assets.begin(), m_Assets.end(), sameName))
+		return false;
+
+	const auto pBytes = static_cast<const uint8_t*>(pData);
+	m_Assets.push_back({ std::string{ name }, type, { pBytes, pBytes + size } });
+
+	return true;
+}
+
+bool AssetPackBuilder::AddFile(std::string_view name, AssetType type, const std::filesystem::path& path)
+{
+	std::ifstream file{ path, std::ios::binary | std::ios::ate };
+	if (!file)
+		return false;
+
+	std::vector<uint8_t> data(static_cast<size_t>(file.tellg()));
+	file.seekg(0);
+	file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+	if (!file)
+		return false;
+
+	return Add(name, type, data.data(), data.size());
+}
+
+bool AssetPackBuilder::Write(const std::filesystem::path& path, uint32_t alignment, AssetCompression compression, uint32_t blockSize) const
+{
+	if (alignment == 0 || (alignment & (alignment - 1)) != 0 || blockSize == 0)
+		return false;
+
+	const bool isCompressed{ compression != AssetCompression::None };
+
+	AssetPackHeader header{};
+	header.m_Magic = AssetPack::s_Magic;
+	header.m_Version = AssetPack::s_Version;
+	header.m_EntryCount = static_cast<uint32_t>(m_Assets.size());
+	header.m_Alignment = alignment;
+	header.m_TocOffset = AlignUp(sizeof(AssetPackHeader), alignof(AssetPackEntry));
+	header.m_BlocksOffset = header.m_TocOffset + m_Assets.size() * sizeof(AssetPackEntry);
+
+	std::vector<AssetPackEntry> entries(m_Assets.size());
+	std::string names{};
+	for (size_t i{}; i < m_Assets.size(); ++i)
+	{
+		const Asset& asset{ m_Assets[i] };
+		AssetPackEntry& entry{ entries[i] };
+		entry.m_NameHash = AssetPack::Hash(asset.m_Name.data(), asset.m_Name.size());
+		entry.m_ContentHash = AssetPack::Hash(asset.m_Data.data(), asset.m_Data.size());
+		entry.m_NameOffset = static_cast<uint32_t>(names.size());
+		entry.m_NameSize = static_cast<uint32_t>(asset.m_Name.size());
+		entry.m_Type = asset.m_Type;
+		entry.m_Size = asset.m_Data.size();
+		names += asset.m_Name;
+	}
+
+	// Uncompressed packs place the assets in the file after the names, compressed ones in a stream of their own
+	uint64_t offset{ isCompressed ? 0 : header.m_BlocksOffset + names.size() };
+	for (AssetPackEntry& entry : entries)
+	{
+		offset = AlignUp(offset, alignment);
+		entry.m_Offset = offset;
+		offset += entry.m_Size;
+	}
+
+	std::vector<AssetPackBlock> blocks{};
+	std::vector<std::vector<uint8_t>> blockData{};
+	if (isCompressed && offset > 0)
+	{
+		header.m_StreamSize = offset;
+		header.m_BlockCount = static_cast<uint32_t>((offset - 1) / blockSize + 1);
+		header.m_BlockSize = blockSize;
+
+		std::vector<uint8_t> stream(static_cast<size_t>(offset));
+		for (size_t i{}; i < m_Assets.size(); ++i)
+			std::copy(m_Assets[i].m_Data.begin(), m_Assets[i].m_Data.end(), stream.begin() + static_cast<ptrdiff_t>(entries[i].m_Offset));
+
+		blocks.resize(header.m_BlockCount);
+		blockData.resize(header.m_BlockCount);
+		JobSystem::Get().ParallelFor(header.m_BlockCount, [&](uint32_t index) {
+			const uint8_t* pSource{ stream.data() + static_cast<size_t>(index) * blockSize };
+			const size_t sourceSize{ std::min<size_t>(blockSize, stream.size() - static_cast<size_t>(index) * blockSize) };
+
+			std::vector<uint8_t>& data{ blockData[index] };
+			data.resize(LZ4::GetMaxCompressedSize(sourceSize));
+			const size_t compressedSize{ LZ4::Compress(pSource, sourceSize, data.data(), data.size()) };
+
+			// Decompressing a block that did not shrink would only cost time
+			if (compressedSize == 0 || compressedSize >= sourceSize)
+			{
+				data.assign(pSource, pSource + sourceSize);
+				blocks[index].m_Compression = AssetCompression::None;
+			}
+			else
+			{
+				data.resize(compressedSize);
+				blocks[index].m_Compression = AssetCompression::LZ4;
+			}
+			blocks[index].m_StoredSize = static_cast<uint32_t>(data.size());
+		});
+	}
+
+	header.m_NamesOffset = header.m_BlocksOffset + blocks.size() * sizeof(AssetPackBlock);
+
+	if (isCompressed)
+	{
+		offset = header.m_NamesOffset + names.size();
+		for (AssetPackBlock& block : blocks)
+		{
+			block.m_Offset = offset;
+			offset += block.m_StoredSize;
+		}
+	}
+	header.m_FileSize = offset;
+
+	// Sorting after the data offsets were assigned keeps the assets in insertion order in the file, so the
+	// builder's caller decides which assets share pages
+	std::vector<uint32_t> order(entries.size());
+	for (uint32_t i{}; i < order.size(); ++i)
+		order[i] = i;
+	std::stable_sort(order.begin(), order.end(),
+		[&entries](uint32_t a, uint32_t b) { return entries[a].m_NameHash < entries[b].m_NameHash; });
+
+	std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+	if (!file)
+		return false;
+
+	const auto writePadding{ [&file](uint64_t target) {
+		static constexpr char s_Zeros[256]{};
+		for (uint64_t position{ static_cast<uint64_t>(file.tellp()) }; position < target; position += sizeof(s_Zeros))
+			file.write(s_Zeros, static_cast<std::streamsize>(std::min<uint64_t>(target - position, sizeof(s_Zeros))));
+	} };
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	writePadding(header.m_TocOffset);
+	for (const uint32_t index : order)
+		file.write(reinterpret_cast<const char*>(&entries[index]), sizeof(AssetPackEntry));
+	file.write(reinterpret_cast<const char*>(blocks.data()), static_cast<std::streamsize>(blocks.size() * sizeof(AssetPackBlock)));
+	file.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+	if (isCompressed)
+	{
+		for (const std::vector<uint8_t>& data : blockData)
+			file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+	}
+	else
+	{
+		for (size_t i{}; i < m_Assets.size(); ++i)
+		{
+			writePadding(entries[i].m_Offset);
+			file.write(reinterpret_cast<const char*>(m_Assets[i].m_Data.data()), static_cast<std::streamsize>(m_Assets[i].m_Data.size()));
+		}
+	}
+
+	return static_cast<bool>(file);
+}
+
+uint32_t AssetPackBuilder::GetAssetCount() const
+{
+	return static_cast<uint32_t>(m_Assets.size());
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * \brief Kind of data stored in an AssetPack entry, only a hint for tools and consumers
+ */
+enum class AssetType : uint32_t
+{
+	Raw,
+	Shader
+};
+
+enum class AssetCompression : uint32_t
+{
+	None,
+	LZ4
+};
+
+/**
+ * \brief First bytes of a pack file. Every offset in the file is relative to its first byte.
+ * Layout: header, table of contents sorted by name hash, block table, names, then the data.
+ * In uncompressed packs the data is the assets, each starting on m_Alignment. Compressed packs lay the assets out the
+ * same way in an uncompressed stream, cut in blocks of m_BlockSize bytes compressed independently of each other.
+ */
+struct AssetPackHeader
+{
+	uint32_t m_Magic{};
+	uint32_t m_Version{};
+	uint32_t m_EntryCount{};
+	uint32_t m_Alignment{};
+	uint64_t m_TocOffset{};
+	uint64_t m_NamesOffset{};
+	uint64_t m_FileSize{};
+	uint64_t m_BlocksOffset{};
+	uint64_t m_StreamSize{}; // Uncompressed size of all the blocks
+	uint32_t m_BlockCount{}; // 0 for uncompressed packs
+	uint32_t m_BlockSize{}; // Uncompressed, every block but the last has exactly this size
+};
+
+struct AssetPackBlock
+{
+	uint64_t m_Offset{}; // In the file
+	uint32_t m_StoredSize{};
+	AssetCompression m_Compression{}; // Blocks that would not shrink are stored as they are
+};
+
+struct AssetPackEntry
+{
+	uint64_t m_NameHash{};
+	uint64_t m_ContentHash{}; // So consumers deduplicating on content never read the data
+	uint64_t m_Offset{}; // In the file, or in the uncompressed stream of compressed packs
+	uint64_t m_Size{};
+	uint32_t m_NameOffset{}; // From AssetPackHeader::m_NamesOffset
+	uint32_t m_NameSize{};
+	AssetType m_Type{};
+	uint32_t m_Padding{};
+};
+
+/**
+ * \brief Read-only view of a pack file mapped in memory. Opening only validates the header and the table of
+ * contents, assets are never parsed nor copied: lookups return pointers into the mapping, valid until Close.
+ * Pages are read from disk on first access. Compressed packs are read through an AssetPackReader instead.
+ */
+class AssetPack final
+{
+public:
+	AssetPack() noexcept = default;
+	~AssetPack();
+
+	AssetPack(const AssetPack& other) noexcept = delete;
+	AssetPack& operator=(const AssetPack& other) noexcept = delete;
+	AssetPack(AssetPack&& other) noexcept = delete;
+	AssetPack& operator=(AssetPack&& other) noexcept = delete;
+
+	/**
+	 * \return False if the file could not be mapped or is not a valid pack
+	 */
+	bool Open(const std::filesystem::path& path);
+	void Close();
+	[[nodiscard]] bool IsOpen() const;
+
+	/**
+	 * \brief Binary search on the name hash
+	 * \param name As given to the builder, see AssetPackBuilder::Add
+	 * \return nullptr if the pack has no such asset
+	 */
+	[[nodiscard]] const AssetPackEntry* Find(std::string_view name) const;
+	[[nodiscard]] std::span<const AssetPackEntry> GetEntries() const;
+	/**
+	 * \return nullptr for compressed packs
+	 */
+	[[nodiscard]] const void* GetData(const AssetPackEntry& entry) const;
+	[[nodiscard]] std::string_view GetName(const AssetPackEntry& entry) const;
+	[[nodiscard]] uint64_t GetFileSize() const;
+
+	[[nodiscard]] bool IsCompressed() const;
+	[[nodiscard]] std::span<const AssetPackBlock> GetBlocks() const;
+	[[nodiscard]] const void* GetBlockData(const AssetPackBlock& block) const; // As stored, compressed or not
+	[[nodiscard]] uint32_t GetBlockSize() const;
+	[[nodiscard]] uint32_t GetBlockUncompressedSize(uint32_t blockIndex) const; // Only the last block is shorter
+
+	/**
+	 * \brief 64-bit FNV-1a, used for the name and content hashes
+	 * \param seed Hash of the preceding data, to hash several ranges as one
+	 */
+	[[nodiscard]] static uint64_t Hash(const void* pData, size_t size, uint64_t seed = s_HashSeed);
+
+	inline static constexpr uint32_t s_Magic{ 0x4B504750u }; // "PGPK"
+	inline static constexpr uint32_t s_Version{ 2 };
+	inline static constexpr uint64_t s_HashSeed{ 0xCBF29CE484222325ull };
+
+private:
+	/* DATA MEMBERS */
+
+	const uint8_t* m_pBase{};
+	uint64_t m_Size{};
+	const AssetPackHeader* m_pHeader{};
+	const AssetPackEntry* m_pEntries{};
+	const AssetPackBlock* m_pBlocks{};
+
+	void* m_pFileHandle{}; // Windows only, the mapping keeps POSIX files alive on its own
+	void* m_pMappingHandle{};
+
+	/* PRIVATE METHODS */
+
+	bool Validate() const;
+
+};
+
+/**
+ * \brief Collects assets in memory and writes them as a pack file
+ */
+class AssetPackBuilder final
+{
+public:
+	AssetPackBuilder() noexcept = default;
+	~AssetPackBuilder() = default;
+
+	AssetPackBuilder(const AssetPackBuilder& other) noexcept = delete;
+	AssetPackBuilder& operator=(const AssetPackBuilder& other) noexcept = delete;
+	AssetPackBuilder(AssetPackBuilder&& other) noexcept = delete;
+	AssetPackBuilder& operator=(AssetPackBuilder&& other) noexcept = delete;
+
+	/**
+	 * \param name Lookup key, paths are expected normalized with forward slashes
+	 * \return False if the name is already used
+	 */
+	bool Add(std::string_view name, AssetType type, const void* pData, size_t size);
+	/**
+	 * \return False if the file could not be read or the name is already used
+	 */
+	bool AddFile(std::string_view name, AssetType type, const std::filesystem::path& path);
+
+	/**
+	 * \param alignment Power of two, start of every asset in the file, or in the uncompressed stream
+	 * \param compression With LZ4 the blocks are compressed in parallel on the JobSystem
+	 * \param blockSize Uncompressed size of the blocks of compressed packs. Larger blocks compress better, smaller
+	 * ones waste less decompression on small reads.
+	 * \return False if the file could not be written
+	 */
+	bool Write(const std::filesystem::path& path, uint32_t alignment = s_DefaultAlignment, AssetCompression compression = AssetCompression::None,
+		uint32_t blockSize = s_DefaultBlockSize) const;
+
+	[[nodiscard]] uint32_t GetAssetCount() const;
+
+	inline static constexpr uint32_t s_DefaultAlignment{ 64 }; // Cache line, enough for SIMD loads straight from the mapping
+	inline static constexpr uint32_t s_DefaultBlockSize{ 64 * 1024 };
+
+private:
+	/* NESTED CLASSES */
+
+	struct Asset
+	{
+		std::string m_Name{};
+		AssetType m_Type{};
+		std::vector<uint8_t> m_Data{};
+	};
+
+	/* DATA MEMBERS */
+
+	std::vector<Asset> m_Assets{};
+
+};
@@ -0,0 +1,166 @@
+#include "AssetPackReader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+#include "AssetPack.h"
+#include "JobSystem.h"
+#include "LZ4.h"
+
+AssetPackReader::AssetPackReader(const AssetPack& pack, uint64_t cacheCapacity)
+	: m_Pack{ pack }
+	, m_CacheCapacity{ cacheCapacity }
+{
+}
+
+bool AssetPackReader::Read(const AssetPackEntry& entry, std::vector<uint8_t>& destination)
+{
+	destination.resize(static_cast<size_t>(entry.m_Size));
+	if (entry.m_Size == 0)
+		return true;
+
+	if (!m_Pack.IsCompressed())
+	{
+		std::memcpy(destination.data(), m_Pack.GetData(entry), destination.size());
+
+		std::lock_guard lock{ m_Mutex };
+		m_Stats.m_BytesRead += entry.m_Size;
+		return true;
+	}
+
+	const uint64_t blockSize{ m_Pack.GetBlockSize() };
+	const auto firstBlock = static_cast<uint32_t>(entry.m_Offset / blockSize);
+	const auto lastBlock = static_cast<uint32_t>((entry.m_Offset + entry.m_Size - 1) / blockSize);
+
+	std::vector<BlockData> blocks(lastBlock - firstBlock + 1);
+	std::vector<uint32_t> missingBlocks{};
+	{
+		std::lock_guard lock{ m_Mutex };
+		for (uint32_t index{ firstBlock }; index <= lastBlock; ++index)
+		{
+			const auto it{ m_CachedBlockLookup.find(index) };
+			if (it == m_CachedBlockLookup.end())
+			{
+				missingBlocks.push_back(index);
+				continue;
+			}
+
+			m_CachedBlocks.splice(m_CachedBlocks.begin(), m_CachedBlocks, it->second);
+			blocks[index - firstBlock] = it->second->m_pData;
+		}
+
+		m_Stats.m_BlockHitCount += blocks.size() - missingBlocks.size();
+		m_Stats.m_BlockMissCount += missingBlocks.size();
+	}
+
+	// Two reads missing the same block both decompress it, the cache keeps the first one
+	if (!missingBlocks.empty())
+	{
+		std::atomic<bool> isCorrupted{};
+		const auto start{ std::chrono::steady_clock::now() };
+		JobSystem::Get().ParallelFor(static_cast<uint32_t>(missingBlocks.size()), [&](uint32_t i) {
+			BlockData pData{ DecompressBlock(missingBlocks[i]) };
+			if (!pData)
+				isCorrupted = true;
+			blocks[missingBlocks[i] - firstBlock] = std::move(pData);
+		});
+		const std::chrono::duration<double> duration{ std::chrono::steady_clock::now() - start };
+
+		std::lock_guard lock{ m_Mutex };
+		m_Stats.m_DecompressionSeconds += duration.count();
+		for (const uint32_t index : missingBlocks)
+		{
+			const BlockData& pData{ blocks[index - firstBlock] };
+			if (!pData)
+				continue;
+
+			m_Stats.m_BytesRead += m_Pack.GetBlocks()[index].m_StoredSize;
+			m_Stats.m_BytesDecompressed += pData->size();
+			AddToCache(index, pData);
+		}
+
+		if (isCorrupted)
+			return false;
+	}
+
+	// Copies the part of every block the asset overlaps
+	for (uint32_t index{ firstBlock }; index <= lastBlock; ++index)
+	{
+		const uint64_t blockStart{ index * blockSize };
+		const uint64_t copyStart{ std::max(entry.m_Offset, blockStart) };
+		const uint64_t copyEnd{ std::min(entry.m_Offset + entry.m_Size, blockStart + blocks[index - firstBlock]->size()) };
+
+		std::memcpy(destination.data() + (copyStart - entry.m_Offset), blocks[index - firstBlock]->data() + (copyStart - blockStart),
+			static_cast<size_t>(copyEnd - copyStart));
+	}
+
+	return true;
+}
+
+void AssetPackReader::ClearCache()
+{
+	std::lock_guard lock{ m_Mutex };
+
+	m_CachedBlocks.clear();
+	m_CachedBlockLookup.clear();
+	m_CachedBytes = 0;
+}
+
+uint64_t AssetPackReader::GetCachedBytes() const
+{
+	std::lock_guard lock{ m_Mutex };
+	return m_CachedBytes;
+}
+
+AssetPackReadStats AssetPackReader::GetStats() const
+{
+	std::lock_guard lock{ m_Mutex };
+	return m_Stats;
+}
+
+void AssetPackReader::ResetStats()
+{
+	std::lock_guard lock{ m_Mutex };
+	m_Stats = {};
+}
+
+AssetPackReader::BlockData AssetPackReader::DecompressBlock(uint32_t index) const
+{
+	const AssetPackBlock& block{ m_Pack.GetBlocks()[index] };
+	const auto pSource = static_cast<const uint8_t*>(m_Pack.GetBlockData(block));
+
+	auto pData{ std::make_shared<std::vector<uint8_t>>(m_Pack.GetBlockUncompressedSize(index)) };
+	if (block.m_Compression == AssetCompression::None)
+	{
+		if (block.m_StoredSize != pData->size())
+			return nullptr;
+
+		std::memcpy(pData->data(), pSource, pData->size());
+		return pData;
+	}
+
+	if (!LZ4::Decompress(pSource, block.m_StoredSize, pData->data(), pData->size()))
+		return nullptr;
+
+	return pData;
+}
+
+void AssetPackReader::AddToCache(uint32_t index, const BlockData& pData)
+{
+	if (pData->size() > m_CacheCapacity || m_CachedBlockLookup.contains(index))
+		return;
+
+	m_CachedBlocks.push_front({ index, pData });
+	m_CachedBlockLookup.emplace(index, m_CachedBlocks.begin());
+	m_CachedBytes += pData->size();
+
+	while (m_CachedBytes > m_CacheCapacity)
+	{
+		const CachedBlock& oldest{ m_CachedBlocks.back() };
+		m_CachedBytes -= oldest.m_pData->size();
+		m_CachedBlockLookup.erase(oldest.m_Index);
+		m_CachedBlocks.pop_back();
+	}
+}
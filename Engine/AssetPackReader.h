@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class AssetPack;
+struct AssetPackEntry;
+
+struct AssetPackReadStats
+{
+	uint64_t m_BytesRead{}; // From the pack, as stored
+	uint64_t m_BytesDecompressed{};
+	double m_DecompressionSeconds{}; // Wall time of the decompression passes, the blocks of a read run in parallel
+	uint64_t m_BlockHitCount{}; // Blocks found in the cache
+	uint64_t m_BlockMissCount{}; // Blocks read from the pack
+
+	[[nodiscard]] double GetHitRate() const
+	{
+		const uint64_t total{ m_BlockHitCount + m_BlockMissCount };
+		return total > 0 ? static_cast<double>(m_BlockHitCount) / static_cast<double>(total) : 0.;
+	}
+
+	/**
+	 * \return Bytes per second
+	 */
+	[[nodiscard]] double GetDecompressionThroughput() const
+	{
+		return m_DecompressionSeconds > 0. ? static_cast<double>(m_BytesDecompressed) / m_DecompressionSeconds : 0.;
+	}
+};
+
+/**
+ * \brief Reads assets out of compressed packs. The blocks an asset spans are decompressed in parallel on the
+ * JobSystem, then kept in a least recently used cache so assets sharing blocks, or read again, skip the work.
+ * Reads from uncompressed packs are plain copies out of the mapping. Thread safe, the pack must outlive the reader.
+ */
+class AssetPackReader final
+{
+public:
+	/**
+	 * \param cacheCapacity Uncompressed bytes of blocks kept, 0 disables the cache
+	 */
+	explicit AssetPackReader(const AssetPack& pack, uint64_t cacheCapacity = s_DefaultCacheCapacity);
+	~AssetPackReader() = default;
+
+	AssetPackReader(const AssetPackReader& other) noexcept = delete;
+	AssetPackReader& operator=(const AssetPackReader& other) noexcept = delete;
+	AssetPackReader(AssetPackReader&& other) noexcept = delete;
+	AssetPackReader& operator=(AssetPackReader&& other) noexcept = delete;
+
+	/**
+	 * \param entry From the pack given to the constructor
+	 * \return False if a block is corrupted
+	 */
+	bool Read(const AssetPackEntry& entry, std::vector<uint8_t>& destination);
+
+	void ClearCache();
+	[[nodiscard]] uint64_t GetCachedBytes() const;
+
+	[[nodiscard]] AssetPackReadStats GetStats() const;
+	void ResetStats();
+
+	inline static constexpr uint64_t s_DefaultCacheCapacity{ 16ull * 1024 * 1024 };
+
+private:
+	/* NESTED CLASSES */
+
+	using BlockData = std::shared_ptr<const std::vector<uint8_t>>; // Shared, so eviction never frees a block being copied
+
+	struct CachedBlock
+	{
+		uint32_t m_Index{};
+		BlockData m_pData{};
+	};
+
+	/* DATA MEMBERS */
+
+	const AssetPack& m_Pack;
+	const uint64_t m_CacheCapacity;
+
+	mutable std::mutex m_Mutex{};
+	std::list<CachedBlock> m_CachedBlocks{}; // Most recently used first
+	std::unordered_map<uint32_t, std::list<CachedBlock>::iterator> m_CachedBlockLookup{};
+	uint64_t m_CachedBytes{};
+	AssetPackReadStats m_Stats{};
+
+	/* PRIVATE METHODS */
+
+	[[nodiscard]] BlockData DecompressBlock(uint32_t index) const;
+	void AddToCache(uint32_t index, const BlockData& pData);
+
+};
@@ -0,0 +1,191 @@
+#include "AssetStreamer.h"
+
+#include <algorithm>
+
+#include "BatchFileReader.h"
+#include "GameSettings.h"
+
+AssetStreamer::AssetStreamer()
+{
+	const uint32_t workerCount{ std::max(GameSettings::streamingThreadCount, 1u) };
+
+	m_Workers.reserve(workerCount);
+	for (uint32_t i{}; i < workerCount; ++i)
+		m_Workers.emplace_back(&AssetStreamer::WorkerLoop, this);
+}
+
+AssetStreamer::~AssetStreamer()
+{
+	{
+		std::lock_guard lock{ m_Mutex };
+		m_IsRunning = false;
+	}
+	m_WakeCondition.notify_all();
+
+	for (auto& worker : m_Workers)
+		worker.join();
+}
+
+std::shared_ptr<const StreamedAsset> AssetStreamer::Request(StreamRequestDesc desc)
+{
+	auto pAsset{ std::make_shared<StreamedAsset>() };
+	pAsset->m_Placeholder = desc.m_Placeholder;
+
+	{
+		std::lock_guard lock{ m_Mutex };
+
+		const StreamRequestId id{ m_NextId++ };
+		pAsset->m_Id = id;
+
+		m_Requests.emplace(id, PendingRequest{ pAsset, std::move(desc.m_Path), desc.m_Priority, std::move(desc.m_OnComplete) });
+		m_Queue.push_back({ desc.m_Priority, m_NextSequence++, id });
+		std::push_heap(m_Queue.begin(), m_Queue.end());
+	}
+	m_WakeCondition.notify_one();
+
+	return pAsset;
+}
+
+void AssetStreamer::UpdatePriority(StreamRequestId id, float priority)
+{
+	std::lock_guard lock{ m_Mutex };
+
+	const auto it{ m_Requests.find(id) };
+	if (it == m_Requests.end() || it->second.m_IsReading || it->second.m_Priority == priority)
+		return;
+
+	// The previous entry stays in the heap and is skipped once popped, its priority no longer matches
+	it->second.m_Priority = priority;
+	m_Queue.push_back({ priority, m_NextSequence++, id });
+	std::push_heap(m_Queue.begin(), m_Queue.end());
+}
+
+void AssetStreamer::Cancel(StreamRequestId id)
+{
+	std::lock_guard lock{ m_Mutex };
+
+	const auto it{ m_Requests.find(id) };
+	if (it == m_Requests.end())
+		return;
+
+	// Heap entries and completions of a missing request are dropped
+	it->second.m_pAsset->m_State = StreamedAsset::State::Cancelled;
+	m_Requests.erase(it);
+}
+
+void AssetStreamer::Update()
+{
+	std::vector<Completion> completions{};
+	{
+		std::lock_guard lock{ m_Mutex };
+		completions.swap(m_Completions);
+	}
+
+	for (Completion& completion : completions)
+	{
+		PendingRequest request{};
+		{
+			std::lock_guard lock{ m_Mutex };
+
+			const auto it{ m_Requests.find(completion.m_Id) };
+			if (it == m_Requests.end())
+				continue;
+
+			request = std::move(it->second);
+			m_Requests.erase(it);
+
+			if (completion.m_Succeeded)
+				m_LoadedBytes += completion.m_Data.size();
+		}
+
+		StreamedAsset& asset{ *request.m_pAsset };
+		asset.m_Data = std::move(completion.m_Data);
+		asset.m_State = completion.m_Succeeded ? StreamedAsset::State::Loaded : StreamedAsset::State::Failed;
+
+		// Outside the lock, callbacks are free to issue new requests
+		if (request.m_OnComplete)
+			request.m_OnComplete(asset);
+	}
+}
+
+float AssetStreamer::ComputePriority(float distance, bool isVisible)
+{
+	const float closeness{ 1.f / (1.f + std::max(distance, 0.f)) };
+	return isVisible ? 1.f + closeness : closeness;
+}
+
+uint32_t AssetStreamer::GetPendingCount() const
+{
+	std::lock_guard lock{ m_Mutex };
+	return static_cast<uint32_t>(m_Requests.size());
+}
+
+uint64_t AssetStreamer::GetLoadedBytes() const
+{
+	std::lock_guard lock{ m_Mutex };
+	return m_LoadedBytes;
+}
+
+bool AssetStreamer::IsUsingIoUring() const
+{
+	std::lock_guard lock{ m_Mutex };
+	return m_IsUsingIoUring;
+}
+
+void AssetStreamer::WorkerLoop()
+{
+	const uint32_t queueDepth{ std::max(GameSettings::streamingQueueDepth, 1u) };
+	BatchFileReader reader{ queueDepth };
+
+	// Blocking reads take one file at a time, so a more urgent request never waits behind a whole batch
+	const uint32_t batchSize{ reader.IsUsingIoUring() ? queueDepth : 1u };
+
+	std::vector<BatchFileReader::Read> reads{};
+	std::vector<StreamRequestId> ids{};
+
+	{
+		std::lock_guard lock{ m_Mutex };
+		m_IsUsingIoUring = m_IsUsingIoUring || reader.IsUsingIoUring();
+	}
+
+	while (true)
+	{
+		{
+			std::unique_lock lock{ m_Mutex };
+			m_WakeCondition.wait(lock, [this] { return !m_IsRunning || !m_Queue.empty(); });
+
+			if (!m_IsRunning)
+				return;
+
+			while (!m_Queue.empty() && reads.size() < batchSize)
+			{
+				std::pop_heap(m_Queue.begin(), m_Queue.end());
+				const QueueEntry entry{ m_Queue.back() };
+				m_Queue.pop_back();
+
+				// Cancelled, reprioritized since, or a duplicate entry of a request already being read
+				const auto it{ m_Requests.find(entry.m_Id) };
+				if (it == m_Requests.end() || it->second.m_IsReading || it->second.m_Priority != entry.m_Priority)
+					continue;
+
+				it->second.m_IsReading = true;
+				reads.push_back({ it->second.m_Path });
+				ids.push_back(entry.m_Id);
+			}
+		}
+
+		if (reads.empty())
+			continue;
+
+		reader.ReadAll(reads);
+
+		{
+			std::lock_guard lock{ m_Mutex };
+			for (size_t i{}; i < reads.size(); ++i)
+				m_Completions.push_back({ ids[i], std::move(reads[i].m_Data), reads[i].m_Succeeded });
+		}
+
+		reads.clear();
+		ids.clear();
+	}
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Singleton.h"
+
+using StreamRequestId = uint64_t;
+
+/**
+ * \brief Asset requested from the AssetStreamer. Its data is the placeholder given with the request until the file
+ * arrives, and only changes during AssetStreamer::Update, so the main thread never sees it half loaded.
+ */
+class StreamedAsset final
+{
+public:
+	enum class State
+	{
+		Queued,
+		Loaded,
+		Failed,
+		Cancelled
+	};
+
+	StreamedAsset() noexcept = default;
+	~StreamedAsset() = default;
+
+	StreamedAsset(const StreamedAsset& other) noexcept = delete;
+	StreamedAsset& operator=(const StreamedAsset& other) noexcept = delete;
+	StreamedAsset(StreamedAsset&& other) noexcept = delete;
+	StreamedAsset& operator=(StreamedAsset&& other) noexcept = delete;
+
+	[[nodiscard]] StreamRequestId GetId() const { return m_Id; }
+	[[nodiscard]] State GetState() const { return m_State; }
+	[[nodiscard]] bool IsLoaded() const { return m_State == State::Loaded; }
+	/**
+	 * \return The file content once loaded, the placeholder otherwise
+	 */
+	[[nodiscard]] std::span<const uint8_t> GetData() const { return IsLoaded() ? std::span<const uint8_t>{ m_Data } : m_Placeholder; }
+
+private:
+	friend class AssetStreamer;
+
+	/* DATA MEMBERS */
+
+	StreamRequestId m_Id{};
+	State m_State{ State::Queued };
+	std::vector<uint8_t> m_Data{};
+	std::span<const uint8_t> m_Placeholder{};
+
+};
+
+struct StreamRequestDesc
+{
+	std::filesystem::path m_Path{};
+	float m_Priority{}; // Higher is loaded first, see AssetStreamer::ComputePriority
+	std::span<const uint8_t> m_Placeholder{}; // Not copied, must outlive the request
+	std::function<void(const StreamedAsset&)> m_OnComplete{}; // Main thread, on success or failure but not after Cancel
+};
+
+/**
+ * \brief Loads files on IO threads, highest priority first, so frames never wait on the disk.
+ * Requests can be reprioritized or cancelled while queued. Completions are handed over to the main thread in
+ * Update, which is also where the callbacks run. Each IO thread reads its batch with a BatchFileReader, so
+ * io_uring is used on Linux when available.
+ * Request, UpdatePriority, Cancel and Update are meant for the main thread.
+ */
+class AssetStreamer final : public Singleton<AssetStreamer>
+{
+public:
+	~AssetStreamer() override;
+
+	AssetStreamer(const AssetStreamer& other) noexcept = delete;
+	AssetStreamer& operator=(const AssetStreamer& other) noexcept = delete;
+	AssetStreamer(AssetStreamer&& other) noexcept = delete;
+	AssetStreamer& operator=(AssetStreamer&& other) noexcept = delete;
+
+	/**
+	 * \return Keeps the data alive once loaded, also when the request completed
+	 */
+	[[nodiscard]] std::shared_ptr<const StreamedAsset> Request(StreamRequestDesc desc);
+	/**
+	 * \brief No effect once an IO thread picked the request up
+	 */
+	void UpdatePriority(StreamRequestId id, float priority);
+	/**
+	 * \brief Drops a queued request, or discards its data if it is being read. The callback is never called.
+	 */
+	void Cancel(StreamRequestId id);
+
+	/**
+	 * \brief Publishes the finished requests to their assets and runs their callbacks, once per frame
+	 */
+	void Update();
+
+	/**
+	 * \brief Visible assets always come before hidden ones, closer ones first within each group
+	 */
+	[[nodiscard]] static float ComputePriority(float distance, bool isVisible);
+
+	[[nodiscard]] uint32_t GetPendingCount() const; // Queued or being read
+	[[nodiscard]] uint64_t GetLoadedBytes() const;
+	[[nodiscard]] bool IsUsingIoUring() const;
+
+private:
+	friend class Singleton<AssetStreamer>;
+	AssetStreamer();
+
+	/* NESTED CLASSES */
+
+	struct PendingRequest
+	{
+		std::shared_ptr<StreamedAsset> m_pAsset{};
+		std::filesystem::path m_Path{};
+		float m_Priority{};
+		std::function<void(const StreamedAsset&)> m_OnComplete{};
+		bool m_IsReading{};
+	};
+
+	/**
+	 * \brief Entry of the priority heap. Reprioritizing pushes a new entry, stale ones are skipped when popped.
+	 */
+	struct QueueEntry
+	{
+		float m_Priority{};
+		uint64_t m_Sequence{}; // Requests of equal priority are served in order
+		StreamRequestId m_Id{};
+
+		bool operator<(const QueueEntry& other) const
+		{
+			return m_Priority != other.m_Priority ? m_Priority < other.m_Priority : m_Sequence > other.m_Sequence;
+		}
+	};
+
+	struct Completion
+	{
+		StreamRequestId m_Id{};
+		std::vector<uint8_t> m_Data{};
+		bool m_Succeeded{};
+	};
+
+	/* DATA MEMBERS */
+
+	std::vector<std::thread> m_Workers{};
+
+	mutable std::mutex m_Mutex{};
+	std::condition_variable m_WakeCondition{};
+	std::unordered_map<StreamRequestId, PendingRequest> m_Requests{};
+	std::vector<QueueEntry> m_Queue{}; // Max heap
+	std::vector<Completion> m_Completions{};
+	StreamRequestId m_NextId{ 1 };
+	uint64_t m_NextSequence{};
+	uint64_t m_LoadedBytes{};
+	bool m_IsUsingIoUring{};
+	bool m_IsRunning{ true };
+
+	/* PRIVATE METHODS */
+
+	void WorkerLoop();
+
+};
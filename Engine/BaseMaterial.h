@@ -1,10 +1,20 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "Structs.h"
+
 class BaseMaterial
 {
 public:
-	BaseMaterial() noexcept = default;
-	virtual ~BaseMaterial() = default;
+	BaseMaterial() noexcept : m_SortId{ s_NextSortId++ } {}
+	virtual ~BaseMaterial()
+	{
+		if (IsParameterUploadRequested())
+			std::erase(s_pUploadRequests, this);
+	}
 
 	BaseMaterial(const BaseMaterial& other) noexcept = delete;
 	BaseMaterial& operator=(const BaseMaterial& other) noexcept = delete;
@@ -13,4 +23,75 @@ public:
 
 	virtual void Bind() = 0;
 
+	/**
+	 * \brief Materials able to draw many objects in a single call return true and implement BindInstanced
+	 */
+	[[nodiscard]] virtual bool SupportsInstancing() const { return false; }
+	/**
+	 * \brief Binds the variant reading world matrix and color from the per-draw instance array
+	 */
+	virtual void BindInstanced() {}
+	/**
+	 * \brief 
+	 * \return Color packed in the instance data of instanced draws
+	 */
+	[[nodiscard]] virtual XMFLOAT4 GetInstanceColor() const { return { 1.f, 1.f, 1.f, 1.f }; }
+
+	/**
+	 * \brief 
+	 * \return Unique id of this material, used in draw sort keys
+	 */
+	[[nodiscard]] uint32_t GetSortId() const { return m_SortId; }
+
+	/**
+	 * \brief Queues the parameters for the next flush, requesting again before it is a no-op. Nothing is tracked across
+	 * frames: every frame recycles its transient region, so the renderer requests an upload for each material it is
+	 * about to draw, whether its parameters changed or not.
+	 */
+	void RequestParameterUpload()
+	{
+		if (IsParameterUploadRequested())
+			return;
+
+		s_pUploadRequests.emplace_back(this);
+		m_IsUploadRequested = true;
+	}
+
+	/**
+	 * \brief Writes the parameters of every material queued since the last flush into the transient ring, called once
+	 * per frame before the backend flushes its uploads so they reach the GPU with the rest of the frame's data
+	 */
+	static void FlushParameterUploads()
+	{
+		for (BaseMaterial* pMaterial : s_pUploadRequests)
+		{
+			pMaterial->m_Parameters = pMaterial->WriteParameters();
+			pMaterial->m_IsUploadRequested = false;
+		}
+		s_pUploadRequests.clear();
+	}
+
+	[[nodiscard]] bool IsParameterUploadRequested() const { return m_IsUploadRequested; }
+
+protected:
+	/**
+	 * \brief Copies the CPU copy of the parameters to a transient allocation of the current frame
+	 * \return Invalid allocation if the backend does not read the parameters from a buffer
+	 */
+	[[nodiscard]] virtual TransientAllocation WriteParameters() { return {}; }
+	/**
+	 * \brief 
+	 * \return Slice written by the last flush, only valid during the frame it was flushed in
+	 */
+	[[nodiscard]] const TransientAllocation& GetParameters() const { return m_Parameters; }
+
+private:
+	/* DATA MEMBERS */
+
+	inline static uint32_t s_NextSortId{};
+	inline static std::vector<BaseMaterial*> s_pUploadRequests{};
+	const uint32_t m_SortId;
+	TransientAllocation m_Parameters{};
+	bool m_IsUploadRequested{};
+
 };
\ No newline at end of file
@@ -0,0 +1,368 @@
+#include "BatchFileReader.h"
+
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <atomic>
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Raw system calls, so the engine does not depend on liburing
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define PICOGINE_IO_URING
+#endif
+#endif
+
+class BatchFileReader::ReaderImpl
+{
+public:
+	ReaderImpl() noexcept = default;
+	virtual ~ReaderImpl() = default;
+
+	ReaderImpl(const ReaderImpl& other) noexcept = delete;
+	ReaderImpl& operator=(const ReaderImpl& other) noexcept = delete;
+	ReaderImpl(ReaderImpl&& other) noexcept = delete;
+	ReaderImpl& operator=(ReaderImpl&& other) noexcept = delete;
+
+	virtual void ReadAll(std::span<Read> reads) = 0;
+	[[nodiscard]] virtual bool IsUsingIoUring() const { return false; }
+
+protected:
+	static void ReadBlocking(Read& read);
+};
+
+void BatchFileReader::ReaderImpl::ReadBlocking(Read& read)
+{
+	read.m_Succeeded = false;
+
+	std::ifstream file{ read.m_Path, std::ios::binary | std::ios::ate };
+	if (!file)
+		return;
+
+	read.m_Data.resize(static_cast<size_t>(file.tellg()));
+	file.seekg(0);
+	file.read(reinterpret_cast<char*>(read.m_Data.data()), static_cast<std::streamsize>(read.m_Data.size()));
+	read.m_Succeeded = static_cast<bool>(file);
+}
+
+class BlockingReader final : public BatchFileReader::ReaderImpl
+{
+public:
+	void ReadAll(std::span<BatchFileReader::Read> reads) override
+	{
+		for (BatchFileReader::Read& read : reads)
+			ReadBlocking(read);
+	}
+};
+
+#ifdef PICOGINE_IO_URING
+
+class IoUringReader final : public BatchFileReader::ReaderImpl
+{
+public:
+	explicit IoUringReader(uint32_t queueDepth);
+	~IoUringReader() override;
+
+	IoUringReader(const IoUringReader& other) noexcept = delete;
+	IoUringReader& operator=(const IoUringReader& other) noexcept = delete;
+	IoUringReader(IoUringReader&& other) noexcept = delete;
+	IoUringReader& operator=(IoUringReader&& other) noexcept = delete;
+
+	/**
+	 * \return False if the kernel refused the ring, io_uring missing or disabled, the caller falls back to blocking reads
+	 */
+	[[nodiscard]] bool IsValid() const { return m_RingFd >= 0; }
+
+	void ReadAll(std::span<BatchFileReader::Read> reads) override;
+	[[nodiscard]] bool IsUsingIoUring() const override { return true; }
+
+private:
+	/* NESTED CLASSES */
+
+	struct PendingRead
+	{
+		BatchFileReader::Read* m_pRead{};
+		int m_Fd{ -1 };
+		uint64_t m_ReadSize{}; // Short reads are resubmitted for the rest
+	};
+
+	/* DATA MEMBERS */
+
+	inline static constexpr uint64_t s_MaxReadSize{ 1ull << 30 }; // The length of a read is 32-bit
+
+	int m_RingFd{ -1 };
+	uint32_t m_EntryCount{};
+
+	void* m_pSubmissionRing{};
+	size_t m_SubmissionRingSize{};
+	void* m_pCompletionRing{}; // Same mapping as the submission ring on kernels with IORING_FEAT_SINGLE_MMAP
+	size_t m_CompletionRingSize{};
+	io_uring_sqe* m_pSubmissionEntries{};
+	size_t m_SubmissionEntriesSize{};
+
+	uint32_t* m_pSubmissionTail{};
+	uint32_t m_SubmissionMask{};
+	uint32_t* m_pSubmissionArray{};
+	uint32_t* m_pCompletionHead{};
+	uint32_t* m_pCompletionTail{};
+	uint32_t m_CompletionMask{};
+	io_uring_cqe* m_pCompletionEntries{};
+
+	/* PRIVATE METHODS */
+
+	void Release();
+	void PushRead(uint64_t userData, const PendingRead& pending);
+	/**
+	 * \brief Submits the pushed reads and waits for completions, retrying when interrupted
+	 * \param submittedCount Entries the kernel consumed, may be fewer than submitCount, the rest stay in the ring
+	 * \return False on any other error
+	 */
+	bool Enter(uint32_t submitCount, uint32_t waitCount, uint32_t& submittedCount);
+	static void Finish(PendingRead& pending, bool succeeded);
+};
+
+IoUringReader::IoUringReader(uint32_t queueDepth)
+{
+	io_uring_params params{};
+	const long ringFd{ syscall(__NR_io_uring_setup, std::max(queueDepth, 1u), &params) };
+	if (ringFd < 0)
+		return;
+
+	m_RingFd = static_cast<int>(ringFd);
+	m_EntryCount = params.sq_entries;
+
+	m_SubmissionRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+	m_CompletionRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	const bool isSingleMapping{ (params.features & IORING_FEAT_SINGLE_MMAP) != 0 };
+	if (isSingleMapping)
+		m_SubmissionRingSize = m_CompletionRingSize = std::max(m_SubmissionRingSize, m_CompletionRingSize);
+
+	m_pSubmissionRing = mmap(nullptr, m_SubmissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, IORING_OFF_SQ_RING);
+	if (m_pSubmissionRing == MAP_FAILED)
+		m_pSubmissionRing = nullptr;
+
+	m_pCompletionRing = isSingleMapping ? m_pSubmissionRing
+		: mmap(nullptr, m_CompletionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, IORING_OFF_CQ_RING);
+	if (m_pCompletionRing == MAP_FAILED)
+		m_pCompletionRing = nullptr;
+
+	m_SubmissionEntriesSize = params.sq_entries * sizeof(io_uring_sqe);
+	void* pEntries{ mmap(nullptr, m_SubmissionEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFd, IORING_OFF_SQES) };
+	m_pSubmissionEntries = pEntries != MAP_FAILED ? static_cast<io_uring_sqe*>(pEntries) : nullptr;
+
+	if (!m_pSubmissionRing || !m_pCompletionRing || !m_pSubmissionEntries)
+	{
+		Release();
+		return;
+	}
+
+	const auto pSubmission = static_cast<uint8_t*>(m_pSubmissionRing);
+	m_pSubmissionTail = reinterpret_cast<uint32_t*>(pSubmission + params.sq_off.tail);
+	m_SubmissionMask = *reinterpret_cast<uint32_t*>(pSubmission + params.sq_off.ring_mask);
+	m_pSubmissionArray = reinterpret_cast<uint32_t*>(pSubmission + params.sq_off.array);
+
+	const auto pCompletion = static_cast<uint8_t*>(m_pCompletionRing);
+	m_pCompletionHead = reinterpret_cast<uint32_t*>(pCompletion + params.cq_off.head);
+	m_pCompletionTail = reinterpret_cast<uint32_t*>(pCompletion + params.cq_off.tail);
+	m_CompletionMask = *reinterpret_cast<uint32_t*>(pCompletion + params.cq_off.ring_mask);
+	m_pCompletionEntries = reinterpret_cast<io_uring_cqe*>(pCompletion + params.cq_off.cqes);
+}
+
+IoUringReader::~IoUringReader()
+{
+	Release();
+}
+
+void IoUringReader::ReadAll(std::span<BatchFileReader::Read> reads)
+{
+	std::vector<PendingRead> pendingReads(std::min<size_t>(reads.size(), m_EntryCount));
+
+	for (size_t batchStart{}; batchStart < reads.size(); batchStart += m_EntryCount)
+	{
+		const size_t batchSize{ std::min<size_t>(reads.size() - batchStart, m_EntryCount) };
+
+		uint32_t submitCount{};
+		uint32_t inFlightCount{};
+		for (size_t i{}; i < batchSize; ++i)
+		{
+			PendingRead& pending{ pendingReads[i] };
+			pending = { &reads[batchStart + i] };
+			pending.m_pRead->m_Succeeded = false;
+
+			pending.m_Fd = open(pending.m_pRead->m_Path.c_str(), O_RDONLY | O_CLOEXEC);
+			struct stat status{};
+			if (pending.m_Fd < 0 || fstat(pending.m_Fd, &status) != 0)
+			{
+				Finish(pending, false);
+				continue;
+			}
+
+			pending.m_pRead->m_Data.resize(static_cast<size_t>(status.st_size));
+			if (pending.m_pRead->m_Data.empty())
+			{
+				Finish(pending, true);
+				continue;
+			}
+
+			PushRead(i, pending);
+			++submitCount;
+			++inFlightCount;
+		}
+
+		while (inFlightCount > 0)
+		{
+			uint32_t submittedCount{};
+			if (!Enter(submitCount, 1, submittedCount))
+			{
+				// Only happens with an invalid ring or arguments, the batch is given up
+				assert(false && "io_uring_enter failed");
+				for (size_t i{}; i < batchSize; ++i)
+				{
+					if (pendingReads[i].m_Fd >= 0)
+						Finish(pendingReads[i], false);
+				}
+				break;
+			}
+
+			// Entries the kernel did not take are still queued between the ring's head and tail, submitted by the next
+			// Enter. Forgetting them would leave reads counted in flight that never complete, and wait forever.
+			submitCount -= std::min(submittedCount, submitCount);
+
+			const uint32_t tail{ std::atomic_ref<uint32_t>{ *m_pCompletionTail }.load(std::memory_order_acquire) };
+			uint32_t head{ *m_pCompletionHead };
+			for (; head != tail; ++head)
+			{
+				const io_uring_cqe& completion{ m_pCompletionEntries[head & m_CompletionMask] };
+				PendingRead& pending{ pendingReads[completion.user_data] };
+				--inFlightCount;
+
+				if (completion.res == -EINVAL || completion.res == -EOPNOTSUPP)
+				{
+					// Kernel older than IORING_OP_READ
+					close(pending.m_Fd);
+					pending.m_Fd = -1;
+					ReadBlocking(*pending.m_pRead);
+					continue;
+				}
+				if (completion.res <= 0)
+				{
+					Finish(pending, false);
+					continue;
+				}
+
+				pending.m_ReadSize += static_cast<uint64_t>(completion.res);
+				if (pending.m_ReadSize < pending.m_pRead->m_Data.size())
+				{
+					PushRead(completion.user_data, pending);
+					++submitCount;
+					++inFlightCount;
+					continue;
+				}
+
+				Finish(pending, true);
+			}
+			std::atomic_ref<uint32_t>{ *m_pCompletionHead }.store(head, std::memory_order_release);
+		}
+	}
+}
+
+void IoUringReader::PushRead(uint64_t userData, const PendingRead& pending)
+{
+	const uint32_t tail{ *m_pSubmissionTail };
+	const uint32_t index{ tail & m_SubmissionMask };
+
+	io_uring_sqe& entry{ m_pSubmissionEntries[index] };
+	entry = {};
+	entry.opcode = IORING_OP_READ;
+	entry.fd = pending.m_Fd;
+	entry.off = pending.m_ReadSize;
+	entry.addr = reinterpret_cast<uint64_t>(pending.m_pRead->m_Data.data() + pending.m_ReadSize);
+	entry.len = static_cast<uint32_t>(std::min(pending.m_pRead->m_Data.size() - pending.m_ReadSize, s_MaxReadSize));
+	entry.user_data = userData;
+
+	m_pSubmissionArray[index] = index;
+	std::atomic_ref<uint32_t>{ *m_pSubmissionTail }.store(tail + 1, std::memory_order_release);
+}
+
+void IoUringReader::Release()
+{
+	if (m_pSubmissionEntries)
+		munmap(m_pSubmissionEntries, m_SubmissionEntriesSize);
+	if (m_pCompletionRing && m_pCompletionRing != m_pSubmissionRing)
+		munmap(m_pCompletionRing, m_CompletionRingSize);
+	if (m_pSubmissionRing)
+		munmap(m_pSubmissionRing, m_SubmissionRingSize);
+	if (m_RingFd >= 0)
+		close(m_RingFd);
+
+	m_pSubmissionEntries = nullptr;
+	m_pCompletionRing = nullptr;
+	m_pSubmissionRing = nullptr;
+	m_RingFd = -1;
+}
+
+bool IoUringReader::Enter(uint32_t submitCount, uint32_t waitCount, uint32_t& submittedCount)
+{
+	while (true)
+	{
+		const long result{ syscall(__NR_io_uring_enter, m_RingFd, submitCount, waitCount, IORING_ENTER_GETEVENTS, nullptr, 0) };
+		if (result >= 0)
+		{
+			submittedCount = static_cast<uint32_t>(result);
+			return true;
+		}
+		if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+			return false;
+	}
+}
+
+void IoUringReader::Finish(PendingRead& pending, bool succeeded)
+{
+	if (pending.m_Fd >= 0)
+		close(pending.m_Fd);
+
+	pending.m_Fd = -1;
+	pending.m_pRead->m_Succeeded = succeeded;
+}
+
+#endif
+
+BatchFileReader::BatchFileReader(uint32_t queueDepth)
+{
+#ifdef PICOGINE_IO_URING
+	auto pIoUring{ new IoUringReader{ queueDepth } };
+	if (pIoUring->IsValid())
+	{
+		m_pReaderImpl = pIoUring;
+		return;
+	}
+	delete pIoUring;
+#else
+	(void)queueDepth;
+#endif
+
+	m_pReaderImpl = new BlockingReader{};
+}
+
+BatchFileReader::~BatchFileReader()
+{
+	delete m_pReaderImpl;
+}
+
+void BatchFileReader::ReadAll(std::span<Read> reads)
+{
+	m_pReaderImpl->ReadAll(reads);
+}
+
+bool BatchFileReader::IsUsingIoUring() const
+{
+	return m_pReaderImpl->IsUsingIoUring();
+}
+
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+/**
+ * \brief Reads whole files in batches. On Linux the batch is submitted to io_uring at once when the kernel
+ * supports it, so the reads overlap without a thread per file. Everywhere else, or when io_uring cannot be set up,
+ * the files are read one after the other with blocking calls.
+ * Not thread safe, every IO thread owns its own reader.
+ */
+class BatchFileReader final
+{
+public:
+	class ReaderImpl;
+
+	struct Read
+	{
+		std::filesystem::path m_Path{};
+		std::vector<uint8_t> m_Data{}; // Filled by ReadAll
+		bool m_Succeeded{};
+	};
+
+	/**
+	 * \param queueDepth Reads in flight at once, larger batches are split
+	 */
+	explicit BatchFileReader(uint32_t queueDepth);
+	~BatchFileReader();
+
+	BatchFileReader(const BatchFileReader& other) noexcept = delete;
+	BatchFileReader& operator=(const BatchFileReader& other) noexcept = delete;
+	BatchFileReader(BatchFileReader&& other) noexcept = delete;
+	BatchFileReader& operator=(BatchFileReader&& other) noexcept = delete;
+
+	/**
+	 * \brief Returns once every file of the batch was read or failed
+	 */
+	void ReadAll(std::span<Read> reads);
+
+	[[nodiscard]] bool IsUsingIoUring() const;
+
+private:
+	/* DATA MEMBERS */
+
+	ReaderImpl* m_pReaderImpl{};
+
+};
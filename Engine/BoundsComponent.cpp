@@ -0,0 +1,98 @@
+#include "BoundsComponent.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "GameObject.h"
+
+
+void BoundsComponent::FixedUpdate()
+{
+}
+
+void BoundsComponent::Update()
+{
+}
+
+void BoundsComponent::LateUpdate()
+{
+	// The owner is only known once the component is added, dirty transforms are propagated at the end of its Update
+	if (!m_IsRegistered)
+	{
+		m_IsRegistered = true;
+		m_TransformHasChanged = true;
+		GetOwner()->RegisterNotifyDirtyTransform(this);
+	}
+
+	if (m_TransformHasChanged)
+	{
+		m_TransformHasChanged = false;
+		UpdateWorldBounds();
+	}
+}
+
+void BoundsComponent::Render()
+{
+}
+
+void BoundsComponent::SetBox(const XMFLOAT3& center, const XMFLOAT3& extents)
+{
+	m_Center = center;
+	m_Extents = extents;
+	XMStoreFloat(&m_Radius, XMVector3Length(XMLoadFloat3(&extents)));
+	m_TransformHasChanged = true;
+}
+
+void BoundsComponent::SetSphere(const XMFLOAT3& center, float radius)
+{
+	m_Center = center;
+	m_Extents = { radius, radius, radius };
+	m_Radius = radius;
+	m_TransformHasChanged = true;
+}
+
+const XMFLOAT3& BoundsComponent::GetWorldCenter() const
+{
+	return m_WorldCenter;
+}
+
+const XMFLOAT3& BoundsComponent::GetWorldExtents() const
+{
+	return m_WorldExtents;
+}
+
+float BoundsComponent::GetWorldRadius() const
+{
+	return m_WorldRadius;
+}
+
+AABB BoundsComponent::GetWorldBox() const
+{
+	return {
+		{ m_WorldCenter.x - m_WorldExtents.x, m_WorldCenter.y - m_WorldExtents.y, m_WorldCenter.z - m_WorldExtents.z },
+		{ m_WorldCenter.x + m_WorldExtents.x, m_WorldCenter.y + m_WorldExtents.y, m_WorldCenter.z + m_WorldExtents.z }
+	};
+}
+
+void BoundsComponent::UpdateWorldBounds()
+{
+	m_HasMoved = true;
+
+	const XMMATRIX world{ XMLoadFloat4x4(&GetOwner()->GetWorldTransform().GetTransform()) };
+
+	XMStoreFloat3(&m_WorldCenter, XMVector3TransformCoord(XMLoadFloat3(&m_Center), world));
+
+	// Matrix rows are the scaled local axes, projecting them on the world axes gives the extents of the rotated box
+	const XMVECTOR extents{ XMLoadFloat3(&m_Extents) };
+	const XMVECTOR absRight{ XMVectorAbs(world.r[0]) };
+	const XMVECTOR absUp{ XMVectorAbs(world.r[1]) };
+	const XMVECTOR absForward{ XMVectorAbs(world.r[2]) };
+	XMStoreFloat3(&m_WorldExtents, XMVectorMultiplyAdd(XMVectorSplatZ(extents), absForward, XMVectorMultiplyAdd(XMVectorSplatY(extents), absUp, XMVectorMultiply(XMVectorSplatX(extents), absRight))));
+
+	// Non uniform scale stretches the sphere by its largest axis
+	const float maxScale{ std::sqrt((std::max)({
+		XMVectorGetX(XMVector3LengthSq(world.r[0])),
+		XMVectorGetX(XMVector3LengthSq(world.r[1])),
+		XMVectorGetX(XMVector3LengthSq(world.r[2])) })) };
+	m_WorldRadius = m_Radius * maxScale;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "BaseComponent.h"
+#include "AABB.h"
+
+/**
+ * \brief Local space bounding volume of an object, used by the scene to cull it against the camera frustum and to
+ * find it in spatial queries. Objects without bounds are never culled and never returned by queries.
+ */
+class BoundsComponent final : public BaseComponent
+{
+	friend class GameScene;
+
+public:
+	BoundsComponent() noexcept = default;
+	~BoundsComponent() override = default;
+
+	BoundsComponent(const BoundsComponent& other) = delete;
+	BoundsComponent& operator=(const BoundsComponent& other) noexcept = delete;
+	BoundsComponent(BoundsComponent&& other) = delete;
+	BoundsComponent& operator=(BoundsComponent&& other) noexcept = delete;
+
+	void FixedUpdate() override;
+	void Update() override;
+	void LateUpdate() override;
+	void Render() override;
+
+	/**
+	 * \brief Set an axis aligned box, the bounding sphere is fitted around it
+	 * \param center Local space center
+	 * \param extents Local space half size
+	 */
+	void SetBox(const XMFLOAT3& center, const XMFLOAT3& extents);
+	/**
+	 * \brief Set a sphere, the box is fitted around it
+	 * \param center Local space center
+	 * \param radius Local space radius
+	 */
+	void SetSphere(const XMFLOAT3& center, float radius);
+
+	[[nodiscard]] const XMFLOAT3& GetWorldCenter() const;
+	[[nodiscard]] const XMFLOAT3& GetWorldExtents() const;
+	[[nodiscard]] float GetWorldRadius() const;
+	[[nodiscard]] AABB GetWorldBox() const;
+
+private:
+	/* DATA MEMBERS */
+
+	XMFLOAT3 m_Center{};
+	XMFLOAT3 m_Extents{ .5f, .5f, .5f };
+	float m_Radius{ .8660254f }; // Sphere around the default unit cube
+
+	XMFLOAT3 m_WorldCenter{};
+	XMFLOAT3 m_WorldExtents{};
+	float m_WorldRadius{};
+
+	bool m_IsRegistered{};
+	bool m_HasMoved{}; // World bounds changed since the scene's spatial index last saw them
+	int32_t m_Proxy{ -1 }; // Leaf in the scene's spatial index
+
+	/* PRIVATE METHODS */
+
+	void UpdateWorldBounds();
+
+};
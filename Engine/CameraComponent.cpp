@@ -53,6 +53,14 @@ void CameraComponent::Update()
 		XMStoreFloat4x4(&m_ViewInverse, viewInv);
 		XMStoreFloat4x4(&m_ViewProjection, view * projection);
 		XMStoreFloat4x4(&m_ViewProjectionInverse, viewProjectionInv);
+
+		XMStoreFloat4x4(&m_ViewConstants.m_View, XMMatrixTranspose(view));
+		XMStoreFloat4x4(&m_ViewConstants.m_Projection, XMMatrixTranspose(projection));
+		XMStoreFloat4x4(&m_ViewConstants.m_ViewProjection, XMMatrixTranspose(view * projection));
+		XMStoreFloat4x4(&m_ViewConstants.m_ViewInverse, XMMatrixTranspose(viewInv));
+		XMStoreFloat4x4(&m_ViewConstants.m_ProjectionInverse, XMMatrixTranspose(XMMatrixInverse(nullptr, projection)));
+		XMStoreFloat4x4(&m_ViewConstants.m_ViewProjectionInverse, XMMatrixTranspose(viewProjectionInv));
+		XMStoreFloat4(&m_ViewConstants.m_ViewPosition, worldPosition);
 	}
 }
 
@@ -88,3 +96,8 @@ const XMFLOAT4X4& CameraComponent::GetViewProjectionInverse() const
 {
 	return m_ViewProjectionInverse;
 }
+
+const ViewConstants& CameraComponent::GetViewConstants() const
+{
+	return m_ViewConstants;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "BaseComponent.h"
+#include "ViewConstants.h"
 
 class CameraComponent final : public BaseComponent
 {
@@ -23,6 +24,10 @@ public:
 	const XMFLOAT4X4& GetViewProjection() const;
 	const XMFLOAT4X4& GetViewInverse() const;
 	const XMFLOAT4X4& GetViewProjectionInverse() const;
+	/**
+	 * \brief Matrices and inverses in the layout the shaders read, rebuilt with the matrices
+	 */
+	const ViewConstants& GetViewConstants() const;
 
 private:
 	/* DATA MEMBERS */
@@ -32,6 +37,7 @@ private:
 	XMFLOAT4X4 m_ViewInverse{};
 	XMFLOAT4X4 m_ViewProjection{};
 	XMFLOAT4X4 m_ViewProjectionInverse{};
+	ViewConstants m_ViewConstants{};
 
 	float m_Size;
 	bool m_PerspectiveProjection{ true };
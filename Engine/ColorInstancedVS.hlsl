@@ -0,0 +1,32 @@
+#include "ViewConstants.hlsli"
+#include "WorldMatrices.hlsli"
+
+#define MAX_INSTANCES 512 // Must match Renderer::RendererImpl::s_MaxInstancesPerDraw
+
+struct InstanceData
+{
+	uint ObjectId;
+	uint3 Padding;
+	float4 Color;
+};
+
+cbuffer InstanceBuffer : register(b1)
+{
+	InstanceData g_Instances[MAX_INSTANCES];
+};
+
+struct VS_Output
+{
+	float4 Position: SV_POSITION;
+	float4 Color: COLOR0;
+};
+
+VS_Output main(float2 pos : POSITION, uint instanceId : SV_InstanceID)
+{
+	VS_Output output = (VS_Output)0;
+
+	output.Position = mul(float4(TransformToWorld(g_Instances[instanceId].ObjectId, float3(pos, 0.f)), 1.f), g_ViewProjection);
+	output.Color = g_Instances[instanceId].Color;
+
+	return output;
+}
\ No newline at end of file
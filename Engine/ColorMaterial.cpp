@@ -2,10 +2,17 @@
 
 #include <d3d11.h>
 #pragma comment(lib, "d3d11.lib")
-#include <d3dcompiler.h>
-#pragma comment(lib, "d3dcompiler.lib")
 
+#include "DX11ShaderCache.h"
+#include "DX12Context.h"
+#include "GameSettings.h"
 #include "Renderer.h"
+#include "SoftwareRasterizer.h"
+#include "StateTracker.h"
+
+#ifdef PICOGINE_VULKAN
+#include "VulkanContext.h"
+#endif
 
 using Microsoft::WRL::ComPtr;
 
@@ -20,16 +27,26 @@ public:
 	ColorMaterialImpl(ColorMaterialImpl&& other) noexcept = delete;
 	ColorMaterialImpl& operator=(ColorMaterialImpl&& other) noexcept = delete;
 
-	virtual void Bind() = 0;
+	/**
+	 * \param parameters Written by WriteParameters during this frame's flush
+	 */
+	virtual void Bind(const TransientAllocation& parameters) = 0;
+	virtual void BindInstanced() = 0;
 	virtual void SetColor(const XMFLOAT4& color) = 0;
 	virtual void SetColor(float r, float g, float b, float a = 1) = 0;
+	[[nodiscard]] virtual const XMFLOAT4& GetColor() const = 0;
+	/**
+	 * \brief Only needed by backends reading the color from a constant buffer
+	 * \return Transient slice holding the color, invalid if the backend does not need one
+	 */
+	[[nodiscard]] virtual TransientAllocation WriteParameters() const { return {}; }
 
 };
 
 class DX11ColorMaterial final : public ColorMaterial::ColorMaterialImpl
 {
 public:
-	DX11ColorMaterial() noexcept;
+	DX11ColorMaterial();
 	~DX11ColorMaterial() override = default;
 
 	DX11ColorMaterial(const DX11ColorMaterial& other) = delete;
@@ -37,9 +54,12 @@ public:
 	DX11ColorMaterial(DX11ColorMaterial&& other) = delete;
 	DX11ColorMaterial& operator=(DX11ColorMaterial&& other) noexcept = delete;
 
-	void Bind() override;
+	void Bind(const TransientAllocation& parameters) override;
+	void BindInstanced() override;
 	void SetColor(const XMFLOAT4& color) override;
 	void SetColor(float r, float g, float b, float a = 1) override;
+	[[nodiscard]] const XMFLOAT4& GetColor() const override;
+	[[nodiscard]] TransientAllocation WriteParameters() const override;
 
 private:
 	/* STRUCTS */
@@ -51,68 +71,74 @@ private:
 
 	/* DATA MEMBERS */
 
-	PSConstantBufferData m_PSConstantBufferData{};
+	PSConstantBufferData m_PSConstantBufferData{}; // CPU copy, written to the transient ring by WriteParameters
 
-	ComPtr<ID3D11Buffer> m_pPSConstantBuffer;
 	ComPtr<ID3D11PixelShader> m_pPixelShader;
 	ComPtr<ID3D11VertexShader> m_pVertexShader;
 	ComPtr<ID3D11InputLayout> m_pInputLayout;
 
+	// Instanced variant, color comes from the instance data
+	ComPtr<ID3D11PixelShader> m_pInstancedPixelShader;
+	ComPtr<ID3D11VertexShader> m_pInstancedVertexShader;
+
 	/* PRIVATE METHODS */
 
-	void UpdateBuffer() const;
 };
 
-DX11ColorMaterial::DX11ColorMaterial() noexcept
+DX11ColorMaterial::DX11ColorMaterial()
 {
 	const auto device = static_cast<ID3D11Device*>(Renderer::Get().GetDevice());
 
-	D3D11_BUFFER_DESC cbDesc;
-	cbDesc.ByteWidth = sizeof(PSConstantBufferData);
-	cbDesc.Usage = D3D11_USAGE_DYNAMIC;
-	cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-	cbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-	cbDesc.MiscFlags = 0;
-	cbDesc.StructureByteStride = 0;
-
-	D3D11_SUBRESOURCE_DATA cbData;
-	cbData.pSysMem = &m_PSConstantBufferData;
-	cbData.SysMemPitch = 0;
-	cbData.SysMemSlicePitch = 0;
-
-	device->CreateBuffer(&cbDesc, &cbData, &m_pPSConstantBuffer);
+	// Shader objects and the input layout are shared with every other material using the same files
+	DX11ShaderCache& shaderCache{ DX11ShaderCache::Get() };
 
-	// PS
-	ComPtr<ID3DBlob> pBlob;
-	D3DReadFileToBlob(L"../Engine/Shaders/ColorPS.cso", &pBlob);
-	device->CreatePixelShader(pBlob->GetBufferPointer(), pBlob->GetBufferSize(), nullptr, &m_pPixelShader);
-
-	// VS
-	D3DReadFileToBlob(L"../Engine/Shaders/ColorVS.cso", &pBlob);
-	device->CreateVertexShader(pBlob->GetBufferPointer(), pBlob->GetBufferSize(), nullptr, &m_pVertexShader);
+	m_pPixelShader = shaderCache.GetPixelShader(device, L"../Engine/Shaders/ColorPS.cso");
+	m_pVertexShader = shaderCache.GetVertexShader(device, L"../Engine/Shaders/ColorVS.cso");
 
 	// Input Layout
 	const D3D11_INPUT_ELEMENT_DESC ied[] =
 	{
 		{ "POSITION", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
 	};
-	device->CreateInputLayout(ied, UINT(std::size(ied)), pBlob->GetBufferPointer(), pBlob->GetBufferSize(), &m_pInputLayout);
+	m_pInputLayout = shaderCache.GetInputLayout(device, ied, UINT(std::size(ied)), L"../Engine/Shaders/ColorVS.cso");
+
+	// Instanced variant, same input signature as ColorVS
+	m_pInstancedPixelShader = shaderCache.GetPixelShader(device, L"../Engine/Shaders/TestPS.cso");
+	m_pInstancedVertexShader = shaderCache.GetVertexShader(device, L"../Engine/Shaders/ColorInstancedVS.cso");
+}
+
+void DX11ColorMaterial::Bind(const TransientAllocation& parameters)
+{
+	const auto deviceContext = static_cast<ID3D11DeviceContext*>(Renderer::Get().GetDeviceContext());
+	StateTracker& state{ Renderer::Get().GetStateTracker() };
+
+	// Shaders and layout are shared between materials, only the constant range is guaranteed to change
+	if (parameters.IsValid())
+		Renderer::Get().BindTransientConstants(ShaderStage::Pixel, 0, parameters);
+	if (state.SetPixelShader(m_pPixelShader.Get()))
+		deviceContext->PSSetShader(m_pPixelShader.Get(), nullptr, 0u);
+	if (state.SetVertexShader(m_pVertexShader.Get()))
+		deviceContext->VSSetShader(m_pVertexShader.Get(), nullptr, 0u);
+	if (state.SetInputLayout(m_pInputLayout.Get()))
+		deviceContext->IASetInputLayout(m_pInputLayout.Get());
 }
 
-void DX11ColorMaterial::Bind()
+void DX11ColorMaterial::BindInstanced()
 {
 	const auto deviceContext = static_cast<ID3D11DeviceContext*>(Renderer::Get().GetDeviceContext());
-	deviceContext->PSSetConstantBuffers(0, 1, m_pPSConstantBuffer.GetAddressOf());
-	deviceContext->PSSetShader(m_pPixelShader.Get(), nullptr, 0u);
-	deviceContext->VSSetShader(m_pVertexShader.Get(), nullptr, 0u);
-	deviceContext->IASetInputLayout(m_pInputLayout.Get());
+	StateTracker& state{ Renderer::Get().GetStateTracker() };
+
+	if (state.SetPixelShader(m_pInstancedPixelShader.Get()))
+		deviceContext->PSSetShader(m_pInstancedPixelShader.Get(), nullptr, 0u);
+	if (state.SetVertexShader(m_pInstancedVertexShader.Get()))
+		deviceContext->VSSetShader(m_pInstancedVertexShader.Get(), nullptr, 0u);
+	if (state.SetInputLayout(m_pInputLayout.Get()))
+		deviceContext->IASetInputLayout(m_pInputLayout.Get());
 }
 
 void DX11ColorMaterial::SetColor(const XMFLOAT4& color)
 {
 	m_PSConstantBufferData.color = color;
-
-	UpdateBuffer();
 }
 
 void DX11ColorMaterial::SetColor(float r, float g, float b, float a)
@@ -121,27 +147,251 @@ void DX11ColorMaterial::SetColor(float r, float g, float b, float a)
 	m_PSConstantBufferData.color.y = g;
 	m_PSConstantBufferData.color.z = b;
 	m_PSConstantBufferData.color.w = a;
+}
 
-	UpdateBuffer();
+const XMFLOAT4& DX11ColorMaterial::GetColor() const
+{
+	return m_PSConstantBufferData.color;
 }
 
-void DX11ColorMaterial::UpdateBuffer() const
+TransientAllocation DX11ColorMaterial::WriteParameters() const
 {
-	const auto deviceContext = static_cast<ID3D11DeviceContext*>(Renderer::Get().GetDeviceContext());
+	// Goes up with the renderer's single map of the transient buffer
+	const TransientAllocation parameters{ Renderer::Get().AllocateTransient(sizeof(PSConstantBufferData)) };
+	if (parameters.IsValid())
+		memcpy(parameters.m_pData, &m_PSConstantBufferData, sizeof(PSConstantBufferData));
+
+	return parameters;
+}
+
+class NullColorMaterial final : public ColorMaterial::ColorMaterialImpl
+{
+public:
+	NullColorMaterial() noexcept = default;
+	~NullColorMaterial() override = default;
+
+	NullColorMaterial(const NullColorMaterial& other) = delete;
+	NullColorMaterial& operator=(const NullColorMaterial& other) noexcept = delete;
+	NullColorMaterial(NullColorMaterial&& other) = delete;
+	NullColorMaterial& operator=(NullColorMaterial&& other) noexcept = delete;
+
+	void Bind(const TransientAllocation& /*parameters*/) override {}
+	void BindInstanced() override {}
+	void SetColor(const XMFLOAT4& color) override { m_Color = color; }
+	void SetColor(float r, float g, float b, float a = 1) override { m_Color = { r, g, b, a }; }
+	[[nodiscard]] const XMFLOAT4& GetColor() const override { return m_Color; }
+
+private:
+	/* DATA MEMBERS */
+
+	XMFLOAT4 m_Color{};
+};
+
+class SoftwareColorMaterial final : public ColorMaterial::ColorMaterialImpl
+{
+public:
+	SoftwareColorMaterial() noexcept = default;
+	~SoftwareColorMaterial() override = default;
+
+	SoftwareColorMaterial(const SoftwareColorMaterial& other) = delete;
+	SoftwareColorMaterial& operator=(const SoftwareColorMaterial& other) noexcept = delete;
+	SoftwareColorMaterial(SoftwareColorMaterial&& other) = delete;
+	SoftwareColorMaterial& operator=(SoftwareColorMaterial&& other) noexcept = delete;
+
+	void Bind(const TransientAllocation& parameters) override;
+	void BindInstanced() override;
+	void SetColor(const XMFLOAT4& color) override { m_Color = color; }
+	void SetColor(float r, float g, float b, float a = 1) override { m_Color = { r, g, b, a }; }
+	[[nodiscard]] const XMFLOAT4& GetColor() const override { return m_Color; }
+
+private:
+	/* DATA MEMBERS */
+
+	XMFLOAT4 m_Color{};
+};
+
+void SoftwareColorMaterial::Bind(const TransientAllocation& /*parameters*/)
+{
+	// ColorVS / ColorPS
+	const auto pRasterizer = static_cast<SoftwareRasterizer*>(Renderer::Get().GetDeviceContext());
+	pRasterizer->SetPipelineState({ SoftwareRasterizer::VertexProgram::Color, SoftwareRasterizer::PixelProgram::ConstantColor, { m_Color.x, m_Color.y, m_Color.z, m_Color.w } });
+}
+
+void SoftwareColorMaterial::BindInstanced()
+{
+	// ColorInstancedVS / TestPS
+	const auto pRasterizer = static_cast<SoftwareRasterizer*>(Renderer::Get().GetDeviceContext());
+	pRasterizer->SetPipelineState({ SoftwareRasterizer::VertexProgram::ColorInstanced, SoftwareRasterizer::PixelProgram::VertexColor, { m_Color.x, m_Color.y, m_Color.z, m_Color.w } });
+}
+
+class DX12ColorMaterial final : public ColorMaterial::ColorMaterialImpl
+{
+public:
+	DX12ColorMaterial();
+	~DX12ColorMaterial() override;
+
+	DX12ColorMaterial(const DX12ColorMaterial& other) = delete;
+	DX12ColorMaterial& operator=(const DX12ColorMaterial& other) noexcept = delete;
+	DX12ColorMaterial(DX12ColorMaterial&& other) = delete;
+	DX12ColorMaterial& operator=(DX12ColorMaterial&& other) noexcept = delete;
+
+	void Bind(const TransientAllocation& parameters) override;
+	void BindInstanced() override;
+	void SetColor(const XMFLOAT4& color) override { m_Color = color; }
+	void SetColor(float r, float g, float b, float a = 1) override { m_Color = { r, g, b, a }; }
+	[[nodiscard]] const XMFLOAT4& GetColor() const override { return m_Color; }
+	[[nodiscard]] TransientAllocation WriteParameters() const override;
+
+private:
+	/* DATA MEMBERS */
+
+	XMFLOAT4 m_Color{};
+
+	ComPtr<ID3D12PipelineState> m_pPipeline{};
+	ComPtr<ID3D12PipelineState> m_pInstancedPipeline{}; // Color comes from the instance data
+
+};
+
+DX12ColorMaterial::DX12ColorMaterial()
+{
+	const auto pContext = static_cast<DX12Context*>(Renderer::Get().GetDevice());
 
-	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	m_pPipeline = pContext->CreateGraphicsPipeline(L"../Engine/Shaders/ColorVS.cso", L"../Engine/Shaders/ColorPS.cso");
+	m_pInstancedPipeline = pContext->CreateGraphicsPipeline(L"../Engine/Shaders/ColorInstancedVS.cso", L"../Engine/Shaders/TestPS.cso");
+}
+
+DX12ColorMaterial::~DX12ColorMaterial()
+{
+	const auto pContext = static_cast<DX12Context*>(Renderer::Get().GetDevice());
+	pContext->DestroyPipeline(m_pPipeline);
+	pContext->DestroyPipeline(m_pInstancedPipeline);
+}
+
+void DX12ColorMaterial::Bind(const TransientAllocation& parameters)
+{
+	const auto pCommandList = static_cast<ID3D12GraphicsCommandList*>(Renderer::Get().GetDeviceContext());
+	if (Renderer::Get().GetStateTracker().SetPipeline(m_pPipeline.Get()))
+		pCommandList->SetPipelineState(m_pPipeline.Get());
+
+	if (parameters.IsValid())
+		Renderer::Get().BindTransientConstants(ShaderStage::Pixel, 0, parameters);
+}
+
+void DX12ColorMaterial::BindInstanced()
+{
+	const auto pCommandList = static_cast<ID3D12GraphicsCommandList*>(Renderer::Get().GetDeviceContext());
+	if (Renderer::Get().GetStateTracker().SetPipeline(m_pInstancedPipeline.Get()))
+		pCommandList->SetPipelineState(m_pInstancedPipeline.Get());
+}
+
+TransientAllocation DX12ColorMaterial::WriteParameters() const
+{
+	const TransientAllocation parameters{ Renderer::Get().AllocateTransient(sizeof(XMFLOAT4)) };
+	if (parameters.IsValid())
+		memcpy(parameters.m_pData, &m_Color, sizeof(XMFLOAT4));
+
+	return parameters;
+}
+
+#ifdef PICOGINE_VULKAN
+class VKColorMaterial final : public ColorMaterial::ColorMaterialImpl
+{
+public:
+	VKColorMaterial();
+	~VKColorMaterial() override;
+
+	VKColorMaterial(const VKColorMaterial& other) = delete;
+	VKColorMaterial& operator=(const VKColorMaterial& other) noexcept = delete;
+	VKColorMaterial(VKColorMaterial&& other) = delete;
+	VKColorMaterial& operator=(VKColorMaterial&& other) noexcept = delete;
+
+	void Bind(const TransientAllocation& parameters) override;
+	void BindInstanced() override;
+	void SetColor(const XMFLOAT4& color) override { m_Color = color; }
+	void SetColor(float r, float g, float b, float a = 1) override { m_Color = { r, g, b, a }; }
+	[[nodiscard]] const XMFLOAT4& GetColor() const override { return m_Color; }
+	[[nodiscard]] TransientAllocation WriteParameters() const override;
+
+private:
+	/* DATA MEMBERS */
+
+	XMFLOAT4 m_Color{};
+
+	VkPipeline m_Pipeline{};
+	VkPipeline m_InstancedPipeline{}; // Color comes from the instance data
+
+};
+
+VKColorMaterial::VKColorMaterial()
+{
+	const auto pContext = static_cast<VulkanContext*>(Renderer::Get().GetDevice());
+
+	// SPIR-V compiled from the same HLSL as the DX11 path
+	m_Pipeline = pContext->CreateGraphicsPipeline(L"../Engine/Shaders/ColorVS.spv", L"../Engine/Shaders/ColorPS.spv", sizeof(XMFLOAT2));
+	m_InstancedPipeline = pContext->CreateGraphicsPipeline(L"../Engine/Shaders/ColorInstancedVS.spv", L"../Engine/Shaders/TestPS.spv", sizeof(XMFLOAT2));
+}
+
+VKColorMaterial::~VKColorMaterial()
+{
+	const auto pContext = static_cast<VulkanContext*>(Renderer::Get().GetDevice());
+	pContext->DestroyPipeline(m_Pipeline);
+	pContext->DestroyPipeline(m_InstancedPipeline);
+}
+
+void VKColorMaterial::Bind(const TransientAllocation& parameters)
+{
+	const auto commandBuffer = static_cast<VkCommandBuffer>(Renderer::Get().GetDeviceContext());
+	if (Renderer::Get().GetStateTracker().SetPipeline(m_Pipeline))
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline);
 
-	deviceContext->Map(m_pPSConstantBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	if (parameters.IsValid())
+		Renderer::Get().BindTransientConstants(ShaderStage::Pixel, 0, parameters);
+}
 
-	const auto data = static_cast<float*>(mappedResource.pData);
-	memcpy(data, &m_PSConstantBufferData, sizeof(PSConstantBufferData));
+void VKColorMaterial::BindInstanced()
+{
+	const auto commandBuffer = static_cast<VkCommandBuffer>(Renderer::Get().GetDeviceContext());
+	if (Renderer::Get().GetStateTracker().SetPipeline(m_InstancedPipeline))
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_InstancedPipeline);
+}
 
-	deviceContext->Unmap(m_pPSConstantBuffer.Get(), 0);
+TransientAllocation VKColorMaterial::WriteParameters() const
+{
+	const TransientAllocation parameters{ Renderer::Get().AllocateTransient(sizeof(XMFLOAT4)) };
+	if (parameters.IsValid())
+		memcpy(parameters.m_pData, &m_Color, sizeof(XMFLOAT4));
+
+	return parameters;
 }
+#endif
 
-ColorMaterial::ColorMaterial() noexcept
+ColorMaterial::ColorMaterial()
 {
-	m_pColorMaterialImpl = new DX11ColorMaterial();
+	switch (GameSettings::renderAPI)
+	{
+	case GameSettings::RenderAPI::DirectX11:
+		m_pColorMaterialImpl = new DX11ColorMaterial();
+		break;
+
+	case GameSettings::RenderAPI::DirectX12:
+		m_pColorMaterialImpl = new DX12ColorMaterial();
+		break;
+
+	case GameSettings::RenderAPI::Software:
+		m_pColorMaterialImpl = new SoftwareColorMaterial();
+		break;
+
+#ifdef PICOGINE_VULKAN
+	case GameSettings::RenderAPI::Vulkan:
+		m_pColorMaterialImpl = new VKColorMaterial();
+		break;
+#endif
+
+	default:
+		// No material path for this backend yet, parameters are only stored
+		m_pColorMaterialImpl = new NullColorMaterial();
+		break;
+	}
 }
 
 ColorMaterial::~ColorMaterial()
@@ -151,15 +401,40 @@ ColorMaterial::~ColorMaterial()
 
 void ColorMaterial::Bind()
 {
-	m_pColorMaterialImpl->Bind();
+	m_pColorMaterialImpl->Bind(GetParameters());
 }
 
-void ColorMaterial::SetColor(const XMFLOAT4& color) const
+bool ColorMaterial::SupportsInstancing() const
+{
+	return true;
+}
+
+void ColorMaterial::BindInstanced()
+{
+	m_pColorMaterialImpl->BindInstanced();
+}
+
+XMFLOAT4 ColorMaterial::GetInstanceColor() const
+{
+	return m_pColorMaterialImpl->GetColor();
+}
+
+void ColorMaterial::SetColor(const XMFLOAT4& color)
 {
 	m_pColorMaterialImpl->SetColor(color);
 }
 
-void ColorMaterial::SetColor(float r, float g, float b, float a) const
+void ColorMaterial::SetColor(float r, float g, float b, float a)
 {
 	m_pColorMaterialImpl->SetColor(r, g, b, a);
 }
+
+const XMFLOAT4& ColorMaterial::GetColor() const
+{
+	return m_pColorMaterialImpl->GetColor();
+}
+
+TransientAllocation ColorMaterial::WriteParameters()
+{
+	return m_pColorMaterialImpl->WriteParameters();
+}
\ No newline at end of file
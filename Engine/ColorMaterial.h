@@ -7,7 +7,7 @@ class ColorMaterial final : public BaseMaterial
 public:
 	class ColorMaterialImpl;
 
-	ColorMaterial() noexcept;
+	ColorMaterial();
 	~ColorMaterial() override;
 
 	ColorMaterial(const ColorMaterial& other) = delete;
@@ -16,8 +16,19 @@ public:
 	ColorMaterial& operator=(ColorMaterial&& other) noexcept = delete;
 
 	void Bind() override;
-	void SetColor(const XMFLOAT4& color) const;
-	void SetColor(float r, float g, float b, float a = 1) const;
+	[[nodiscard]] bool SupportsInstancing() const override;
+	void BindInstanced() override;
+	[[nodiscard]] XMFLOAT4 GetInstanceColor() const override;
+
+	/**
+	 * \brief Only written to the CPU copy, copied to the transient ring by the flush of every frame drawing the material
+	 */
+	void SetColor(const XMFLOAT4& color);
+	void SetColor(float r, float g, float b, float a = 1);
+	[[nodiscard]] const XMFLOAT4& GetColor() const;
+
+protected:
+	[[nodiscard]] TransientAllocation WriteParameters() override;
 
 private:
 	/* DATA MEMBERS */
@@ -1,6 +1,12 @@
-// TODO Add camera transform
+#include "ViewConstants.hlsli"
+#include "WorldMatrices.hlsli"
+
+cbuffer ObjectConstants : register(b1)
+{
+	uint g_ObjectId;
+};
 
 float4 main(float2 pos : POSITION) : SV_POSITION
 {
-	return float4(pos, 0.f, 1.0f);
+	return mul(float4(TransformToWorld(g_ObjectId, float3(pos, 0.f)), 1.f), g_ViewProjection);
 }
\ No newline at end of file
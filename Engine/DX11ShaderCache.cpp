@@ -0,0 +1,93 @@
+#include "DX11ShaderCache.h"
+
+#include <cstring>
+
+#include "Renderer.h"
+#include "ShaderCache.h"
+#include "WindowsException.h"
+
+using Microsoft::WRL::ComPtr;
+
+ID3D11VertexShader* DX11ShaderCache::GetVertexShader(ID3D11Device* pDevice, const std::filesystem::path& path)
+{
+	const ShaderBytecode* pBytecode{ ShaderCache::Get().Load(path) };
+	if (!pBytecode)
+		throw PGWND_EXCEPTION(HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND));
+
+	ComPtr<ID3D11VertexShader>& pShader{ m_VertexShaders[pBytecode->m_Hash] };
+	if (!pShader)
+	{
+		PGWND_THROW_IF_FAILED(pDevice->CreateVertexShader(pBytecode->GetData(), pBytecode->GetSize(), nullptr, &pShader));
+		Renderer::Get().CountResourceCreation();
+	}
+
+	return pShader.Get();
+}
+
+ID3D11PixelShader* DX11ShaderCache::GetPixelShader(ID3D11Device* pDevice, const std::filesystem::path& path)
+{
+	const ShaderBytecode* pBytecode{ ShaderCache::Get().Load(path) };
+	if (!pBytecode)
+		throw PGWND_EXCEPTION(HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND));
+
+	ComPtr<ID3D11PixelShader>& pShader{ m_PixelShaders[pBytecode->m_Hash] };
+	if (!pShader)
+	{
+		PGWND_THROW_IF_FAILED(pDevice->CreatePixelShader(pBytecode->GetData(), pBytecode->GetSize(), nullptr, &pShader));
+		Renderer::Get().CountResourceCreation();
+	}
+
+	return pShader.Get();
+}
+
+ID3D11InputLayout* DX11ShaderCache::GetInputLayout(ID3D11Device* pDevice, const D3D11_INPUT_ELEMENT_DESC* pElements, UINT elementCount, const std::filesystem::path& vertexShaderPath)
+{
+	ComPtr<ID3D11InputLayout>& pLayout{ m_InputLayouts[HashInputLayout(pElements, elementCount)] };
+	if (pLayout)
+		return pLayout.Get();
+
+	const ShaderBytecode* pBytecode{ ShaderCache::Get().Load(vertexShaderPath) };
+	if (!pBytecode)
+		throw PGWND_EXCEPTION(HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND));
+
+	PGWND_THROW_IF_FAILED(pDevice->CreateInputLayout(pElements, elementCount, pBytecode->GetData(), pBytecode->GetSize(), &pLayout));
+	Renderer::Get().CountResourceCreation();
+
+	return pLayout.Get();
+}
+
+void DX11ShaderCache::Release()
+{
+	m_VertexShaders.clear();
+	m_PixelShaders.clear();
+	m_InputLayouts.clear();
+}
+
+uint32_t DX11ShaderCache::GetShaderCount() const
+{
+	return static_cast<uint32_t>(m_VertexShaders.size() + m_PixelShaders.size());
+}
+
+uint32_t DX11ShaderCache::GetInputLayoutCount() const
+{
+	return static_cast<uint32_t>(m_InputLayouts.size());
+}
+
+uint64_t DX11ShaderCache::HashInputLayout(const D3D11_INPUT_ELEMENT_DESC* pElements, UINT elementCount)
+{
+	// Semantic names are hashed by content, the pointers usually differ between materials
+	uint64_t hash{ ShaderCache::s_HashSeed };
+	for (UINT i{}; i < elementCount; ++i)
+	{
+		const D3D11_INPUT_ELEMENT_DESC& element{ pElements[i] };
+		hash = ShaderCache::Hash(element.SemanticName, strlen(element.SemanticName) + 1, hash);
+		hash = ShaderCache::Hash(&element.SemanticIndex, sizeof(element.SemanticIndex), hash);
+		hash = ShaderCache::Hash(&element.Format, sizeof(element.Format), hash);
+		hash = ShaderCache::Hash(&element.InputSlot, sizeof(element.InputSlot), hash);
+		hash = ShaderCache::Hash(&element.AlignedByteOffset, sizeof(element.AlignedByteOffset), hash);
+		hash = ShaderCache::Hash(&element.InputSlotClass, sizeof(element.InputSlotClass), hash);
+		hash = ShaderCache::Hash(&element.InstanceDataStepRate, sizeof(element.InstanceDataStepRate), hash);
+	}
+
+	return hash;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <d3d11.h>
+
+#include <filesystem>
+#include <unordered_map>
+
+#include "Singleton.h"
+
+/**
+ * \brief DirectX 11 shader objects and input layouts shared by every material.
+ * Shaders are keyed by the content hash of their bytecode, so a file is read and compiled into a shader object
+ * once however many materials use it. Input layouts are keyed by their element description only, every vertex
+ * shader using the same description must therefore declare the same input signature.
+ */
+class DX11ShaderCache final : public Singleton<DX11ShaderCache>
+{
+public:
+	~DX11ShaderCache() override = default;
+
+	DX11ShaderCache(const DX11ShaderCache& other) noexcept = delete;
+	DX11ShaderCache& operator=(const DX11ShaderCache& other) noexcept = delete;
+	DX11ShaderCache(DX11ShaderCache&& other) noexcept = delete;
+	DX11ShaderCache& operator=(DX11ShaderCache&& other) noexcept = delete;
+
+	/**
+	 * \brief Creations are counted by Renderer::GetResourceCreationCount. A file that cannot be read or a bytecode the
+	 * device rejects throws, a material never ends up with a null shader.
+	 */
+	[[nodiscard]] ID3D11VertexShader* GetVertexShader(ID3D11Device* pDevice, const std::filesystem::path& path);
+	[[nodiscard]] ID3D11PixelShader* GetPixelShader(ID3D11Device* pDevice, const std::filesystem::path& path);
+	/**
+	 * \param vertexShaderPath Validates the layout against its input signature when the layout is first created
+	 */
+	[[nodiscard]] ID3D11InputLayout* GetInputLayout(ID3D11Device* pDevice, const D3D11_INPUT_ELEMENT_DESC* pElements, UINT elementCount, const std::filesystem::path& vertexShaderPath);
+
+	/**
+	 * \brief Releases every object, call before the device is destroyed
+	 */
+	void Release();
+
+	[[nodiscard]] uint32_t GetShaderCount() const;
+	[[nodiscard]] uint32_t GetInputLayoutCount() const;
+
+private:
+	friend class Singleton<DX11ShaderCache>;
+	DX11ShaderCache() noexcept = default;
+
+	/* DATA MEMBERS */
+
+	std::unordered_map<uint64_t, Microsoft::WRL::ComPtr<ID3D11VertexShader>> m_VertexShaders{};
+	std::unordered_map<uint64_t, Microsoft::WRL::ComPtr<ID3D11PixelShader>> m_PixelShaders{};
+	std::unordered_map<uint64_t, Microsoft::WRL::ComPtr<ID3D11InputLayout>> m_InputLayouts{};
+
+	/* PRIVATE METHODS */
+
+	[[nodiscard]] static uint64_t HashInputLayout(const D3D11_INPUT_ELEMENT_DESC* pElements, UINT elementCount);
+
+};
@@ -0,0 +1,86 @@
+#include "DX12Context.h"
+
+#include <cassert>
+
+#include "ShaderCache.h"
+#include "WindowsException.h"
+
+using Microsoft::WRL::ComPtr;
+
+DX12Context::DX12Context(ID3D12Device* pDevice, ID3D12RootSignature* pRootSignature, DXGI_FORMAT renderTargetFormat) noexcept
+	: m_pDevice{ pDevice }
+	, m_pRootSignature{ pRootSignature }
+	, m_RenderTargetFormat{ renderTargetFormat }
+{
+}
+
+ComPtr<ID3D12PipelineState> DX12Context::CreateGraphicsPipeline(const std::filesystem::path& vertexShaderPath, const std::filesystem::path& pixelShaderPath) const
+{
+	const D3D12_INPUT_ELEMENT_DESC inputElements[]
+	{
+		{ "POSITION", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+	};
+
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC desc{};
+	desc.pRootSignature = m_pRootSignature;
+	desc.VS = LoadShader(vertexShaderPath);
+	desc.PS = LoadShader(pixelShaderPath);
+	desc.InputLayout = { inputElements, UINT(std::size(inputElements)) };
+	desc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+
+	// Same fixed function state as the DX11 defaults: solid, back face culled, clockwise front faces, no blending nor depth.
+	// Enums are validated even when their state is disabled, zero is not a valid value for them.
+	desc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+	desc.RasterizerState.CullMode = D3D12_CULL_MODE_BACK;
+	desc.RasterizerState.FrontCounterClockwise = FALSE;
+	desc.RasterizerState.DepthClipEnable = TRUE;
+
+	D3D12_RENDER_TARGET_BLEND_DESC& blend{ desc.BlendState.RenderTarget[0] };
+	blend.SrcBlend = blend.SrcBlendAlpha = D3D12_BLEND_ONE;
+	blend.DestBlend = blend.DestBlendAlpha = D3D12_BLEND_ZERO;
+	blend.BlendOp = blend.BlendOpAlpha = D3D12_BLEND_OP_ADD;
+	blend.LogicOp = D3D12_LOGIC_OP_NOOP;
+	blend.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+	desc.SampleMask = UINT_MAX;
+
+	constexpr D3D12_DEPTH_STENCILOP_DESC stencilOp{ D3D12_STENCIL_OP_KEEP, D3D12_STENCIL_OP_KEEP, D3D12_STENCIL_OP_KEEP, D3D12_COMPARISON_FUNC_ALWAYS };
+	desc.DepthStencilState.DepthEnable = FALSE;
+	desc.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
+	desc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_ALWAYS;
+	desc.DepthStencilState.FrontFace = stencilOp;
+	desc.DepthStencilState.BackFace = stencilOp;
+
+	desc.NumRenderTargets = 1;
+	desc.RTVFormats[0] = m_RenderTargetFormat;
+	desc.SampleDesc.Count = 1;
+
+	ComPtr<ID3D12PipelineState> pPipeline;
+	PGWND_THROW_IF_FAILED(m_pDevice->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&pPipeline)));
+	Renderer::Get().CountResourceCreation();
+
+	return pPipeline;
+}
+
+void DX12Context::DestroyPipeline(ComPtr<ID3D12PipelineState>& pPipeline)
+{
+	if (pPipeline)
+		m_DeferredPipelines[m_FrameIndex].emplace_back(std::move(pPipeline));
+}
+
+void DX12Context::BeginFrame(uint32_t frameIndex)
+{
+	assert(frameIndex < Renderer::s_FrameCount);
+	m_FrameIndex = frameIndex;
+
+	m_DeferredPipelines[frameIndex].clear();
+}
+
+D3D12_SHADER_BYTECODE DX12Context::LoadShader(const std::filesystem::path& path)
+{
+	// The bytecode stays alive in the ShaderCache, the device copies it when creating the pipeline
+	const ShaderBytecode* pBytecode{ ShaderCache::Get().Load(path) };
+	if (!pBytecode)
+		throw PGWND_EXCEPTION(HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND));
+
+	return { pBytecode->GetData(), pBytecode->GetSize() };
+}
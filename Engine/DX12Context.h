@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <filesystem>
+#include <vector>
+
+#include <d3d12.h>
+
+#include "Renderer.h"
+
+/**
+ * \brief DirectX 12 objects the materials build and bind their pipelines with.
+ * Returned by Renderer::GetDevice when the DirectX 12 backend is active, Renderer::GetDeviceContext then returns the
+ * ID3D12GraphicsCommandList of the frame being recorded, with the shared root signature already bound.
+ */
+class DX12Context final
+{
+public:
+	DX12Context(ID3D12Device* pDevice, ID3D12RootSignature* pRootSignature, DXGI_FORMAT renderTargetFormat) noexcept;
+	~DX12Context() = default;
+
+	DX12Context(const DX12Context& other) noexcept = delete;
+	DX12Context& operator=(const DX12Context& other) noexcept = delete;
+	DX12Context(DX12Context&& other) noexcept = delete;
+	DX12Context& operator=(DX12Context&& other) noexcept = delete;
+
+	/**
+	 * \brief Builds a triangle list pipeline reading a float2 POSITION at offset 0 of each vertex, the stride comes from
+	 * the vertex buffer view of the bound mesh
+	 * \param vertexShaderPath Compiled HLSL vertex shader, the same .cso as the DX11 path
+	 * \param pixelShaderPath Compiled HLSL pixel shader
+	 */
+	[[nodiscard]] Microsoft::WRL::ComPtr<ID3D12PipelineState> CreateGraphicsPipeline(const std::filesystem::path& vertexShaderPath, const std::filesystem::path& pixelShaderPath) const;
+	/**
+	 * \brief Releases the pipeline once the frames in flight are done with it
+	 */
+	void DestroyPipeline(Microsoft::WRL::ComPtr<ID3D12PipelineState>& pPipeline);
+
+	/**
+	 * \brief Must be called once the GPU finished the frame that previously used frameIndex
+	 */
+	void BeginFrame(uint32_t frameIndex);
+
+	[[nodiscard]] ID3D12Device* GetDevice() const { return m_pDevice; }
+	[[nodiscard]] ID3D12RootSignature* GetRootSignature() const { return m_pRootSignature; }
+
+private:
+	/* DATA MEMBERS */
+
+	ID3D12Device* m_pDevice{};
+	ID3D12RootSignature* m_pRootSignature{};
+	DXGI_FORMAT m_RenderTargetFormat{};
+
+	std::array<std::vector<Microsoft::WRL::ComPtr<ID3D12PipelineState>>, Renderer::s_FrameCount> m_DeferredPipelines{};
+	uint32_t m_FrameIndex{};
+
+	/* PRIVATE METHODS */
+
+	[[nodiscard]] static D3D12_SHADER_BYTECODE LoadShader(const std::filesystem::path& path);
+
+};
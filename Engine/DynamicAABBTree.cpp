@@ -0,0 +1,419 @@
+#include "DynamicAABBTree.h"
+
+#include <cassert>
+#include <limits>
+
+namespace
+{
+	float GetAxis(const XMFLOAT3& vector, int axis)
+	{
+		return axis == 0 ? vector.x : (axis == 1 ? vector.y : vector.z);
+	}
+}
+
+DynamicAABBTree::DynamicAABBTree(float margin) noexcept
+	: m_Margin{ margin }
+{
+}
+
+int32_t DynamicAABBTree::CreateProxy(const AABB& box, void* pUserData)
+{
+	const int32_t proxy{ AllocateNode() };
+
+	Node& node{ m_Nodes[proxy] };
+	node.m_Box = { { box.m_Min.x - m_Margin, box.m_Min.y - m_Margin, box.m_Min.z - m_Margin }, { box.m_Max.x + m_Margin, box.m_Max.y + m_Margin, box.m_Max.z + m_Margin } };
+	node.m_pUserData = pUserData;
+	node.m_Height = 0;
+
+	InsertLeaf(proxy);
+	++m_ProxyCount;
+
+	return proxy;
+}
+
+void DynamicAABBTree::DestroyProxy(int32_t proxy)
+{
+	assert(proxy >= 0 && proxy < static_cast<int32_t>(m_Nodes.size()) && m_Nodes[proxy].IsLeaf());
+
+	RemoveLeaf(proxy);
+	FreeNode(proxy);
+	--m_ProxyCount;
+}
+
+bool DynamicAABBTree::MoveProxy(int32_t proxy, const AABB& box)
+{
+	assert(proxy >= 0 && proxy < static_cast<int32_t>(m_Nodes.size()) && m_Nodes[proxy].IsLeaf());
+
+	const AABB fatBox{ { box.m_Min.x - m_Margin, box.m_Min.y - m_Margin, box.m_Min.z - m_Margin }, { box.m_Max.x + m_Margin, box.m_Max.y + m_Margin, box.m_Max.z + m_Margin } };
+	const AABB& treeBox{ m_Nodes[proxy].m_Box };
+	if (Contains(treeBox, box))
+	{
+		// Still enclosed, but an object that shrank a lot would keep a needlessly large leaf
+		const float hugeMargin{ 4.f * m_Margin };
+		const AABB hugeBox{ { fatBox.m_Min.x - hugeMargin, fatBox.m_Min.y - hugeMargin, fatBox.m_Min.z - hugeMargin }, { fatBox.m_Max.x + hugeMargin, fatBox.m_Max.y + hugeMargin, fatBox.m_Max.z + hugeMargin } };
+		if (Contains(hugeBox, treeBox))
+			return false;
+	}
+
+	RemoveLeaf(proxy);
+	m_Nodes[proxy].m_Box = fatBox;
+	InsertLeaf(proxy);
+
+	return true;
+}
+
+void* DynamicAABBTree::GetUserData(int32_t proxy) const
+{
+	return m_Nodes[proxy].m_pUserData;
+}
+
+const AABB& DynamicAABBTree::GetFatBox(int32_t proxy) const
+{
+	return m_Nodes[proxy].m_Box;
+}
+
+uint32_t DynamicAABBTree::GetProxyCount() const
+{
+	return m_ProxyCount;
+}
+
+int32_t DynamicAABBTree::GetHeight() const
+{
+	return m_Root == s_NullNode ? 0 : m_Nodes[m_Root].m_Height;
+}
+
+void DynamicAABBTree::Rebuild()
+{
+	if (m_ProxyCount == 0)
+		return;
+
+	// Keep the leaves so proxies stay valid, only the internal nodes are recreated
+	std::vector<int32_t> leaves{};
+	leaves.reserve(m_ProxyCount);
+
+	for (int32_t index{}; index < static_cast<int32_t>(m_Nodes.size()); ++index)
+	{
+		Node& node{ m_Nodes[index] };
+		if (node.m_Height < 0)
+			continue;
+
+		if (node.IsLeaf())
+		{
+			node.m_Parent = s_NullNode;
+			leaves.emplace_back(index);
+		}
+		else
+			FreeNode(index);
+	}
+
+	m_Root = BuildSubtree(leaves.data(), static_cast<uint32_t>(leaves.size()));
+}
+
+int32_t DynamicAABBTree::AllocateNode()
+{
+	if (m_FreeList == s_NullNode)
+	{
+		m_Nodes.emplace_back();
+		return static_cast<int32_t>(m_Nodes.size() - 1);
+	}
+
+	const int32_t node{ m_FreeList };
+	m_FreeList = m_Nodes[node].m_Parent;
+	m_Nodes[node] = Node{};
+
+	return node;
+}
+
+void DynamicAABBTree::FreeNode(int32_t node)
+{
+	m_Nodes[node] = Node{};
+	m_Nodes[node].m_Parent = m_FreeList;
+	m_FreeList = node;
+}
+
+void DynamicAABBTree::InsertLeaf(int32_t leaf)
+{
+	if (m_Root == s_NullNode)
+	{
+		m_Root = leaf;
+		m_Nodes[leaf].m_Parent = s_NullNode;
+		return;
+	}
+
+	// Descend towards the sibling that increases the total surface area the least
+	const AABB leafBox{ m_Nodes[leaf].m_Box };
+	int32_t index{ m_Root };
+	while (!m_Nodes[index].IsLeaf())
+	{
+		const Node& node{ m_Nodes[index] };
+
+		const float combinedArea{ SurfaceArea(Union(node.m_Box, leafBox)) };
+		const float cost{ 2.f * combinedArea }; // New parent of this node and the leaf
+		const float inheritanceCost{ 2.f * (combinedArea - SurfaceArea(node.m_Box)) }; // Growth pushed to the ancestors
+
+		auto childCost = [&](int32_t child)
+		{
+			const Node& childNode{ m_Nodes[child] };
+			const float area{ SurfaceArea(Union(childNode.m_Box, leafBox)) };
+			return (childNode.IsLeaf() ? area : area - SurfaceArea(childNode.m_Box)) + inheritanceCost;
+		};
+
+		const float cost1{ childCost(node.m_Child1) };
+		const float cost2{ childCost(node.m_Child2) };
+		if (cost < cost1 && cost < cost2)
+			break;
+
+		index = cost1 < cost2 ? node.m_Child1 : node.m_Child2;
+	}
+
+	const int32_t sibling{ index };
+	const int32_t oldParent{ m_Nodes[sibling].m_Parent };
+	const int32_t newParent{ AllocateNode() };
+
+	Node& parentNode{ m_Nodes[newParent] };
+	parentNode.m_Parent = oldParent;
+	parentNode.m_Box = Union(leafBox, m_Nodes[sibling].m_Box);
+	parentNode.m_Height = m_Nodes[sibling].m_Height + 1;
+	parentNode.m_Child1 = sibling;
+	parentNode.m_Child2 = leaf;
+
+	if (oldParent != s_NullNode)
+	{
+		if (m_Nodes[oldParent].m_Child1 == sibling)
+			m_Nodes[oldParent].m_Child1 = newParent;
+		else
+			m_Nodes[oldParent].m_Child2 = newParent;
+	}
+	else
+		m_Root = newParent;
+
+	m_Nodes[sibling].m_Parent = newParent;
+	m_Nodes[leaf].m_Parent = newParent;
+
+	RefitAncestors(newParent);
+}
+
+void DynamicAABBTree::RemoveLeaf(int32_t leaf)
+{
+	if (leaf == m_Root)
+	{
+		m_Root = s_NullNode;
+		return;
+	}
+
+	const int32_t parent{ m_Nodes[leaf].m_Parent };
+	const int32_t grandParent{ m_Nodes[parent].m_Parent };
+	const int32_t sibling{ m_Nodes[parent].m_Child1 == leaf ? m_Nodes[parent].m_Child2 : m_Nodes[parent].m_Child1 };
+
+	// The sibling takes the place of the parent
+	if (grandParent != s_NullNode)
+	{
+		if (m_Nodes[grandParent].m_Child1 == parent)
+			m_Nodes[grandParent].m_Child1 = sibling;
+		else
+			m_Nodes[grandParent].m_Child2 = sibling;
+	}
+	else
+		m_Root = sibling;
+
+	m_Nodes[sibling].m_Parent = grandParent;
+	m_Nodes[leaf].m_Parent = s_NullNode;
+	FreeNode(parent);
+
+	if (grandParent != s_NullNode)
+		RefitAncestors(grandParent);
+}
+
+void DynamicAABBTree::RefitAncestors(int32_t node)
+{
+	for (int32_t index{ node }; index != s_NullNode; index = m_Nodes[index].m_Parent)
+	{
+		index = Balance(index);
+
+		Node& current{ m_Nodes[index] };
+		const Node& child1{ m_Nodes[current.m_Child1] };
+		const Node& child2{ m_Nodes[current.m_Child2] };
+		current.m_Height = 1 + (std::max)(child1.m_Height, child2.m_Height);
+		current.m_Box = Union(child1.m_Box, child2.m_Box);
+	}
+}
+
+int32_t DynamicAABBTree::Balance(int32_t node)
+{
+	Node& a{ m_Nodes[node] };
+	if (a.IsLeaf() || a.m_Height < 2)
+		return node;
+
+	const int32_t balance{ m_Nodes[a.m_Child2].m_Height - m_Nodes[a.m_Child1].m_Height };
+	if (balance >= -1 && balance <= 1)
+		return node;
+
+	// Rotate the taller child up, it adopts this node and its own taller child while this node keeps the shorter one
+	const int32_t up{ balance > 0 ? a.m_Child2 : a.m_Child1 };
+	const int32_t other{ balance > 0 ? a.m_Child1 : a.m_Child2 };
+
+	Node& b{ m_Nodes[up] };
+	const bool isFirstTaller{ m_Nodes[b.m_Child1].m_Height > m_Nodes[b.m_Child2].m_Height };
+	const int32_t tallGrandChild{ isFirstTaller ? b.m_Child1 : b.m_Child2 };
+	const int32_t shortGrandChild{ isFirstTaller ? b.m_Child2 : b.m_Child1 };
+
+	b.m_Parent = a.m_Parent;
+	if (b.m_Parent != s_NullNode)
+	{
+		if (m_Nodes[b.m_Parent].m_Child1 == node)
+			m_Nodes[b.m_Parent].m_Child1 = up;
+		else
+			m_Nodes[b.m_Parent].m_Child2 = up;
+	}
+	else
+		m_Root = up;
+
+	b.m_Child1 = node;
+	b.m_Child2 = tallGrandChild;
+	a.m_Parent = up;
+
+	if (balance > 0)
+		a.m_Child2 = shortGrandChild;
+	else
+		a.m_Child1 = shortGrandChild;
+	m_Nodes[shortGrandChild].m_Parent = node;
+
+	const Node& otherNode{ m_Nodes[other] };
+	const Node& shortNode{ m_Nodes[shortGrandChild] };
+	const Node& tallNode{ m_Nodes[tallGrandChild] };
+	a.m_Box = Union(otherNode.m_Box, shortNode.m_Box);
+	a.m_Height = 1 + (std::max)(otherNode.m_Height, shortNode.m_Height);
+	b.m_Box = Union(a.m_Box, tallNode.m_Box);
+	b.m_Height = 1 + (std::max)(a.m_Height, tallNode.m_Height);
+
+	return up;
+}
+
+int32_t DynamicAABBTree::BuildSubtree(int32_t* pLeaves, uint32_t count)
+{
+	if (count == 1)
+		return pLeaves[0];
+
+	auto centroid = [this](int32_t leaf, int axis)
+	{
+		const AABB& box{ m_Nodes[leaf].m_Box };
+		return GetAxis(box.m_Min, axis) + GetAxis(box.m_Max, axis); // Scaled by 2, only compared
+	};
+
+	// Split along the axis where the centroids are the most spread out
+	XMFLOAT3 centroidMin{ std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+	XMFLOAT3 centroidMax{ std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+	for (uint32_t i{}; i < count; ++i)
+	{
+		const XMFLOAT3 c{ centroid(pLeaves[i], 0), centroid(pLeaves[i], 1), centroid(pLeaves[i], 2) };
+		centroidMin = { (std::min)(centroidMin.x, c.x), (std::min)(centroidMin.y, c.y), (std::min)(centroidMin.z, c.z) };
+		centroidMax = { (std::max)(centroidMax.x, c.x), (std::max)(centroidMax.y, c.y), (std::max)(centroidMax.z, c.z) };
+	}
+
+	const XMFLOAT3 spread{ centroidMax.x - centroidMin.x, centroidMax.y - centroidMin.y, centroidMax.z - centroidMin.z };
+	const int axis{ spread.x > spread.y ? (spread.x > spread.z ? 0 : 2) : (spread.y > spread.z ? 1 : 2) };
+	const float axisMin{ GetAxis(centroidMin, axis) };
+	const float axisSpread{ GetAxis(spread, axis) };
+
+	uint32_t splitCount{ count / 2 };
+	if (axisSpread > 0.f)
+	{
+		struct Bin
+		{
+			AABB m_Box{};
+			uint32_t m_Count{};
+		};
+
+		const float binScale{ s_BinCount / axisSpread };
+		auto binIndex = [&](int32_t leaf)
+		{
+			return (std::min)(static_cast<uint32_t>((centroid(leaf, axis) - axisMin) * binScale), s_BinCount - 1);
+		};
+
+		Bin bins[s_BinCount]{};
+		for (uint32_t i{}; i < count; ++i)
+		{
+			Bin& bin{ bins[binIndex(pLeaves[i])] };
+			bin.m_Box = bin.m_Count == 0 ? m_Nodes[pLeaves[i]].m_Box : Union(bin.m_Box, m_Nodes[pLeaves[i]].m_Box);
+			++bin.m_Count;
+		}
+
+		// Sweep from the right to get the cost of everything after each split plane, then from the left to pick the best
+		float rightCost[s_BinCount]{};
+		AABB sweepBox{};
+		uint32_t sweepCount{};
+		for (uint32_t b{ s_BinCount - 1 }; b > 0; --b)
+		{
+			if (bins[b].m_Count)
+			{
+				sweepBox = sweepCount == 0 ? bins[b].m_Box : Union(sweepBox, bins[b].m_Box);
+				sweepCount += bins[b].m_Count;
+			}
+			rightCost[b] = sweepCount ? SurfaceArea(sweepBox) * static_cast<float>(sweepCount) : 0.f;
+		}
+
+		float bestCost{ std::numeric_limits<float>::max() };
+		uint32_t bestSplit{};
+		sweepCount = 0;
+		for (uint32_t b{}; b < s_BinCount - 1; ++b)
+		{
+			if (bins[b].m_Count)
+			{
+				sweepBox = sweepCount == 0 ? bins[b].m_Box : Union(sweepBox, bins[b].m_Box);
+				sweepCount += bins[b].m_Count;
+			}
+
+			if (sweepCount == 0 || sweepCount == count)
+				continue;
+
+			const float cost{ SurfaceArea(sweepBox) * static_cast<float>(sweepCount) + rightCost[b + 1] };
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestSplit = b;
+			}
+		}
+
+		if (bestCost < std::numeric_limits<float>::max())
+			splitCount = static_cast<uint32_t>(std::partition(pLeaves, pLeaves + count, [&](int32_t leaf) { return binIndex(leaf) <= bestSplit; }) - pLeaves);
+	}
+	else
+		// All centroids coincide, any balanced split is as good
+		std::nth_element(pLeaves, pLeaves + splitCount, pLeaves + count);
+
+	const int32_t node{ AllocateNode() };
+	const int32_t child1{ BuildSubtree(pLeaves, splitCount) };
+	const int32_t child2{ BuildSubtree(pLeaves + splitCount, count - splitCount) };
+
+	Node& parent{ m_Nodes[node] };
+	parent.m_Child1 = child1;
+	parent.m_Child2 = child2;
+	parent.m_Box = Union(m_Nodes[child1].m_Box, m_Nodes[child2].m_Box);
+	parent.m_Height = 1 + (std::max)(m_Nodes[child1].m_Height, m_Nodes[child2].m_Height);
+	m_Nodes[child1].m_Parent = node;
+	m_Nodes[child2].m_Parent = node;
+
+	return node;
+}
+
+AABB DynamicAABBTree::Union(const AABB& a, const AABB& b)
+{
+	return {
+		{ (std::min)(a.m_Min.x, b.m_Min.x), (std::min)(a.m_Min.y, b.m_Min.y), (std::min)(a.m_Min.z, b.m_Min.z) },
+		{ (std::max)(a.m_Max.x, b.m_Max.x), (std::max)(a.m_Max.y, b.m_Max.y), (std::max)(a.m_Max.z, b.m_Max.z) }
+	};
+}
+
+float DynamicAABBTree::SurfaceArea(const AABB& box)
+{
+	const float dx{ box.m_Max.x - box.m_Min.x };
+	const float dy{ box.m_Max.y - box.m_Min.y };
+	const float dz{ box.m_Max.z - box.m_Min.z };
+	return 2.f * (dx * dy + dy * dz + dz * dx);
+}
+
+bool DynamicAABBTree::Contains(const AABB& outer, const AABB& inner)
+{
+	return outer.m_Min.x <= inner.m_Min.x && outer.m_Min.y <= inner.m_Min.y && outer.m_Min.z <= inner.m_Min.z
+		&& outer.m_Max.x >= inner.m_Max.x && outer.m_Max.y >= inner.m_Max.y && outer.m_Max.z >= inner.m_Max.z;
+}
@@ -0,0 +1,319 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "FrustumCuller.h"
+#include "AABB.h"
+
+/**
+ * \brief Incrementally maintained bounding volume hierarchy of proxies (one leaf per proxy).
+ * Leaves store fat boxes so small movements don't touch the tree, inserts pick the sibling with the lowest surface
+ * area cost and every modified ancestor is rebalanced with tree rotations. Rebuild() runs a binned SAH construction
+ * over all leaves, which gives a better tree for content that stopped moving.
+ * Queries invoke a callback with the proxy of every overlapping leaf.
+ */
+class DynamicAABBTree final
+{
+public:
+	/**
+	 * \param margin Distance the fat boxes are grown by on every side
+	 */
+	explicit DynamicAABBTree(float margin = .1f) noexcept;
+	~DynamicAABBTree() = default;
+
+	DynamicAABBTree(const DynamicAABBTree& other) noexcept = delete;
+	DynamicAABBTree& operator=(const DynamicAABBTree& other) noexcept = delete;
+	DynamicAABBTree(DynamicAABBTree&& other) noexcept = delete;
+	DynamicAABBTree& operator=(DynamicAABBTree&& other) noexcept = delete;
+
+	/**
+	 * \brief
+	 * \return Proxy identifying the leaf, stays valid until destroyed
+	 */
+	int32_t CreateProxy(const AABB& box, void* pUserData);
+	void DestroyProxy(int32_t proxy);
+	/**
+	 * \brief Update the bounds of a proxy, the leaf is only reinserted when the box left its fat box
+	 * \return True if the tree changed
+	 */
+	bool MoveProxy(int32_t proxy, const AABB& box);
+
+	[[nodiscard]] void* GetUserData(int32_t proxy) const;
+	[[nodiscard]] const AABB& GetFatBox(int32_t proxy) const;
+	[[nodiscard]] uint32_t GetProxyCount() const;
+	[[nodiscard]] int32_t GetHeight() const;
+
+	/**
+	 * \brief Rebuild the whole tree top down with a binned surface area heuristic, proxies stay valid
+	 */
+	void Rebuild();
+
+	// Queries, callbacks return false to stop early
+
+	template <typename Callback> void QueryBox(const AABB& box, Callback&& callback) const;
+	template <typename Callback> void QuerySphere(const XMFLOAT3& center, float radius, Callback&& callback) const;
+	template <typename Callback> void QueryFrustum(const FrustumCuller::Frustum& frustum, Callback&& callback) const;
+	/**
+	 * \brief Walk the leaves whose fat box is hit by the ray
+	 * \param direction Normalized ray direction
+	 * \param callback Called with (proxy, maxDistance), returns the new max distance: the exact hit distance to only
+	 * look for closer hits, maxDistance to keep going unchanged or 0 to stop
+	 */
+	template <typename Callback> void RayCast(const XMFLOAT3& origin, const XMFLOAT3& direction, float maxDistance, Callback&& callback) const;
+
+	inline static constexpr int32_t s_NullNode{ -1 };
+	inline static constexpr uint32_t s_BinCount{ 16 };
+
+private:
+	/* NESTED CLASSES */
+
+	struct Node
+	{
+		AABB m_Box{};
+		void* m_pUserData{};
+		int32_t m_Parent{ s_NullNode }; // Next free node while in the free list
+		int32_t m_Child1{ s_NullNode };
+		int32_t m_Child2{ s_NullNode };
+		int32_t m_Height{ -1 }; // 0 for leaves, -1 for free nodes
+
+		[[nodiscard]] bool IsLeaf() const { return m_Child1 == s_NullNode; }
+	};
+
+	/**
+	 * \brief Traversal stack, only allocates for trees deeper than the inline storage
+	 */
+	template <typename ElementType>
+	class Stack final
+	{
+	public:
+		void Push(const ElementType& element)
+		{
+			if (m_Size < s_InlineSize)
+				m_Inline[m_Size] = element;
+			else
+				m_Overflow.emplace_back(element);
+			++m_Size;
+		}
+
+		ElementType Pop()
+		{
+			--m_Size;
+			if (m_Size < s_InlineSize)
+				return m_Inline[m_Size];
+
+			const ElementType element{ m_Overflow.back() };
+			m_Overflow.pop_back();
+			return element;
+		}
+
+		[[nodiscard]] bool IsEmpty() const { return m_Size == 0; }
+
+	private:
+		inline static constexpr uint32_t s_InlineSize{ 64 };
+
+		ElementType m_Inline[s_InlineSize];
+		std::vector<ElementType> m_Overflow{};
+		uint32_t m_Size{};
+	};
+
+	/* DATA MEMBERS */
+
+	std::vector<Node> m_Nodes{};
+	int32_t m_Root{ s_NullNode };
+	int32_t m_FreeList{ s_NullNode };
+	uint32_t m_ProxyCount{};
+	float m_Margin;
+
+	/* PRIVATE METHODS */
+
+	int32_t AllocateNode();
+	void FreeNode(int32_t node);
+
+	void InsertLeaf(int32_t leaf);
+	void RemoveLeaf(int32_t leaf);
+	void RefitAncestors(int32_t node);
+	int32_t Balance(int32_t node);
+
+	int32_t BuildSubtree(int32_t* pLeaves, uint32_t count);
+
+	[[nodiscard]] static AABB Union(const AABB& a, const AABB& b);
+	[[nodiscard]] static float SurfaceArea(const AABB& box);
+	[[nodiscard]] static bool Contains(const AABB& outer, const AABB& inner);
+	[[nodiscard]] static bool Overlaps(const AABB& a, const AABB& b)
+	{
+		return a.m_Min.x <= b.m_Max.x && a.m_Max.x >= b.m_Min.x
+			&& a.m_Min.y <= b.m_Max.y && a.m_Max.y >= b.m_Min.y
+			&& a.m_Min.z <= b.m_Max.z && a.m_Max.z >= b.m_Min.z;
+	}
+};
+
+template <typename Callback>
+void DynamicAABBTree::QueryBox(const AABB& box, Callback&& callback) const
+{
+	Stack<int32_t> stack{};
+	stack.Push(m_Root);
+
+	while (!stack.IsEmpty())
+	{
+		const int32_t index{ stack.Pop() };
+		if (index == s_NullNode)
+			continue;
+
+		const Node& node{ m_Nodes[index] };
+		if (!Overlaps(node.m_Box, box))
+			continue;
+
+		if (node.IsLeaf())
+		{
+			if (!callback(index))
+				return;
+		}
+		else
+		{
+			stack.Push(node.m_Child1);
+			stack.Push(node.m_Child2);
+		}
+	}
+}
+
+template <typename Callback>
+void DynamicAABBTree::QuerySphere(const XMFLOAT3& center, float radius, Callback&& callback) const
+{
+	const AABB sphereBox{ { center.x - radius, center.y - radius, center.z - radius }, { center.x + radius, center.y + radius, center.z + radius } };
+	const float radiusSq{ radius * radius };
+
+	Stack<int32_t> stack{};
+	stack.Push(m_Root);
+
+	while (!stack.IsEmpty())
+	{
+		const int32_t index{ stack.Pop() };
+		if (index == s_NullNode)
+			continue;
+
+		const Node& node{ m_Nodes[index] };
+		if (!Overlaps(node.m_Box, sphereBox))
+			continue;
+
+		// Distance from the center to the closest point of the box
+		const float dx{ center.x - std::clamp(center.x, node.m_Box.m_Min.x, node.m_Box.m_Max.x) };
+		const float dy{ center.y - std::clamp(center.y, node.m_Box.m_Min.y, node.m_Box.m_Max.y) };
+		const float dz{ center.z - std::clamp(center.z, node.m_Box.m_Min.z, node.m_Box.m_Max.z) };
+		if (dx * dx + dy * dy + dz * dz > radiusSq)
+			continue;
+
+		if (node.IsLeaf())
+		{
+			if (!callback(index))
+				return;
+		}
+		else
+		{
+			stack.Push(node.m_Child1);
+			stack.Push(node.m_Child2);
+		}
+	}
+}
+
+template <typename Callback>
+void DynamicAABBTree::QueryFrustum(const FrustumCuller::Frustum& frustum, Callback&& callback) const
+{
+	struct Entry
+	{
+		int32_t m_Node;
+		bool m_IsInside; // Fully inside, children don't need testing
+	};
+
+	Stack<Entry> stack{};
+	stack.Push({ m_Root, false });
+
+	while (!stack.IsEmpty())
+	{
+		const Entry entry{ stack.Pop() };
+		if (entry.m_Node == s_NullNode)
+			continue;
+
+		const Node& node{ m_Nodes[entry.m_Node] };
+		bool isInside{ entry.m_IsInside };
+		if (!isInside)
+		{
+			const XMFLOAT3 center{ (node.m_Box.m_Min.x + node.m_Box.m_Max.x) * .5f, (node.m_Box.m_Min.y + node.m_Box.m_Max.y) * .5f, (node.m_Box.m_Min.z + node.m_Box.m_Max.z) * .5f };
+			const XMFLOAT3 extents{ node.m_Box.m_Max.x - center.x, node.m_Box.m_Max.y - center.y, node.m_Box.m_Max.z - center.z };
+
+			bool isOutside{};
+			isInside = true;
+			for (const FrustumCuller::Plane& plane : frustum)
+			{
+				const float distance{ plane.m_A * center.x + plane.m_B * center.y + plane.m_C * center.z + plane.m_D };
+				const float boxRadius{ std::abs(plane.m_A) * extents.x + std::abs(plane.m_B) * extents.y + std::abs(plane.m_C) * extents.z };
+				if (distance + boxRadius < 0.f)
+				{
+					isOutside = true;
+					break;
+				}
+
+				if (distance - boxRadius < 0.f)
+					isInside = false;
+			}
+
+			if (isOutside)
+				continue;
+		}
+
+		if (node.IsLeaf())
+		{
+			if (!callback(entry.m_Node))
+				return;
+		}
+		else
+		{
+			stack.Push({ node.m_Child1, isInside });
+			stack.Push({ node.m_Child2, isInside });
+		}
+	}
+}
+
+template <typename Callback>
+void DynamicAABBTree::RayCast(const XMFLOAT3& origin, const XMFLOAT3& direction, float maxDistance, Callback&& callback) const
+{
+	const XMFLOAT3 invDirection{ 1.f / direction.x, 1.f / direction.y, 1.f / direction.z };
+
+	Stack<int32_t> stack{};
+	stack.Push(m_Root);
+
+	while (!stack.IsEmpty())
+	{
+		const int32_t index{ stack.Pop() };
+		if (index == s_NullNode)
+			continue;
+
+		// Slab test, a zero direction component gives infinite slab distances
+		const Node& node{ m_Nodes[index] };
+		const float tx1{ (node.m_Box.m_Min.x - origin.x) * invDirection.x };
+		const float tx2{ (node.m_Box.m_Max.x - origin.x) * invDirection.x };
+		const float ty1{ (node.m_Box.m_Min.y - origin.y) * invDirection.y };
+		const float ty2{ (node.m_Box.m_Max.y - origin.y) * invDirection.y };
+		const float tz1{ (node.m_Box.m_Min.z - origin.z) * invDirection.z };
+		const float tz2{ (node.m_Box.m_Max.z - origin.z) * invDirection.z };
+
+		const float tEnter{ (std::max)({ (std::min)(tx1, tx2), (std::min)(ty1, ty2), (std::min)(tz1, tz2), 0.f }) };
+		const float tExit{ (std::min)({ (std::max)(tx1, tx2), (std::max)(ty1, ty2), (std::max)(tz1, tz2), maxDistance }) };
+		if (tEnter > tExit)
+			continue;
+
+		if (node.IsLeaf())
+		{
+			maxDistance = callback(index, maxDistance);
+			if (maxDistance <= 0.f)
+				return;
+		}
+		else
+		{
+			stack.Push(node.m_Child1);
+			stack.Push(node.m_Child2);
+		}
+	}
+}
@@ -2,8 +2,11 @@
 
 //#include <thread>
 
+#include "AssetStreamer.h"
+#include "GameSettings.h"
 #include "Renderer.h"
 #include "SceneManager.h"
+#include "ShaderCache.h"
 #include "TimeManager.h"
 #include "WindowHandler.h"
 
@@ -15,19 +18,22 @@ void Engine::Run()
 	cout << "Creating window" << endl;
 
 	/* --- REFERENCES --- */
+	auto& assetStreamer = AssetStreamer::Get();
 	auto& renderer = Renderer::Get();
 	auto& sceneManager = SceneManager::Get();
 	auto& time = TimeManager::Get();
 
 	/* --- INITIALIZATION --- */
+	// Mounted first, the renderer loads its shaders during Init
+	if (GameSettings::assetPackPath && !ShaderCache::Get().MountPack(GameSettings::assetPackPath))
+		cout << "Could not open the asset pack " << GameSettings::assetPackPath << endl;
+
 	renderer.Init();
 	sceneManager.Init();
 	time.Init();
 
 	/* --- GAME LOOP --- */
 	bool running{ true };
-	float lag{};
-	const float fixedTimeStep{ time.GetFixedTimeStep() };
 	while (running)
 	{
 		/* --- TIME --- */
@@ -42,13 +48,14 @@ void Engine::Run()
 			running = false;
 		}
 
+		/* --- STREAMING --- */
+		// Loads finished on the IO threads become visible here, before any gameplay code reads them
+		assetStreamer.Update();
+
 		/* --- FIXED UPDATE --- */
-		lag += time.GetElapsedTime();
-		while (lag >= fixedTimeStep)
-		{
+		// Accumulated in integer ticks by the TimeManager, so the fixed step cadence never drifts
+		while (time.ConsumeFixedStep())
 			sceneManager.FixedUpdate();
-			lag -= fixedTimeStep;
-		}
 
 		/* --- UPDATE --- */
 		sceneManager.Update();
@@ -60,6 +67,7 @@ void Engine::Run()
 		renderer.BeginFrame();
 		sceneManager.Render();
 		renderer.RenderTestTriangle();
+		renderer.Submit();
 		renderer.EndFrame();
 
 		//std::this_thread::sleep_for(duration_cast<milliseconds>(time.GetTimeToNextFrame()));
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+#include "Structs.h"
+
+/**
+ * \brief Linear allocator over one persistently mapped buffer split into one region per frame in flight.
+ * Allocating only bumps an offset, no graphics API call is involved. A region is tagged with the fence value
+ * signaled at the end of its frame and can only be reused once the GPU has completed that fence.
+ * Backend agnostic, the backend provides the mapped memory and the fence values.
+ * \tparam FrameCount Number of frames in flight
+ */
+template <int FrameCount>
+class FrameRingAllocator final
+{
+public:
+	using Allocation = TransientAllocation;
+
+	FrameRingAllocator() noexcept = default;
+	~FrameRingAllocator() = default;
+
+	FrameRingAllocator(const FrameRingAllocator& other) noexcept = delete;
+	FrameRingAllocator& operator=(const FrameRingAllocator& other) noexcept = delete;
+	FrameRingAllocator(FrameRingAllocator&& other) noexcept = delete;
+	FrameRingAllocator& operator=(FrameRingAllocator&& other) noexcept = delete;
+
+	/**
+	 * \brief 
+	 * \param pMappedData CPU address of the buffer, must stay valid until Release
+	 * \param capacity Size of the whole buffer, split evenly between the frames
+	 * \param regionAlignment Every region starts on a multiple of this, must be a power of two
+	 */
+	void Initialize(void* pMappedData, uint64_t capacity, uint64_t regionAlignment = 256)
+	{
+		assert(pMappedData && capacity);
+		assert((regionAlignment & (regionAlignment - 1)) == 0);
+
+		m_pData = static_cast<uint8_t*>(pMappedData);
+		m_RegionSize = (capacity / FrameCount) & ~(regionAlignment - 1);
+		m_RegionFenceValues = {};
+		m_FrameIndex = 0;
+		m_Head = 0;
+		m_IsRecording = false;
+		m_FailedAllocationCount = 0;
+
+		assert(m_RegionSize);
+	}
+
+	void Release()
+	{
+		m_pData = nullptr;
+		m_RegionSize = 0;
+		m_Head = 0;
+	}
+
+	/**
+	 * \brief 
+	 * \return Fence value the GPU must reach before the next region can be reused by BeginFrame
+	 */
+	[[nodiscard]] uint64_t GetRequiredFenceValue() const
+	{
+		return m_RegionFenceValues[m_FrameIndex];
+	}
+
+	/**
+	 * \brief Starts recording in the next region
+	 * \param completedFenceValue Last fence value completed by the GPU
+	 * \return False if the region is still in use, wait for GetRequiredFenceValue and try again
+	 */
+	[[nodiscard]] bool BeginFrame(uint64_t completedFenceValue)
+	{
+		assert(m_pData && !m_IsRecording);
+
+		if (completedFenceValue < m_RegionFenceValues[m_FrameIndex])
+			return false;
+
+		m_Head = 0;
+		m_IsRecording = true;
+		return true;
+	}
+
+	/**
+	 * \brief Closes the current region
+	 * \param fenceValue Fence value signaled once the GPU is done with this frame
+	 */
+	void EndFrame(uint64_t fenceValue)
+	{
+		assert(m_IsRecording);
+
+		m_RegionFenceValues[m_FrameIndex] = fenceValue;
+		m_FrameIndex = (m_FrameIndex + 1) % FrameCount;
+		m_IsRecording = false;
+	}
+
+	/**
+	 * \brief Suballocates an aligned slice of the current region
+	 * \param size Size in bytes
+	 * \param alignment Power of two
+	 * \return Invalid allocation if the region is full
+	 */
+	[[nodiscard]] Allocation Allocate(uint64_t size, uint64_t alignment)
+	{
+		assert(m_IsRecording);
+		assert(alignment && (alignment & (alignment - 1)) == 0);
+
+		const uint64_t offset{ (m_Head + alignment - 1) & ~(alignment - 1) };
+		if (offset + size > m_RegionSize)
+		{
+			++m_FailedAllocationCount;
+			return {};
+		}
+
+		m_Head = offset + size;
+
+		const uint64_t bufferOffset{ GetRegionOffset() + offset };
+		return Allocation{ m_pData + bufferOffset, bufferOffset, size };
+	}
+
+	[[nodiscard]] uint32_t GetFrameIndex() const { return m_FrameIndex; }
+	[[nodiscard]] uint64_t GetRegionSize() const { return m_RegionSize; }
+	[[nodiscard]] uint64_t GetRegionOffset() const { return m_FrameIndex * m_RegionSize; }
+	[[nodiscard]] uint64_t GetUsedSize() const { return m_Head; }
+	[[nodiscard]] uint32_t GetFailedAllocationCount() const { return m_FailedAllocationCount; }
+
+private:
+	/* DATA MEMBERS */
+
+	uint8_t* m_pData{};
+	uint64_t m_RegionSize{};
+	std::array<uint64_t, FrameCount> m_RegionFenceValues{};
+	uint64_t m_Head{};
+	uint32_t m_FrameIndex{};
+	uint32_t m_FailedAllocationCount{};
+	bool m_IsRecording{};
+
+	/* PRIVATE METHODS */
+
+};
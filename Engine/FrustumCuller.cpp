@@ -0,0 +1,238 @@
+#include "FrustumCuller.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define PG_TARGET_AVX2
+#else
+#include <immintrin.h>
+#define PG_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#include "JobSystem.h"
+
+namespace
+{
+	bool SupportsAVX2()
+	{
+#ifdef _MSC_VER
+		int info[4]{};
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return false;
+
+		// AVX registers must also be saved by the OS
+		__cpuid(info, 1);
+		const bool hasOSXSave{ (info[2] & (1 << 27)) != 0 };
+		const bool hasAVX{ (info[2] & (1 << 28)) != 0 };
+		if (!hasOSXSave || !hasAVX || (_xgetbv(0) & 0x6) != 0x6)
+			return false;
+
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+
+	const bool g_HasAVX2{ SupportsAVX2() };
+
+	FrustumCuller::Plane NormalizePlane(float a, float b, float c, float d)
+	{
+		const float invLength{ 1.f / std::sqrt(a * a + b * b + c * c) };
+		return { a * invLength, b * invLength, c * invLength, d * invLength };
+	}
+}
+
+FrustumCuller::Frustum FrustumCuller::ExtractFrustum(const float (&viewProjection)[4][4])
+{
+	// clip = v * M, every plane is a combination of the matrix columns
+	const auto& m{ viewProjection };
+	return {
+		NormalizePlane(m[0][3] + m[0][0], m[1][3] + m[1][0], m[2][3] + m[2][0], m[3][3] + m[3][0]), // Left
+		NormalizePlane(m[0][3] - m[0][0], m[1][3] - m[1][0], m[2][3] - m[2][0], m[3][3] - m[3][0]), // Right
+		NormalizePlane(m[0][3] + m[0][1], m[1][3] + m[1][1], m[2][3] + m[2][1], m[3][3] + m[3][1]), // Bottom
+		NormalizePlane(m[0][3] - m[0][1], m[1][3] - m[1][1], m[2][3] - m[2][1], m[3][3] - m[3][1]), // Top
+		NormalizePlane(m[0][2], m[1][2], m[2][2], m[3][2]),                                         // Near
+		NormalizePlane(m[0][3] - m[0][2], m[1][3] - m[1][2], m[2][3] - m[2][2], m[3][3] - m[3][2])  // Far
+	};
+}
+
+void FrustumCuller::Clear()
+{
+	m_CenterX.clear();
+	m_CenterY.clear();
+	m_CenterZ.clear();
+	m_ExtentX.clear();
+	m_ExtentY.clear();
+	m_ExtentZ.clear();
+	m_Radius.clear();
+}
+
+void FrustumCuller::Reserve(uint32_t count)
+{
+	m_CenterX.reserve(count);
+	m_CenterY.reserve(count);
+	m_CenterZ.reserve(count);
+	m_ExtentX.reserve(count);
+	m_ExtentY.reserve(count);
+	m_ExtentZ.reserve(count);
+	m_Radius.reserve(count);
+}
+
+uint32_t FrustumCuller::Add(const Bounds& bounds)
+{
+	m_CenterX.emplace_back(bounds.m_Center[0]);
+	m_CenterY.emplace_back(bounds.m_Center[1]);
+	m_CenterZ.emplace_back(bounds.m_Center[2]);
+	m_ExtentX.emplace_back(bounds.m_Extents[0]);
+	m_ExtentY.emplace_back(bounds.m_Extents[1]);
+	m_ExtentZ.emplace_back(bounds.m_Extents[2]);
+	m_Radius.emplace_back(bounds.m_Radius);
+
+	return GetSize() - 1;
+}
+
+uint32_t FrustumCuller::GetSize() const
+{
+	return static_cast<uint32_t>(m_CenterX.size());
+}
+
+const std::vector<uint32_t>& FrustumCuller::Cull(const Frustum& frustum)
+{
+	m_Visible.clear();
+
+	const uint32_t size{ GetSize() };
+	const uint32_t jobCount{ (size + s_BoundsPerJob - 1) / s_BoundsPerJob };
+	if (jobCount <= 1 || !m_IsParallelEnabled)
+	{
+		CullRange(frustum, 0, size, m_Visible);
+		return m_Visible;
+	}
+
+	// Every job compacts its own chunk, chunks are appended in order afterwards
+	if (m_JobResults.size() < jobCount)
+		m_JobResults.resize(jobCount);
+
+	JobSystem::Get().ParallelFor(jobCount, [&](uint32_t job)
+	{
+		std::vector<uint32_t>& visible{ m_JobResults[job] };
+		visible.clear();
+		CullRange(frustum, job * s_BoundsPerJob, std::min(size, (job + 1) * s_BoundsPerJob), visible);
+	});
+
+	size_t visibleCount{};
+	for (uint32_t job{}; job < jobCount; ++job)
+		visibleCount += m_JobResults[job].size();
+
+	m_Visible.reserve(visibleCount);
+	for (uint32_t job{}; job < jobCount; ++job)
+		m_Visible.insert(m_Visible.end(), m_JobResults[job].begin(), m_JobResults[job].end());
+
+	return m_Visible;
+}
+
+const std::vector<uint32_t>& FrustumCuller::GetVisible() const
+{
+	return m_Visible;
+}
+
+void FrustumCuller::SetAVX2Enabled(bool isEnabled)
+{
+	m_IsAVX2Enabled = isEnabled;
+}
+
+void FrustumCuller::SetParallelEnabled(bool isEnabled)
+{
+	m_IsParallelEnabled = isEnabled;
+}
+
+bool FrustumCuller::IsAVX2Supported()
+{
+	return g_HasAVX2;
+}
+
+void FrustumCuller::CullRange(const Frustum& frustum, uint32_t first, uint32_t last, std::vector<uint32_t>& visible) const
+{
+	if (g_HasAVX2 && m_IsAVX2Enabled)
+	{
+		CullRangeAVX2(frustum, first, last, visible);
+		first += (last - first) / s_BatchSize * s_BatchSize;
+	}
+
+	for (uint32_t i{ first }; i < last; ++i)
+	{
+		bool isInside{ true };
+		for (const Plane& plane : frustum)
+		{
+			const float distance{ plane.m_A * m_CenterX[i] + plane.m_B * m_CenterY[i] + plane.m_C * m_CenterZ[i] + plane.m_D };
+			const float boxRadius{ std::abs(plane.m_A) * m_ExtentX[i] + std::abs(plane.m_B) * m_ExtentY[i] + std::abs(plane.m_C) * m_ExtentZ[i] };
+			if (distance + std::min(boxRadius, m_Radius[i]) < 0.f)
+			{
+				isInside = false;
+				break;
+			}
+		}
+
+		if (isInside)
+			visible.emplace_back(i);
+	}
+}
+
+PG_TARGET_AVX2 void FrustumCuller::CullRangeAVX2(const Frustum& frustum, uint32_t first, uint32_t last, std::vector<uint32_t>& visible) const
+{
+	const __m256 signMask{ _mm256_set1_ps(-0.f) };
+	const __m256 zero{ _mm256_setzero_ps() };
+
+	__m256 planeX[6], planeY[6], planeZ[6], planeW[6], absPlaneX[6], absPlaneY[6], absPlaneZ[6];
+	for (size_t p{}; p < frustum.size(); ++p)
+	{
+		planeX[p] = _mm256_set1_ps(frustum[p].m_A);
+		planeY[p] = _mm256_set1_ps(frustum[p].m_B);
+		planeZ[p] = _mm256_set1_ps(frustum[p].m_C);
+		planeW[p] = _mm256_set1_ps(frustum[p].m_D);
+		absPlaneX[p] = _mm256_andnot_ps(signMask, planeX[p]);
+		absPlaneY[p] = _mm256_andnot_ps(signMask, planeY[p]);
+		absPlaneZ[p] = _mm256_andnot_ps(signMask, planeZ[p]);
+	}
+
+	const uint32_t batchEnd{ first + (last - first) / s_BatchSize * s_BatchSize };
+	for (uint32_t i{ first }; i < batchEnd; i += s_BatchSize)
+	{
+		const __m256 centerX{ _mm256_loadu_ps(m_CenterX.data() + i) };
+		const __m256 centerY{ _mm256_loadu_ps(m_CenterY.data() + i) };
+		const __m256 centerZ{ _mm256_loadu_ps(m_CenterZ.data() + i) };
+		const __m256 extentX{ _mm256_loadu_ps(m_ExtentX.data() + i) };
+		const __m256 extentY{ _mm256_loadu_ps(m_ExtentY.data() + i) };
+		const __m256 extentZ{ _mm256_loadu_ps(m_ExtentZ.data() + i) };
+		const __m256 radius{ _mm256_loadu_ps(m_Radius.data() + i) };
+
+		__m256 isInside{ _mm256_castsi256_ps(_mm256_set1_epi32(-1)) };
+		for (size_t p{}; p < frustum.size(); ++p)
+		{
+			// Same order of operations as the scalar path, so both give the same result for every bounds
+			__m256 distance{ _mm256_mul_ps(planeX[p], centerX) };
+			distance = _mm256_add_ps(distance, _mm256_mul_ps(planeY[p], centerY));
+			distance = _mm256_add_ps(distance, _mm256_mul_ps(planeZ[p], centerZ));
+			distance = _mm256_add_ps(distance, planeW[p]);
+
+			__m256 boxRadius{ _mm256_mul_ps(absPlaneX[p], extentX) };
+			boxRadius = _mm256_add_ps(_mm256_mul_ps(absPlaneY[p], extentY), boxRadius);
+			boxRadius = _mm256_add_ps(_mm256_mul_ps(absPlaneZ[p], extentZ), boxRadius);
+
+			const __m256 reach{ _mm256_add_ps(distance, _mm256_min_ps(boxRadius, radius)) };
+			isInside = _mm256_and_ps(isInside, _mm256_cmp_ps(reach, zero, _CMP_GE_OQ));
+		}
+
+		// Compact the lanes that passed every plane
+		auto mask = static_cast<uint32_t>(_mm256_movemask_ps(isInside));
+		while (mask)
+		{
+			visible.emplace_back(i + static_cast<uint32_t>(std::countr_zero(mask)));
+			mask &= mask - 1;
+		}
+	}
+}
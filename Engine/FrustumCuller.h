@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/**
+ * \brief Tests world space bounds against the camera frustum.
+ * Bounds are stored as structure of arrays and tested 8 at a time with AVX2 when the CPU supports it, large sets
+ * are split in chunks culled in parallel on the JobSystem. The visible list keeps the order bounds were added in.
+ * Only depends on the standard library and the JobSystem, so it builds outside the engine.
+ */
+class FrustumCuller final
+{
+public:
+	/**
+	 * \brief Plane a * x + b * y + c * z + d = 0, the normal (a, b, c) has unit length
+	 */
+	struct Plane
+	{
+		float m_A{};
+		float m_B{};
+		float m_C{};
+		float m_D{};
+	};
+
+	using Frustum = std::array<Plane, 6>; // Inside is positive
+
+	/**
+	 * \brief World space bounds, the tightest of the box and the sphere is used for every plane
+	 */
+	struct Bounds
+	{
+		float m_Center[3]{};
+		float m_Extents[3]{}; // Half size of the axis aligned box
+		float m_Radius{}; // Sphere around the same center
+	};
+
+	FrustumCuller() noexcept = default;
+	~FrustumCuller() = default;
+
+	FrustumCuller(const FrustumCuller& other) noexcept = delete;
+	FrustumCuller& operator=(const FrustumCuller& other) noexcept = delete;
+	FrustumCuller(FrustumCuller&& other) noexcept = delete;
+	FrustumCuller& operator=(FrustumCuller&& other) noexcept = delete;
+
+	/**
+	 * \brief Extracts the frustum planes of a row major, row vector view projection matrix with a [0, 1] depth range
+	 */
+	[[nodiscard]] static Frustum ExtractFrustum(const float (&viewProjection)[4][4]);
+
+	void Clear();
+	void Reserve(uint32_t count);
+	/**
+	 * \brief
+	 * \return Index reported in the visible list
+	 */
+	uint32_t Add(const Bounds& bounds);
+	[[nodiscard]] uint32_t GetSize() const;
+
+	/**
+	 * \brief
+	 * \return Indices of the bounds intersecting the frustum, in ascending order, valid until the next Cull
+	 */
+	const std::vector<uint32_t>& Cull(const Frustum& frustum);
+	[[nodiscard]] const std::vector<uint32_t>& GetVisible() const;
+
+	/**
+	 * \brief Both enabled by default, only meant to compare the code paths. AVX2 is ignored when the CPU lacks it.
+	 */
+	void SetAVX2Enabled(bool isEnabled);
+	void SetParallelEnabled(bool isEnabled);
+	[[nodiscard]] static bool IsAVX2Supported();
+
+	inline static constexpr uint32_t s_BatchSize{ 8 };
+	inline static constexpr uint32_t s_BoundsPerJob{ 16384 };
+
+private:
+	/* DATA MEMBERS */
+
+	std::vector<float> m_CenterX{};
+	std::vector<float> m_CenterY{};
+	std::vector<float> m_CenterZ{};
+	std::vector<float> m_ExtentX{};
+	std::vector<float> m_ExtentY{};
+	std::vector<float> m_ExtentZ{};
+	std::vector<float> m_Radius{};
+
+	std::vector<std::vector<uint32_t>> m_JobResults{};
+	std::vector<uint32_t> m_Visible{};
+
+	bool m_IsAVX2Enabled{ true };
+	bool m_IsParallelEnabled{ true };
+
+	/* PRIVATE METHODS */
+
+	void CullRange(const Frustum& frustum, uint32_t first, uint32_t last, std::vector<uint32_t>& visible) const;
+	void CullRangeAVX2(const Frustum& frustum, uint32_t first, uint32_t last, std::vector<uint32_t>& visible) const;
+
+};
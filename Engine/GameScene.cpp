@@ -1,6 +1,24 @@
 #include "GameScene.h"
 
+#include <algorithm>
+
+#include "BoundsComponent.h"
+#include "CameraComponent.h"
 #include "GameObject.h"
+#include "GameSettings.h"
+#include "LODComponent.h"
+#include "OccluderComponent.h"
+#include "Renderer.h"
+
+namespace
+{
+	bool Overlaps(const AABB& a, const AABB& b)
+	{
+		return a.m_Min.x <= b.m_Max.x && a.m_Max.x >= b.m_Min.x
+			&& a.m_Min.y <= b.m_Max.y && a.m_Max.y >= b.m_Min.y
+			&& a.m_Min.z <= b.m_Max.z && a.m_Max.z >= b.m_Min.z;
+	}
+}
 
 GameScene::~GameScene()
 {
@@ -34,18 +52,70 @@ void GameScene::LateUpdate()
 
 	for (const auto& object : m_TrashBin)
 	{
+		if (const BoundsComponent* pBounds{ object->GetComponent<BoundsComponent>() }; pBounds && pBounds->m_Proxy != DynamicAABBTree::s_NullNode)
+			m_SpatialIndex.DestroyProxy(pBounds->m_Proxy);
+
 		delete object;
 		std::erase(m_Objects, object);
 	}
 	m_TrashBin.clear();
 
+	UpdateSpatialIndex();
 }
 
-void GameScene::Render() const
+void GameScene::Render()
 {
+	if (!m_pActiveCamera)
+	{
+		for (const auto& object : m_Objects)
+			if (object->IsActive())
+				object->Render();
+
+		return;
+	}
+
+	Renderer::Get().SetView(m_pActiveCamera->GetViewConstants());
+
+	m_FrustumCuller.Clear();
+	m_pBoundedObjects.clear();
+	m_BoundedBoxes.clear();
+
 	for (const auto& object : m_Objects)
-		if (object->IsActive())
+	{
+		if (!object->IsActive())
+			continue;
+
+		// Objects without bounds are always rendered
+		const BoundsComponent* pBounds{ object->GetComponent<BoundsComponent>() };
+		if (!pBounds || !pBounds->IsActive())
+		{
 			object->Render();
+			continue;
+		}
+
+		const XMFLOAT3& center{ pBounds->GetWorldCenter() };
+		const XMFLOAT3& extents{ pBounds->GetWorldExtents() };
+		m_FrustumCuller.Add({ { center.x, center.y, center.z }, { extents.x, extents.y, extents.z }, pBounds->GetWorldRadius() });
+		m_pBoundedObjects.emplace_back(object);
+		m_BoundedBoxes.emplace_back(pBounds->GetWorldBox());
+	}
+
+	const FrustumCuller::Frustum frustum{ FrustumCuller::ExtractFrustum(m_pActiveCamera->GetViewProjection().m) };
+	const std::vector<uint32_t>& visible{ m_FrustumCuller.Cull(frustum) };
+
+	// Levels of detail are only selected for the objects that end up drawn
+	m_LODSelector.BeginFrame(m_pActiveCamera->GetProjection(), m_pActiveCamera->GetOwner()->GetWorldTransform().GetPosition());
+
+	if (GameSettings::useOcclusionCulling)
+		RenderUnoccluded(visible);
+
+	else
+	{
+		for (const uint32_t index : visible)
+			RenderBounded(index);
+	}
+
+	m_LODSelector.EndFrame();
 }
 
 void GameScene::AddGameObject(GameObject* gameObject)
@@ -53,3 +123,175 @@ void GameScene::AddGameObject(GameObject* gameObject)
 	m_Objects.emplace_back(gameObject);
 }
 
+void GameScene::SetActiveCamera(CameraComponent* pCamera)
+{
+	m_pActiveCamera = pCamera;
+}
+
+CameraComponent* GameScene::GetActiveCamera() const
+{
+	return m_pActiveCamera;
+}
+
+const OcclusionCuller::Stats& GameScene::GetOcclusionStats() const
+{
+	return m_OcclusionCuller.GetStats();
+}
+
+const LODSelector& GameScene::GetLODSelector() const
+{
+	return m_LODSelector;
+}
+
+void GameScene::QueryBox(const AABB& box, std::vector<GameObject*>& objects) const
+{
+	m_SpatialIndex.QueryBox(box, [&](int32_t proxy)
+	{
+		GameObject* pObject{ static_cast<GameObject*>(m_SpatialIndex.GetUserData(proxy)) };
+		if (pObject->IsActive() && Overlaps(pObject->GetComponent<BoundsComponent>()->GetWorldBox(), box))
+			objects.emplace_back(pObject);
+		return true;
+	});
+}
+
+void GameScene::QuerySphere(const XMFLOAT3& center, float radius, std::vector<GameObject*>& objects) const
+{
+	m_SpatialIndex.QuerySphere(center, radius, [&](int32_t proxy)
+	{
+		GameObject* pObject{ static_cast<GameObject*>(m_SpatialIndex.GetUserData(proxy)) };
+		if (!pObject->IsActive())
+			return true;
+
+		// Leaves hold fat boxes, test against the exact world box
+		const AABB box{ pObject->GetComponent<BoundsComponent>()->GetWorldBox() };
+		const float dx{ center.x - std::clamp(center.x, box.m_Min.x, box.m_Max.x) };
+		const float dy{ center.y - std::clamp(center.y, box.m_Min.y, box.m_Max.y) };
+		const float dz{ center.z - std::clamp(center.z, box.m_Min.z, box.m_Max.z) };
+		if (dx * dx + dy * dy + dz * dz <= radius * radius)
+			objects.emplace_back(pObject);
+		return true;
+	});
+}
+
+void GameScene::QueryFrustum(const FrustumCuller::Frustum& frustum, std::vector<GameObject*>& objects) const
+{
+	// Conservative, the fat boxes are slightly larger than the objects
+	m_SpatialIndex.QueryFrustum(frustum, [&](int32_t proxy)
+	{
+		GameObject* pObject{ static_cast<GameObject*>(m_SpatialIndex.GetUserData(proxy)) };
+		if (pObject->IsActive())
+			objects.emplace_back(pObject);
+		return true;
+	});
+}
+
+GameObject* GameScene::RayCast(const XMFLOAT3& origin, const XMFLOAT3& direction, float maxDistance, float* pDistance) const
+{
+	const XMFLOAT3 invDirection{ 1.f / direction.x, 1.f / direction.y, 1.f / direction.z };
+
+	GameObject* pHitObject{};
+	m_SpatialIndex.RayCast(origin, direction, maxDistance, [&](int32_t proxy, float currentMaxDistance)
+	{
+		GameObject* pObject{ static_cast<GameObject*>(m_SpatialIndex.GetUserData(proxy)) };
+		if (!pObject->IsActive())
+			return currentMaxDistance;
+
+		const AABB box{ pObject->GetComponent<BoundsComponent>()->GetWorldBox() };
+		const float tx1{ (box.m_Min.x - origin.x) * invDirection.x };
+		const float tx2{ (box.m_Max.x - origin.x) * invDirection.x };
+		const float ty1{ (box.m_Min.y - origin.y) * invDirection.y };
+		const float ty2{ (box.m_Max.y - origin.y) * invDirection.y };
+		const float tz1{ (box.m_Min.z - origin.z) * invDirection.z };
+		const float tz2{ (box.m_Max.z - origin.z) * invDirection.z };
+
+		const float tEnter{ (std::max)({ (std::min)(tx1, tx2), (std::min)(ty1, ty2), (std::min)(tz1, tz2), 0.f }) };
+		const float tExit{ (std::min)({ (std::max)(tx1, tx2), (std::max)(ty1, ty2), (std::max)(tz1, tz2), currentMaxDistance }) };
+		if (tEnter > tExit)
+			return currentMaxDistance;
+
+		// Only closer hits are reported from now on
+		pHitObject = pObject;
+		if (pDistance)
+			*pDistance = tEnter;
+		return tEnter;
+	});
+
+	return pHitObject;
+}
+
+void GameScene::RebuildSpatialIndex()
+{
+	UpdateSpatialIndex();
+	m_SpatialIndex.Rebuild();
+}
+
+void GameScene::UpdateSpatialIndex()
+{
+	// Bounds refresh in LateUpdate, only the ones that moved touch the tree
+	for (const auto& object : m_Objects)
+	{
+		BoundsComponent* pBounds{ object->GetComponent<BoundsComponent>() };
+		if (!pBounds || !pBounds->m_HasMoved)
+			continue;
+
+		pBounds->m_HasMoved = false;
+		if (pBounds->m_Proxy == DynamicAABBTree::s_NullNode)
+			pBounds->m_Proxy = m_SpatialIndex.CreateProxy(pBounds->GetWorldBox(), object);
+		else
+			m_SpatialIndex.MoveProxy(pBounds->m_Proxy, pBounds->GetWorldBox());
+	}
+}
+
+void GameScene::RenderUnoccluded(const std::vector<uint32_t>& visible)
+{
+	if (m_OcclusionCuller.GetWidth() != GameSettings::occlusionBufferWidth || m_OcclusionCuller.GetHeight() != GameSettings::occlusionBufferHeight)
+		m_OcclusionCuller.Resize(GameSettings::occlusionBufferWidth, GameSettings::occlusionBufferHeight);
+
+	// Occluders in view are rasterized first, then every object in view is tested against them
+	m_OcclusionCuller.BeginFrame(m_pActiveCamera->GetViewProjection());
+	for (const uint32_t index : visible)
+	{
+		GameObject* pObject{ m_pBoundedObjects[index] };
+		if (const OccluderComponent* pOccluder{ pObject->GetComponent<OccluderComponent>() }; pOccluder && pOccluder->IsActive() && !pOccluder->GetIndices().empty())
+		{
+			const std::vector<XMFLOAT3>& positions{ pOccluder->GetPositions() };
+			const std::vector<uint32_t>& indices{ pOccluder->GetIndices() };
+			m_OcclusionCuller.AddOccluder(positions.data(), static_cast<uint32_t>(positions.size()), indices.data(), static_cast<uint32_t>(indices.size()), pObject->GetWorldTransform().GetTransform());
+		}
+	}
+
+	if (m_OcclusionCuller.GetStats().m_OccluderCount == 0)
+	{
+		for (const uint32_t index : visible)
+			RenderBounded(index);
+		return;
+	}
+
+	m_OcclusionCuller.RasterizeOccluders();
+
+	m_OccludeeBoxes.clear();
+	for (const uint32_t index : visible)
+		m_OccludeeBoxes.emplace_back(m_BoundedBoxes[index]);
+
+	m_OccludeeVisibility.resize(m_OccludeeBoxes.size());
+	m_OcclusionCuller.TestOccludees(m_OccludeeBoxes.data(), static_cast<uint32_t>(m_OccludeeBoxes.size()), m_OccludeeVisibility.data());
+
+	for (size_t i{}; i < visible.size(); ++i)
+	{
+		if (m_OccludeeVisibility[i])
+			RenderBounded(visible[i]);
+	}
+}
+
+void GameScene::RenderBounded(uint32_t index)
+{
+	GameObject* pObject{ m_pBoundedObjects[index] };
+	if (LODComponent* pLOD{ pObject->GetComponent<LODComponent>() }; pLOD && pLOD->IsActive())
+	{
+		const AABB& box{ m_BoundedBoxes[index] };
+		const XMFLOAT3 center{ (box.m_Min.x + box.m_Max.x) * .5f, (box.m_Min.y + box.m_Max.y) * .5f, (box.m_Min.z + box.m_Max.z) * .5f };
+		m_LODSelector.Select(*pLOD, center, pObject->GetComponent<BoundsComponent>()->GetWorldRadius());
+	}
+
+	pObject->Render();
+}
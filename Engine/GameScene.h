@@ -2,6 +2,12 @@
 
 #include <vector>
 
+#include "DynamicAABBTree.h"
+#include "FrustumCuller.h"
+#include "LODSelector.h"
+#include "OcclusionCuller.h"
+
+class CameraComponent;
 class GameObject;
 
 class GameScene
@@ -19,17 +25,72 @@ public:
 	void FixedUpdate();
 	void Update();
 	void LateUpdate();
-	void Render() const;
+	/**
+	 * \brief Render the active objects, objects with bounds are culled against the active camera's frustum
+	 */
+	void Render();
 
 	void AddGameObject(GameObject* gameObject);
 
+	/**
+	 * \brief Set the camera the scene is rendered from
+	 * \param pCamera Camera component owned by one of the scene's objects
+	 */
+	void SetActiveCamera(CameraComponent* pCamera);
+	[[nodiscard]] CameraComponent* GetActiveCamera() const;
+
+	/**
+	 * \brief
+	 * \return Occluders, culled objects and timings of the last rendered frame
+	 */
+	[[nodiscard]] const OcclusionCuller::Stats& GetOcclusionStats() const;
+	/**
+	 * \brief
+	 * \return Selection state of the last rendered frame, triangle count and effective bias
+	 */
+	[[nodiscard]] const LODSelector& GetLODSelector() const;
+
+	// Spatial queries, only active objects with bounds are returned
+
+	void QueryBox(const AABB& box, std::vector<GameObject*>& objects) const;
+	void QuerySphere(const XMFLOAT3& center, float radius, std::vector<GameObject*>& objects) const;
+	void QueryFrustum(const FrustumCuller::Frustum& frustum, std::vector<GameObject*>& objects) const;
+	/**
+	 * \brief Find the closest object whose world bounds are hit by the ray
+	 * \param direction Normalized ray direction
+	 * \param pDistance Receives the distance to the hit, optional
+	 * \return Hit object or nullptr
+	 */
+	GameObject* RayCast(const XMFLOAT3& origin, const XMFLOAT3& direction, float maxDistance, float* pDistance = nullptr) const;
+	/**
+	 * \brief Rebuild the spatial index from scratch with a SAH build, call once static content has been placed
+	 */
+	void RebuildSpatialIndex();
+
 private:
 	/* DATA MEMBERS */
 
 	std::vector<GameObject*> m_Objects;
 	std::vector<GameObject*> m_TrashBin;
+	CameraComponent* m_pActiveCamera{};
+
+	FrustumCuller m_FrustumCuller{};
+	std::vector<GameObject*> m_pBoundedObjects{}; // Indexed by the culler's visible list
+	std::vector<AABB> m_BoundedBoxes{};
+
+	OcclusionCuller m_OcclusionCuller{};
+	std::vector<AABB> m_OccludeeBoxes{};
+	std::vector<uint8_t> m_OccludeeVisibility{};
+
+	LODSelector m_LODSelector{};
+
+	DynamicAABBTree m_SpatialIndex{};
 
 	/* PRIVATE METHODS */
-	
+
+	void UpdateSpatialIndex();
+	void RenderUnoccluded(const std::vector<uint32_t>& visible);
+	void RenderBounded(uint32_t index);
+
 };
 
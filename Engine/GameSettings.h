@@ -7,7 +7,10 @@ struct GameSettings
 	enum class RenderAPI
 	{
 		DirectX11,
-		DirectX12
+		DirectX12,
+		Null, // Headless backend recording calls, no GPU required
+		Software, // CPU rasterizer, no GPU required
+		Vulkan // Requires the Vulkan SDK at build time
 	};
 
 	inline static unsigned short windowTop{ 100 };
@@ -19,5 +22,19 @@ struct GameSettings
 	inline static float nearPlane{ .1f };
 	inline static float farPlane{ 3000.f };
 	inline static bool useVSync{ true };
+	inline static unsigned int transientUploadBufferSize{ 16u * 1024u * 1024u }; // Split between all frames in flight, each needs ~300 bytes per object of maxObjectsPerFrame
+	inline static unsigned int maxObjectsPerFrame{ 16384u }; // Draws recorded per frame, sizes the world matrix buffer
 	inline static RenderAPI renderAPI{ RenderAPI::DirectX11 };
+	inline static bool renderOffscreen{ false }; // Vulkan only, renders to an offscreen image instead of a window swap chain
+	inline static bool useOcclusionCulling{ true }; // Only has an effect on scenes with occluders
+	inline static unsigned short occlusionBufferWidth{ 320 };
+	inline static unsigned short occlusionBufferHeight{ 180 };
+	inline static float lodBias{ 1.f }; // Scales projected sizes, higher keeps detailed levels further away
+	inline static float lodHysteresis{ .1f }; // Margin below a level's screen size before switching to a coarser one
+	inline static unsigned int lodTriangleBudget{ 0u }; // Triangles of the selected levels per frame, 0 disables the budget
+	inline static const char* rendererStatsLogPath{ nullptr }; // CSV of the renderer stats rolling averages, nullptr disables it
+	inline static unsigned int rendererStatsLogInterval{ 60u }; // Frames between two rows of the stats CSV
+	inline static unsigned int streamingThreadCount{ 2u }; // IO threads of the AssetStreamer
+	inline static unsigned int streamingQueueDepth{ 8u }; // Reads in flight per IO thread when io_uring is available
+	inline static const char* assetPackPath{ nullptr }; // Pack built by the AssetPacker tool, searched before the loose files, nullptr disables it
 };
\ No newline at end of file
@@ -0,0 +1,26 @@
+#include "ImageWriter.h"
+
+#include <fstream>
+
+bool ImageWriter::SaveTGA(const std::string& path, const uint32_t* pPixels, uint32_t width, uint32_t height, uint32_t pitch)
+{
+	std::ofstream file{ path, std::ios::binary };
+	if (!file)
+		return false;
+
+	uint8_t header[18]{};
+	header[2] = 2; // Uncompressed true color
+	header[12] = static_cast<uint8_t>(width & 0xFF);
+	header[13] = static_cast<uint8_t>(width >> 8);
+	header[14] = static_cast<uint8_t>(height & 0xFF);
+	header[15] = static_cast<uint8_t>(height >> 8);
+	header[16] = 32;
+	header[17] = 0x28; // 8 alpha bits, top-left origin
+	file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+	// 0xAARRGGBB stored little endian is the BGRA byte order TGA expects
+	for (uint32_t y{}; y < height; ++y)
+		file.write(reinterpret_cast<const char*>(pPixels + static_cast<size_t>(y) * pitch), static_cast<std::streamsize>(width) * sizeof(uint32_t));
+
+	return static_cast<bool>(file);
+}
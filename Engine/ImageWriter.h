@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+class ImageWriter final
+{
+public:
+	/**
+	 * \brief Writes an uncompressed 32-bit TGA, top row first
+	 * \param pPixels BGRA8 pixels (0xAARRGGBB)
+	 * \param pitch Pixels per row in pPixels, at least width
+	 * \return False if the file could not be written
+	 */
+	static bool SaveTGA(const std::string& path, const uint32_t* pPixels, uint32_t width, uint32_t height, uint32_t pitch);
+};
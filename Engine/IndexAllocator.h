@@ -0,0 +1,234 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+
+/**
+ * \brief Lock-free allocator of indices in [0, capacity), used for descriptor heap slots.
+ * Free indices form a Treiber stack linked through a per-index next array, the head is tagged with a counter to
+ * rule out ABA. Every thread refills a small cache from the stack with a single CAS, so most allocations touch no
+ * shared cache line. Freed indices wait in the list of the frame they were freed in until ReclaimFrame hands them
+ * back, once the GPU can no longer reference them.
+ * Backend agnostic, the backend provides the frame index.
+ * \tparam FrameCount Number of frames in flight
+ */
+template <int FrameCount>
+class IndexAllocator final
+{
+public:
+	IndexAllocator() noexcept
+	{
+		for (std::atomic<uint32_t>& head : m_RetiredHeads)
+			head.store(s_InvalidIndex, std::memory_order_relaxed);
+	}
+	~IndexAllocator() = default;
+
+	IndexAllocator(const IndexAllocator& other) noexcept = delete;
+	IndexAllocator& operator=(const IndexAllocator& other) noexcept = delete;
+	IndexAllocator(IndexAllocator&& other) noexcept = delete;
+	IndexAllocator& operator=(IndexAllocator&& other) noexcept = delete;
+
+	/**
+	 * \brief Makes every index free, not thread safe
+	 */
+	void Initialize(uint32_t capacity)
+	{
+		assert(capacity && capacity < s_InvalidIndex);
+
+		m_pNext = std::make_unique<std::atomic<uint32_t>[]>(capacity);
+		for (uint32_t i{}; i < capacity; ++i)
+			m_pNext[i].store(i + 1 < capacity ? i + 1 : s_InvalidIndex, std::memory_order_relaxed);
+
+		m_pCaches = std::make_unique<Cache[]>(s_CacheCount);
+		m_FreeHead.store(Pack(0, 0), std::memory_order_relaxed);
+		for (std::atomic<uint32_t>& head : m_RetiredHeads)
+			head.store(s_InvalidIndex, std::memory_order_relaxed);
+
+		m_Capacity = capacity;
+		m_Size.store(0, std::memory_order_relaxed);
+	}
+
+	/**
+	 * \brief Forgets every index, not thread safe
+	 */
+	void Release()
+	{
+		m_pNext.reset();
+		m_pCaches.reset();
+		m_FreeHead.store(Pack(s_InvalidIndex, 0), std::memory_order_relaxed);
+		for (std::atomic<uint32_t>& head : m_RetiredHeads)
+			head.store(s_InvalidIndex, std::memory_order_relaxed);
+
+		m_Capacity = 0;
+		m_Size.store(0, std::memory_order_relaxed);
+	}
+
+	/**
+	 * \brief Thread safe, never blocks
+	 * \return s_InvalidIndex if every index is in use or waiting for its frame
+	 */
+	[[nodiscard]] uint32_t Allocate()
+	{
+		assert(m_pNext);
+
+		uint32_t index{ AllocateCached(GetThreadCache()) };
+
+		// The own cache is taken by a thread sharing it, or the stack ran dry while other caches still hold indices
+		for (uint32_t i{}; index == s_InvalidIndex && i < s_CacheCount; ++i)
+			index = AllocateCached(i);
+
+		if (index != s_InvalidIndex)
+			m_Size.fetch_add(1, std::memory_order_relaxed);
+
+		return index;
+	}
+
+	/**
+	 * \brief Thread safe, never blocks. The index stays in use until ReclaimFrame is called for the same frame
+	 * \param frameIndex Frame in flight that may still reference the index
+	 */
+	void Free(uint32_t index, uint32_t frameIndex)
+	{
+		assert(index < m_Capacity && frameIndex < FrameCount);
+
+		std::atomic<uint32_t>& head{ m_RetiredHeads[frameIndex] };
+		uint32_t next{ head.load(std::memory_order_relaxed) };
+		do
+		{
+			m_pNext[index].store(next, std::memory_order_relaxed);
+		} while (!head.compare_exchange_weak(next, index, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	/**
+	 * \brief Returns the indices freed during a frame to the free stack, call once the GPU completed that frame
+	 */
+	void ReclaimFrame(uint32_t frameIndex)
+	{
+		assert(frameIndex < FrameCount);
+
+		const uint32_t first{ m_RetiredHeads[frameIndex].exchange(s_InvalidIndex, std::memory_order_acquire) };
+		if (first == s_InvalidIndex)
+			return;
+
+		uint32_t count{ 1 };
+		uint32_t last{ first };
+		for (uint32_t next{ m_pNext[last].load(std::memory_order_relaxed) }; next != s_InvalidIndex; next = m_pNext[last].load(std::memory_order_relaxed))
+		{
+			last = next;
+			++count;
+		}
+
+		PushChain(first, last);
+		m_Size.fetch_sub(count, std::memory_order_relaxed);
+	}
+
+	/**
+	 * \brief Reclaims every frame, only when no frame is in flight anymore
+	 */
+	void ReclaimAll()
+	{
+		for (uint32_t i{}; i < FrameCount; ++i)
+			ReclaimFrame(i);
+	}
+
+	[[nodiscard]] uint32_t GetCapacity() const { return m_Capacity; }
+	/**
+	 * \brief
+	 * \return Indices allocated and not reclaimed yet, only exact while no other thread allocates
+	 */
+	[[nodiscard]] uint32_t GetSize() const { return m_Size.load(std::memory_order_relaxed); }
+
+	inline static constexpr uint32_t s_InvalidIndex{ 0xFFFFFFFFu };
+	inline static constexpr uint32_t s_CacheCount{ 16 };
+	inline static constexpr uint32_t s_CacheSize{ 32 }; // Indices taken from the stack per refill
+
+private:
+	/* NESTED CLASSES */
+
+	struct alignas(64) Cache
+	{
+		std::atomic_flag m_IsBusy{};
+		uint32_t m_Count{};
+		uint32_t m_Indices[s_CacheSize]{};
+	};
+
+	/* DATA MEMBERS */
+
+	std::unique_ptr<std::atomic<uint32_t>[]> m_pNext{};
+	std::unique_ptr<Cache[]> m_pCaches{};
+	alignas(64) std::atomic<uint64_t> m_FreeHead{ Pack(s_InvalidIndex, 0) }; // Index in the low half, tag in the high half
+	alignas(64) std::array<std::atomic<uint32_t>, FrameCount> m_RetiredHeads{}; // Indices freed per frame, linked like the free stack
+	std::atomic<uint32_t> m_Size{};
+	uint32_t m_Capacity{};
+
+	/* PRIVATE METHODS */
+
+	static constexpr uint64_t Pack(uint32_t index, uint32_t tag)
+	{
+		return static_cast<uint64_t>(tag) << 32 | index;
+	}
+
+	static uint32_t GetThreadCache()
+	{
+		static std::atomic<uint32_t> s_ThreadCount{};
+		static thread_local const uint32_t s_ThreadCache{ s_ThreadCount.fetch_add(1, std::memory_order_relaxed) % s_CacheCount };
+		return s_ThreadCache;
+	}
+
+	uint32_t AllocateCached(uint32_t cacheIndex)
+	{
+		Cache& cache{ m_pCaches[cacheIndex] };
+		if (cache.m_IsBusy.test_and_set(std::memory_order_acquire))
+			return s_InvalidIndex;
+
+		if (cache.m_Count == 0)
+			cache.m_Count = PopChain(cache.m_Indices, s_CacheSize);
+
+		const uint32_t index{ cache.m_Count ? cache.m_Indices[--cache.m_Count] : s_InvalidIndex };
+
+		cache.m_IsBusy.clear(std::memory_order_release);
+		return index;
+	}
+
+	/**
+	 * \brief Detaches up to maxCount indices from the top of the free stack with one CAS
+	 * \return Number of indices written to pIndices
+	 */
+	uint32_t PopChain(uint32_t* pIndices, uint32_t maxCount)
+	{
+		uint64_t head{ m_FreeHead.load(std::memory_order_acquire) };
+		while (true)
+		{
+			uint32_t count{};
+			uint32_t next{ static_cast<uint32_t>(head) };
+			while (next != s_InvalidIndex && count < maxCount)
+			{
+				pIndices[count++] = next;
+				next = m_pNext[next].load(std::memory_order_relaxed);
+			}
+
+			if (count == 0)
+				return 0;
+
+			// A matching tag means no push or pop happened since head was read, so the walked links were consistent
+			if (m_FreeHead.compare_exchange_weak(head, Pack(next, static_cast<uint32_t>(head >> 32) + 1), std::memory_order_acquire, std::memory_order_acquire))
+				return count;
+		}
+	}
+
+	/**
+	 * \brief Pushes a linked chain of indices on the free stack with one CAS
+	 */
+	void PushChain(uint32_t first, uint32_t last)
+	{
+		uint64_t head{ m_FreeHead.load(std::memory_order_relaxed) };
+		do
+		{
+			m_pNext[last].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+		} while (!m_FreeHead.compare_exchange_weak(head, Pack(first, static_cast<uint32_t>(head >> 32) + 1), std::memory_order_release, std::memory_order_relaxed));
+	}
+
+};
@@ -0,0 +1,92 @@
+#include "JobSystem.h"
+
+JobSystem::JobSystem()
+{
+	const uint32_t hardwareThreads{ std::thread::hardware_concurrency() };
+	const uint32_t workerCount{ hardwareThreads > 1 ? hardwareThreads - 1 : 0 };
+
+	m_Workers.reserve(workerCount);
+	for (uint32_t i{}; i < workerCount; ++i)
+		m_Workers.emplace_back(&JobSystem::WorkerLoop, this);
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard lock{ m_Mutex };
+		m_IsRunning = false;
+	}
+	m_WakeCondition.notify_all();
+
+	for (auto& worker : m_Workers)
+		worker.join();
+}
+
+void JobSystem::ParallelFor(uint32_t count, const std::function<void(uint32_t index)>& job)
+{
+	if (s_IsRunningJob || m_Workers.empty() || count < 2)
+	{
+		for (uint32_t i{}; i < count; ++i)
+			job(i);
+		return;
+	}
+
+	std::lock_guard dispatchLock{ m_DispatchMutex };
+
+	{
+		std::lock_guard lock{ m_Mutex };
+		m_pJob = &job;
+		m_JobCount = count;
+		m_NextIndex = 0;
+		m_ActiveWorkerCount = static_cast<uint32_t>(m_Workers.size());
+		++m_Generation;
+	}
+	m_WakeCondition.notify_all();
+
+	s_IsRunningJob = true;
+	RunJobs();
+	s_IsRunningJob = false;
+
+	// Every worker has to acknowledge the generation before the job reference goes out of scope
+	std::unique_lock lock{ m_Mutex };
+	m_DoneCondition.wait(lock, [this] { return m_ActiveWorkerCount == 0; });
+	m_pJob = nullptr;
+}
+
+uint32_t JobSystem::GetThreadCount() const
+{
+	return static_cast<uint32_t>(m_Workers.size()) + 1;
+}
+
+void JobSystem::WorkerLoop()
+{
+	s_IsRunningJob = true;
+
+	uint64_t seenGeneration{};
+	while (true)
+	{
+		{
+			std::unique_lock lock{ m_Mutex };
+			m_WakeCondition.wait(lock, [this, seenGeneration] { return !m_IsRunning || m_Generation != seenGeneration; });
+
+			if (!m_IsRunning)
+				return;
+
+			seenGeneration = m_Generation;
+		}
+
+		RunJobs();
+
+		{
+			std::lock_guard lock{ m_Mutex };
+			if (--m_ActiveWorkerCount == 0)
+				m_DoneCondition.notify_one();
+		}
+	}
+}
+
+void JobSystem::RunJobs()
+{
+	for (uint32_t index{ m_NextIndex.fetch_add(1) }; index < m_JobCount; index = m_NextIndex.fetch_add(1))
+		(*m_pJob)(index);
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Singleton.h"
+
+/**
+ * \brief Fixed pool of worker threads running data parallel loops. The calling thread takes part in the work.
+ */
+class JobSystem final : public Singleton<JobSystem>
+{
+public:
+	~JobSystem() override;
+
+	JobSystem(const JobSystem& other) noexcept = delete;
+	JobSystem& operator=(const JobSystem& other) noexcept = delete;
+	JobSystem(JobSystem&& other) noexcept = delete;
+	JobSystem& operator=(JobSystem&& other) noexcept = delete;
+
+	/**
+	 * \brief Runs job(i) for every i in [0, count[ across all workers and returns once every call finished.
+	 * Called from inside a job, the loop runs inline on the calling worker.
+	 * \param count Number of job invocations
+	 * \param job Invoked concurrently, must be thread safe
+	 */
+	void ParallelFor(uint32_t count, const std::function<void(uint32_t index)>& job);
+
+	/**
+	 * \brief 
+	 * \return Number of threads taking part in a ParallelFor, calling thread included
+	 */
+	[[nodiscard]] uint32_t GetThreadCount() const;
+
+private:
+	friend class Singleton<JobSystem>;
+	JobSystem();
+
+	/* DATA MEMBERS */
+
+	std::vector<std::thread> m_Workers{};
+
+	std::mutex m_DispatchMutex{}; // One ParallelFor at a time
+	std::mutex m_Mutex{};
+	std::condition_variable m_WakeCondition{};
+	std::condition_variable m_DoneCondition{};
+
+	const std::function<void(uint32_t)>* m_pJob{};
+	uint32_t m_JobCount{};
+	std::atomic<uint32_t> m_NextIndex{};
+	uint32_t m_ActiveWorkerCount{};
+	uint64_t m_Generation{};
+	bool m_IsRunning{ true };
+
+	inline static thread_local bool s_IsRunningJob{}; // Nested loops run inline
+
+	/* PRIVATE METHODS */
+
+	void WorkerLoop();
+	void RunJobs();
+
+};
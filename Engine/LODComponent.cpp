@@ -0,0 +1,77 @@
+#include "LODComponent.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "GameObject.h"
+#include "MeshRendererComponent.h"
+
+
+void LODComponent::FixedUpdate()
+{
+}
+
+void LODComponent::Update()
+{
+}
+
+void LODComponent::LateUpdate()
+{
+}
+
+void LODComponent::Render()
+{
+}
+
+void LODComponent::AddLevel(MeshHandle mesh, float screenSize, uint32_t triangleCount)
+{
+	m_Levels.emplace_back(Level{ mesh, screenSize, triangleCount });
+}
+
+uint32_t LODComponent::SelectLevel(float screenSize, float hysteresis)
+{
+	if (m_Levels.empty())
+		return 0;
+
+	// Finer levels are picked right away, coarser ones only once the size is clearly below the threshold
+	uint32_t level{ FindLevel(screenSize) };
+	if (level > m_CurrentLevel)
+		level = std::max(m_CurrentLevel, FindLevel(screenSize * (1.f + hysteresis)));
+
+	if (!m_pMeshRenderer)
+		m_pMeshRenderer = GetOwner()->GetComponent<MeshRendererComponent>();
+
+	if (m_pMeshRenderer && (level != m_CurrentLevel || m_pMeshRenderer->GetMesh() != m_Levels[level].m_Mesh))
+		m_pMeshRenderer->SetMesh(m_Levels[level].m_Mesh);
+
+	m_CurrentLevel = level;
+	return level;
+}
+
+uint32_t LODComponent::GetCurrentLevel() const
+{
+	return m_CurrentLevel;
+}
+
+uint32_t LODComponent::GetLevelCount() const
+{
+	return static_cast<uint32_t>(m_Levels.size());
+}
+
+const LODComponent::Level& LODComponent::GetLevel(uint32_t level) const
+{
+	assert(level < m_Levels.size());
+	return m_Levels[level];
+}
+
+uint32_t LODComponent::FindLevel(float screenSize) const
+{
+	const uint32_t lastLevel{ static_cast<uint32_t>(m_Levels.size()) - 1 };
+	for (uint32_t level{}; level < lastLevel; ++level)
+	{
+		if (screenSize >= m_Levels[level].m_ScreenSize)
+			return level;
+	}
+
+	return lastLevel;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+
+#include "BaseComponent.h"
+#include "Structs.h"
+
+class MeshRendererComponent;
+
+/**
+ * \brief Mesh detail levels of an object, the scene picks one every frame from the object's projected size and
+ * hands it to the MeshRendererComponent of the same object. Needs a BoundsComponent to be selected.
+ */
+class LODComponent final : public BaseComponent
+{
+public:
+	struct Level
+	{
+		MeshHandle m_Mesh{};
+		float m_ScreenSize{}; // Used while the bounding sphere covers at least this fraction of the screen height
+		uint32_t m_TriangleCount{};
+	};
+
+	LODComponent() noexcept = default;
+	~LODComponent() override = default;
+
+	LODComponent(const LODComponent& other) = delete;
+	LODComponent& operator=(const LODComponent& other) noexcept = delete;
+	LODComponent(LODComponent&& other) = delete;
+	LODComponent& operator=(LODComponent&& other) noexcept = delete;
+
+	void FixedUpdate() override;
+	void Update() override;
+	void LateUpdate() override;
+	void Render() override;
+
+	/**
+	 * \brief Append a level, levels go from the most to the least detailed
+	 * \param screenSize Smallest screen height fraction this level is used at, the last level is used below that too
+	 */
+	void AddLevel(MeshHandle mesh, float screenSize, uint32_t triangleCount);
+
+	/**
+	 * \brief Switch to the level matching the screen size and apply it to the mesh renderer
+	 * \param hysteresis Fraction the size has to drop below a threshold before a coarser level is picked
+	 * \return Selected level
+	 */
+	uint32_t SelectLevel(float screenSize, float hysteresis);
+
+	[[nodiscard]] uint32_t GetCurrentLevel() const;
+	[[nodiscard]] uint32_t GetLevelCount() const;
+	[[nodiscard]] const Level& GetLevel(uint32_t level) const;
+
+private:
+	/* DATA MEMBERS */
+
+	std::vector<Level> m_Levels{};
+	uint32_t m_CurrentLevel{};
+	MeshRendererComponent* m_pMeshRenderer{};
+
+	/* PRIVATE METHODS */
+
+	[[nodiscard]] uint32_t FindLevel(float screenSize) const;
+
+};
@@ -0,0 +1,72 @@
+#include "LODSelector.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "GameSettings.h"
+#include "LODComponent.h"
+
+void LODSelector::BeginFrame(const XMFLOAT4X4& projection, const XMFLOAT3& viewPosition)
+{
+	// _22 maps view space y to [-1, 1], a perspective projection divides it by the distance (w = z)
+	m_ProjectionScale = projection._22;
+	m_IsPerspective = projection._34 != 0.f;
+	m_ViewPosition = viewPosition;
+	m_TriangleCount = 0;
+}
+
+uint32_t LODSelector::Select(LODComponent& lod, const XMFLOAT3& center, float radius)
+{
+	const float screenSize{ GetScreenSize(center, radius) * GetBias() };
+	const uint32_t level{ lod.SelectLevel(screenSize, GameSettings::lodHysteresis) };
+
+	if (level < lod.GetLevelCount())
+		m_TriangleCount += lod.GetLevel(level).m_TriangleCount;
+
+	return level;
+}
+
+void LODSelector::EndFrame()
+{
+	if (GameSettings::lodTriangleBudget == 0 || m_TriangleCount == 0)
+	{
+		m_BudgetBias = 1.f;
+		return;
+	}
+
+	// Triangle counts grow roughly with the screen area, so the bias follows the square root of the error.
+	// Steps are small and a dead band around the budget keeps levels from flickering.
+	const float ratio{ static_cast<float>(GameSettings::lodTriangleBudget) / static_cast<float>(m_TriangleCount) };
+	if (ratio > .95f && ratio < 1.05f)
+		return;
+
+	const float step{ std::clamp(std::sqrt(ratio), .9f, 1.1f) };
+	m_BudgetBias = std::clamp(m_BudgetBias * step, s_MinBudgetBias, s_MaxBudgetBias);
+}
+
+float LODSelector::GetScreenSize(const XMFLOAT3& center, float radius) const
+{
+	if (!m_IsPerspective)
+		return radius * m_ProjectionScale;
+
+	const float dx{ center.x - m_ViewPosition.x };
+	const float dy{ center.y - m_ViewPosition.y };
+	const float dz{ center.z - m_ViewPosition.z };
+	const float distance{ std::sqrt(dx * dx + dy * dy + dz * dz) };
+
+	// Inside the sphere it covers the whole screen
+	if (distance <= radius)
+		return 1.f;
+
+	return radius * m_ProjectionScale / distance;
+}
+
+float LODSelector::GetBias() const
+{
+	return GameSettings::lodBias * m_BudgetBias;
+}
+
+uint32_t LODSelector::GetTriangleCount() const
+{
+	return m_TriangleCount;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+
+class LODComponent;
+
+/**
+ * \brief Per-frame level of detail selection from the projected size of bounding spheres.
+ * The screen size is the fraction of the screen height covered by the sphere, scaled by GameSettings::lodBias.
+ * With a triangle budget set, an extra bias factor is retuned every frame to bring the selected triangle count
+ * towards the budget.
+ */
+class LODSelector final
+{
+public:
+	LODSelector() noexcept = default;
+	~LODSelector() = default;
+
+	LODSelector(const LODSelector& other) noexcept = delete;
+	LODSelector& operator=(const LODSelector& other) noexcept = delete;
+	LODSelector(LODSelector&& other) noexcept = delete;
+	LODSelector& operator=(LODSelector&& other) noexcept = delete;
+
+	/**
+	 * \param projection Camera projection, perspective or orthographic
+	 * \param viewPosition Camera world position
+	 */
+	void BeginFrame(const XMFLOAT4X4& projection, const XMFLOAT3& viewPosition);
+	/**
+	 * \brief Select the level of an object from its world space bounding sphere
+	 * \return Selected level
+	 */
+	uint32_t Select(LODComponent& lod, const XMFLOAT3& center, float radius);
+	/**
+	 * \brief Retune the budget bias from the triangles selected this frame
+	 */
+	void EndFrame();
+
+	/**
+	 * \brief
+	 * \return Fraction of the screen height covered by the sphere, before any bias
+	 */
+	[[nodiscard]] float GetScreenSize(const XMFLOAT3& center, float radius) const;
+	/**
+	 * \brief
+	 * \return Global bias combined with the triangle budget bias
+	 */
+	[[nodiscard]] float GetBias() const;
+	[[nodiscard]] uint32_t GetTriangleCount() const;
+
+	inline static constexpr float s_MinBudgetBias{ 1.f / 16.f };
+	inline static constexpr float s_MaxBudgetBias{ 16.f };
+
+private:
+	/* DATA MEMBERS */
+
+	float m_ProjectionScale{}; // Screen height fraction per world unit of radius at distance 1
+	bool m_IsPerspective{ true };
+	XMFLOAT3 m_ViewPosition{};
+
+	float m_BudgetBias{ 1.f };
+	uint32_t m_TriangleCount{};
+
+	/* PRIVATE METHODS */
+
+};
@@ -0,0 +1,208 @@
+#include "LZ4.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	// Limits of the format, the last sequence is literals only and the decoder relies on both
+	constexpr size_t s_MinMatch{ 4 };
+	constexpr size_t s_LastLiterals{ 5 }; // The last five bytes are always literals
+	constexpr size_t s_MatchFindLimit{ 12 }; // The last match starts at least twelve bytes before the end
+
+	constexpr uint32_t s_HashLog{ 14 };
+
+	[[nodiscard]] uint32_t Read32(const uint8_t* pData)
+	{
+		uint32_t value;
+		std::memcpy(&value, pData, sizeof(value));
+		return value;
+	}
+
+	[[nodiscard]] uint32_t HashSequence(uint32_t sequence)
+	{
+		return (sequence * 2654435761u) >> (32 - s_HashLog);
+	}
+
+	/**
+	 * \brief Lengths of 15 and more continue in extra bytes, 255 meaning another byte follows
+	 */
+	void WriteLength(uint8_t*& pOutput, size_t length)
+	{
+		for (; length >= 255; length -= 255)
+			*pOutput++ = 255;
+		*pOutput++ = static_cast<uint8_t>(length);
+	}
+
+	[[nodiscard]] bool ReadLength(const uint8_t*& pInput, const uint8_t* pInputEnd, size_t& length)
+	{
+		uint8_t value;
+		do
+		{
+			if (pInput == pInputEnd)
+				return false;
+
+			value = *pInput++;
+			length += value;
+		} while (value == 255);
+
+		return true;
+	}
+
+	/**
+	 * \return False if the sequence does not fit before pOutputEnd
+	 */
+	[[nodiscard]] bool WriteSequence(uint8_t*& pOutput, const uint8_t* pOutputEnd, const uint8_t* pLiterals, size_t literalCount,
+		size_t offset, size_t matchLength)
+	{
+		// Token, literal length bytes, literals, offset and match length bytes, matchLength 0 for the last sequence
+		const size_t worstSize{ 1 + literalCount / 255 + 1 + literalCount + 2 + matchLength / 255 + 1 };
+		if (worstSize > static_cast<size_t>(pOutputEnd - pOutput))
+			return false;
+
+		uint8_t* pToken{ pOutput++ };
+		*pToken = static_cast<uint8_t>(std::min<size_t>(literalCount, 15) << 4);
+		if (literalCount >= 15)
+			WriteLength(pOutput, literalCount - 15);
+
+		std::memcpy(pOutput, pLiterals, literalCount);
+		pOutput += literalCount;
+
+		if (matchLength == 0)
+			return true;
+
+		*pOutput++ = static_cast<uint8_t>(offset);
+		*pOutput++ = static_cast<uint8_t>(offset >> 8);
+
+		const size_t lengthCode{ matchLength - s_MinMatch };
+		*pToken |= static_cast<uint8_t>(std::min<size_t>(lengthCode, 15));
+		if (lengthCode >= 15)
+			WriteLength(pOutput, lengthCode - 15);
+
+		return true;
+	}
+}
+
+size_t LZ4::GetMaxCompressedSize(size_t size)
+{
+	return size + size / 255 + 16;
+}
+
+size_t LZ4::Compress(const void* pSource, size_t sourceSize, void* pDestination, size_t destinationCapacity)
+{
+	const auto pInput = static_cast<const uint8_t*>(pSource);
+	const auto pOutputStart = static_cast<uint8_t*>(pDestination);
+	uint8_t* pOutput{ pOutputStart };
+	const uint8_t* pOutputEnd{ pOutputStart + destinationCapacity };
+
+	size_t anchor{};
+	if (sourceSize > s_MatchFindLimit)
+	{
+		// Positions of the last sequence seen with each hash, 0 is harmless since it is never before the current one
+		std::vector<uint32_t> table(size_t{ 1 } << s_HashLog);
+
+		const size_t matchFindEnd{ sourceSize - s_MatchFindLimit };
+		const size_t matchEnd{ sourceSize - s_LastLiterals };
+
+		size_t position{ 1 };
+		while (position < matchFindEnd)
+		{
+			const uint32_t sequence{ Read32(pInput + position) };
+			uint32_t& entry{ table[HashSequence(sequence)] };
+			size_t candidate{ entry };
+			entry = static_cast<uint32_t>(position);
+
+			if (candidate >= position || position - candidate > s_MaxOffset || Read32(pInput + candidate) != sequence)
+			{
+				// Skip faster through data that does not compress
+				position += 1 + ((position - anchor) >> 6);
+				continue;
+			}
+
+			while (position > anchor && candidate > 0 && pInput[position - 1] == pInput[candidate - 1])
+			{
+				--position;
+				--candidate;
+			}
+
+			size_t matchLength{ s_MinMatch };
+			while (position + matchLength < matchEnd && pInput[position + matchLength] == pInput[candidate + matchLength])
+				++matchLength;
+
+			if (!WriteSequence(pOutput, pOutputEnd, pInput + anchor, position - anchor, position - candidate, matchLength))
+				return 0;
+
+			position += matchLength;
+			anchor = position;
+
+			// Lets the next match start inside this one
+			if (position - 2 < matchFindEnd)
+				table[HashSequence(Read32(pInput + position - 2))] = static_cast<uint32_t>(position - 2);
+		}
+	}
+
+	if (!WriteSequence(pOutput, pOutputEnd, pInput + anchor, sourceSize - anchor, 0, 0))
+		return 0;
+
+	return static_cast<size_t>(pOutput - pOutputStart);
+}
+
+bool LZ4::Decompress(const void* pSource, size_t sourceSize, void* pDestination, size_t destinationSize)
+{
+	const auto pInputStart = static_cast<const uint8_t*>(pSource);
+	const uint8_t* pInput{ pInputStart };
+	const uint8_t* pInputEnd{ pInputStart + sourceSize };
+	const auto pOutputStart = static_cast<uint8_t*>(pDestination);
+	uint8_t* pOutput{ pOutputStart };
+	const uint8_t* pOutputEnd{ pOutputStart + destinationSize };
+
+	while (pInput < pInputEnd)
+	{
+		const uint8_t token{ *pInput++ };
+
+		size_t literalCount{ static_cast<size_t>(token >> 4) };
+		if (literalCount == 15 && !ReadLength(pInput, pInputEnd, literalCount))
+			return false;
+		if (literalCount > static_cast<size_t>(pInputEnd - pInput) || literalCount > static_cast<size_t>(pOutputEnd - pOutput))
+			return false;
+
+		std::memcpy(pOutput, pInput, literalCount);
+		pInput += literalCount;
+		pOutput += literalCount;
+
+		// The last sequence has no match
+		if (pInput == pInputEnd)
+			break;
+
+		if (pInputEnd - pInput < 2)
+			return false;
+		const size_t offset{ static_cast<size_t>(pInput[0]) | static_cast<size_t>(pInput[1]) << 8 };
+		pInput += 2;
+		if (offset == 0 || offset > static_cast<size_t>(pOutput - pOutputStart))
+			return false;
+
+		size_t matchLength{ static_cast<size_t>(token & 15) };
+		if (matchLength == 15 && !ReadLength(pInput, pInputEnd, matchLength))
+			return false;
+		matchLength += s_MinMatch;
+		if (matchLength > static_cast<size_t>(pOutputEnd - pOutput))
+			return false;
+
+		const uint8_t* pMatch{ pOutput - offset };
+		if (offset >= matchLength)
+		{
+			std::memcpy(pOutput, pMatch, matchLength);
+			pOutput += matchLength;
+		}
+		else
+		{
+			// Overlapping, repeats the last offset bytes
+			for (size_t i{}; i < matchLength; ++i)
+				*pOutput++ = pMatch[i];
+		}
+	}
+
+	return pOutput == pOutputEnd;
+}
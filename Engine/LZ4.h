@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * \brief Compressor and decompressor for the LZ4 block format, the raw sequences without the frame around them.
+ * Output is compatible with the reference implementation. The compressor favours speed with a single hash probe per
+ * position, decompression checks every bound so corrupted input fails instead of overrunning.
+ * Only depends on the standard library so offline tools can build it without the engine.
+ */
+class LZ4 final
+{
+public:
+	/**
+	 * \return Destination size guaranteeing Compress succeeds
+	 */
+	[[nodiscard]] static size_t GetMaxCompressedSize(size_t size);
+
+	/**
+	 * \return Compressed size, 0 if it does not fit in destinationCapacity
+	 */
+	[[nodiscard]] static size_t Compress(const void* pSource, size_t sourceSize, void* pDestination, size_t destinationCapacity);
+
+	/**
+	 * \param destinationSize Exact uncompressed size, stored by the caller next to the compressed data
+	 * \return False if the data is corrupted or does not decompress to exactly destinationSize bytes
+	 */
+	[[nodiscard]] static bool Decompress(const void* pSource, size_t sourceSize, void* pDestination, size_t destinationSize);
+
+	inline static constexpr size_t s_MaxOffset{ 65535 }; // Matches are found in the last 64 KiB
+};
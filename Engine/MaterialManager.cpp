@@ -1,2 +1,182 @@
 #include "MaterialManager.h"
 
+#include <cassert>
+
+void MaterialManager::DestroyTemplate(MaterialTemplateHandle handle)
+{
+	const Template* pFound{ FindTemplate(handle) };
+	if (!pFound)
+		return;
+
+	Template& materialTemplate{ m_Templates[handle.m_Index] };
+	assert(materialTemplate.m_InstanceCount == 0 && "Destroy the instances of a template before the template");
+
+	materialTemplate.m_pMaterial.reset();
+	materialTemplate.m_Parameters = {};
+	materialTemplate.m_FreeParameters = {};
+	++materialTemplate.m_Generation;
+
+	m_FreeTemplates.emplace_back(handle.m_Index);
+	--m_TemplateCount;
+}
+
+BaseMaterial* MaterialManager::GetTemplate(MaterialTemplateHandle handle) const
+{
+	const Template* pTemplate{ FindTemplate(handle) };
+	return pTemplate ? pTemplate->m_pMaterial.get() : nullptr;
+}
+
+MaterialInstanceHandle MaterialManager::CreateInstance(MaterialTemplateHandle templateHandle)
+{
+	if (!FindTemplate(templateHandle))
+		return {};
+
+	Template& materialTemplate{ m_Templates[templateHandle.m_Index] };
+
+	uint32_t parameterIndex;
+	if (!materialTemplate.m_FreeParameters.empty())
+	{
+		parameterIndex = materialTemplate.m_FreeParameters.back();
+		materialTemplate.m_FreeParameters.pop_back();
+		materialTemplate.m_Parameters[parameterIndex] = materialTemplate.m_pMaterial->GetInstanceColor();
+	}
+	else
+	{
+		parameterIndex = static_cast<uint32_t>(materialTemplate.m_Parameters.size());
+		materialTemplate.m_Parameters.emplace_back(materialTemplate.m_pMaterial->GetInstanceColor());
+	}
+	++materialTemplate.m_InstanceCount;
+
+	uint32_t index;
+	if (!m_FreeInstances.empty())
+	{
+		index = m_FreeInstances.back();
+		m_FreeInstances.pop_back();
+	}
+	else
+	{
+		index = static_cast<uint32_t>(m_Instances.size());
+		m_Instances.emplace_back();
+	}
+
+	Instance& instance{ m_Instances[index] };
+	instance.m_Template = templateHandle.m_Index;
+	instance.m_ParameterIndex = parameterIndex;
+	instance.m_IsAlive = true;
+	++m_InstanceCount;
+
+	return MaterialInstanceHandle{ index, instance.m_Generation };
+}
+
+void MaterialManager::DestroyInstance(MaterialInstanceHandle handle)
+{
+	if (!FindInstance(handle))
+		return;
+
+	Instance& instance{ m_Instances[handle.m_Index] };
+	Template& materialTemplate{ m_Templates[instance.m_Template] };
+	materialTemplate.m_FreeParameters.emplace_back(instance.m_ParameterIndex);
+	--materialTemplate.m_InstanceCount;
+
+	instance.m_IsAlive = false;
+	++instance.m_Generation;
+
+	m_FreeInstances.emplace_back(handle.m_Index);
+	--m_InstanceCount;
+}
+
+bool MaterialManager::IsAlive(MaterialInstanceHandle handle) const
+{
+	return FindInstance(handle) != nullptr;
+}
+
+void MaterialManager::SetParameters(MaterialInstanceHandle handle, const Parameters& parameters)
+{
+	const Instance* pInstance{ FindInstance(handle) };
+	if (!pInstance)
+		return;
+
+	m_Templates[pInstance->m_Template].m_Parameters[pInstance->m_ParameterIndex] = parameters;
+}
+
+const MaterialManager::Parameters& MaterialManager::GetParameters(MaterialInstanceHandle handle) const
+{
+	const Instance* pInstance{ FindInstance(handle) };
+	assert(pInstance);
+
+	return m_Templates[pInstance->m_Template].m_Parameters[pInstance->m_ParameterIndex];
+}
+
+BaseMaterial* MaterialManager::GetInstanceTemplate(MaterialInstanceHandle handle) const
+{
+	const Instance* pInstance{ FindInstance(handle) };
+	return pInstance ? m_Templates[pInstance->m_Template].m_pMaterial.get() : nullptr;
+}
+
+uint32_t MaterialManager::GetParameterIndex(MaterialInstanceHandle handle) const
+{
+	const Instance* pInstance{ FindInstance(handle) };
+	assert(pInstance);
+
+	return pInstance->m_ParameterIndex;
+}
+
+const std::vector<MaterialManager::Parameters>& MaterialManager::GetPackedParameters(MaterialTemplateHandle handle) const
+{
+	const Template* pTemplate{ FindTemplate(handle) };
+	assert(pTemplate);
+
+	return pTemplate->m_Parameters;
+}
+
+uint32_t MaterialManager::GetTemplateCount() const
+{
+	return m_TemplateCount;
+}
+
+uint32_t MaterialManager::GetInstanceCount() const
+{
+	return m_InstanceCount;
+}
+
+MaterialTemplateHandle MaterialManager::AddTemplate(std::unique_ptr<BaseMaterial> pMaterial)
+{
+	// Instance parameters only reach the shaders through the instance data of instanced draws
+	assert(pMaterial->SupportsInstancing());
+
+	uint32_t index;
+	if (!m_FreeTemplates.empty())
+	{
+		index = m_FreeTemplates.back();
+		m_FreeTemplates.pop_back();
+	}
+	else
+	{
+		index = static_cast<uint32_t>(m_Templates.size());
+		m_Templates.emplace_back();
+	}
+
+	Template& materialTemplate{ m_Templates[index] };
+	materialTemplate.m_pMaterial = std::move(pMaterial);
+	++m_TemplateCount;
+
+	return MaterialTemplateHandle{ index, materialTemplate.m_Generation };
+}
+
+const MaterialManager::Template* MaterialManager::FindTemplate(MaterialTemplateHandle handle) const
+{
+	if (handle.m_Index >= m_Templates.size())
+		return nullptr;
+
+	const Template& materialTemplate{ m_Templates[handle.m_Index] };
+	return materialTemplate.m_pMaterial && materialTemplate.m_Generation == handle.m_Generation ? &materialTemplate : nullptr;
+}
+
+const MaterialManager::Instance* MaterialManager::FindInstance(MaterialInstanceHandle handle) const
+{
+	if (handle.m_Index >= m_Instances.size())
+		return nullptr;
+
+	const Instance& instance{ m_Instances[handle.m_Index] };
+	return instance.m_IsAlive && instance.m_Generation == handle.m_Generation ? &instance : nullptr;
+}
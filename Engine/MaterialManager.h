@@ -1,10 +1,26 @@
 #pragma once
 
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "BaseMaterial.h"
 #include "Singleton.h"
+#include "Structs.h"
 
-class MaterialManager : public Singleton<MaterialManager>
+/**
+ * \brief Owns material templates and their instances.
+ * A template is a material holding the shaders and pipeline state, created once. An instance is only a parameter
+ * block of its template: the blocks of every instance of a template are packed in one array and a draw refers to
+ * its block by index, so creating an instance costs memory and no graphics API call. Draws of instances sharing a
+ * template and a mesh are merged into one instanced draw whatever their parameters.
+ * Not thread safe, create and destroy on the main thread.
+ */
+class MaterialManager final : public Singleton<MaterialManager>
 {
 public:
+	using Parameters = XMFLOAT4; // Per instance data of the instanced shaders
+
 	~MaterialManager() override = default;
 
 	MaterialManager(const MaterialManager& other) = delete;
@@ -12,18 +28,87 @@ public:
 	MaterialManager(MaterialManager&& other) = delete;
 	MaterialManager& operator=(MaterialManager&& other) noexcept = delete;
 
+	/**
+	 * \brief Creates the shared material, its instance color becomes the default parameters of new instances
+	 * \tparam MaterialType Material supporting instancing
+	 */
 	template <typename MaterialType>
-	UINT32 CreateMaterial()
+	[[nodiscard]] MaterialTemplateHandle CreateTemplate()
 	{
-		return 0;
+		static_assert(std::is_base_of_v<BaseMaterial, MaterialType>, "Templates must be materials");
+		return AddTemplate(std::make_unique<MaterialType>());
 	}
+	/**
+	 * \brief Every instance of the template must have been destroyed
+	 */
+	void DestroyTemplate(MaterialTemplateHandle handle);
+	/**
+	 * \brief
+	 * \return nullptr if the handle is stale
+	 */
+	[[nodiscard]] BaseMaterial* GetTemplate(MaterialTemplateHandle handle) const;
 
-protected:
-	MaterialManager() noexcept = default;
+	[[nodiscard]] MaterialInstanceHandle CreateInstance(MaterialTemplateHandle templateHandle);
+	void DestroyInstance(MaterialInstanceHandle handle);
+	[[nodiscard]] bool IsAlive(MaterialInstanceHandle handle) const;
+
+	void SetParameters(MaterialInstanceHandle handle, const Parameters& parameters);
+	[[nodiscard]] const Parameters& GetParameters(MaterialInstanceHandle handle) const;
+	/**
+	 * \brief
+	 * \return Template of the instance, nullptr if the handle is stale
+	 */
+	[[nodiscard]] BaseMaterial* GetInstanceTemplate(MaterialInstanceHandle handle) const;
+	/**
+	 * \brief
+	 * \return Index of the instance's parameter block in the packed parameters of its template
+	 */
+	[[nodiscard]] uint32_t GetParameterIndex(MaterialInstanceHandle handle) const;
+	/**
+	 * \brief
+	 * \return Parameter blocks of every instance of the template, including unused slots
+	 */
+	[[nodiscard]] const std::vector<Parameters>& GetPackedParameters(MaterialTemplateHandle handle) const;
+
+	[[nodiscard]] uint32_t GetTemplateCount() const;
+	[[nodiscard]] uint32_t GetInstanceCount() const;
 
 private:
+	friend class Singleton<MaterialManager>;
+	MaterialManager() noexcept = default;
+
+	/* NESTED CLASSES */
+
+	struct Template
+	{
+		std::unique_ptr<BaseMaterial> m_pMaterial{}; // nullptr once destroyed
+		std::vector<Parameters> m_Parameters{};
+		std::vector<uint32_t> m_FreeParameters{};
+		uint32_t m_InstanceCount{};
+		uint32_t m_Generation{};
+	};
+
+	struct Instance
+	{
+		uint32_t m_Template{};
+		uint32_t m_ParameterIndex{};
+		uint32_t m_Generation{};
+		bool m_IsAlive{};
+	};
+
 	/* DATA MEMBERS */
 
+	std::vector<Template> m_Templates{};
+	std::vector<uint32_t> m_FreeTemplates{};
+	std::vector<Instance> m_Instances{};
+	std::vector<uint32_t> m_FreeInstances{};
+	uint32_t m_TemplateCount{};
+	uint32_t m_InstanceCount{};
+
 	/* PRIVATE METHODS */
-	
-};
\ No newline at end of file
+
+	[[nodiscard]] MaterialTemplateHandle AddTemplate(std::unique_ptr<BaseMaterial> pMaterial);
+	[[nodiscard]] const Template* FindTemplate(MaterialTemplateHandle handle) const;
+	[[nodiscard]] const Instance* FindInstance(MaterialInstanceHandle handle) const;
+
+};
@@ -0,0 +1,422 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t s_InvalidVertex{ 0xFFFFFFFFu };
+
+	/**
+	 * \brief Triangles around each vertex, in compressed rows
+	 */
+	struct Adjacency
+	{
+		std::vector<uint32_t> m_Offsets{}; // vertexCount + 1
+		std::vector<uint32_t> m_Triangles{};
+	};
+
+	Adjacency BuildAdjacency(const uint32_t* pIndices, uint32_t indexCount, uint32_t vertexCount)
+	{
+		Adjacency adjacency{};
+		adjacency.m_Offsets.assign(static_cast<size_t>(vertexCount) + 1, 0);
+		adjacency.m_Triangles.resize(indexCount);
+
+		for (uint32_t i{}; i < indexCount; ++i)
+			++adjacency.m_Offsets[pIndices[i] + 1];
+
+		std::partial_sum(adjacency.m_Offsets.begin(), adjacency.m_Offsets.end(), adjacency.m_Offsets.begin());
+
+		std::vector<uint32_t> fill{ adjacency.m_Offsets.begin(), adjacency.m_Offsets.end() - 1 };
+		for (uint32_t i{}; i < indexCount; ++i)
+			adjacency.m_Triangles[fill[pIndices[i]]++] = i / 3;
+
+		return adjacency;
+	}
+
+	const float* GetPosition(const float* pPositions, uint32_t positionStride, uint32_t vertex)
+	{
+		return reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(pPositions) + static_cast<size_t>(vertex) * positionStride);
+	}
+
+	int16_t ToSnorm16(float value)
+	{
+		return static_cast<int16_t>(std::lround(std::clamp(value, -1.f, 1.f) * 32767.f));
+	}
+}
+
+MeshOptimizer::VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const uint32_t* pIndices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize)
+{
+	VertexCacheStats stats{};
+	if (indexCount == 0)
+		return stats;
+
+	// A vertex is cached while fewer than cacheSize misses happened since it was inserted, hits do not refresh a FIFO
+	std::vector<uint32_t> insertedAt(vertexCount, 0);
+	std::vector<bool> isReferenced(vertexCount, false);
+	uint32_t time{ cacheSize + 1 };
+	uint32_t referencedCount{};
+
+	for (uint32_t i{}; i < indexCount; ++i)
+	{
+		const uint32_t vertex{ pIndices[i] };
+		if (time - insertedAt[vertex] > cacheSize)
+		{
+			insertedAt[vertex] = time++;
+			++stats.m_TransformedCount;
+		}
+
+		if (!isReferenced[vertex])
+		{
+			isReferenced[vertex] = true;
+			++referencedCount;
+		}
+	}
+
+	stats.m_ACMR = static_cast<float>(stats.m_TransformedCount) / static_cast<float>(indexCount / 3);
+	stats.m_ATVR = static_cast<float>(stats.m_TransformedCount) / static_cast<float>(referencedCount);
+	return stats;
+}
+
+uint32_t MeshOptimizer::OptimizeVertexCache(uint32_t* pDestination, const uint32_t* pIndices, uint32_t indexCount, uint32_t vertexCount,
+	uint32_t cacheSize, uint32_t* pClusters)
+{
+	if (indexCount == 0)
+		return 0;
+
+	// Copied first, the destination may be the source
+	const std::vector<uint32_t> indices{ pIndices, pIndices + indexCount };
+	const Adjacency adjacency{ BuildAdjacency(indices.data(), indexCount, vertexCount) };
+
+	std::vector<uint32_t> liveCount(vertexCount);
+	for (uint32_t v{}; v < vertexCount; ++v)
+		liveCount[v] = adjacency.m_Offsets[v + 1] - adjacency.m_Offsets[v];
+
+	std::vector<uint32_t> cachedAt(vertexCount, 0);
+	std::vector<bool> isEmitted(indexCount / 3, false);
+	std::vector<uint32_t> deadEnds{};
+	std::vector<uint32_t> candidates{};
+	uint32_t time{ cacheSize + 1 };
+	uint32_t cursor{};
+	uint32_t emittedCount{};
+	uint32_t clusterCount{ 1 };
+
+	// Recently referenced vertices first, then any vertex with triangles left
+	const auto skipDeadEnd = [&]() -> uint32_t
+	{
+		while (!deadEnds.empty())
+		{
+			const uint32_t vertex{ deadEnds.back() };
+			deadEnds.pop_back();
+			if (liveCount[vertex] > 0)
+				return vertex;
+		}
+
+		for (; cursor < vertexCount; ++cursor)
+			if (liveCount[cursor] > 0)
+				return cursor;
+
+		return s_InvalidVertex;
+	};
+
+	uint32_t fanning{ skipDeadEnd() };
+	if (pClusters)
+		pClusters[0] = 0;
+
+	while (fanning != s_InvalidVertex)
+	{
+		candidates.clear();
+
+		for (uint32_t a{ adjacency.m_Offsets[fanning] }; a < adjacency.m_Offsets[fanning + 1]; ++a)
+		{
+			const uint32_t triangle{ adjacency.m_Triangles[a] };
+			if (isEmitted[triangle])
+				continue;
+
+			for (uint32_t k{}; k < 3; ++k)
+			{
+				const uint32_t vertex{ indices[triangle * 3 + k] };
+				deadEnds.emplace_back(vertex);
+				candidates.emplace_back(vertex);
+				--liveCount[vertex];
+
+				if (time - cachedAt[vertex] > cacheSize)
+					cachedAt[vertex] = time++;
+			}
+
+			isEmitted[triangle] = true;
+			memcpy(pDestination + static_cast<size_t>(emittedCount) * 3, indices.data() + static_cast<size_t>(triangle) * 3, 3 * sizeof(uint32_t));
+			++emittedCount;
+		}
+
+		// Best candidate is the oldest vertex still cached once all its remaining triangles are emitted
+		uint32_t next{ s_InvalidVertex };
+		int64_t bestPriority{ -1 };
+		for (const uint32_t vertex : candidates)
+		{
+			if (liveCount[vertex] == 0)
+				continue;
+
+			int64_t priority{};
+			if (time - cachedAt[vertex] + 2 * liveCount[vertex] <= cacheSize)
+				priority = time - cachedAt[vertex];
+
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				next = vertex;
+			}
+		}
+
+		if (next == s_InvalidVertex)
+		{
+			next = skipDeadEnd();
+
+			// Restarting away from the last fan starts a new cluster
+			if (next != s_InvalidVertex)
+			{
+				if (pClusters)
+					pClusters[clusterCount] = emittedCount;
+				++clusterCount;
+			}
+		}
+
+		fanning = next;
+	}
+
+	return clusterCount;
+}
+
+void MeshOptimizer::OptimizeOverdraw(uint32_t* pDestination, const uint32_t* pIndices, uint32_t indexCount, const float* pPositions, uint32_t positionStride,
+	uint32_t vertexCount, float threshold, uint32_t cacheSize)
+{
+	const uint32_t triangleCount{ indexCount / 3 };
+	if (triangleCount == 0)
+		return;
+
+	// Hard boundaries are where Tipsify restarted, reordering clusters there costs nothing
+	std::vector<uint32_t> indices(indexCount);
+	std::vector<uint32_t> hardClusters(triangleCount);
+	const uint32_t hardClusterCount{ OptimizeVertexCache(indices.data(), pIndices, indexCount, vertexCount, cacheSize, hardClusters.data()) };
+	hardClusters.resize(hardClusterCount);
+	hardClusters.emplace_back(triangleCount);
+
+	// Soft boundaries split a hard cluster as soon as its own ACMR, with a cold cache, is within the threshold of the mesh's
+	const float maxACMR{ AnalyzeVertexCache(indices.data(), indexCount, vertexCount, cacheSize).m_ACMR * threshold };
+
+	std::vector<uint32_t> clusters{};
+	std::vector<uint32_t> insertedAt(vertexCount, 0);
+	uint32_t time{ cacheSize + 1 };
+
+	for (uint32_t c{}; c < hardClusterCount; ++c)
+	{
+		const uint32_t end{ hardClusters[c + 1] };
+		uint32_t start{ hardClusters[c] };
+		uint32_t transformedCount{};
+		clusters.emplace_back(start);
+
+		for (uint32_t triangle{ start }; triangle < end; ++triangle)
+		{
+			for (uint32_t k{}; k < 3; ++k)
+			{
+				const uint32_t vertex{ indices[triangle * 3 + k] };
+				if (time - insertedAt[vertex] > cacheSize)
+				{
+					insertedAt[vertex] = time++;
+					++transformedCount;
+				}
+			}
+
+			if (triangle + 1 < end && static_cast<float>(transformedCount) <= maxACMR * static_cast<float>(triangle + 1 - start))
+			{
+				start = triangle + 1;
+				transformedCount = 0;
+				clusters.emplace_back(start);
+
+				// Empties the simulated cache
+				time += cacheSize + 1;
+			}
+		}
+
+		time += cacheSize + 1;
+	}
+
+	const auto clusterCount = static_cast<uint32_t>(clusters.size());
+	clusters.emplace_back(triangleCount);
+
+	// Area weighted centroid and normal of every cluster
+	struct ClusterInfo
+	{
+		float m_Centroid[3]{};
+		float m_Normal[3]{};
+		float m_Area{};
+		float m_SortKey{};
+	};
+
+	std::vector<ClusterInfo> infos(clusterCount);
+	float meshCentroid[3]{};
+	float meshArea{};
+
+	for (uint32_t c{}; c < clusterCount; ++c)
+	{
+		ClusterInfo& info{ infos[c] };
+		for (uint32_t triangle{ clusters[c] }; triangle < clusters[c + 1]; ++triangle)
+		{
+			const float* p0{ GetPosition(pPositions, positionStride, indices[triangle * 3]) };
+			const float* p1{ GetPosition(pPositions, positionStride, indices[triangle * 3 + 1]) };
+			const float* p2{ GetPosition(pPositions, positionStride, indices[triangle * 3 + 2]) };
+
+			const float e1[3]{ p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+			const float e2[3]{ p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+			const float normal[3]{ e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+			const float area{ std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]) };
+
+			for (uint32_t axis{}; axis < 3; ++axis)
+			{
+				info.m_Centroid[axis] += (p0[axis] + p1[axis] + p2[axis]) / 3.f * area;
+				info.m_Normal[axis] += normal[axis];
+			}
+			info.m_Area += area;
+		}
+
+		for (uint32_t axis{}; axis < 3; ++axis)
+			meshCentroid[axis] += info.m_Centroid[axis];
+		meshArea += info.m_Area;
+
+		if (info.m_Area > 0.f)
+			for (float& value : info.m_Centroid)
+				value /= info.m_Area;
+	}
+
+	if (meshArea > 0.f)
+		for (float& value : meshCentroid)
+			value /= meshArea;
+
+	// Clusters facing away from the center of the mesh are the likeliest to occlude the others, they go first
+	for (ClusterInfo& info : infos)
+	{
+		const float length{ std::sqrt(info.m_Normal[0] * info.m_Normal[0] + info.m_Normal[1] * info.m_Normal[1] + info.m_Normal[2] * info.m_Normal[2]) };
+		if (length == 0.f)
+			continue;
+
+		for (uint32_t axis{}; axis < 3; ++axis)
+			info.m_SortKey += (info.m_Centroid[axis] - meshCentroid[axis]) * info.m_Normal[axis] / length;
+	}
+
+	std::vector<uint32_t> order(clusterCount);
+	std::iota(order.begin(), order.end(), 0u);
+	std::stable_sort(order.begin(), order.end(), [&infos](uint32_t a, uint32_t b) { return infos[a].m_SortKey > infos[b].m_SortKey; });
+
+	uint32_t* pOutput{ pDestination };
+	for (const uint32_t c : order)
+	{
+		const size_t count{ static_cast<size_t>(clusters[c + 1] - clusters[c]) * 3 };
+		memcpy(pOutput, indices.data() + static_cast<size_t>(clusters[c]) * 3, count * sizeof(uint32_t));
+		pOutput += count;
+	}
+}
+
+uint32_t MeshOptimizer::OptimizeVertexFetch(void* pDestination, uint32_t* pIndices, uint32_t indexCount, const void* pVertices, uint32_t vertexCount, uint32_t vertexStride)
+{
+	std::vector<uint32_t> remap(vertexCount, s_InvalidVertex);
+	uint32_t nextVertex{};
+
+	for (uint32_t i{}; i < indexCount; ++i)
+	{
+		uint32_t& newIndex{ remap[pIndices[i]] };
+		if (newIndex == s_InvalidVertex)
+		{
+			newIndex = nextVertex++;
+			memcpy(static_cast<uint8_t*>(pDestination) + static_cast<size_t>(newIndex) * vertexStride,
+				static_cast<const uint8_t*>(pVertices) + static_cast<size_t>(pIndices[i]) * vertexStride, vertexStride);
+		}
+
+		pIndices[i] = newIndex;
+	}
+
+	return nextVertex;
+}
+
+void MeshOptimizer::QuantizePositions(uint16_t* pDestination, const float* pPositions, uint32_t positionStride, uint32_t vertexCount, float scale[3], float offset[3])
+{
+	float min[3]{}, max[3]{};
+	if (vertexCount > 0)
+	{
+		const float* pFirst{ GetPosition(pPositions, positionStride, 0) };
+		std::copy(pFirst, pFirst + 3, min);
+		std::copy(pFirst, pFirst + 3, max);
+	}
+
+	for (uint32_t v{ 1 }; v < vertexCount; ++v)
+	{
+		const float* pPosition{ GetPosition(pPositions, positionStride, v) };
+		for (uint32_t axis{}; axis < 3; ++axis)
+		{
+			min[axis] = std::min(min[axis], pPosition[axis]);
+			max[axis] = std::max(max[axis], pPosition[axis]);
+		}
+	}
+
+	constexpr float maxValue{ 65535.f };
+	float encodeScale[3]{};
+	for (uint32_t axis{}; axis < 3; ++axis)
+	{
+		const float extent{ max[axis] - min[axis] };
+		scale[axis] = extent / maxValue;
+		offset[axis] = min[axis];
+		encodeScale[axis] = extent > 0.f ? maxValue / extent : 0.f;
+	}
+
+	for (uint32_t v{}; v < vertexCount; ++v)
+	{
+		const float* pPosition{ GetPosition(pPositions, positionStride, v) };
+		uint16_t* pQuantized{ pDestination + static_cast<size_t>(v) * 4 };
+
+		for (uint32_t axis{}; axis < 3; ++axis)
+			pQuantized[axis] = static_cast<uint16_t>(std::lround(std::clamp((pPosition[axis] - min[axis]) * encodeScale[axis], 0.f, maxValue)));
+		pQuantized[3] = 0;
+	}
+}
+
+void MeshOptimizer::EncodeOctahedralNormals(int16_t* pDestination, const float* pNormals, uint32_t normalStride, uint32_t vertexCount)
+{
+	for (uint32_t v{}; v < vertexCount; ++v)
+	{
+		const float* pNormal{ GetPosition(pNormals, normalStride, v) };
+
+		// Projected on the octahedron |x| + |y| + |z| = 1, the lower half is folded over the diagonals
+		const float length{ std::abs(pNormal[0]) + std::abs(pNormal[1]) + std::abs(pNormal[2]) };
+		float x{ length > 0.f ? pNormal[0] / length : 0.f };
+		float y{ length > 0.f ? pNormal[1] / length : 0.f };
+
+		if (pNormal[2] < 0.f)
+		{
+			const float foldedX{ (1.f - std::abs(y)) * (x >= 0.f ? 1.f : -1.f) };
+			const float foldedY{ (1.f - std::abs(x)) * (y >= 0.f ? 1.f : -1.f) };
+			x = foldedX;
+			y = foldedY;
+		}
+
+		pDestination[static_cast<size_t>(v) * 2] = ToSnorm16(x);
+		pDestination[static_cast<size_t>(v) * 2 + 1] = ToSnorm16(y);
+	}
+}
+
+void MeshOptimizer::DecodeOctahedralNormal(const int16_t encoded[2], float normal[3])
+{
+	float x{ std::max(encoded[0] / 32767.f, -1.f) };
+	float y{ std::max(encoded[1] / 32767.f, -1.f) };
+	const float z{ 1.f - std::abs(x) - std::abs(y) };
+
+	const float fold{ std::max(-z, 0.f) };
+	x += x >= 0.f ? -fold : fold;
+	y += y >= 0.f ? -fold : fold;
+
+	const float length{ std::sqrt(x * x + y * y + z * z) };
+	normal[0] = x / length;
+	normal[1] = y / length;
+	normal[2] = z / length;
+}
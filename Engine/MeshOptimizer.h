@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * \brief Import-time processing of indexed triangle lists, meant to run once per mesh before it reaches the renderer.
+ * The usual order is OptimizeVertexCache, OptimizeOverdraw, OptimizeVertexFetch, then quantization of the attributes.
+ * Only depends on the standard library so offline tools can build it without the engine.
+ */
+class MeshOptimizer final
+{
+public:
+	struct VertexCacheStats
+	{
+		uint32_t m_TransformedCount{}; // Cache misses, each one runs the vertex shader
+		float m_ACMR{}; // Average cache miss ratio, transformed vertices per triangle, 0.5 at best for large grids
+		float m_ATVR{}; // Average transform to vertex ratio, 1 is optimal
+	};
+
+	/**
+	 * \brief Simulates a FIFO post-transform cache of the given size
+	 */
+	[[nodiscard]] static VertexCacheStats AnalyzeVertexCache(const uint32_t* pIndices, uint32_t indexCount, uint32_t vertexCount, uint32_t cacheSize = s_DefaultCacheSize);
+
+	/**
+	 * \brief Reorders the triangles for the post-transform cache with Tipsify (Sander et al. 2007)
+	 * \param pDestination indexCount indices, may be pIndices
+	 * \param pClusters Optional, receives the first triangle of every cluster, a new one starts each time the algorithm
+	 * has to restart away from the last fan. Room for indexCount / 3 values.
+	 * \return Number of clusters
+	 */
+	static uint32_t OptimizeVertexCache(uint32_t* pDestination, const uint32_t* pIndices, uint32_t indexCount, uint32_t vertexCount,
+		uint32_t cacheSize = s_DefaultCacheSize, uint32_t* pClusters = nullptr);
+
+	/**
+	 * \brief Cache optimizes the triangles, splits them into clusters and sorts those so outward facing clusters are
+	 * drawn first, which lets them occlude the rest of the mesh (Sander et al. 2007). Replaces OptimizeVertexCache.
+	 * \param pDestination indexCount indices, may be pIndices
+	 * \param pPositions Three floats per vertex, positionStride bytes apart
+	 * \param threshold Largest ACMR degradation accepted, 1.05 allows 5% more transformed vertices
+	 */
+	static void OptimizeOverdraw(uint32_t* pDestination, const uint32_t* pIndices, uint32_t indexCount, const float* pPositions, uint32_t positionStride,
+		uint32_t vertexCount, float threshold = 1.05f, uint32_t cacheSize = s_DefaultCacheSize);
+
+	/**
+	 * \brief Reorders the vertices in the order the indices first reference them, dropping unreferenced ones.
+	 * \param pDestination Room for vertexCount vertices, must not overlap pVertices
+	 * \param pIndices Remapped in place
+	 * \return Number of vertices written
+	 */
+	static uint32_t OptimizeVertexFetch(void* pDestination, uint32_t* pIndices, uint32_t indexCount, const void* pVertices, uint32_t vertexCount, uint32_t vertexStride);
+
+	/**
+	 * \brief Quantizes positions to 16-bit unsigned normalized coordinates over their bounds.
+	 * The shader decodes them with position = quantized * scale + offset.
+	 * \param pDestination Four values per vertex, the last one is padding so the vertex stays 8 byte aligned
+	 * \param pPositions Three floats per vertex, positionStride bytes apart
+	 * \param scale Receives the three dequantization scales
+	 * \param offset Receives the three dequantization offsets, the minimum of the bounds
+	 */
+	static void QuantizePositions(uint16_t* pDestination, const float* pPositions, uint32_t positionStride, uint32_t vertexCount, float scale[3], float offset[3]);
+
+	/**
+	 * \brief Octahedral encoding of unit vectors to two 16-bit signed normalized values
+	 * \param pDestination Two values per vertex
+	 * \param pNormals Three floats per vertex, normalStride bytes apart, normalized
+	 */
+	static void EncodeOctahedralNormals(int16_t* pDestination, const float* pNormals, uint32_t normalStride, uint32_t vertexCount);
+	static void DecodeOctahedralNormal(const int16_t encoded[2], float normal[3]);
+
+	inline static constexpr uint32_t s_DefaultCacheSize{ 16 };
+};
@@ -0,0 +1,71 @@
+#include "MeshRendererComponent.h"
+
+#include "GameObject.h"
+#include "Renderer.h"
+
+
+void MeshRendererComponent::FixedUpdate()
+{
+}
+
+void MeshRendererComponent::Update()
+{
+}
+
+void MeshRendererComponent::LateUpdate()
+{
+}
+
+void MeshRendererComponent::Render()
+{
+	if (!m_Mesh.IsValid())
+		return;
+
+	// Only records a draw packet, the renderer sorts and submits them after the scene is done
+	if (m_MaterialInstance.IsValid())
+		Renderer::Get().Draw(m_Mesh, m_MaterialInstance, GetOwner()->GetWorldTransform().GetTransform(), m_Layer);
+	else if (m_pMaterial)
+		Renderer::Get().Draw(m_Mesh, m_pMaterial, GetOwner()->GetWorldTransform().GetTransform(), m_Layer);
+}
+
+void MeshRendererComponent::SetMesh(MeshHandle mesh)
+{
+	m_Mesh = mesh;
+}
+
+void MeshRendererComponent::SetMaterial(BaseMaterial* pMaterial)
+{
+	m_pMaterial = pMaterial;
+	m_MaterialInstance = {};
+}
+
+void MeshRendererComponent::SetMaterial(MaterialInstanceHandle material)
+{
+	m_pMaterial = nullptr;
+	m_MaterialInstance = material;
+}
+
+void MeshRendererComponent::SetLayer(uint8_t layer)
+{
+	m_Layer = layer;
+}
+
+MeshHandle MeshRendererComponent::GetMesh() const
+{
+	return m_Mesh;
+}
+
+BaseMaterial* MeshRendererComponent::GetMaterial() const
+{
+	return m_pMaterial;
+}
+
+MaterialInstanceHandle MeshRendererComponent::GetMaterialInstance() const
+{
+	return m_MaterialInstance;
+}
+
+uint8_t MeshRendererComponent::GetLayer() const
+{
+	return m_Layer;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "BaseComponent.h"
+#include "Structs.h"
+
+class BaseMaterial;
+
+class MeshRendererComponent final : public BaseComponent
+{
+public:
+	MeshRendererComponent() noexcept = default;
+	~MeshRendererComponent() override = default;
+
+	MeshRendererComponent(const MeshRendererComponent& other) = delete;
+	MeshRendererComponent& operator=(const MeshRendererComponent& other) noexcept = delete;
+	MeshRendererComponent(MeshRendererComponent&& other) = delete;
+	MeshRendererComponent& operator=(MeshRendererComponent&& other) noexcept = delete;
+
+	void FixedUpdate() override;
+	void Update() override;
+	void LateUpdate() override;
+	void Render() override;
+
+	void SetMesh(MeshHandle mesh);
+	void SetMaterial(BaseMaterial* pMaterial);
+	/**
+	 * \brief Draw with an instance of a MaterialManager template instead of a material of its own
+	 */
+	void SetMaterial(MaterialInstanceHandle material);
+	/**
+	 * \brief Set render layer
+	 * \param layer Lower layers are drawn first
+	 */
+	void SetLayer(uint8_t layer);
+
+	[[nodiscard]] MeshHandle GetMesh() const;
+	[[nodiscard]] BaseMaterial* GetMaterial() const;
+	[[nodiscard]] MaterialInstanceHandle GetMaterialInstance() const;
+	[[nodiscard]] uint8_t GetLayer() const;
+
+private:
+	/* DATA MEMBERS */
+
+	MeshHandle m_Mesh{};
+	BaseMaterial* m_pMaterial{};
+	MaterialInstanceHandle m_MaterialInstance{};
+	uint8_t m_Layer{};
+
+	/* PRIVATE METHODS */
+
+};
@@ -0,0 +1,58 @@
+#include "OccluderComponent.h"
+
+
+void OccluderComponent::FixedUpdate()
+{
+}
+
+void OccluderComponent::Update()
+{
+}
+
+void OccluderComponent::LateUpdate()
+{
+}
+
+void OccluderComponent::Render()
+{
+}
+
+void OccluderComponent::SetMesh(const XMFLOAT3* pPositions, uint32_t vertexCount, const uint32_t* pIndices, uint32_t indexCount)
+{
+	m_Positions.assign(pPositions, pPositions + vertexCount);
+	m_Indices.assign(pIndices, pIndices + indexCount);
+}
+
+void OccluderComponent::SetBox(const XMFLOAT3& center, const XMFLOAT3& extents)
+{
+	// Corner i has the max x, y and z for bits 0, 1 and 2
+	XMFLOAT3 corners[8]{};
+	for (uint32_t i{}; i < 8; ++i)
+	{
+		corners[i] = {
+			center.x + (i & 1 ? extents.x : -extents.x),
+			center.y + (i & 2 ? extents.y : -extents.y),
+			center.z + (i & 4 ? extents.z : -extents.z) };
+	}
+
+	constexpr uint32_t indices[]{
+		0, 6, 2, 0, 4, 6, // -x
+		1, 3, 7, 1, 7, 5, // +x
+		0, 1, 5, 0, 5, 4, // -y
+		2, 7, 3, 2, 6, 7, // +y
+		0, 3, 1, 0, 2, 3, // -z
+		4, 5, 7, 4, 7, 6  // +z
+	};
+
+	SetMesh(corners, 8, indices, static_cast<uint32_t>(std::size(indices)));
+}
+
+const std::vector<XMFLOAT3>& OccluderComponent::GetPositions() const
+{
+	return m_Positions;
+}
+
+const std::vector<uint32_t>& OccluderComponent::GetIndices() const
+{
+	return m_Indices;
+}
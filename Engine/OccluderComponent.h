@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+
+#include "BaseComponent.h"
+
+/**
+ * \brief Simplified geometry hiding other objects in the software occlusion pass.
+ * It must stay inside the rendered mesh since anything behind it is culled, and the object needs a BoundsComponent
+ * so the frustum culling pass hands it over to the occlusion pass.
+ */
+class OccluderComponent final : public BaseComponent
+{
+public:
+	OccluderComponent() noexcept = default;
+	~OccluderComponent() override = default;
+
+	OccluderComponent(const OccluderComponent& other) = delete;
+	OccluderComponent& operator=(const OccluderComponent& other) noexcept = delete;
+	OccluderComponent(OccluderComponent&& other) = delete;
+	OccluderComponent& operator=(OccluderComponent&& other) noexcept = delete;
+
+	void FixedUpdate() override;
+	void Update() override;
+	void LateUpdate() override;
+	void Render() override;
+
+	/**
+	 * \brief Copy an occluder mesh
+	 * \param pPositions Local space positions
+	 * \param pIndices Triangle list, clockwise front faces
+	 */
+	void SetMesh(const XMFLOAT3* pPositions, uint32_t vertexCount, const uint32_t* pIndices, uint32_t indexCount);
+	/**
+	 * \brief Use a box as occluder
+	 * \param center Local space center
+	 * \param extents Local space half size
+	 */
+	void SetBox(const XMFLOAT3& center, const XMFLOAT3& extents);
+
+	[[nodiscard]] const std::vector<XMFLOAT3>& GetPositions() const;
+	[[nodiscard]] const std::vector<uint32_t>& GetIndices() const;
+
+private:
+	/* DATA MEMBERS */
+
+	std::vector<XMFLOAT3> m_Positions{};
+	std::vector<uint32_t> m_Indices{};
+
+	/* PRIVATE METHODS */
+
+};
@@ -0,0 +1,416 @@
+#include "OcclusionCuller.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include <emmintrin.h>
+
+#include "JobSystem.h"
+
+static_assert(OcclusionCuller::s_TileSize % OcclusionCuller::s_BlockSize == 0, "Tiles must be made of whole blocks");
+
+namespace
+{
+	constexpr float g_MinClipW{ 1e-5f };
+
+	float GetMilliseconds(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+void OcclusionCuller::Resize(uint32_t width, uint32_t height)
+{
+	m_Width = width;
+	m_Height = height;
+	m_Pitch = (width + s_BlockSize - 1) & ~(s_BlockSize - 1);
+	m_TileCountX = (width + s_TileSize - 1) / s_TileSize;
+	m_TileCountY = (height + s_TileSize - 1) / s_TileSize;
+	m_BlockCountX = (width + s_BlockSize - 1) / s_BlockSize;
+	m_BlockCountY = (height + s_BlockSize - 1) / s_BlockSize;
+
+	m_pDepthBuffer = std::make_unique<float[]>(static_cast<size_t>(m_Pitch) * height);
+	m_pBlockMaxDepth = std::make_unique<float[]>(static_cast<size_t>(m_BlockCountX) * m_BlockCountY);
+
+	m_Bins.clear();
+	m_Bins.resize(static_cast<size_t>(m_TileCountX) * m_TileCountY);
+}
+
+void OcclusionCuller::BeginFrame(const XMFLOAT4X4& viewProjection)
+{
+	m_ViewProjection = viewProjection;
+	m_Stats = {};
+
+	std::fill_n(m_pDepthBuffer.get(), static_cast<size_t>(m_Pitch) * m_Height, 1.f);
+	std::fill_n(m_pBlockMaxDepth.get(), static_cast<size_t>(m_BlockCountX) * m_BlockCountY, 1.f);
+}
+
+void OcclusionCuller::AddOccluder(const XMFLOAT3* pPositions, uint32_t vertexCount, const uint32_t* pIndices, uint32_t indexCount, const XMFLOAT4X4& world)
+{
+	const XMMATRIX worldViewProjection{ XMMatrixMultiply(XMLoadFloat4x4(&world), XMLoadFloat4x4(&m_ViewProjection)) };
+
+	++m_Stats.m_OccluderCount;
+	for (uint32_t i{}; i + 2 < indexCount; i += 3)
+	{
+		if (pIndices[i] >= vertexCount || pIndices[i + 1] >= vertexCount || pIndices[i + 2] >= vertexCount)
+			continue;
+
+		Triangle triangle{};
+		for (uint32_t v{}; v < 3; ++v)
+			XMStoreFloat4(&triangle.m_Positions[v], XMVector3Transform(XMLoadFloat3(&pPositions[pIndices[i + v]]), worldViewProjection));
+
+		m_Triangles.emplace_back(triangle);
+		++m_Stats.m_OccluderTriangleCount;
+	}
+}
+
+void OcclusionCuller::RasterizeOccluders()
+{
+	const auto start{ std::chrono::steady_clock::now() };
+
+	if (!m_Bins.empty() && !m_Triangles.empty())
+	{
+		SetupTriangles();
+		BinTriangles();
+
+		JobSystem::Get().ParallelFor(static_cast<uint32_t>(m_Bins.size()), [this](uint32_t tileIndex)
+		{
+			RasterizeTile(tileIndex);
+			UpdateBlockMaxDepth(tileIndex);
+		});
+	}
+
+	m_Triangles.clear();
+	m_Setups.clear();
+	for (std::vector<uint32_t>& bin : m_Bins)
+		bin.clear();
+
+	m_Stats.m_RasterizeMilliseconds = GetMilliseconds(start);
+}
+
+void OcclusionCuller::TestOccludees(const AABB* pBoxes, uint32_t count, uint8_t* pIsVisible)
+{
+	const auto start{ std::chrono::steady_clock::now() };
+
+	const uint32_t jobCount{ (count + s_OccludeesPerJob - 1) / s_OccludeesPerJob };
+	JobSystem::Get().ParallelFor(jobCount, [&](uint32_t job)
+	{
+		const uint32_t last{ std::min(count, (job + 1) * s_OccludeesPerJob) };
+		for (uint32_t i{ job * s_OccludeesPerJob }; i < last; ++i)
+			pIsVisible[i] = IsVisible(pBoxes[i]) ? 1 : 0;
+	});
+
+	m_Stats.m_TestedCount += count;
+	m_Stats.m_CulledCount += static_cast<uint32_t>(std::count(pIsVisible, pIsVisible + count, uint8_t{ 0 }));
+	m_Stats.m_TestMilliseconds += GetMilliseconds(start);
+}
+
+bool OcclusionCuller::IsVisible(const AABB& box) const
+{
+	if (m_Bins.empty())
+		return true;
+
+	const XMMATRIX viewProjection{ XMLoadFloat4x4(&m_ViewProjection) };
+
+	// Screen rectangle and nearest depth of the projected corners
+	float minX{ static_cast<float>(m_Width) }, minY{ static_cast<float>(m_Height) }, maxX{ 0.f }, maxY{ 0.f };
+	float minZ{ 1.f };
+	for (uint32_t corner{}; corner < 8; ++corner)
+	{
+		const XMVECTOR position{ XMVectorSet(
+			corner & 1 ? box.m_Max.x : box.m_Min.x,
+			corner & 2 ? box.m_Max.y : box.m_Min.y,
+			corner & 4 ? box.m_Max.z : box.m_Min.z, 1.f) };
+
+		XMFLOAT4 clip{};
+		XMStoreFloat4(&clip, XMVector4Transform(position, viewProjection));
+
+		// Crossing the near plane, the camera is inside or right in front of it
+		if (clip.w <= g_MinClipW)
+			return true;
+
+		const float invW{ 1.f / clip.w };
+		const float x{ (clip.x * invW + 1.f) * .5f * static_cast<float>(m_Width) };
+		const float y{ (1.f - clip.y * invW) * .5f * static_cast<float>(m_Height) };
+		minX = std::min(minX, x);
+		maxX = std::max(maxX, x);
+		minY = std::min(minY, y);
+		maxY = std::max(maxY, y);
+		minZ = std::min(minZ, clip.z * invW);
+	}
+
+	// Every pixel the rectangle touches, frustum culling is left to the caller
+	const int firstX{ static_cast<int>(std::clamp(std::floor(minX), 0.f, static_cast<float>(m_Width - 1))) };
+	const int firstY{ static_cast<int>(std::clamp(std::floor(minY), 0.f, static_cast<float>(m_Height - 1))) };
+	const int lastX{ static_cast<int>(std::clamp(std::floor(maxX), 0.f, static_cast<float>(m_Width - 1))) };
+	const int lastY{ static_cast<int>(std::clamp(std::floor(maxY), 0.f, static_cast<float>(m_Height - 1))) };
+
+	for (int blockY{ firstY / static_cast<int>(s_BlockSize) }; blockY <= lastY / static_cast<int>(s_BlockSize); ++blockY)
+	{
+		for (int blockX{ firstX / static_cast<int>(s_BlockSize) }; blockX <= lastX / static_cast<int>(s_BlockSize); ++blockX)
+		{
+			// The whole block has occluders in front of the box
+			if (m_pBlockMaxDepth[static_cast<size_t>(blockY) * m_BlockCountX + blockX] < minZ)
+				continue;
+
+			const int pixelMinX{ std::max(firstX, blockX * static_cast<int>(s_BlockSize)) };
+			const int pixelMaxX{ std::min(lastX, (blockX + 1) * static_cast<int>(s_BlockSize) - 1) };
+			const int pixelMinY{ std::max(firstY, blockY * static_cast<int>(s_BlockSize)) };
+			const int pixelMaxY{ std::min(lastY, (blockY + 1) * static_cast<int>(s_BlockSize) - 1) };
+			for (int y{ pixelMinY }; y <= pixelMaxY; ++y)
+			{
+				const float* pDepthRow{ m_pDepthBuffer.get() + static_cast<size_t>(y) * m_Pitch };
+				for (int x{ pixelMinX }; x <= pixelMaxX; ++x)
+				{
+					if (pDepthRow[x] >= minZ)
+						return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
+
+const OcclusionCuller::Stats& OcclusionCuller::GetStats() const
+{
+	return m_Stats;
+}
+
+const float* OcclusionCuller::GetDepthBuffer() const
+{
+	return m_pDepthBuffer.get();
+}
+
+uint32_t OcclusionCuller::GetWidth() const
+{
+	return m_Width;
+}
+
+uint32_t OcclusionCuller::GetHeight() const
+{
+	return m_Height;
+}
+
+uint32_t OcclusionCuller::GetPitch() const
+{
+	return m_Pitch;
+}
+
+void OcclusionCuller::SetupTriangles()
+{
+	m_Setups.reserve(m_Triangles.size());
+
+	const __m128 halfWidth{ _mm_set1_ps(static_cast<float>(m_Width) * .5f) };
+	const __m128 halfHeight{ _mm_set1_ps(static_cast<float>(m_Height) * .5f) };
+	const __m128 minW{ _mm_set1_ps(g_MinClipW) };
+	const __m128 zero{ _mm_setzero_ps() };
+
+	// Four triangles per iteration, one per SSE lane
+	for (size_t first{}; first < m_Triangles.size(); first += 4)
+	{
+		const size_t laneCount{ std::min<size_t>(4, m_Triangles.size() - first) };
+
+		alignas(16) float clip[3][4][4]{}; // [vertex][component][lane]
+		for (size_t lane{}; lane < 4; ++lane)
+		{
+			// Unused lanes repeat the last triangle and are ignored
+			const Triangle& triangle{ m_Triangles[first + std::min(lane, laneCount - 1)] };
+			for (int v{}; v < 3; ++v)
+			{
+				clip[v][0][lane] = triangle.m_Positions[v].x;
+				clip[v][1][lane] = triangle.m_Positions[v].y;
+				clip[v][2][lane] = triangle.m_Positions[v].z;
+				clip[v][3][lane] = triangle.m_Positions[v].w;
+			}
+		}
+
+		__m128 x[3], y[3], z[3];
+		__m128 isVisible{ _mm_castsi128_ps(_mm_set1_epi32(-1)) };
+		for (int v{}; v < 3; ++v)
+		{
+			const __m128 w{ _mm_load_ps(clip[v][3]) };
+			isVisible = _mm_and_ps(isVisible, _mm_cmpgt_ps(w, minW)); // Dropping an occluder is always conservative
+
+			const __m128 invW{ _mm_div_ps(_mm_set1_ps(1.f), w) };
+			x[v] = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_load_ps(clip[v][0]), invW), _mm_set1_ps(1.f)), halfWidth);
+			y[v] = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(1.f), _mm_mul_ps(_mm_load_ps(clip[v][1]), invW)), halfHeight);
+			z[v] = _mm_mul_ps(_mm_load_ps(clip[v][2]), invW);
+		}
+
+		// Edge i is opposite to vertex i, E(p) = A * p.x + B * p.y + C
+		__m128 a[3], b[3], c[3];
+		for (int e{}; e < 3; ++e)
+		{
+			const int from{ (e + 1) % 3 };
+			const int to{ (e + 2) % 3 };
+			a[e] = _mm_sub_ps(y[from], y[to]);
+			b[e] = _mm_sub_ps(x[to], x[from]);
+			c[e] = _mm_sub_ps(_mm_mul_ps(x[from], y[to]), _mm_mul_ps(x[to], y[from]));
+		}
+
+		// Back faces are hidden by the front faces of a closed occluder
+		const __m128 area{ _mm_add_ps(_mm_add_ps(_mm_mul_ps(a[0], x[0]), _mm_mul_ps(b[0], y[0])), c[0]) };
+		isVisible = _mm_and_ps(isVisible, _mm_cmpgt_ps(area, zero));
+		const __m128 invArea{ _mm_div_ps(_mm_set1_ps(1.f), area) };
+
+		alignas(16) float laneArea[4], laneMinX[4], laneMinY[4], laneMaxX[4], laneMaxY[4];
+		alignas(16) float laneA[3][4], laneB[3][4], laneC[3][4], laneZ[3][4];
+		_mm_store_ps(laneArea, _mm_and_ps(area, isVisible));
+		_mm_store_ps(laneMinX, _mm_min_ps(_mm_min_ps(x[0], x[1]), x[2]));
+		_mm_store_ps(laneMinY, _mm_min_ps(_mm_min_ps(y[0], y[1]), y[2]));
+		_mm_store_ps(laneMaxX, _mm_max_ps(_mm_max_ps(x[0], x[1]), x[2]));
+		_mm_store_ps(laneMaxY, _mm_max_ps(_mm_max_ps(y[0], y[1]), y[2]));
+		for (int i{}; i < 3; ++i)
+		{
+			_mm_store_ps(laneA[i], a[i]);
+			_mm_store_ps(laneB[i], b[i]);
+			_mm_store_ps(laneC[i], c[i]);
+			_mm_store_ps(laneZ[i], _mm_mul_ps(z[i], invArea));
+		}
+
+		for (size_t lane{}; lane < laneCount; ++lane)
+		{
+			if (!(laneArea[lane] > 0.f))
+				continue;
+
+			const float width{ static_cast<float>(m_Width) };
+			const float height{ static_cast<float>(m_Height) };
+
+			TriangleSetup setup{};
+			setup.m_MinX = static_cast<int>(std::ceil(std::clamp(laneMinX[lane] - .5f, 0.f, width)));
+			setup.m_MinY = static_cast<int>(std::ceil(std::clamp(laneMinY[lane] - .5f, 0.f, height)));
+			setup.m_MaxX = static_cast<int>(std::floor(std::clamp(laneMaxX[lane] - .5f, -1.f, width - 1.f)));
+			setup.m_MaxY = static_cast<int>(std::floor(std::clamp(laneMaxY[lane] - .5f, -1.f, height - 1.f)));
+			if (setup.m_MinX > setup.m_MaxX || setup.m_MinY > setup.m_MaxY)
+				continue;
+
+			for (int i{}; i < 3; ++i)
+			{
+				setup.m_EdgeA[i] = laneA[i][lane];
+				setup.m_EdgeB[i] = laneB[i][lane];
+				setup.m_EdgeC[i] = laneC[i][lane];
+				setup.m_Z[i] = laneZ[i][lane];
+			}
+
+			m_Setups.emplace_back(setup);
+		}
+	}
+}
+
+void OcclusionCuller::BinTriangles()
+{
+	for (uint32_t setupIndex{}; setupIndex < static_cast<uint32_t>(m_Setups.size()); ++setupIndex)
+	{
+		const TriangleSetup& setup{ m_Setups[setupIndex] };
+		const uint32_t firstTileX{ static_cast<uint32_t>(setup.m_MinX) / s_TileSize };
+		const uint32_t firstTileY{ static_cast<uint32_t>(setup.m_MinY) / s_TileSize };
+		const uint32_t lastTileX{ static_cast<uint32_t>(setup.m_MaxX) / s_TileSize };
+		const uint32_t lastTileY{ static_cast<uint32_t>(setup.m_MaxY) / s_TileSize };
+
+		for (uint32_t tileY{ firstTileY }; tileY <= lastTileY; ++tileY)
+		{
+			for (uint32_t tileX{ firstTileX }; tileX <= lastTileX; ++tileX)
+				m_Bins[tileY * m_TileCountX + tileX].emplace_back(setupIndex);
+		}
+	}
+}
+
+void OcclusionCuller::RasterizeTile(uint32_t tileIndex)
+{
+	const int tileMinX{ static_cast<int>(tileIndex % m_TileCountX * s_TileSize) };
+	const int tileMinY{ static_cast<int>(tileIndex / m_TileCountX * s_TileSize) };
+	const int tileMaxX{ std::min(tileMinX + static_cast<int>(s_TileSize), static_cast<int>(m_Width)) - 1 };
+	const int tileMaxY{ std::min(tileMinY + static_cast<int>(s_TileSize), static_cast<int>(m_Height)) - 1 };
+
+	const __m128 laneOffsets{ _mm_set_ps(3.5f, 2.5f, 1.5f, .5f) };
+	const __m128i laneIndices{ _mm_set_epi32(3, 2, 1, 0) };
+	const __m128 zero{ _mm_setzero_ps() };
+
+	for (const uint32_t setupIndex : m_Bins[tileIndex])
+	{
+		const TriangleSetup& setup{ m_Setups[setupIndex] };
+
+		const int minX{ std::max(setup.m_MinX, tileMinX) };
+		const int minY{ std::max(setup.m_MinY, tileMinY) };
+		const int maxX{ std::min(setup.m_MaxX, tileMaxX) };
+		const int maxY{ std::min(setup.m_MaxY, tileMaxY) };
+
+		__m128 edgeA[3], edgeB[3], edgeC[3], z[3];
+		for (int i{}; i < 3; ++i)
+		{
+			edgeA[i] = _mm_set1_ps(setup.m_EdgeA[i]);
+			edgeB[i] = _mm_set1_ps(setup.m_EdgeB[i]);
+			edgeC[i] = _mm_set1_ps(setup.m_EdgeC[i]);
+			z[i] = _mm_set1_ps(setup.m_Z[i]);
+		}
+
+		const __m128i minXVector{ _mm_set1_epi32(minX) };
+		const __m128i maxXVector{ _mm_set1_epi32(maxX) };
+		const int firstQuadX{ minX & ~3 };
+
+		for (int y{ minY }; y <= maxY; ++y)
+		{
+			const __m128 pixelY{ _mm_set1_ps(static_cast<float>(y) + .5f) };
+			float* pDepthRow{ m_pDepthBuffer.get() + static_cast<size_t>(y) * m_Pitch };
+
+			for (int x{ firstQuadX }; x <= maxX; x += 4)
+			{
+				const __m128 pixelX{ _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets) };
+				const __m128i pixelIndex{ _mm_add_epi32(_mm_set1_epi32(x), laneIndices) };
+
+				__m128 mask{ _mm_castsi128_ps(_mm_andnot_si128(_mm_or_si128(_mm_cmplt_epi32(pixelIndex, minXVector), _mm_cmpgt_epi32(pixelIndex, maxXVector)), _mm_set1_epi32(-1))) };
+
+				// Shared edges may be covered twice, harmless for a depth only min
+				__m128 edge[3];
+				for (int i{}; i < 3; ++i)
+				{
+					edge[i] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(edgeA[i], pixelX), _mm_mul_ps(edgeB[i], pixelY)), edgeC[i]);
+					mask = _mm_and_ps(mask, _mm_cmpge_ps(edge[i], zero));
+				}
+				if (_mm_movemask_ps(mask) == 0)
+					continue;
+
+				// Occluders in front of the near plane never hide anything
+				const __m128 depth{ _mm_add_ps(_mm_add_ps(_mm_mul_ps(edge[0], z[0]), _mm_mul_ps(edge[1], z[1])), _mm_mul_ps(edge[2], z[2])) };
+				mask = _mm_and_ps(mask, _mm_cmpge_ps(depth, zero));
+
+				const __m128 oldDepth{ _mm_loadu_ps(pDepthRow + x) };
+				const __m128 newDepth{ _mm_min_ps(depth, oldDepth) };
+				_mm_storeu_ps(pDepthRow + x, _mm_or_ps(_mm_and_ps(mask, newDepth), _mm_andnot_ps(mask, oldDepth)));
+			}
+		}
+	}
+}
+
+void OcclusionCuller::UpdateBlockMaxDepth(uint32_t tileIndex)
+{
+	if (m_Bins[tileIndex].empty())
+		return;
+
+	// Tiles are made of whole blocks, only the pixels inside the buffer count
+	const uint32_t firstBlockX{ tileIndex % m_TileCountX * (s_TileSize / s_BlockSize) };
+	const uint32_t firstBlockY{ tileIndex / m_TileCountX * (s_TileSize / s_BlockSize) };
+	const uint32_t lastBlockX{ std::min(firstBlockX + s_TileSize / s_BlockSize, m_BlockCountX) };
+	const uint32_t lastBlockY{ std::min(firstBlockY + s_TileSize / s_BlockSize, m_BlockCountY) };
+
+	for (uint32_t blockY{ firstBlockY }; blockY < lastBlockY; ++blockY)
+	{
+		for (uint32_t blockX{ firstBlockX }; blockX < lastBlockX; ++blockX)
+		{
+			const uint32_t maxX{ std::min((blockX + 1) * s_BlockSize, m_Width) };
+			const uint32_t maxY{ std::min((blockY + 1) * s_BlockSize, m_Height) };
+
+			float maxDepth{};
+			for (uint32_t y{ blockY * s_BlockSize }; y < maxY; ++y)
+			{
+				const float* pDepthRow{ m_pDepthBuffer.get() + static_cast<size_t>(y) * m_Pitch };
+				for (uint32_t x{ blockX * s_BlockSize }; x < maxX; ++x)
+					maxDepth = std::max(maxDepth, pDepthRow[x]);
+			}
+
+			m_pBlockMaxDepth[static_cast<size_t>(blockY) * m_BlockCountX + blockX] = maxDepth;
+		}
+	}
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "AABB.h"
+
+/**
+ * \brief CPU occlusion culling against a low resolution depth buffer.
+ * Occluder triangles are set up four at a time with SSE, binned into tiles and rasterized in parallel on the
+ * JobSystem, keeping the closest depth of every pixel. Each 8x8 block also keeps the farthest depth it contains,
+ * so occludees are rejected block by block and only read the pixels of blocks that are not fully in front of them.
+ */
+class OcclusionCuller final
+{
+public:
+	struct Stats
+	{
+		uint32_t m_OccluderCount{};
+		uint32_t m_OccluderTriangleCount{}; // Submitted, before back face and near plane rejection
+		uint32_t m_TestedCount{};
+		uint32_t m_CulledCount{};
+		float m_RasterizeMilliseconds{};
+		float m_TestMilliseconds{};
+	};
+
+	OcclusionCuller() noexcept = default;
+	~OcclusionCuller() = default;
+
+	OcclusionCuller(const OcclusionCuller& other) noexcept = delete;
+	OcclusionCuller& operator=(const OcclusionCuller& other) noexcept = delete;
+	OcclusionCuller(OcclusionCuller&& other) noexcept = delete;
+	OcclusionCuller& operator=(OcclusionCuller&& other) noexcept = delete;
+
+	void Resize(uint32_t width, uint32_t height);
+	/**
+	 * \brief Clear the depth buffer and the stats
+	 * \param viewProjection Used for both the occluders and the occludees of this frame
+	 */
+	void BeginFrame(const XMFLOAT4X4& viewProjection);
+
+	/**
+	 * \brief Buffer an occluder mesh, it must lie inside the object it stands for since everything behind it is hidden
+	 * \param pPositions Object space positions
+	 * \param pIndices Triangle list, clockwise front faces
+	 */
+	void AddOccluder(const XMFLOAT3* pPositions, uint32_t vertexCount, const uint32_t* pIndices, uint32_t indexCount, const XMFLOAT4X4& world);
+	/**
+	 * \brief Rasterizes every buffered occluder, blocks until the depth buffer is complete
+	 */
+	void RasterizeOccluders();
+
+	/**
+	 * \brief Test world space boxes against the rasterized occluders, large batches are split over the JobSystem
+	 * \param pIsVisible Receives 1 for every box that may be visible, 0 for hidden ones
+	 */
+	void TestOccludees(const AABB* pBoxes, uint32_t count, uint8_t* pIsVisible);
+	[[nodiscard]] bool IsVisible(const AABB& box) const;
+
+	[[nodiscard]] const Stats& GetStats() const;
+	[[nodiscard]] const float* GetDepthBuffer() const;
+	[[nodiscard]] uint32_t GetWidth() const;
+	[[nodiscard]] uint32_t GetHeight() const;
+	[[nodiscard]] uint32_t GetPitch() const;
+
+	inline static constexpr uint32_t s_TileSize{ 32 };
+	inline static constexpr uint32_t s_BlockSize{ 8 };
+	inline static constexpr uint32_t s_OccludeesPerJob{ 256 };
+
+private:
+	/* NESTED CLASSES */
+
+	struct Triangle
+	{
+		XMFLOAT4 m_Positions[3]; // Clip space
+	};
+
+	struct TriangleSetup
+	{
+		float m_EdgeA[3]{};
+		float m_EdgeB[3]{};
+		float m_EdgeC[3]{};
+		float m_Z[3]{}; // Divided by the area, weighted by the edge functions
+		int m_MinX{}, m_MinY{}, m_MaxX{}, m_MaxY{};
+	};
+
+	/* DATA MEMBERS */
+
+	uint32_t m_Width{};
+	uint32_t m_Height{};
+	uint32_t m_Pitch{}; // Width rounded up to a whole block
+	uint32_t m_TileCountX{};
+	uint32_t m_TileCountY{};
+	uint32_t m_BlockCountX{};
+	uint32_t m_BlockCountY{};
+
+	std::unique_ptr<float[]> m_pDepthBuffer{};
+	std::unique_ptr<float[]> m_pBlockMaxDepth{};
+
+	XMFLOAT4X4 m_ViewProjection{};
+	Stats m_Stats{};
+
+	std::vector<Triangle> m_Triangles{};
+	std::vector<TriangleSetup> m_Setups{};
+	std::vector<std::vector<uint32_t>> m_Bins{}; // Setup indices per tile
+
+	/* PRIVATE METHODS */
+
+	void SetupTriangles();
+	void BinTriangles();
+	void RasterizeTile(uint32_t tileIndex);
+	void UpdateBlockMaxDepth(uint32_t tileIndex);
+
+};
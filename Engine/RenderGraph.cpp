@@ -0,0 +1,277 @@
+#include "RenderGraph.h"
+
+#include <algorithm>
+#include <cassert>
+
+RenderGraph::PassBuilder::PassBuilder(RenderGraph& graph, uint32_t pass) noexcept
+	: m_Graph{ graph }
+	, m_Pass{ pass }
+{
+}
+
+RenderGraph::ResourceId RenderGraph::PassBuilder::CreateTexture(const std::string& name, const TextureDesc& desc)
+{
+	const ResourceId resource{ static_cast<ResourceId>(m_Graph.m_Resources.size()) };
+	m_Graph.m_Resources.emplace_back(Resource{ name, desc });
+	return Write(resource);
+}
+
+RenderGraph::ResourceId RenderGraph::PassBuilder::Read(ResourceId resource)
+{
+	assert(resource < m_Graph.m_Resources.size());
+
+	std::vector<ResourceId>& reads{ m_Graph.m_Passes[m_Pass].m_Reads };
+	if (std::find(reads.begin(), reads.end(), resource) == reads.end())
+		reads.emplace_back(resource);
+
+	return resource;
+}
+
+RenderGraph::ResourceId RenderGraph::PassBuilder::Write(ResourceId resource)
+{
+	assert(resource < m_Graph.m_Resources.size());
+
+	std::vector<ResourceId>& writes{ m_Graph.m_Passes[m_Pass].m_Writes };
+	if (std::find(writes.begin(), writes.end(), resource) == writes.end())
+	{
+		writes.emplace_back(resource);
+		m_Graph.m_Resources[resource].m_Writers.emplace_back(m_Pass);
+	}
+
+	return resource;
+}
+
+void RenderGraph::PassBuilder::SetSideEffect()
+{
+	m_Graph.m_Passes[m_Pass].m_HasSideEffect = true;
+}
+
+void RenderGraph::Reset()
+{
+	m_Passes.clear();
+	m_Resources.clear();
+	m_ExecutionOrder.clear();
+	m_Stats = {};
+}
+
+RenderGraph::ResourceId RenderGraph::ImportTexture(const std::string& name, const TextureDesc& desc)
+{
+	const ResourceId resource{ static_cast<ResourceId>(m_Resources.size()) };
+	m_Resources.emplace_back(Resource{ name, desc, true });
+	return resource;
+}
+
+void RenderGraph::AddPass(const std::string& name, const std::function<void(PassBuilder&)>& setup, std::function<void()> execute)
+{
+	const uint32_t pass{ static_cast<uint32_t>(m_Passes.size()) };
+	m_Passes.emplace_back(Pass{ name, std::move(execute) });
+
+	PassBuilder builder{ *this, pass };
+	setup(builder);
+}
+
+void RenderGraph::Compile()
+{
+	CullPasses();
+	ComputeLifetimes();
+	AliasTransients();
+}
+
+void RenderGraph::Execute() const
+{
+	for (const uint32_t pass : m_ExecutionOrder)
+	{
+		if (m_Passes[pass].m_Execute)
+			m_Passes[pass].m_Execute();
+	}
+}
+
+const RenderGraph::CompileStats& RenderGraph::GetStats() const
+{
+	return m_Stats;
+}
+
+const std::vector<uint32_t>& RenderGraph::GetExecutionOrder() const
+{
+	return m_ExecutionOrder;
+}
+
+const std::string& RenderGraph::GetPassName(uint32_t pass) const
+{
+	return m_Passes[pass].m_Name;
+}
+
+bool RenderGraph::IsPassCulled(uint32_t pass) const
+{
+	return m_Passes[pass].m_IsCulled;
+}
+
+const RenderGraph::TextureDesc& RenderGraph::GetTextureDesc(ResourceId resource) const
+{
+	return m_Resources[resource].m_Desc;
+}
+
+uint64_t RenderGraph::GetHeapOffset(ResourceId resource) const
+{
+	return m_Resources[resource].m_HeapOffset;
+}
+
+uint64_t RenderGraph::GetHeapSize() const
+{
+	return m_Stats.m_PeakMemory;
+}
+
+uint64_t RenderGraph::GetTextureSize(const TextureDesc& desc)
+{
+	uint64_t bytesPerPixel{};
+	switch (desc.m_Format)
+	{
+	case Format::RGBA8:
+	case Format::R32F:
+	case Format::D32:
+		bytesPerPixel = 4;
+		break;
+	case Format::RGBA16F:
+		bytesPerPixel = 8;
+		break;
+	}
+
+	const uint64_t size{ static_cast<uint64_t>(desc.m_Width) * desc.m_Height * bytesPerPixel };
+	return (size + s_PlacementAlignment - 1) & ~(s_PlacementAlignment - 1);
+}
+
+void RenderGraph::CullPasses()
+{
+	// Reference counting: a pass lives while one of its outputs is read, imported or it has a side effect
+	for (Pass& pass : m_Passes)
+	{
+		pass.m_RefCount = static_cast<uint32_t>(pass.m_Writes.size()) + (pass.m_HasSideEffect ? 1 : 0);
+		pass.m_IsCulled = false;
+	}
+
+	for (Resource& resource : m_Resources)
+		resource.m_RefCount = resource.m_IsImported ? 1 : 0;
+
+	for (const Pass& pass : m_Passes)
+	{
+		for (const ResourceId resource : pass.m_Reads)
+			++m_Resources[resource].m_RefCount;
+	}
+
+	std::vector<ResourceId> unused{};
+	for (ResourceId resource{}; resource < static_cast<ResourceId>(m_Resources.size()); ++resource)
+	{
+		if (m_Resources[resource].m_RefCount == 0)
+			unused.emplace_back(resource);
+	}
+
+	// Passes reading nothing and writing nothing are kept, they can only be there for their side effects
+	while (!unused.empty())
+	{
+		const ResourceId resource{ unused.back() };
+		unused.pop_back();
+
+		for (const uint32_t writer : m_Resources[resource].m_Writers)
+		{
+			Pass& pass{ m_Passes[writer] };
+			if (pass.m_RefCount == 0 || --pass.m_RefCount > 0)
+				continue;
+
+			pass.m_IsCulled = true;
+			for (const ResourceId read : pass.m_Reads)
+			{
+				if (--m_Resources[read].m_RefCount == 0)
+					unused.emplace_back(read);
+			}
+		}
+	}
+
+	m_ExecutionOrder.clear();
+	for (uint32_t pass{}; pass < static_cast<uint32_t>(m_Passes.size()); ++pass)
+	{
+		if (!m_Passes[pass].m_IsCulled)
+			m_ExecutionOrder.emplace_back(pass);
+	}
+
+	m_Stats.m_PassCount = static_cast<uint32_t>(m_Passes.size());
+	m_Stats.m_CulledPassCount = m_Stats.m_PassCount - static_cast<uint32_t>(m_ExecutionOrder.size());
+}
+
+void RenderGraph::ComputeLifetimes()
+{
+	for (Resource& resource : m_Resources)
+	{
+		resource.m_FirstUse = s_InvalidPass;
+		resource.m_LastUse = s_InvalidPass;
+	}
+
+	for (uint32_t position{}; position < static_cast<uint32_t>(m_ExecutionOrder.size()); ++position)
+	{
+		const Pass& pass{ m_Passes[m_ExecutionOrder[position]] };
+
+		const auto use{ [&](ResourceId resourceId)
+		{
+			Resource& resource{ m_Resources[resourceId] };
+			if (resource.m_FirstUse == s_InvalidPass)
+				resource.m_FirstUse = position;
+			resource.m_LastUse = position;
+		} };
+
+		for (const ResourceId resource : pass.m_Reads)
+			use(resource);
+		for (const ResourceId resource : pass.m_Writes)
+			use(resource);
+	}
+}
+
+void RenderGraph::AliasTransients()
+{
+	std::vector<ResourceId> transients{};
+	for (ResourceId resource{}; resource < static_cast<ResourceId>(m_Resources.size()); ++resource)
+	{
+		m_Resources[resource].m_HeapOffset = 0;
+		if (!m_Resources[resource].m_IsImported && m_Resources[resource].m_FirstUse != s_InvalidPass)
+			transients.emplace_back(resource);
+	}
+
+	// Largest first, each texture goes to the lowest offset not overlapping a placed texture that is alive at the same time
+	std::stable_sort(transients.begin(), transients.end(), [this](ResourceId a, ResourceId b)
+	{
+		return GetTextureSize(m_Resources[a].m_Desc) > GetTextureSize(m_Resources[b].m_Desc);
+	});
+
+	m_Stats.m_TransientCount = static_cast<uint32_t>(transients.size());
+	m_Stats.m_TransientMemory = 0;
+	m_Stats.m_PeakMemory = 0;
+
+	std::vector<ResourceId> placed{};
+	std::vector<std::pair<uint64_t, uint64_t>> conflicts{}; // Occupied [begin, end) ranges
+	for (const ResourceId resourceId : transients)
+	{
+		Resource& resource{ m_Resources[resourceId] };
+		const uint64_t size{ GetTextureSize(resource.m_Desc) };
+
+		conflicts.clear();
+		for (const ResourceId otherId : placed)
+		{
+			const Resource& other{ m_Resources[otherId] };
+			if (other.m_FirstUse <= resource.m_LastUse && resource.m_FirstUse <= other.m_LastUse)
+				conflicts.emplace_back(other.m_HeapOffset, other.m_HeapOffset + GetTextureSize(other.m_Desc));
+		}
+		std::sort(conflicts.begin(), conflicts.end());
+
+		uint64_t offset{};
+		for (const auto& [begin, end] : conflicts)
+		{
+			if (offset + size <= begin)
+				break;
+			offset = std::max(offset, end);
+		}
+
+		resource.m_HeapOffset = offset;
+		placed.emplace_back(resourceId);
+
+		m_Stats.m_TransientMemory += size;
+		m_Stats.m_PeakMemory = std::max(m_Stats.m_PeakMemory, offset + size);
+	}
+}
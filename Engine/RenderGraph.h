@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * \brief Frame graph of render passes and the textures flowing between them, independent of the graphics API.
+ * Passes declare what they create, read and write during setup. Compile culls the passes whose results are never
+ * consumed, computes the first and last pass using every transient texture and places transients with disjoint
+ * lifetimes at overlapping offsets of a single heap. Live passes run in declaration order, which always satisfies
+ * the dependencies since a pass can only use the textures declared before it.
+ */
+class RenderGraph final
+{
+public:
+	using ResourceId = uint32_t;
+
+	enum class Format
+	{
+		RGBA8,
+		RGBA16F,
+		R32F,
+		D32
+	};
+
+	struct TextureDesc
+	{
+		uint32_t m_Width{};
+		uint32_t m_Height{};
+		Format m_Format{ Format::RGBA8 };
+	};
+
+	struct CompileStats
+	{
+		uint32_t m_PassCount{};
+		uint32_t m_CulledPassCount{};
+		uint32_t m_TransientCount{}; // Used by live passes
+		uint64_t m_TransientMemory{}; // Sum of the transient sizes, what a graph without aliasing would allocate
+		uint64_t m_PeakMemory{}; // Heap size once lifetimes are aliased
+	};
+
+	/**
+	 * \brief Declares the resource usage of a pass, only valid inside its setup callback
+	 */
+	class PassBuilder final
+	{
+	public:
+		~PassBuilder() = default;
+
+		PassBuilder(const PassBuilder& other) noexcept = delete;
+		PassBuilder& operator=(const PassBuilder& other) noexcept = delete;
+		PassBuilder(PassBuilder&& other) noexcept = delete;
+		PassBuilder& operator=(PassBuilder&& other) noexcept = delete;
+
+		/**
+		 * \brief Declare a transient texture written by this pass, memory is only reserved while it is used
+		 */
+		ResourceId CreateTexture(const std::string& name, const TextureDesc& desc);
+		ResourceId Read(ResourceId resource);
+		ResourceId Write(ResourceId resource);
+		/**
+		 * \brief Keep the pass even if nothing reads its outputs, for passes with effects outside the graph
+		 */
+		void SetSideEffect();
+
+	private:
+		friend class RenderGraph;
+		PassBuilder(RenderGraph& graph, uint32_t pass) noexcept;
+
+		RenderGraph& m_Graph;
+		uint32_t m_Pass;
+	};
+
+	RenderGraph() noexcept = default;
+	~RenderGraph() = default;
+
+	RenderGraph(const RenderGraph& other) noexcept = delete;
+	RenderGraph& operator=(const RenderGraph& other) noexcept = delete;
+	RenderGraph(RenderGraph&& other) noexcept = delete;
+	RenderGraph& operator=(RenderGraph&& other) noexcept = delete;
+
+	/**
+	 * \brief Remove every pass and resource, done at the start of each frame
+	 */
+	void Reset();
+
+	/**
+	 * \brief Register a texture owned outside the graph, like the back buffer. Passes writing it are never culled
+	 */
+	ResourceId ImportTexture(const std::string& name, const TextureDesc& desc);
+	/**
+	 * \param setup Declares the pass resources, called immediately
+	 * \param execute Records the pass, called by Execute if the pass survived culling
+	 */
+	void AddPass(const std::string& name, const std::function<void(PassBuilder&)>& setup, std::function<void()> execute);
+
+	void Compile();
+	/**
+	 * \brief Run the live passes in order, Compile must have been called since the last change
+	 */
+	void Execute() const;
+
+	[[nodiscard]] const CompileStats& GetStats() const;
+	/**
+	 * \brief
+	 * \return Indices of the live passes in execution order
+	 */
+	[[nodiscard]] const std::vector<uint32_t>& GetExecutionOrder() const;
+	[[nodiscard]] const std::string& GetPassName(uint32_t pass) const;
+	[[nodiscard]] bool IsPassCulled(uint32_t pass) const;
+
+	[[nodiscard]] const TextureDesc& GetTextureDesc(ResourceId resource) const;
+	/**
+	 * \brief
+	 * \return Placement of a transient texture in the aliased heap, only meaningful for transients used by live passes
+	 */
+	[[nodiscard]] uint64_t GetHeapOffset(ResourceId resource) const;
+	[[nodiscard]] uint64_t GetHeapSize() const;
+
+	/**
+	 * \brief
+	 * \return Bytes a texture takes in the heap, rounded up to the placement alignment
+	 */
+	[[nodiscard]] static uint64_t GetTextureSize(const TextureDesc& desc);
+
+	inline static constexpr uint64_t s_PlacementAlignment{ 64u * 1024u }; // D3D12 default resource placement alignment
+	inline static constexpr uint32_t s_InvalidPass{ 0xFFFFFFFFu };
+
+private:
+	/* NESTED CLASSES */
+
+	struct Pass
+	{
+		std::string m_Name{};
+		std::function<void()> m_Execute{};
+		std::vector<ResourceId> m_Reads{};
+		std::vector<ResourceId> m_Writes{};
+		bool m_HasSideEffect{};
+		bool m_IsCulled{};
+		uint32_t m_RefCount{}; // Outputs still consumed while culling
+	};
+
+	struct Resource
+	{
+		std::string m_Name{};
+		TextureDesc m_Desc{};
+		bool m_IsImported{};
+		std::vector<uint32_t> m_Writers{};
+		uint32_t m_RefCount{}; // Live readers while culling
+		uint32_t m_FirstUse{ s_InvalidPass }; // Positions in the execution order
+		uint32_t m_LastUse{ s_InvalidPass };
+		uint64_t m_HeapOffset{};
+	};
+
+	/* DATA MEMBERS */
+
+	std::vector<Pass> m_Passes{};
+	std::vector<Resource> m_Resources{};
+	std::vector<uint32_t> m_ExecutionOrder{};
+	CompileStats m_Stats{};
+
+	/* PRIVATE METHODS */
+
+	void CullPasses();
+	void ComputeLifetimes();
+	void AliasTransients();
+
+};
@@ -0,0 +1,129 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <array>
+
+uint64_t SortKey::Make(uint8_t layer, uint32_t materialId, uint32_t meshId, float depth)
+{
+	constexpr float maxDepth{ float((1u << s_DepthBits) - 1) };
+	const uint64_t quantizedDepth{ uint64_t(std::clamp(depth, 0.f, 1.f) * maxDepth) };
+
+	return uint64_t(layer) << s_LayerShift
+		| uint64_t(materialId & ((1u << s_MaterialBits) - 1)) << s_MaterialShift
+		| uint64_t(meshId & ((1u << s_MeshBits) - 1)) << s_MeshShift
+		| quantizedDepth << s_DepthShift;
+}
+
+void RenderCommandBuffer::Draw(uint64_t sortKey, MeshHandle mesh, BaseMaterial* pMaterial, const XMFLOAT4X4& world, MaterialInstanceHandle materialInstance)
+{
+	m_Packets.emplace_back(DrawPacket{ sortKey, mesh, pMaterial, uint32_t(m_Transforms.size()), materialInstance });
+	m_Transforms.emplace_back(world);
+}
+
+void RenderCommandBuffer::Reset()
+{
+	// Keeps the capacity, recording does not allocate once warmed up
+	m_Packets.clear();
+	m_Transforms.clear();
+}
+
+RenderQueue::RenderQueue() noexcept
+{
+	m_pCommandBuffers.emplace_back(std::make_unique<RenderCommandBuffer>());
+}
+
+RenderCommandBuffer& RenderQueue::GetMainCommandBuffer() const
+{
+	return *m_pCommandBuffers[0];
+}
+
+RenderCommandBuffer& RenderQueue::AcquireCommandBuffer()
+{
+	std::lock_guard lock{ m_Mutex };
+
+	if (m_AcquiredCount == m_pCommandBuffers.size())
+		m_pCommandBuffers.emplace_back(std::make_unique<RenderCommandBuffer>());
+
+	return *m_pCommandBuffers[m_AcquiredCount++];
+}
+
+void RenderQueue::Reset()
+{
+	std::lock_guard lock{ m_Mutex };
+
+	for (size_t i{}; i < m_AcquiredCount; ++i)
+		m_pCommandBuffers[i]->Reset();
+
+	m_AcquiredCount = 1;
+	m_SortedPackets.clear();
+	m_Transforms.clear();
+}
+
+void RenderQueue::Sort()
+{
+	m_SortedPackets.clear();
+	m_Transforms.clear();
+
+	for (size_t i{}; i < m_AcquiredCount; ++i)
+	{
+		const auto& commandBuffer = *m_pCommandBuffers[i];
+		const uint32_t transformOffset{ uint32_t(m_Transforms.size()) };
+
+		for (DrawPacket packet : commandBuffer.GetPackets())
+		{
+			packet.m_TransformIndex += transformOffset;
+			m_SortedPackets.emplace_back(packet);
+		}
+		m_Transforms.insert(m_Transforms.end(), commandBuffer.GetTransforms().begin(), commandBuffer.GetTransforms().end());
+	}
+
+	RadixSort();
+}
+
+void RenderQueue::RadixSort()
+{
+	// LSD radix sort, 8 bits per pass, stable so equal keys keep their recording order
+	constexpr uint32_t radixBits{ 8 };
+	constexpr uint32_t bucketCount{ 1u << radixBits };
+	constexpr uint32_t passCount{ 64 / radixBits };
+
+	const size_t count{ m_SortedPackets.size() };
+	if (count < 2)
+		return;
+
+	// All histograms in a single read pass
+	std::array<std::array<uint32_t, bucketCount>, passCount> histograms{};
+	for (const auto& packet : m_SortedPackets)
+		for (uint32_t pass{}; pass < passCount; ++pass)
+			++histograms[pass][(packet.m_SortKey >> (pass * radixBits)) & (bucketCount - 1)];
+
+	m_SortScratch.resize(count);
+	auto* pSource = &m_SortedPackets;
+	auto* pDestination = &m_SortScratch;
+
+	for (uint32_t pass{}; pass < passCount; ++pass)
+	{
+		auto& histogram = histograms[pass];
+		const uint32_t shift{ pass * radixBits };
+
+		// Every key shares this digit, the pass would not move anything
+		if (histogram[((*pSource)[0].m_SortKey >> shift) & (bucketCount - 1)] == count)
+			continue;
+
+		uint32_t offset{};
+		for (auto& bucket : histogram)
+		{
+			const uint32_t bucketSize{ bucket };
+			bucket = offset;
+			offset += bucketSize;
+		}
+
+		for (const auto& packet : *pSource)
+			(*pDestination)[histogram[(packet.m_SortKey >> shift) & (bucketCount - 1)]++] = packet;
+
+		std::swap(pSource, pDestination);
+	}
+
+	if (pSource != &m_SortedPackets)
+		m_SortedPackets.swap(m_SortScratch);
+}
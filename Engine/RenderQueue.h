@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Structs.h"
+
+class BaseMaterial;
+
+/**
+ * \brief 64-bit draw sort key, most significant bits first:
+ * layer (8) | material (20) | mesh (20) | depth (16).
+ * Sorting on it groups draws by layer, then collapses material and mesh changes, then goes front to back.
+ */
+struct SortKey
+{
+	inline static constexpr uint32_t s_LayerBits{ 8 };
+	inline static constexpr uint32_t s_MaterialBits{ 20 };
+	inline static constexpr uint32_t s_MeshBits{ 20 };
+	inline static constexpr uint32_t s_DepthBits{ 16 };
+
+	inline static constexpr uint32_t s_DepthShift{ 0 };
+	inline static constexpr uint32_t s_MeshShift{ s_DepthShift + s_DepthBits };
+	inline static constexpr uint32_t s_MaterialShift{ s_MeshShift + s_MeshBits };
+	inline static constexpr uint32_t s_LayerShift{ s_MaterialShift + s_MaterialBits };
+
+	/**
+	 * \brief 
+	 * \param layer Render layer, lower layers are drawn first
+	 * \param materialId Material sort id, wrapped to 20 bits
+	 * \param meshId Mesh handle index, wrapped to 20 bits
+	 * \param depth Normalized view depth in [0, 1], clamped
+	 * \return Sort key
+	 */
+	[[nodiscard]] static uint64_t Make(uint8_t layer, uint32_t materialId, uint32_t meshId, float depth);
+
+	[[nodiscard]] static constexpr uint32_t GetLayer(uint64_t key) { return uint32_t(key >> s_LayerShift) & ((1u << s_LayerBits) - 1); }
+	[[nodiscard]] static constexpr uint32_t GetMaterial(uint64_t key) { return uint32_t(key >> s_MaterialShift) & ((1u << s_MaterialBits) - 1); }
+	[[nodiscard]] static constexpr uint32_t GetMesh(uint64_t key) { return uint32_t(key >> s_MeshShift) & ((1u << s_MeshBits) - 1); }
+	[[nodiscard]] static constexpr uint32_t GetDepth(uint64_t key) { return uint32_t(key >> s_DepthShift) & ((1u << s_DepthBits) - 1); }
+};
+
+struct DrawPacket
+{
+	uint64_t m_SortKey{};
+	MeshHandle m_Mesh{};
+	BaseMaterial* m_pMaterial{};
+	uint32_t m_TransformIndex{}; // Into the transforms of the buffer that recorded it, into the merged transforms once sorted
+	MaterialInstanceHandle m_MaterialInstance{}; // Parameters of draws of a material template, invalid for plain materials
+};
+
+/**
+ * \brief Linear per-frame list of draw packets. Not thread safe, every recording thread uses its own buffer.
+ */
+class RenderCommandBuffer final
+{
+public:
+	RenderCommandBuffer() noexcept = default;
+	~RenderCommandBuffer() = default;
+
+	RenderCommandBuffer(const RenderCommandBuffer& other) noexcept = delete;
+	RenderCommandBuffer& operator=(const RenderCommandBuffer& other) noexcept = delete;
+	RenderCommandBuffer(RenderCommandBuffer&& other) noexcept = delete;
+	RenderCommandBuffer& operator=(RenderCommandBuffer&& other) noexcept = delete;
+
+	void Draw(uint64_t sortKey, MeshHandle mesh, BaseMaterial* pMaterial, const XMFLOAT4X4& world, MaterialInstanceHandle materialInstance = {});
+	void Reset();
+
+	[[nodiscard]] const std::vector<DrawPacket>& GetPackets() const { return m_Packets; }
+	[[nodiscard]] const std::vector<XMFLOAT4X4>& GetTransforms() const { return m_Transforms; }
+
+private:
+	/* DATA MEMBERS */
+
+	std::vector<DrawPacket> m_Packets{};
+	std::vector<XMFLOAT4X4> m_Transforms{};
+
+};
+
+/**
+ * \brief Collects the command buffers of a frame, merges them and radix sorts the packets on their key.
+ * Recording can go wide: each job acquires its own command buffer, only the acquisition is synchronized.
+ */
+class RenderQueue final
+{
+public:
+	RenderQueue() noexcept;
+	~RenderQueue() = default;
+
+	RenderQueue(const RenderQueue& other) noexcept = delete;
+	RenderQueue& operator=(const RenderQueue& other) noexcept = delete;
+	RenderQueue(RenderQueue&& other) noexcept = delete;
+	RenderQueue& operator=(RenderQueue&& other) noexcept = delete;
+
+	/**
+	 * \brief Command buffer of the main thread, always available
+	 */
+	[[nodiscard]] RenderCommandBuffer& GetMainCommandBuffer() const;
+	/**
+	 * \brief Thread safe, returns a command buffer owned by the caller until the next Reset
+	 */
+	[[nodiscard]] RenderCommandBuffer& AcquireCommandBuffer();
+
+	/**
+	 * \brief Clears every command buffer, call at the beginning of the frame
+	 */
+	void Reset();
+	/**
+	 * \brief Merges every command buffer and sorts the packets, no recording may happen concurrently
+	 */
+	void Sort();
+
+	[[nodiscard]] const std::vector<DrawPacket>& GetSortedPackets() const { return m_SortedPackets; }
+	[[nodiscard]] const XMFLOAT4X4& GetTransform(const DrawPacket& packet) const { return m_Transforms[packet.m_TransformIndex]; }
+	/**
+	 * \brief Transforms of every command buffer, merged in recording order and indexed by DrawPacket::m_TransformIndex
+	 */
+	[[nodiscard]] const std::vector<XMFLOAT4X4>& GetTransforms() const { return m_Transforms; }
+
+private:
+	/* DATA MEMBERS */
+
+	std::vector<std::unique_ptr<RenderCommandBuffer>> m_pCommandBuffers{}; // [0] is the main thread's
+	size_t m_AcquiredCount{ 1 };
+	std::mutex m_Mutex{};
+
+	std::vector<DrawPacket> m_SortedPackets{};
+	std::vector<DrawPacket> m_SortScratch{};
+	std::vector<XMFLOAT4X4> m_Transforms{};
+
+	/* PRIVATE METHODS */
+
+	void RadixSort();
+
+};
@@ -2,7 +2,7 @@
 
 #include "CleanedWindows.h"
 
-#include <d3d11.h>
+#include <d3d11_1.h>
 #include <d3dcompiler.h>
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "d3dcompiler.lib")
@@ -12,14 +12,43 @@
 #pragma comment(lib, "d3d12.lib")
 #pragma comment(lib, "dxgi.lib")
 
+#ifdef PICOGINE_VULKAN
+// Only Win32 surfaces are created, other platforms are limited to the offscreen target (see GameSettings::renderOffscreen)
+#ifdef _WIN32
+#define VK_USE_PLATFORM_WIN32_KHR
+#endif
+#include <vulkan/vulkan.h>
+#endif
+
+#include <algorithm>
 #include <array>
+#include <cstring>
+#include <span>
 #include <vector>
-#include <mutex>
+#include <string>
 
+#include "BaseMaterial.h"
+#include "DX11ShaderCache.h"
+#include "FrameRingAllocator.h"
 #include "GameSettings.h"
+#include "ImageWriter.h"
+#include "MaterialManager.h"
+#include "IndexAllocator.h"
+#include "RendererStats.h"
+#include "RenderQueue.h"
+#include "ResourceTable.h"
+#include "SoftwareRasterizer.h"
+#include "StateTracker.h"
 #include "WindowsException.h"
 #include "WindowHandler.h"
 
+#include "DX12Context.h"
+
+#ifdef PICOGINE_VULKAN
+#include "VulkanContext.h"
+#include "VulkanException.h"
+#endif
+
 #include "ColorMaterial.h"
 
 using Microsoft::WRL::ComPtr;
@@ -40,18 +69,118 @@ public:
 	virtual void* GetDevice() const = 0;
 	virtual void* GetDeviceContext() const = 0;
 
-	virtual void BeginFrame() const = 0;
-	virtual void EndFrame() const = 0;
-
-	virtual void RenderTestTriangle() = 0;
+	virtual void BeginFrame() = 0;
+	virtual void EndFrame() = 0;
+
+	[[nodiscard]] virtual MeshHandle CreateMesh(const MeshDesc& desc) = 0;
+	virtual void DestroyMesh(MeshHandle handle) = 0;
+	virtual void BindMesh(MeshHandle handle) = 0;
+	virtual void DrawBoundMesh(uint32_t instanceCount) = 0;
+	void DrawMesh(MeshHandle handle);
+
+	/**
+	 * \brief Sorts the recorded packets and translates them to API calls, skipping redundant material and mesh binds.
+	 * Runs of packets sharing mesh and material are merged into instanced draws when the material supports it.
+	 * The view constants are uploaded once and stay bound for every draw, the per-draw data only holds world matrices.
+	 */
+	void Submit(RenderQueue& queue, const ViewConstants& view);
+	[[nodiscard]] const SubmitStats& GetSubmitStats() const { return m_SubmitStats; }
+
+	[[nodiscard]] TransientAllocation AllocateTransient(uint32_t size, uint32_t alignment);
+	[[nodiscard]] uint64_t GetTransientRegionSize() const { return m_TransientRing.GetRegionSize(); }
+	/**
+	 * \brief Transient bytes a Submit of GameSettings::maxObjectsPerFrame draws of materials without instancing needs:
+	 * view constants, world matrices and one constant buffer aligned ObjectConstants per draw. Material parameters are not included.
+	 */
+	[[nodiscard]] static uint64_t GetMaxSubmitTransientSize();
+	virtual void BindTransientConstants(ShaderStage stage, uint32_t slot, const TransientAllocation& allocation) = 0;
+	/**
+	 * \brief Memory this frame's world matrices are written to, a transient slice unless the backend can write them
+	 * straight into the buffer the shaders read
+	 * \param count XMFLOAT3X4A written
+	 * \return Invalid allocation if there is no room left
+	 */
+	[[nodiscard]] virtual TransientAllocation AllocateWorldMatrices(uint32_t count);
+	/**
+	 * \brief Binds this frame's world matrices as the structured buffer at s_WorldMatricesSlot
+	 * \param allocation Returned by AllocateWorldMatrices, holding one XMFLOAT3X4 per recorded object
+	 */
+	virtual void BindWorldMatrices(const TransientAllocation& allocation) = 0;
+	virtual void FlushUploads() = 0;
+
+	[[nodiscard]] uint32_t GetResourceCreationCount() const { return m_ResourceCreationCount; }
+	void CountResourceCreation(uint32_t count) { m_ResourceCreationCount += count; }
+	[[nodiscard]] StateTracker& GetStateTracker() { return m_StateTracker; }
+
+	/**
+	 * \brief Writes the last presented frame to an image file
+	 * \return False if the backend keeps no CPU copy of its frames
+	 */
+	virtual bool SaveFrame(const std::string& /*path*/) { return false; }
+	/**
+	 * \brief 
+	 * \return Draws issued since the last BeginFrame, empty unless the backend records them
+	 */
+	[[nodiscard]] virtual std::span<const RecordedDraw> GetRecordedDraws() const { return {}; }
 
 protected:
 	/* DATA MEMBERS */
 
 	HWND m_HWnd;
+	uint32_t m_ResourceCreationCount{};
+	uint32_t m_MapCount{}; // Reset by every Submit
+	uint64_t m_DirectUploadedBytes{}; // Written to GPU buffers outside the transient ring, reset by every Submit
+	StateTracker m_StateTracker{};
+	const BaseMaterial* m_pBoundMaterial{}; // Set by Submit before the material binds itself
+
+	FrameRingAllocator<Renderer::s_FrameCount> m_TransientRing{};
+
+	inline static constexpr uint32_t s_ObjectConstantsSlot{ 1 }; // VS, also holds the instance array of instanced draws
+	inline static constexpr uint32_t s_WorldMatricesSlot{ 0 }; // VS t0, must match WorldMatrices.hlsli
+	inline static constexpr uint32_t s_MaxInstancesPerDraw{ 512 }; // Must match ColorInstancedVS.hlsl
 
 	inline static float m_DefaultBackgroundColor[4] = { .5f, .5f, .5f, 1.0f };
 	inline static bool m_VSyncEnabled{ GameSettings::useVSync };
+
+	/* NESTED CLASSES */
+
+	// World matrices are read from the world matrix buffer, draws only carry the index of their object
+
+	struct ObjectConstants
+	{
+		uint32_t m_ObjectId{};
+	};
+
+	struct InstanceData
+	{
+		uint32_t m_ObjectId{};
+		uint32_t m_Padding[3]{};
+		XMFLOAT4 m_Color{};
+	};
+
+private:
+	/* NESTED CLASSES */
+
+	struct DrawBatch
+	{
+		uint32_t m_FirstPacket{};
+		uint32_t m_InstanceCount{};
+		TransientAllocation m_Constants{};
+		bool m_IsInstanced{};
+	};
+
+	/* DATA MEMBERS */
+
+	std::vector<DrawBatch> m_DrawBatches{};
+	SubmitStats m_SubmitStats{};
+
+	/* PRIVATE METHODS */
+
+	/**
+	 * \brief Converts to the transposed 3x4 layout the shaders read, the constant last column is dropped
+	 * \param pDestination 16 byte aligned
+	 */
+	static void StoreWorldMatrices(XMFLOAT3X4A* pDestination, const XMFLOAT4X4* pSource, uint32_t count);
 	
 };
 
@@ -60,6 +189,197 @@ Renderer::RendererImpl::RendererImpl(HWND hwnd) noexcept
 {
 }
 
+TransientAllocation Renderer::RendererImpl::AllocateTransient(uint32_t size, uint32_t alignment)
+{
+	const TransientAllocation allocation{ m_TransientRing.Allocate(size, alignment) };
+	assert(allocation.IsValid() && "Transient upload region is full, increase GameSettings::transientUploadBufferSize");
+	return allocation;
+}
+
+uint64_t Renderer::RendererImpl::GetMaxSubmitTransientSize()
+{
+	const auto alignUp = [](uint64_t size)
+	{
+		return (size + Renderer::s_ConstantBufferAlignment - 1) / Renderer::s_ConstantBufferAlignment * Renderer::s_ConstantBufferAlignment;
+	};
+
+	const uint64_t objectCount{ GameSettings::maxObjectsPerFrame };
+	return alignUp(sizeof(ViewConstants)) + alignUp(objectCount * sizeof(XMFLOAT3X4A)) + objectCount * alignUp(sizeof(ObjectConstants));
+}
+
+TransientAllocation Renderer::RendererImpl::AllocateWorldMatrices(uint32_t count)
+{
+	return AllocateTransient(count * uint32_t(sizeof(XMFLOAT3X4A)), Renderer::s_ConstantBufferAlignment);
+}
+
+void Renderer::RendererImpl::StoreWorldMatrices(XMFLOAT3X4A* pDestination, const XMFLOAT4X4* pSource, uint32_t count)
+{
+	// One SIMD load, transpose and three aligned stores per matrix, written front to back for write-combined memory
+	for (uint32_t i{}; i < count; ++i)
+		XMStoreFloat3x4A(&pDestination[i], XMLoadFloat4x4(&pSource[i]));
+}
+
+void Renderer::RendererImpl::DrawMesh(MeshHandle handle)
+{
+	BindMesh(handle);
+	DrawBoundMesh(1);
+}
+
+void Renderer::RendererImpl::Submit(RenderQueue& queue, const ViewConstants& view)
+{
+	m_MapCount = 0;
+	m_DirectUploadedBytes = 0;
+	m_pBoundMaterial = nullptr;
+	m_StateTracker.ResetStats();
+
+	queue.Sort();
+	const auto& packets = queue.GetSortedPackets();
+	const uint32_t packetCount{ static_cast<uint32_t>(packets.size()) };
+
+	// Every upload is written before the first draw, so the backend can flush them all at once
+	const TransientAllocation viewConstants{ AllocateTransient(sizeof(ViewConstants), Renderer::s_ConstantBufferAlignment) };
+	if (viewConstants.IsValid())
+		memcpy(viewConstants.m_pData, &view, sizeof(ViewConstants));
+
+	// Every recorded world matrix goes up in one contiguous copy, in recording order so objects keep their transform index
+	const std::vector<XMFLOAT4X4>& transforms{ queue.GetTransforms() };
+	assert(transforms.size() <= GameSettings::maxObjectsPerFrame && "Too many objects recorded, increase GameSettings::maxObjectsPerFrame");
+	const uint32_t objectCount{ std::min(static_cast<uint32_t>(transforms.size()), GameSettings::maxObjectsPerFrame) };
+
+	TransientAllocation worldMatrices{};
+	if (objectCount)
+	{
+		worldMatrices = AllocateWorldMatrices(objectCount);
+		if (worldMatrices.IsValid())
+			StoreWorldMatrices(static_cast<XMFLOAT3X4A*>(worldMatrices.m_pData), transforms.data(), objectCount);
+	}
+
+	// Packets of objects without an uploaded world matrix would read past it on the GPU, they are dropped instead
+	const uint32_t uploadedObjectCount{ worldMatrices.IsValid() ? objectCount : 0 };
+	uint32_t droppedPacketCount{};
+
+	m_DrawBatches.clear();
+	for (uint32_t first{}; first < packetCount;)
+	{
+		const DrawPacket& packet = packets[first];
+
+		uint32_t runEnd{ first + 1 };
+		while (runEnd < packetCount && packets[runEnd].m_Mesh == packet.m_Mesh && packets[runEnd].m_pMaterial == packet.m_pMaterial)
+			++runEnd;
+
+		// Queued once per frame whatever the number of runs using it, its parameters are written by the flush below
+		packet.m_pMaterial->RequestParameterUpload();
+
+		// Instance parameters are only read by the instanced shaders, template draws take that path even alone
+		if ((runEnd - first > 1 || packet.m_MaterialInstance.IsValid()) && packet.m_pMaterial->SupportsInstancing())
+		{
+			const XMFLOAT4 color{ packet.m_pMaterial->GetInstanceColor() };
+			const MaterialManager& materialManager{ MaterialManager::Get() };
+
+			for (uint32_t batchFirst{ first }; batchFirst < runEnd;)
+			{
+				// Sized for the whole batch, dropped packets leave its end unused
+				const uint32_t maxInstanceCount{ std::min(runEnd - batchFirst, s_MaxInstancesPerDraw) };
+				DrawBatch batch{ batchFirst, 0, AllocateTransient(maxInstanceCount * uint32_t(sizeof(InstanceData)), Renderer::s_ConstantBufferAlignment), true };
+				if (!batch.m_Constants.IsValid())
+				{
+					batchFirst += maxInstanceCount;
+					continue;
+				}
+
+				const auto pInstances = static_cast<InstanceData*>(batch.m_Constants.m_pData);
+				for (; batchFirst < runEnd && batch.m_InstanceCount < maxInstanceCount; ++batchFirst)
+				{
+					const DrawPacket& instancePacket = packets[batchFirst];
+					if (instancePacket.m_TransformIndex >= uploadedObjectCount)
+					{
+						++droppedPacketCount;
+						continue;
+					}
+
+					InstanceData& instance = pInstances[batch.m_InstanceCount++];
+					instance.m_ObjectId = instancePacket.m_TransformIndex;
+					instance.m_Color = instancePacket.m_MaterialInstance.IsValid() ? materialManager.GetParameters(instancePacket.m_MaterialInstance) : color;
+				}
+
+				if (batch.m_InstanceCount)
+					m_DrawBatches.emplace_back(batch);
+			}
+		}
+		else
+		{
+			for (uint32_t i{ first }; i < runEnd; ++i)
+			{
+				if (packets[i].m_TransformIndex >= uploadedObjectCount)
+				{
+					++droppedPacketCount;
+					continue;
+				}
+
+				DrawBatch batch{ i, 1, AllocateTransient(sizeof(ObjectConstants), Renderer::s_ConstantBufferAlignment), false };
+				if (!batch.m_Constants.IsValid())
+					continue;
+
+				static_cast<ObjectConstants*>(batch.m_Constants.m_pData)->m_ObjectId = packets[i].m_TransformIndex;
+				m_DrawBatches.emplace_back(batch);
+			}
+		}
+
+		first = runEnd;
+	}
+
+	// Parameters of the drawn materials join the frame's transient data, uploaded in one pass however many binds they get
+	BaseMaterial::FlushParameterUploads();
+	FlushUploads();
+
+	if (viewConstants.IsValid())
+	{
+		BindTransientConstants(ShaderStage::Vertex, Renderer::s_ViewConstantsSlot, viewConstants);
+		BindTransientConstants(ShaderStage::Pixel, Renderer::s_ViewConstantsSlot, viewConstants);
+	}
+
+	if (worldMatrices.IsValid())
+		BindWorldMatrices(worldMatrices);
+
+	BaseMaterial* pBoundMaterial{};
+	bool isBoundInstanced{};
+	MeshHandle boundMesh{};
+	for (const auto& batch : m_DrawBatches)
+	{
+		const DrawPacket& packet = packets[batch.m_FirstPacket];
+
+		if (packet.m_pMaterial != pBoundMaterial || batch.m_IsInstanced != isBoundInstanced)
+		{
+			pBoundMaterial = packet.m_pMaterial;
+			isBoundInstanced = batch.m_IsInstanced;
+			m_pBoundMaterial = pBoundMaterial;
+
+			if (isBoundInstanced)
+				pBoundMaterial->BindInstanced();
+			else
+				pBoundMaterial->Bind();
+		}
+
+		if (packet.m_Mesh != boundMesh)
+		{
+			boundMesh = packet.m_Mesh;
+			BindMesh(boundMesh);
+		}
+
+		BindTransientConstants(ShaderStage::Vertex, s_ObjectConstantsSlot, batch.m_Constants);
+		DrawBoundMesh(batch.m_InstanceCount);
+	}
+
+	m_SubmitStats.m_PacketCount = packetCount;
+	m_SubmitStats.m_DroppedPacketCount = droppedPacketCount;
+	m_SubmitStats.m_DrawCallCount = static_cast<uint32_t>(m_DrawBatches.size());
+	m_SubmitStats.m_InstancedDrawCallCount = static_cast<uint32_t>(std::ranges::count_if(m_DrawBatches, [](const DrawBatch& batch) { return batch.m_IsInstanced; }));
+	m_SubmitStats.m_MapCount = m_MapCount;
+	m_SubmitStats.m_UploadedBytes = m_DirectUploadedBytes + m_TransientRing.GetUsedSize();
+	m_SubmitStats.m_StateChangeCount = m_StateTracker.GetStats().m_IssuedCount;
+	m_SubmitStats.m_FilteredStateChangeCount = m_StateTracker.GetStats().m_FilteredCount;
+}
+
 #pragma endregion
 
 #pragma region DX11
@@ -68,7 +388,7 @@ class DirectX11 final : public Renderer::RendererImpl
 {
 public:
 	explicit DirectX11(HWND hwnd);
-	~DirectX11() override = default;
+	~DirectX11() override;
 
 	DirectX11(const DirectX11& other) noexcept = delete;
 	DirectX11& operator=(const DirectX11& other) noexcept = delete;
@@ -78,20 +398,57 @@ public:
 	void* GetDevice() const override;
 	void* GetDeviceContext() const override;
 
-	void BeginFrame() const override;
-	void EndFrame() const override;
+	void BeginFrame() override;
+	void EndFrame() override;
+
+	[[nodiscard]] MeshHandle CreateMesh(const MeshDesc& desc) override;
+	void DestroyMesh(MeshHandle handle) override;
+	void BindMesh(MeshHandle handle) override;
+	void DrawBoundMesh(uint32_t instanceCount) override;
 
-	void RenderTestTriangle() override;
+	void BindTransientConstants(ShaderStage stage, uint32_t slot, const TransientAllocation& allocation) override;
+	[[nodiscard]] TransientAllocation AllocateWorldMatrices(uint32_t count) override;
+	void BindWorldMatrices(const TransientAllocation& allocation) override;
+	void FlushUploads() override;
 
 private:
+	/* NESTED CLASSES */
+
+	struct DX11Mesh
+	{
+		ComPtr<ID3D11Buffer> m_pVertexBuffer{};
+		ComPtr<ID3D11Buffer> m_pIndexBuffer{};
+		UINT m_VertexStride{};
+		UINT m_IndexCount{};
+		DXGI_FORMAT m_IndexFormat{ DXGI_FORMAT_R16_UINT };
+	};
+
 	/* DATA MEMBERS */
 
 	ComPtr<ID3D11Device> m_pDevice{};
 	ComPtr<IDXGISwapChain> m_pSwapChain{};
 	ComPtr<ID3D11DeviceContext> m_pDeviceContext{};
 	ComPtr<ID3D11RenderTargetView> m_pRenderTargetView{};
+	ComPtr<ID3D11DeviceContext1> m_pDeviceContext1{}; // Constant buffer offsets
+
+	ResourceTable<MeshTag, DX11Mesh, Renderer::s_FrameCount> m_Meshes{};
+	UINT m_FrameIndex{};
+	UINT m_BoundIndexCount{};
+
+	// DX11 cannot keep a buffer mapped while the GPU reads it, transient data is written to CPU memory and copied with a single map per frame
+	ComPtr<ID3D11Buffer> m_pTransientBuffer{};
+	std::unique_ptr<uint8_t[]> m_pTransientShadow{};
+	UINT64 m_FrameFenceValue{};
+
+	// Constant buffers cannot be read as structured buffers, world matrices get their own dynamic buffer.
+	// It is mapped from AllocateWorldMatrices to BindWorldMatrices so the matrices are stored into it directly.
+	ComPtr<ID3D11Buffer> m_pWorldMatrixBuffer{};
+	ComPtr<ID3D11ShaderResourceView> m_pWorldMatrixView{};
+	bool m_IsWorldMatrixBufferMapped{};
 
 	/* PRIVATE METHODS */
+
+	ComPtr<ID3D11Buffer> CreateBuffer(const void* pData, UINT byteWidth, UINT stride, UINT bindFlags);
 	
 };
 
@@ -150,6 +507,45 @@ DirectX11::DirectX11(HWND hwnd) : RendererImpl{ hwnd }
 	vp.TopLeftX = 0;
 	vp.TopLeftY = 0;
 	m_pDeviceContext->RSSetViewports(1u, &vp);
+
+	// Transient uploads
+	PGWND_THROW_IF_FAILED(m_pDeviceContext.As(&m_pDeviceContext1));
+
+	D3D11_BUFFER_DESC transientDesc{};
+	transientDesc.ByteWidth = GameSettings::transientUploadBufferSize;
+	transientDesc.Usage = D3D11_USAGE_DYNAMIC;
+	transientDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	transientDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	transientDesc.MiscFlags = 0u;
+	transientDesc.StructureByteStride = 0u;
+	PGWND_THROW_IF_FAILED(m_pDevice->CreateBuffer(&transientDesc, nullptr, &m_pTransientBuffer));
+	++m_ResourceCreationCount;
+
+	m_pTransientShadow = std::make_unique<uint8_t[]>(GameSettings::transientUploadBufferSize);
+	m_TransientRing.Initialize(m_pTransientShadow.get(), GameSettings::transientUploadBufferSize, Renderer::s_ConstantBufferAlignment);
+
+	D3D11_BUFFER_DESC worldMatrixDesc{};
+	worldMatrixDesc.ByteWidth = GameSettings::maxObjectsPerFrame * UINT(sizeof(XMFLOAT3X4A));
+	worldMatrixDesc.Usage = D3D11_USAGE_DYNAMIC;
+	worldMatrixDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	worldMatrixDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	worldMatrixDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+	worldMatrixDesc.StructureByteStride = UINT(sizeof(XMFLOAT3X4A));
+	PGWND_THROW_IF_FAILED(m_pDevice->CreateBuffer(&worldMatrixDesc, nullptr, &m_pWorldMatrixBuffer));
+	++m_ResourceCreationCount;
+
+	D3D11_SHADER_RESOURCE_VIEW_DESC worldMatrixViewDesc{};
+	worldMatrixViewDesc.Format = DXGI_FORMAT_UNKNOWN;
+	worldMatrixViewDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+	worldMatrixViewDesc.Buffer.FirstElement = 0u;
+	worldMatrixViewDesc.Buffer.NumElements = GameSettings::maxObjectsPerFrame;
+	PGWND_THROW_IF_FAILED(m_pDevice->CreateShaderResourceView(m_pWorldMatrixBuffer.Get(), &worldMatrixViewDesc, &m_pWorldMatrixView));
+}
+
+DirectX11::~DirectX11()
+{
+	// Shared shader objects must not outlive the device
+	DX11ShaderCache::Get().Release();
 }
 
 void* DirectX11::GetDevice() const
@@ -162,86 +558,167 @@ void* DirectX11::GetDeviceContext() const
 	return m_pDeviceContext.Get();
 }
 
-void DirectX11::BeginFrame() const
+void DirectX11::BeginFrame()
 {
+	m_Meshes.BeginFrame(m_FrameIndex);
+
+	// WRITE_DISCARD lets the driver rename the buffer, a region is free again as soon as its frame is submitted
+	[[maybe_unused]] const bool isRegionFree{ m_TransientRing.BeginFrame(m_FrameFenceValue) };
+	assert(isRegionFree);
+
 	m_pDeviceContext->ClearRenderTargetView(m_pRenderTargetView.Get(), m_DefaultBackgroundColor);
+
+	// Anything may have touched the immediate context between frames
+	m_StateTracker.Invalidate();
 }
 
-void DirectX11::EndFrame() const
+void DirectX11::EndFrame()
 {
 	if (m_VSyncEnabled)
 		PGWND_THROW_IF_FAILED(m_pSwapChain->Present(1u, 0u));
 	else
 		PGWND_THROW_IF_FAILED(m_pSwapChain->Present(0u, 0u));
+
+	m_TransientRing.EndFrame(++m_FrameFenceValue);
+	m_FrameIndex = (m_FrameIndex + 1) % Renderer::s_FrameCount;
 }
 
-void DirectX11::RenderTestTriangle()
+MeshHandle DirectX11::CreateMesh(const MeshDesc& desc)
 {
-	struct TestVertex
-	{
-		float x{}, y{};
-	};
+	assert(desc.m_pVertices && desc.m_VertexCount && desc.m_VertexStride);
+	assert(desc.m_pIndices && desc.m_IndexCount);
 
-	// Vertex Buffer
-	ComPtr<ID3D11Buffer> pVertexBuffer;
+	const UINT indexSize{ desc.m_IndexFormat == IndexFormat::UInt16 ? UINT(sizeof(uint16_t)) : UINT(sizeof(uint32_t)) };
 
-	static constexpr TestVertex vertices[] =
-	{
-		{ .0f, .5f},
-		{ .5f, -.5f},
-		{ -.5f, -.5f}
-	};
+	DX11Mesh mesh{};
+	mesh.m_pVertexBuffer = CreateBuffer(desc.m_pVertices, desc.m_VertexCount * desc.m_VertexStride, desc.m_VertexStride, D3D11_BIND_VERTEX_BUFFER);
+	mesh.m_pIndexBuffer = CreateBuffer(desc.m_pIndices, desc.m_IndexCount * indexSize, indexSize, D3D11_BIND_INDEX_BUFFER);
+	mesh.m_VertexStride = desc.m_VertexStride;
+	mesh.m_IndexCount = desc.m_IndexCount;
+	mesh.m_IndexFormat = desc.m_IndexFormat == IndexFormat::UInt16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
 
-	D3D11_BUFFER_DESC vbDesc{};
-	vbDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-	vbDesc.Usage = D3D11_USAGE_DEFAULT;
-	vbDesc.CPUAccessFlags = 0u;
-	vbDesc.MiscFlags = 0u;
-	vbDesc.ByteWidth = sizeof(vertices);
-	vbDesc.StructureByteStride = sizeof(TestVertex);
+	return m_Meshes.Add(std::move(mesh));
+}
 
-	D3D11_SUBRESOURCE_DATA vsd{};
-	vsd.pSysMem = vertices;
+void DirectX11::DestroyMesh(MeshHandle handle)
+{
+	m_Meshes.Remove(handle, m_FrameIndex);
+}
 
-	PGWND_THROW_IF_FAILED(m_pDevice->CreateBuffer(&vbDesc, &vsd, &pVertexBuffer));
+void DirectX11::BindMesh(MeshHandle handle)
+{
+	const DX11Mesh* pMesh{ m_Meshes.Get(handle) };
+	assert(pMesh);
+	if (!pMesh)
+	{
+		m_BoundIndexCount = 0;
+		return;
+	}
 
-	constexpr UINT vbStride = sizeof(TestVertex);
 	constexpr UINT vbOffset = 0u;
-	m_pDeviceContext->IASetVertexBuffers(0u, 1u, pVertexBuffer.GetAddressOf(), &vbStride, &vbOffset);
+	if (m_StateTracker.SetVertexBuffer(pMesh->m_pVertexBuffer.Get(), pMesh->m_VertexStride, vbOffset))
+		m_pDeviceContext->IASetVertexBuffers(0u, 1u, pMesh->m_pVertexBuffer.GetAddressOf(), &pMesh->m_VertexStride, &vbOffset);
+	if (m_StateTracker.SetIndexBuffer(pMesh->m_pIndexBuffer.Get(), pMesh->m_IndexFormat))
+		m_pDeviceContext->IASetIndexBuffer(pMesh->m_pIndexBuffer.Get(), pMesh->m_IndexFormat, 0u);
+	if (m_StateTracker.SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST))
+		m_pDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+	m_BoundIndexCount = pMesh->m_IndexCount;
+}
+
+void DirectX11::DrawBoundMesh(uint32_t instanceCount)
+{
+	if (!m_BoundIndexCount)
+		return;
+
+	if (instanceCount > 1)
+		m_pDeviceContext->DrawIndexedInstanced(m_BoundIndexCount, instanceCount, 0u, 0, 0u);
+	else
+		m_pDeviceContext->DrawIndexed(m_BoundIndexCount, 0u, 0u);
+}
+
+void DirectX11::BindTransientConstants(ShaderStage stage, uint32_t slot, const TransientAllocation& allocation)
+{
+	assert(allocation.IsValid() && allocation.m_Offset % Renderer::s_ConstantBufferAlignment == 0);
+
+	// Offsets and sizes are expressed in 16 byte constants, in multiples of 16 constants
+	const UINT firstConstant{ static_cast<UINT>(allocation.m_Offset / 16) };
+	const UINT numConstants{ static_cast<UINT>((allocation.m_Size + Renderer::s_ConstantBufferAlignment - 1) / Renderer::s_ConstantBufferAlignment * 16) };
 
-	// Index Buffer
-	ComPtr<ID3D11Buffer> pIndexBuffer;
+	if (!m_StateTracker.SetConstantBuffer(stage, slot, m_pTransientBuffer.Get(), firstConstant, numConstants))
+		return;
 
-	constexpr uint16_t indices[] =
+	switch (stage)
 	{
-		0, 1, 2
-	};
+	case ShaderStage::Vertex:
+		m_pDeviceContext1->VSSetConstantBuffers1(slot, 1u, m_pTransientBuffer.GetAddressOf(), &firstConstant, &numConstants);
+		break;
+
+	case ShaderStage::Pixel:
+		m_pDeviceContext1->PSSetConstantBuffers1(slot, 1u, m_pTransientBuffer.GetAddressOf(), &firstConstant, &numConstants);
+		break;
+	}
+}
+
+TransientAllocation DirectX11::AllocateWorldMatrices(uint32_t count)
+{
+	assert(!m_IsWorldMatrixBufferMapped && count <= GameSettings::maxObjectsPerFrame);
+
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	PGWND_THROW_IF_FAILED(m_pDeviceContext->Map(m_pWorldMatrixBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource));
+	m_IsWorldMatrixBufferMapped = true;
+	++m_MapCount;
+
+	const UINT64 size{ count * UINT64(sizeof(XMFLOAT3X4A)) };
+	m_DirectUploadedBytes += size;
+
+	return TransientAllocation{ mappedResource.pData, 0, size };
+}
 
-	D3D11_BUFFER_DESC ibDesc{};
-	ibDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-	ibDesc.Usage = D3D11_USAGE_DEFAULT;
-	ibDesc.CPUAccessFlags = 0u;
-	ibDesc.MiscFlags = 0u;
-	ibDesc.ByteWidth = sizeof(indices);
-	ibDesc.StructureByteStride = sizeof(uint16_t);
+void DirectX11::BindWorldMatrices(const TransientAllocation& allocation)
+{
+	assert(allocation.IsValid() && m_IsWorldMatrixBufferMapped);
 
-	D3D11_SUBRESOURCE_DATA isd{};
-	isd.pSysMem = indices;
+	// Submit stored the matrices straight into the mapped buffer
+	m_pDeviceContext->Unmap(m_pWorldMatrixBuffer.Get(), 0);
+	m_IsWorldMatrixBufferMapped = false;
 
-	PGWND_THROW_IF_FAILED(m_pDevice->CreateBuffer(&ibDesc, &isd, &pIndexBuffer));
+	m_pDeviceContext->VSSetShaderResources(s_WorldMatricesSlot, 1u, m_pWorldMatrixView.GetAddressOf());
+}
 
-	m_pDeviceContext->IASetIndexBuffer(pIndexBuffer.Get(), DXGI_FORMAT_R16_UINT, 0u);
+void DirectX11::FlushUploads()
+{
+	const UINT64 usedSize{ m_TransientRing.GetUsedSize() };
+	if (!usedSize)
+		return;
 
-	// IA
-	m_pDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	const UINT64 regionOffset{ m_TransientRing.GetRegionOffset() };
 
-	// Material
-	const auto pMaterial = std::make_unique<ColorMaterial>();
-	pMaterial->SetColor(1.0f, 0.0f, 0.0f, 1.0f);
-	pMaterial->Bind();
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	PGWND_THROW_IF_FAILED(m_pDeviceContext->Map(m_pTransientBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource));
+	memcpy(static_cast<uint8_t*>(mappedResource.pData) + regionOffset, m_pTransientShadow.get() + regionOffset, usedSize);
+	m_pDeviceContext->Unmap(m_pTransientBuffer.Get(), 0);
+	++m_MapCount;
+}
 
-	//m_pDeviceContext->Draw(UINT(std::size(vertices)), 0u);
-	m_pDeviceContext->DrawIndexed(static_cast<UINT>(std::size(indices)), 0u, 0u);
+ComPtr<ID3D11Buffer> DirectX11::CreateBuffer(const void* pData, UINT byteWidth, UINT stride, UINT bindFlags)
+{
+	D3D11_BUFFER_DESC desc{};
+	desc.BindFlags = bindFlags;
+	desc.Usage = D3D11_USAGE_IMMUTABLE;
+	desc.CPUAccessFlags = 0u;
+	desc.MiscFlags = 0u;
+	desc.ByteWidth = byteWidth;
+	desc.StructureByteStride = stride;
+
+	D3D11_SUBRESOURCE_DATA data{};
+	data.pSysMem = pData;
+
+	ComPtr<ID3D11Buffer> pBuffer;
+	PGWND_THROW_IF_FAILED(m_pDevice->CreateBuffer(&desc, &data, &pBuffer));
+	++m_ResourceCreationCount;
+
+	return pBuffer;
 }
 
 #pragma endregion
@@ -262,10 +739,17 @@ public:
 	void* GetDevice() const override;
 	void* GetDeviceContext() const override;
 
-	void BeginFrame() const override;
-	void EndFrame() const override;
+	void BeginFrame() override;
+	void EndFrame() override;
 
-	void RenderTestTriangle() override;
+	[[nodiscard]] MeshHandle CreateMesh(const MeshDesc& desc) override;
+	void DestroyMesh(MeshHandle handle) override;
+	void BindMesh(MeshHandle handle) override;
+	void DrawBoundMesh(uint32_t instanceCount) override;
+
+	void BindTransientConstants(ShaderStage stage, uint32_t slot, const TransientAllocation& allocation) override;
+	void BindWorldMatrices(const TransientAllocation& allocation) override;
+	void FlushUploads() override;
 
 private:
 	/* NESTED CLASSES */
@@ -287,8 +771,10 @@ private:
 		[[nodiscard]] ID3D12CommandQueue* GetCommandQueue() const { return m_pCommandQueue.Get(); }
 		[[nodiscard]] ID3D12GraphicsCommandList6* GetCommandList() const { return m_pCommandList.Get(); }
 		[[nodiscard]] UINT GetFrameIndex() const { return m_FrameIndex; }
+		[[nodiscard]] UINT64 GetFenceValue() const { return m_FenceValue; }
+		[[nodiscard]] UINT64 GetCompletedFenceValue() const { return m_pFence->GetCompletedValue(); }
 
-		inline static constexpr int s_BufferCount{ 3 };
+		inline static constexpr int s_BufferCount{ Renderer::s_FrameCount };
 
 	private:
 		/* NESTED CLASSES */
@@ -348,7 +834,7 @@ private:
 		[[nodiscard]] constexpr D3D12_GPU_DESCRIPTOR_HANDLE GetGPUStart() const { return m_GPUStart; }
 		[[nodiscard]] ID3D12DescriptorHeap* GetHeap() const { return m_pDescriptorHeap.Get(); }
 		[[nodiscard]] constexpr UINT GetCapacity() const { return m_Capacity; }
-		[[nodiscard]] constexpr UINT GetSize() const { return m_Size; }
+		[[nodiscard]] UINT GetSize() const { return m_Indices.GetSize(); }
 		[[nodiscard]] constexpr UINT GetDescSize() const { return m_DescSize; }
 		[[nodiscard]] constexpr bool IsShaderVisible() const { return m_GPUStart.ptr != 0; }
 
@@ -359,22 +845,46 @@ private:
 		ComPtr<ID3D12DescriptorHeap> m_pDescriptorHeap;
 		D3D12_CPU_DESCRIPTOR_HANDLE m_CPUStart{};
 		D3D12_GPU_DESCRIPTOR_HANDLE m_GPUStart{};
-		std::unique_ptr<UINT[]> m_FreeHandles{};
-		std::array<std::vector<UINT>, DX12Command::s_BufferCount> m_DeferredFreeHandles{};
-		std::mutex m_Mutex;
+		IndexAllocator<DX12Command::s_BufferCount> m_Indices{}; // Freed descriptors are reused once their frame is done
 		UINT m_Capacity{};
-		UINT m_Size{};
 		UINT m_DescSize{};
 		const D3D12_DESCRIPTOR_HEAP_TYPE m_Type{};
 
 		/* PRIVATE METHODS */
 
-		void ProcessDeferredRelease(UINT frameIndex);
+	};
+
+	struct DX12Mesh
+	{
+		ComPtr<ID3D12Resource> m_pVertexBuffer{};
+		ComPtr<ID3D12Resource> m_pIndexBuffer{};
+		D3D12_VERTEX_BUFFER_VIEW m_VertexBufferView{};
+		D3D12_INDEX_BUFFER_VIEW m_IndexBufferView{};
+		UINT m_IndexCount{};
+	};
 
+	struct DX12RootBinding
+	{
+		D3D12_ROOT_PARAMETER_TYPE m_Type{};
+		UINT m_Register{};
+		D3D12_SHADER_VISIBILITY m_Visibility{};
 	};
 
 	/* DATA MEMBERS */
 
+	inline static constexpr UINT s_BackBufferCount{ DX12Command::s_BufferCount };
+	inline static constexpr DXGI_FORMAT s_BackBufferFormat{ DXGI_FORMAT_B8G8R8A8_UNORM };
+
+	// Root descriptors only, in the registers of the DX11 slots. A buffer bound to both stages gets a parameter per stage.
+	inline static constexpr DX12RootBinding s_RootBindings[]
+	{
+		{ D3D12_ROOT_PARAMETER_TYPE_CBV, s_ObjectConstantsSlot, D3D12_SHADER_VISIBILITY_VERTEX },
+		{ D3D12_ROOT_PARAMETER_TYPE_CBV, Renderer::s_ViewConstantsSlot, D3D12_SHADER_VISIBILITY_VERTEX },
+		{ D3D12_ROOT_PARAMETER_TYPE_CBV, 0, D3D12_SHADER_VISIBILITY_PIXEL }, // Material parameters
+		{ D3D12_ROOT_PARAMETER_TYPE_CBV, Renderer::s_ViewConstantsSlot, D3D12_SHADER_VISIBILITY_PIXEL },
+		{ D3D12_ROOT_PARAMETER_TYPE_SRV, s_WorldMatricesSlot, D3D12_SHADER_VISIBILITY_VERTEX }
+	};
+
 	ComPtr<ID3D12Device8> m_pDevice{};
 	//Factory??
 	std::unique_ptr<DX12Command> m_pCommand;
@@ -383,8 +893,43 @@ private:
 	std::unique_ptr<DX12DescriptorHeap> m_pSRVDescHeap;
 	std::unique_ptr<DX12DescriptorHeap> m_pUAVDescHeap;
 
+	ComPtr<IDXGISwapChain4> m_pSwapChain{};
+	ComPtr<ID3D12Resource> m_pBackBuffers[s_BackBufferCount]{};
+	DX12DescriptorHandle m_BackBufferViews[s_BackBufferCount]{};
+	UINT m_BackBufferIndex{};
+	D3D12_VIEWPORT m_Viewport{};
+	D3D12_RECT m_ScissorRect{};
+
+	ComPtr<ID3D12RootSignature> m_pRootSignature{};
+	std::unique_ptr<DX12Context> m_pContext;
+
+	ResourceTable<MeshTag, DX12Mesh, DX12Command::s_BufferCount> m_Meshes{};
+	UINT m_BoundIndexCount{};
+	ComPtr<ID3D12Resource> m_pTransientBuffer{}; // Persistently mapped
+
 	/* PRIVATE METHODS */
 
+	void CreateSwapChain(IDXGIFactory7* pDXGIFactory);
+	void CreateRootSignature();
+	/**
+	 * \brief Index in s_RootBindings of the parameter bound to this register, asserts if the root signature has none
+	 */
+	[[nodiscard]] static constexpr UINT GetRootParameterIndex(D3D12_ROOT_PARAMETER_TYPE type, UINT shaderRegister, D3D12_SHADER_VISIBILITY visibility)
+	{
+		for (UINT i{}; i < std::size(s_RootBindings); ++i)
+		{
+			const DX12RootBinding& binding{ s_RootBindings[i] };
+			if (binding.m_Type == type && binding.m_Register == shaderRegister && binding.m_Visibility == visibility)
+				return i;
+		}
+
+		assert(false && "Register not in the DX12 root signature");
+		return 0;
+	}
+	void TransitionBackBuffer(D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after) const;
+
+	ComPtr<ID3D12Resource> CreateUploadBuffer(const void* pData, UINT64 byteWidth);
+
 	ComPtr<IDXGIAdapter4> FindBestAdapter(IDXGIFactory7* pDXGIFactory, D3D_FEATURE_LEVEL minFeatureLevel) const;
 	D3D_FEATURE_LEVEL FindMaxFeatureLevel(IDXGIAdapter4* pAdapter) const;
 	
@@ -426,6 +971,17 @@ DirectX12::DirectX12(HWND hWnd) : RendererImpl{ hWnd }
 	m_pSRVDescHeap->Initialize(m_pDevice.Get(), 4096, true);
 	m_pUAVDescHeap->Initialize(m_pDevice.Get(), 512, false);
 
+	CreateSwapChain(pDXGIFactory.Get());
+	CreateRootSignature();
+	m_pContext = std::make_unique<DX12Context>(m_pDevice.Get(), m_pRootSignature.Get(), s_BackBufferFormat);
+
+	// Transient uploads, upload heaps stay mapped for the whole lifetime of the resource
+	m_pTransientBuffer = CreateUploadBuffer(nullptr, GameSettings::transientUploadBufferSize);
+	void* pTransientData{};
+	constexpr D3D12_RANGE readRange{ 0, 0 };
+	PGWND_THROW_IF_FAILED(m_pTransientBuffer->Map(0, &readRange, &pTransientData));
+	m_TransientRing.Initialize(pTransientData, GameSettings::transientUploadBufferSize, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
 #ifdef _DEBUG
 	{
 		ComPtr<ID3D12InfoQueue> pInfoQueue;
@@ -453,35 +1009,259 @@ DirectX12::~DirectX12()
 	m_pDSVDescHeap->Release();
 	m_pSRVDescHeap->Release();
 	m_pUAVDescHeap->Release();
+
+	// m_pCommand waits for every frame in flight when destroyed, buffers and pipelines must outlive it
+	m_pCommand.reset();
+	m_pContext.reset();
+	m_Meshes.Clear();
+
+	m_TransientRing.Release();
+	m_pTransientBuffer->Unmap(0, nullptr);
 }
 
 void* DirectX12::GetDevice() const
 {
-	return m_pDevice.Get();
+	return m_pContext.get();
 }
 
 void* DirectX12::GetDeviceContext() const
 {
-	return nullptr;
+	return m_pCommand->GetCommandList();
 }
 
-void DirectX12::BeginFrame() const
+void DirectX12::BeginFrame()
 {
 	m_pCommand->BeginFrame();
 	m_pRTVDescHeap->BeginFrame();
 	m_pDSVDescHeap->BeginFrame();
 	m_pSRVDescHeap->BeginFrame();
 	m_pUAVDescHeap->BeginFrame();
+
+	const UINT frameIndex{ m_pCommand->GetFrameIndex() };
+	m_Meshes.BeginFrame(frameIndex);
+	m_pContext->BeginFrame(frameIndex);
+
+	// m_pCommand already waited for this frame's fence
+	[[maybe_unused]] const bool isRegionFree{ m_TransientRing.BeginFrame(m_pCommand->GetCompletedFenceValue()) };
+	assert(isRegionFree);
+
+	ID3D12GraphicsCommandList6* pCommandList{ m_pCommand->GetCommandList() };
+
+	m_BackBufferIndex = m_pSwapChain->GetCurrentBackBufferIndex();
+	TransitionBackBuffer(D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+	const D3D12_CPU_DESCRIPTOR_HANDLE renderTarget{ m_BackBufferViews[m_BackBufferIndex].m_CPUHandle };
+	pCommandList->ClearRenderTargetView(renderTarget, m_DefaultBackgroundColor, 0, nullptr);
+	pCommandList->OMSetRenderTargets(1, &renderTarget, FALSE, nullptr);
+	pCommandList->RSSetViewports(1, &m_Viewport);
+	pCommandList->RSSetScissorRects(1, &m_ScissorRect);
+
+	// Every pipeline is built against the same root signature, it stays bound for the whole frame
+	pCommandList->SetGraphicsRootSignature(m_pRootSignature.Get());
+	pCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+	// Command lists start without any bound state
+	m_StateTracker.Invalidate();
 }
 
-void DirectX12::EndFrame() const
+void DirectX12::EndFrame()
 {
+	TransitionBackBuffer(D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
 	m_pCommand->EndFrame();
+
+	PGWND_THROW_IF_FAILED(m_pSwapChain->Present(m_VSyncEnabled ? 1u : 0u, 0u));
+
+	m_TransientRing.EndFrame(m_pCommand->GetFenceValue());
 }
 
-void DirectX12::RenderTestTriangle()
+MeshHandle DirectX12::CreateMesh(const MeshDesc& desc)
 {
-	
+	assert(desc.m_pVertices && desc.m_VertexCount && desc.m_VertexStride);
+	assert(desc.m_pIndices && desc.m_IndexCount);
+
+	const UINT indexSize{ desc.m_IndexFormat == IndexFormat::UInt16 ? UINT(sizeof(uint16_t)) : UINT(sizeof(uint32_t)) };
+	const UINT vertexBytes{ desc.m_VertexCount * desc.m_VertexStride };
+	const UINT indexBytes{ desc.m_IndexCount * indexSize };
+
+	DX12Mesh mesh{};
+	mesh.m_pVertexBuffer = CreateUploadBuffer(desc.m_pVertices, vertexBytes);
+	mesh.m_pIndexBuffer = CreateUploadBuffer(desc.m_pIndices, indexBytes);
+
+	mesh.m_VertexBufferView.BufferLocation = mesh.m_pVertexBuffer->GetGPUVirtualAddress();
+	mesh.m_VertexBufferView.SizeInBytes = vertexBytes;
+	mesh.m_VertexBufferView.StrideInBytes = desc.m_VertexStride;
+
+	mesh.m_IndexBufferView.BufferLocation = mesh.m_pIndexBuffer->GetGPUVirtualAddress();
+	mesh.m_IndexBufferView.SizeInBytes = indexBytes;
+	mesh.m_IndexBufferView.Format = desc.m_IndexFormat == IndexFormat::UInt16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+
+	mesh.m_IndexCount = desc.m_IndexCount;
+
+	return m_Meshes.Add(std::move(mesh));
+}
+
+void DirectX12::DestroyMesh(MeshHandle handle)
+{
+	m_Meshes.Remove(handle, m_pCommand->GetFrameIndex());
+}
+
+void DirectX12::BindMesh(MeshHandle handle)
+{
+	const DX12Mesh* pMesh{ m_Meshes.Get(handle) };
+	assert(pMesh);
+	if (!pMesh)
+	{
+		m_BoundIndexCount = 0;
+		return;
+	}
+
+	ID3D12GraphicsCommandList6* pCommandList{ m_pCommand->GetCommandList() };
+	if (m_StateTracker.SetVertexBuffer(pMesh->m_pVertexBuffer.Get(), pMesh->m_VertexBufferView.StrideInBytes))
+		pCommandList->IASetVertexBuffers(0, 1, &pMesh->m_VertexBufferView);
+	if (m_StateTracker.SetIndexBuffer(pMesh->m_pIndexBuffer.Get(), pMesh->m_IndexBufferView.Format))
+		pCommandList->IASetIndexBuffer(&pMesh->m_IndexBufferView);
+
+	m_BoundIndexCount = pMesh->m_IndexCount;
+}
+
+void DirectX12::DrawBoundMesh(uint32_t instanceCount)
+{
+	if (!m_BoundIndexCount)
+		return;
+
+	m_pCommand->GetCommandList()->DrawIndexedInstanced(m_BoundIndexCount, instanceCount, 0, 0, 0);
+}
+
+void DirectX12::BindTransientConstants(ShaderStage stage, uint32_t slot, const TransientAllocation& allocation)
+{
+	assert(allocation.IsValid() && allocation.m_Offset % D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT == 0);
+
+	if (!m_StateTracker.SetConstantBuffer(stage, slot, m_pTransientBuffer.Get(), allocation.m_Offset, allocation.m_Size))
+		return;
+
+	const D3D12_SHADER_VISIBILITY visibility{ stage == ShaderStage::Vertex ? D3D12_SHADER_VISIBILITY_VERTEX : D3D12_SHADER_VISIBILITY_PIXEL };
+	const UINT parameterIndex{ GetRootParameterIndex(D3D12_ROOT_PARAMETER_TYPE_CBV, slot, visibility) };
+
+	const D3D12_GPU_VIRTUAL_ADDRESS address{ m_pTransientBuffer->GetGPUVirtualAddress() + allocation.m_Offset };
+	m_pCommand->GetCommandList()->SetGraphicsRootConstantBufferView(parameterIndex, address);
+}
+
+void DirectX12::BindWorldMatrices(const TransientAllocation& allocation)
+{
+	assert(allocation.IsValid() && allocation.m_Offset % D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT == 0);
+
+	constexpr UINT parameterIndex{ GetRootParameterIndex(D3D12_ROOT_PARAMETER_TYPE_SRV, s_WorldMatricesSlot, D3D12_SHADER_VISIBILITY_VERTEX) };
+
+	// A root SRV is a raw address, the StructuredBuffer starts at the first matrix of this frame
+	const D3D12_GPU_VIRTUAL_ADDRESS address{ m_pTransientBuffer->GetGPUVirtualAddress() + allocation.m_Offset };
+	m_pCommand->GetCommandList()->SetGraphicsRootShaderResourceView(parameterIndex, address);
+}
+
+void DirectX12::FlushUploads()
+{
+	// Upload heap memory is coherent, nothing to do
+}
+
+void DirectX12::CreateSwapChain(IDXGIFactory7* pDXGIFactory)
+{
+	DXGI_SWAP_CHAIN_DESC1 desc{};
+	desc.Width = GameSettings::windowWidth;
+	desc.Height = GameSettings::windowHeight;
+	desc.Format = s_BackBufferFormat;
+	desc.SampleDesc.Count = 1;
+	desc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+	desc.BufferCount = s_BackBufferCount;
+	desc.Scaling = DXGI_SCALING_STRETCH;
+	desc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+	desc.AlphaMode = DXGI_ALPHA_MODE_UNSPECIFIED;
+
+	// DirectX 12 swap chains present through the queue, not the device
+	ComPtr<IDXGISwapChain1> pSwapChain;
+	PGWND_THROW_IF_FAILED(pDXGIFactory->CreateSwapChainForHwnd(m_pCommand->GetCommandQueue(), m_HWnd, &desc, nullptr, nullptr, &pSwapChain));
+	PGWND_THROW_IF_FAILED(pSwapChain.As(&m_pSwapChain));
+
+	for (UINT i{}; i < s_BackBufferCount; ++i)
+	{
+		PGWND_THROW_IF_FAILED(m_pSwapChain->GetBuffer(i, IID_PPV_ARGS(&m_pBackBuffers[i])));
+		m_BackBufferViews[i] = m_pRTVDescHeap->Allocate();
+		m_pDevice->CreateRenderTargetView(m_pBackBuffers[i].Get(), nullptr, m_BackBufferViews[i].m_CPUHandle);
+	}
+
+	m_Viewport = { 0.f, 0.f, static_cast<float>(desc.Width), static_cast<float>(desc.Height), 0.f, 1.f };
+	m_ScissorRect = { 0, 0, static_cast<LONG>(desc.Width), static_cast<LONG>(desc.Height) };
+}
+
+void DirectX12::CreateRootSignature()
+{
+	D3D12_ROOT_PARAMETER parameters[std::size(s_RootBindings)]{};
+	for (size_t i{}; i < std::size(s_RootBindings); ++i)
+	{
+		parameters[i].ParameterType = s_RootBindings[i].m_Type;
+		parameters[i].Descriptor.ShaderRegister = s_RootBindings[i].m_Register;
+		parameters[i].Descriptor.RegisterSpace = 0;
+		parameters[i].ShaderVisibility = s_RootBindings[i].m_Visibility;
+	}
+
+	D3D12_ROOT_SIGNATURE_DESC desc{};
+	desc.NumParameters = static_cast<UINT>(std::size(parameters));
+	desc.pParameters = parameters;
+	desc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+
+	ComPtr<ID3DBlob> pSignature;
+	ComPtr<ID3DBlob> pError;
+	PGWND_THROW_IF_FAILED(D3D12SerializeRootSignature(&desc, D3D_ROOT_SIGNATURE_VERSION_1, &pSignature, &pError));
+	PGWND_THROW_IF_FAILED(m_pDevice->CreateRootSignature(0, pSignature->GetBufferPointer(), pSignature->GetBufferSize(), IID_PPV_ARGS(&m_pRootSignature)));
+	++m_ResourceCreationCount;
+}
+
+void DirectX12::TransitionBackBuffer(D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after) const
+{
+	D3D12_RESOURCE_BARRIER barrier{};
+	barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+	barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+	barrier.Transition.pResource = m_pBackBuffers[m_BackBufferIndex].Get();
+	barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+	barrier.Transition.StateBefore = before;
+	barrier.Transition.StateAfter = after;
+	m_pCommand->GetCommandList()->ResourceBarrier(1, &barrier);
+}
+
+ComPtr<ID3D12Resource> DirectX12::CreateUploadBuffer(const void* pData, UINT64 byteWidth)
+{
+	D3D12_HEAP_PROPERTIES heapProperties{};
+	heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+	heapProperties.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+	heapProperties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+	heapProperties.CreationNodeMask = 1;
+	heapProperties.VisibleNodeMask = 1;
+
+	D3D12_RESOURCE_DESC desc{};
+	desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+	desc.Alignment = 0;
+	desc.Width = byteWidth;
+	desc.Height = 1;
+	desc.DepthOrArraySize = 1;
+	desc.MipLevels = 1;
+	desc.Format = DXGI_FORMAT_UNKNOWN;
+	desc.SampleDesc.Count = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+	desc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+	ComPtr<ID3D12Resource> pBuffer;
+	PGWND_THROW_IF_FAILED(m_pDevice->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&pBuffer)));
+	++m_ResourceCreationCount;
+
+	if (pData)
+	{
+		void* pMapped{};
+		constexpr D3D12_RANGE readRange{ 0, 0 };
+		PGWND_THROW_IF_FAILED(pBuffer->Map(0, &readRange, &pMapped));
+		memcpy(pMapped, pData, byteWidth);
+		pBuffer->Unmap(0, nullptr);
+	}
+
+	return pBuffer;
 }
 
 DirectX12::DX12Command::DX12Command(ID3D12Device8* pDevice, D3D12_COMMAND_LIST_TYPE type)
@@ -531,7 +1311,7 @@ void DirectX12::DX12Command::EndFrame()
 	m_pCommandQueue->ExecuteCommandLists(_countof(commandLists), &commandLists[0]);
 
 	++m_FenceValue;
-	m_CommandFrames->m_FenceValue = m_FenceValue;
+	m_CommandFrames[m_FrameIndex].m_FenceValue = m_FenceValue;
 
 	m_pCommandQueue->Signal(m_pFence.Get(), m_FenceValue);
 
@@ -560,14 +1340,11 @@ DirectX12::DX12DescriptorHeap::~DX12DescriptorHeap()
 
 void DirectX12::DX12DescriptorHeap::BeginFrame()
 {
-	const UINT index{ m_pDx12->m_pCommand->GetFrameIndex() };
-	if (!m_DeferredFreeHandles[index].empty())
-		ProcessDeferredRelease(index);
+	m_Indices.ReclaimFrame(m_pDx12->m_pCommand->GetFrameIndex());
 }
 
 void DirectX12::DX12DescriptorHeap::Initialize(ID3D12Device8* pDevice, UINT capacity, bool isShaderVisible)
 {
-	std::lock_guard lock{ m_Mutex };
 	assert(capacity && capacity < D3D12_MAX_SHADER_VISIBLE_DESCRIPTOR_HEAP_SIZE_TIER_2);
 	assert(!(m_Type == D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER && capacity > D3D12_MAX_SHADER_VISIBLE_SAMPLER_HEAP_SIZE));
 
@@ -584,13 +1361,9 @@ void DirectX12::DX12DescriptorHeap::Initialize(ID3D12Device8* pDevice, UINT capa
 
 	PGWND_THROW_IF_FAILED(pDevice->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&m_pDescriptorHeap)));
 
-	m_FreeHandles = std::move(std::make_unique<UINT[]>(capacity));
-
-	for (UINT i{}; i < capacity; ++i)
-		m_FreeHandles[i] = i;
+	m_Indices.Initialize(capacity);
 
 	m_Capacity = capacity;
-	m_Size = 0;
 	m_DescSize = pDevice->GetDescriptorHandleIncrementSize(m_Type);
 	m_CPUStart = m_pDescriptorHeap->GetCPUDescriptorHandleForHeapStart();
 	m_GPUStart = isShaderVisible ? m_pDescriptorHeap->GetGPUDescriptorHandleForHeapStart() : D3D12_GPU_DESCRIPTOR_HANDLE{ 0 };
@@ -598,21 +1371,17 @@ void DirectX12::DX12DescriptorHeap::Initialize(ID3D12Device8* pDevice, UINT capa
 
 void DirectX12::DX12DescriptorHeap::Release()
 {
-	for (UINT i{}; i < DX12Command::s_BufferCount; ++i)
-		if (!m_DeferredFreeHandles[i].empty())
-			ProcessDeferredRelease(i);
+	m_Indices.ReclaimAll();
 }
 
 DirectX12::DX12DescriptorHandle DirectX12::DX12DescriptorHeap::Allocate()
 {
-	std::lock_guard lock{ m_Mutex };
-
 	assert(m_pDescriptorHeap.Get());
-	assert(m_Size < m_Capacity);
 
-	const UINT index{ m_FreeHandles[m_Size] };
+	const UINT index{ m_Indices.Allocate() };
+	assert(index != m_Indices.s_InvalidIndex && "Descriptor heap is full");
+
 	const UINT offset{ index * m_DescSize };
-	++m_Size;
 
 	DX12DescriptorHandle handle;
 	handle.m_CPUHandle.ptr = m_CPUStart.ptr + offset;
@@ -627,31 +1396,16 @@ void DirectX12::DX12DescriptorHeap::Free(DX12DescriptorHandle& handle)
 	if (!handle.IsValid())
 		return;
 
-	std::lock_guard lock{ m_Mutex };
-	assert(m_pDescriptorHeap.Get() && m_Size);
+	assert(m_pDescriptorHeap.Get() && m_Indices.GetSize());
 	assert(handle.m_CPUHandle.ptr >= m_CPUStart.ptr);
-	assert((handle.m_CPUHandle.ptr - m_CPUStart.ptr) % m_DescSize);
+	assert((handle.m_CPUHandle.ptr - m_CPUStart.ptr) % m_DescSize == 0);
 
 	const UINT index{ UINT(handle.m_CPUHandle.ptr - m_CPUStart.ptr) / m_DescSize };
-	m_DeferredFreeHandles[m_pDx12->m_pCommand->GetFrameIndex()].emplace_back(index);
+	m_Indices.Free(index, m_pDx12->m_pCommand->GetFrameIndex());
 
 	handle = {};
 }
 
-void DirectX12::DX12DescriptorHeap::ProcessDeferredRelease(UINT frameIndex)
-{
-	std::lock_guard lock{ m_Mutex };
-
-	assert(frameIndex < DX12Command::s_BufferCount);
-
-	for (const auto index : m_DeferredFreeHandles[frameIndex])
-	{
-		--m_Size;
-		m_FreeHandles[m_Size] = index;
-	}
-	m_DeferredFreeHandles[frameIndex].clear();
-}
-
 ComPtr<IDXGIAdapter4> DirectX12::FindBestAdapter(IDXGIFactory7* pDXGIFactory, D3D_FEATURE_LEVEL minFeatureLevel) const
 {
 	ComPtr<IDXGIAdapter4> pDXGIAdapter;
@@ -689,19 +1443,1464 @@ D3D_FEATURE_LEVEL DirectX12::FindMaxFeatureLevel(IDXGIAdapter4* pAdapter) const
 
 #pragma endregion
 
-#pragma region Renderer
+#pragma region Null
 
-Renderer::~Renderer()
+class NullRenderer final : public Renderer::RendererImpl
 {
-	delete m_pRendererImpl;
-}
+public:
+	explicit NullRenderer(HWND hwnd) noexcept;
+	~NullRenderer() override = default;
 
-void* Renderer::GetDevice() const
-{
-	return m_pRendererImpl->GetDevice();
-}
+	NullRenderer(const NullRenderer& other) noexcept = delete;
+	NullRenderer& operator=(const NullRenderer& other) noexcept = delete;
+	NullRenderer(NullRenderer&& other) noexcept = delete;
+	NullRenderer& operator=(NullRenderer&& other) noexcept = delete;
 
-void* Renderer::GetDeviceContext() const
+	void* GetDevice() const override;
+	void* GetDeviceContext() const override;
+
+	void BeginFrame() override;
+	void EndFrame() override;
+
+	[[nodiscard]] MeshHandle CreateMesh(const MeshDesc& desc) override;
+	void DestroyMesh(MeshHandle handle) override;
+	void BindMesh(MeshHandle handle) override;
+	void DrawBoundMesh(uint32_t instanceCount) override;
+
+	void BindTransientConstants(ShaderStage stage, uint32_t slot, const TransientAllocation& allocation) override;
+	void BindWorldMatrices(const TransientAllocation& allocation) override;
+	void FlushUploads() override;
+
+	[[nodiscard]] std::span<const RecordedDraw> GetRecordedDraws() const override { return m_RecordedDraws; }
+
+private:
+	/* NESTED CLASSES */
+
+	struct NullMesh
+	{
+		uint32_t m_VertexCount{};
+		uint32_t m_IndexCount{};
+	};
+
+	/* DATA MEMBERS */
+
+	ResourceTable<MeshTag, NullMesh, Renderer::s_FrameCount> m_Meshes{};
+	std::vector<RecordedDraw> m_RecordedDraws{}; // In submission order
+	MeshHandle m_BoundMesh{};
+	uint32_t m_FrameIndex{};
+
+	std::unique_ptr<uint8_t[]> m_pTransientMemory{};
+	uint64_t m_FrameFenceValue{};
+
+	/* PRIVATE METHODS */
+
+};
+
+NullRenderer::NullRenderer(HWND hwnd) noexcept
+	: RendererImpl{ hwnd }
+	, m_pTransientMemory{ std::make_unique<uint8_t[]>(GameSettings::transientUploadBufferSize) }
+{
+	m_TransientRing.Initialize(m_pTransientMemory.get(), GameSettings::transientUploadBufferSize, Renderer::s_ConstantBufferAlignment);
+}
+
+void* NullRenderer::GetDevice() const
+{
+	return nullptr;
+}
+
+void* NullRenderer::GetDeviceContext() const
+{
+	return nullptr;
+}
+
+void NullRenderer::BeginFrame()
+{
+	m_Meshes.BeginFrame(m_FrameIndex);
+	m_RecordedDraws.clear();
+
+	// No GPU, every frame completes as soon as it ends
+	[[maybe_unused]] const bool isRegionFree{ m_TransientRing.BeginFrame(m_FrameFenceValue) };
+	assert(isRegionFree);
+}
+
+void NullRenderer::EndFrame()
+{
+	m_TransientRing.EndFrame(++m_FrameFenceValue);
+	m_FrameIndex = (m_FrameIndex + 1) % Renderer::s_FrameCount;
+}
+
+MeshHandle NullRenderer::CreateMesh(const MeshDesc& desc)
+{
+	// Vertex and index buffer, same count as the GPU backends
+	m_ResourceCreationCount += 2;
+	return m_Meshes.Add(NullMesh{ desc.m_VertexCount, desc.m_IndexCount });
+}
+
+void NullRenderer::DestroyMesh(MeshHandle handle)
+{
+	m_Meshes.Remove(handle, m_FrameIndex);
+}
+
+void NullRenderer::BindMesh(MeshHandle handle)
+{
+	assert(m_Meshes.IsAlive(handle));
+	m_BoundMesh = handle;
+}
+
+void NullRenderer::DrawBoundMesh(uint32_t instanceCount)
+{
+	m_RecordedDraws.emplace_back(RecordedDraw{ m_BoundMesh, m_pBoundMaterial, instanceCount });
+}
+
+void NullRenderer::BindTransientConstants(ShaderStage /*stage*/, uint32_t /*slot*/, const TransientAllocation& allocation)
+{
+	assert(allocation.IsValid());
+}
+
+void NullRenderer::BindWorldMatrices(const TransientAllocation& allocation)
+{
+	assert(allocation.IsValid());
+}
+
+void NullRenderer::FlushUploads()
+{
+}
+
+#pragma endregion
+
+#ifdef PICOGINE_VULKAN
+#pragma region Vulkan
+
+class Vulkan final : public Renderer::RendererImpl
+{
+public:
+	explicit Vulkan(HWND hwnd);
+	~Vulkan() override;
+
+	Vulkan(const Vulkan& other) = delete;
+	Vulkan& operator=(const Vulkan& other) noexcept = delete;
+	Vulkan(Vulkan&& other) = delete;
+	Vulkan& operator=(Vulkan&& other) noexcept = delete;
+
+	void* GetDevice() const override;
+	void* GetDeviceContext() const override;
+
+	void BeginFrame() override;
+	void EndFrame() override;
+
+	[[nodiscard]] MeshHandle CreateMesh(const MeshDesc& desc) override;
+	void DestroyMesh(MeshHandle handle) override;
+	void BindMesh(MeshHandle handle) override;
+	void DrawBoundMesh(uint32_t instanceCount) override;
+
+	void BindTransientConstants(ShaderStage stage, uint32_t slot, const TransientAllocation& allocation) override;
+	void BindWorldMatrices(const TransientAllocation& allocation) override;
+	void FlushUploads() override;
+
+	bool SaveFrame(const std::string& path) override;
+
+private:
+	/* NESTED CLASSES */
+
+	/**
+	 * \brief Frames in flight, same model as DX12Command with a timeline semaphore standing in for the fence
+	 */
+	class VKCommand final
+	{
+	public:
+		VKCommand(VkDevice device, uint32_t queueFamilyIndex);
+		~VKCommand();
+
+		VKCommand(const VKCommand& other) noexcept = delete;
+		VKCommand& operator=(const VKCommand& other) noexcept = delete;
+		VKCommand(VKCommand&& other) noexcept = delete;
+		VKCommand& operator=(VKCommand&& other) noexcept = delete;
+
+		void BeginFrame() const;
+		/**
+		 * \param waitSemaphore Binary semaphore waited before color output, VK_NULL_HANDLE if none
+		 * \param signalSemaphore Binary semaphore signaled on completion, VK_NULL_HANDLE if none
+		 */
+		void EndFrame(VkSemaphore waitSemaphore, VkSemaphore signalSemaphore);
+		void Flush() const;
+
+		[[nodiscard]] VkQueue GetCommandQueue() const { return m_Queue; }
+		[[nodiscard]] VkCommandBuffer GetCommandBuffer() const { return m_CommandFrames[m_FrameIndex].m_CommandBuffer; }
+		[[nodiscard]] uint32_t GetFrameIndex() const { return m_FrameIndex; }
+		[[nodiscard]] uint64_t GetFenceValue() const { return m_FenceValue; }
+		[[nodiscard]] uint64_t GetCompletedFenceValue() const;
+
+		inline static constexpr int s_BufferCount{ Renderer::s_FrameCount };
+
+	private:
+		/* NESTED CLASSES */
+
+		struct CommandFrame final
+		{
+			VkCommandPool m_CommandPool{};
+			VkCommandBuffer m_CommandBuffer{};
+			uint64_t m_FenceValue{};
+
+			void Wait(VkDevice device, VkSemaphore fence) const;
+		};
+
+		/* DATA MEMBERS */
+
+		VkDevice m_Device{};
+		VkQueue m_Queue{};
+		CommandFrame m_CommandFrames[s_BufferCount]{};
+		uint32_t m_FrameIndex{};
+
+		VkSemaphore m_Fence{}; // Timeline
+		uint64_t m_FenceValue{};
+
+		/* PRIVATE METHODS */
+
+	};
+
+	struct VKBuffer final
+	{
+		VKBuffer() noexcept = default;
+		~VKBuffer();
+
+		VKBuffer(const VKBuffer& other) noexcept = delete;
+		VKBuffer& operator=(const VKBuffer& other) noexcept = delete;
+		VKBuffer(VKBuffer&& other) noexcept;
+		VKBuffer& operator=(VKBuffer&& other) noexcept;
+
+		void Release();
+
+		VkDevice m_Device{};
+		VkBuffer m_Buffer{};
+		VkDeviceMemory m_Memory{};
+		void* m_pMapped{}; // Host visible memory stays mapped
+	};
+
+	struct VKMesh
+	{
+		VKBuffer m_VertexBuffer{};
+		VKBuffer m_IndexBuffer{};
+		VkIndexType m_IndexType{ VK_INDEX_TYPE_UINT16 };
+		uint32_t m_IndexCount{};
+	};
+
+	/* DATA MEMBERS */
+
+	VkInstance m_Instance{};
+	VkPhysicalDevice m_PhysicalDevice{};
+	VkDevice m_Device{};
+	uint32_t m_QueueFamilyIndex{};
+	VkPhysicalDeviceMemoryProperties m_MemoryProperties{};
+	std::unique_ptr<VKCommand> m_pCommand;
+
+	// Render target, either the swap chain images or a single offscreen image
+	const bool m_IsOffscreen{ GameSettings::renderOffscreen };
+	VkSurfaceKHR m_Surface{};
+	VkSwapchainKHR m_SwapChain{};
+	VkFormat m_ColorFormat{ VK_FORMAT_B8G8R8A8_UNORM };
+	VkExtent2D m_Extent{};
+	std::vector<VkImage> m_Images{};
+	std::vector<VkImageView> m_ImageViews{};
+	std::vector<VkFramebuffer> m_Framebuffers{};
+	std::vector<VkSemaphore> m_RenderFinishedSemaphores{}; // Per image
+	VkSemaphore m_AcquireSemaphores[VKCommand::s_BufferCount]{};
+	VkDeviceMemory m_OffscreenMemory{};
+	uint32_t m_ImageIndex{};
+	bool m_HasRenderedFrame{};
+
+	VkRenderPass m_RenderPass{};
+
+	// Transient constants are bound as dynamic uniform buffers, a single descriptor set covers every draw
+	VkDescriptorSetLayout m_DescriptorSetLayout{};
+	VkDescriptorPool m_DescriptorPool{};
+	VkDescriptorSet m_DescriptorSet{};
+	VkPipelineLayout m_PipelineLayout{};
+	uint32_t m_DynamicOffsets[4]{}; // HLSL register bN maps to binding N, t0 to the binding after the constants
+	bool m_AreDescriptorsDirty{ true };
+
+	std::unique_ptr<VulkanContext> m_pContext;
+
+	ResourceTable<MeshTag, VKMesh, VKCommand::s_BufferCount> m_Meshes{};
+	uint32_t m_BoundIndexCount{};
+
+	VKBuffer m_TransientBuffer{};
+
+	inline static constexpr uint32_t s_ConstantBindingCount{ 3 }; // Material, object and view constants
+	inline static constexpr VkDeviceSize s_ConstantBindingRange{ s_MaxInstancesPerDraw * sizeof(InstanceData) };
+	inline static constexpr uint32_t s_WorldMatricesBinding{ s_ConstantBindingCount }; // Shifted by dxc -fvk-t-shift
+	inline static constexpr uint32_t s_DynamicBindingCount{ s_ConstantBindingCount + 1 };
+
+	/* PRIVATE METHODS */
+
+	void CreateDevice();
+	void CreateSwapChain();
+	void CreateOffscreenTarget();
+	void CreateRenderPass();
+	void CreateDescriptors();
+
+	VKBuffer CreateBuffer(const void* pData, VkDeviceSize byteWidth, VkBufferUsageFlags usage);
+	[[nodiscard]] static VkDeviceSize GetWorldMatricesRange() { return VkDeviceSize{ GameSettings::maxObjectsPerFrame } * sizeof(XMFLOAT3X4A); }
+	[[nodiscard]] uint32_t FindMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties) const;
+	[[nodiscard]] VkPhysicalDevice FindBestPhysicalDevice(uint32_t& queueFamilyIndex) const;
+	
+};
+
+Vulkan::Vulkan(HWND hwnd) : RendererImpl{ hwnd }
+{
+	CreateDevice();
+	m_pCommand = std::make_unique<VKCommand>(m_Device, m_QueueFamilyIndex);
+
+	if (m_IsOffscreen)
+		CreateOffscreenTarget();
+	else
+		CreateSwapChain();
+
+	CreateRenderPass();
+
+	m_Framebuffers.resize(m_ImageViews.size());
+	for (size_t i{}; i < m_ImageViews.size(); ++i)
+	{
+		VkFramebufferCreateInfo framebufferInfo{};
+		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferInfo.renderPass = m_RenderPass;
+		framebufferInfo.attachmentCount = 1;
+		framebufferInfo.pAttachments = &m_ImageViews[i];
+		framebufferInfo.width = m_Extent.width;
+		framebufferInfo.height = m_Extent.height;
+		framebufferInfo.layers = 1;
+		PGVK_THROW_IF_FAILED(vkCreateFramebuffer(m_Device, &framebufferInfo, nullptr, &m_Framebuffers[i]));
+	}
+
+	// The descriptor range is fixed, the buffer is padded so any offset in the ring can be bound
+	const VkDeviceSize bindingRange{ std::max(s_ConstantBindingRange, GetWorldMatricesRange()) };
+	m_TransientBuffer = CreateBuffer(nullptr, GameSettings::transientUploadBufferSize + bindingRange, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+	m_TransientRing.Initialize(m_TransientBuffer.m_pMapped, GameSettings::transientUploadBufferSize, Renderer::s_ConstantBufferAlignment);
+
+	CreateDescriptors();
+
+	m_pContext = std::make_unique<VulkanContext>(m_Device, m_RenderPass, m_PipelineLayout);
+}
+
+Vulkan::~Vulkan()
+{
+	// m_pCommand waits for every frame in flight when destroyed, resources must outlive it
+	m_pCommand.reset();
+
+	m_pContext.reset();
+	m_Meshes.Clear();
+	m_TransientRing.Release();
+	m_TransientBuffer.Release();
+
+	vkDestroyPipelineLayout(m_Device, m_PipelineLayout, nullptr);
+	vkDestroyDescriptorPool(m_Device, m_DescriptorPool, nullptr);
+	vkDestroyDescriptorSetLayout(m_Device, m_DescriptorSetLayout, nullptr);
+
+	for (const VkFramebuffer framebuffer : m_Framebuffers)
+		vkDestroyFramebuffer(m_Device, framebuffer, nullptr);
+	vkDestroyRenderPass(m_Device, m_RenderPass, nullptr);
+
+	for (const VkImageView imageView : m_ImageViews)
+		vkDestroyImageView(m_Device, imageView, nullptr);
+	for (const VkSemaphore semaphore : m_RenderFinishedSemaphores)
+		vkDestroySemaphore(m_Device, semaphore, nullptr);
+	for (const VkSemaphore semaphore : m_AcquireSemaphores)
+		vkDestroySemaphore(m_Device, semaphore, nullptr);
+
+	if (m_IsOffscreen)
+	{
+		vkDestroyImage(m_Device, m_Images.front(), nullptr);
+		vkFreeMemory(m_Device, m_OffscreenMemory, nullptr);
+	}
+	else
+	{
+		vkDestroySwapchainKHR(m_Device, m_SwapChain, nullptr);
+		vkDestroySurfaceKHR(m_Instance, m_Surface, nullptr);
+	}
+
+	vkDestroyDevice(m_Device, nullptr);
+	vkDestroyInstance(m_Instance, nullptr);
+}
+
+void* Vulkan::GetDevice() const
+{
+	return m_pContext.get();
+}
+
+void* Vulkan::GetDeviceContext() const
+{
+	return m_pCommand->GetCommandBuffer();
+}
+
+void Vulkan::BeginFrame()
+{
+	m_pCommand->BeginFrame();
+	const uint32_t frameIndex{ m_pCommand->GetFrameIndex() };
+	m_Meshes.BeginFrame(frameIndex);
+	m_pContext->BeginFrame(frameIndex);
+
+	// m_pCommand already waited for this frame's fence
+	[[maybe_unused]] const bool isRegionFree{ m_TransientRing.BeginFrame(m_pCommand->GetCompletedFenceValue()) };
+	assert(isRegionFree);
+
+	m_ImageIndex = 0;
+	if (!m_IsOffscreen)
+		PGVK_THROW_IF_FAILED(vkAcquireNextImageKHR(m_Device, m_SwapChain, UINT64_MAX, m_AcquireSemaphores[frameIndex], VK_NULL_HANDLE, &m_ImageIndex));
+
+	const VkCommandBuffer commandBuffer{ m_pCommand->GetCommandBuffer() };
+
+	VkClearValue clearValue{};
+	memcpy(clearValue.color.float32, m_DefaultBackgroundColor, sizeof(clearValue.color.float32));
+
+	VkRenderPassBeginInfo renderPassInfo{};
+	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderPassInfo.renderPass = m_RenderPass;
+	renderPassInfo.framebuffer = m_Framebuffers[m_ImageIndex];
+	renderPassInfo.renderArea.extent = m_Extent;
+	renderPassInfo.clearValueCount = 1;
+	renderPassInfo.pClearValues = &clearValue;
+	vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+	VkViewport viewport{};
+	viewport.width = static_cast<float>(m_Extent.width);
+	viewport.height = static_cast<float>(m_Extent.height);
+	viewport.minDepth = 0.f;
+	viewport.maxDepth = 1.f;
+	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+	const VkRect2D scissor{ {}, m_Extent };
+	vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+	// Command buffers start without any bound state
+	m_AreDescriptorsDirty = true;
+	m_StateTracker.Invalidate();
+}
+
+void Vulkan::EndFrame()
+{
+	vkCmdEndRenderPass(m_pCommand->GetCommandBuffer());
+
+	if (m_IsOffscreen)
+	{
+		m_pCommand->EndFrame(VK_NULL_HANDLE, VK_NULL_HANDLE);
+	}
+	else
+	{
+		const VkSemaphore renderFinished{ m_RenderFinishedSemaphores[m_ImageIndex] };
+		m_pCommand->EndFrame(m_AcquireSemaphores[m_pCommand->GetFrameIndex()], renderFinished);
+
+		VkPresentInfoKHR presentInfo{};
+		presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+		presentInfo.waitSemaphoreCount = 1;
+		presentInfo.pWaitSemaphores = &renderFinished;
+		presentInfo.swapchainCount = 1;
+		presentInfo.pSwapchains = &m_SwapChain;
+		presentInfo.pImageIndices = &m_ImageIndex;
+		PGVK_THROW_IF_FAILED(vkQueuePresentKHR(m_pCommand->GetCommandQueue(), &presentInfo));
+	}
+
+	m_TransientRing.EndFrame(m_pCommand->GetFenceValue());
+	m_HasRenderedFrame = true;
+}
+
+MeshHandle Vulkan::CreateMesh(const MeshDesc& desc)
+{
+	assert(desc.m_pVertices && desc.m_VertexCount && desc.m_VertexStride);
+	assert(desc.m_pIndices && desc.m_IndexCount);
+
+	const VkDeviceSize indexSize{ desc.m_IndexFormat == IndexFormat::UInt16 ? sizeof(uint16_t) : sizeof(uint32_t) };
+
+	VKMesh mesh{};
+	mesh.m_VertexBuffer = CreateBuffer(desc.m_pVertices, VkDeviceSize{ desc.m_VertexCount } * desc.m_VertexStride, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+	mesh.m_IndexBuffer = CreateBuffer(desc.m_pIndices, desc.m_IndexCount * indexSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+	mesh.m_IndexType = desc.m_IndexFormat == IndexFormat::UInt16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+	mesh.m_IndexCount = desc.m_IndexCount;
+
+	return m_Meshes.Add(std::move(mesh));
+}
+
+void Vulkan::DestroyMesh(MeshHandle handle)
+{
+	m_Meshes.Remove(handle, m_pCommand->GetFrameIndex());
+}
+
+void Vulkan::BindMesh(MeshHandle handle)
+{
+	const VKMesh* pMesh{ m_Meshes.Get(handle) };
+	assert(pMesh);
+	if (!pMesh)
+	{
+		m_BoundIndexCount = 0;
+		return;
+	}
+
+	const VkCommandBuffer commandBuffer{ m_pCommand->GetCommandBuffer() };
+	constexpr VkDeviceSize vbOffset{ 0 };
+	if (m_StateTracker.SetVertexBuffer(pMesh->m_VertexBuffer.m_Buffer, 0, vbOffset))
+		vkCmdBindVertexBuffers(commandBuffer, 0, 1, &pMesh->m_VertexBuffer.m_Buffer, &vbOffset);
+	if (m_StateTracker.SetIndexBuffer(pMesh->m_IndexBuffer.m_Buffer, pMesh->m_IndexType))
+		vkCmdBindIndexBuffer(commandBuffer, pMesh->m_IndexBuffer.m_Buffer, 0, pMesh->m_IndexType);
+
+	m_BoundIndexCount = pMesh->m_IndexCount;
+}
+
+void Vulkan::DrawBoundMesh(uint32_t instanceCount)
+{
+	if (!m_BoundIndexCount)
+		return;
+
+	const VkCommandBuffer commandBuffer{ m_pCommand->GetCommandBuffer() };
+
+	// Pipelines share the layout, the set stays bound across material changes
+	if (m_AreDescriptorsDirty)
+	{
+		vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout, 0, 1, &m_DescriptorSet, s_DynamicBindingCount, m_DynamicOffsets);
+		m_AreDescriptorsDirty = false;
+	}
+
+	vkCmdDrawIndexed(commandBuffer, m_BoundIndexCount, instanceCount, 0, 0, 0);
+}
+
+void Vulkan::BindTransientConstants(ShaderStage /*stage*/, uint32_t slot, const TransientAllocation& allocation)
+{
+	assert(allocation.IsValid() && allocation.m_Size <= s_ConstantBindingRange);
+	assert(slot < s_ConstantBindingCount);
+
+	// Both bindings are visible to every stage
+	const auto offset = static_cast<uint32_t>(allocation.m_Offset);
+	if (m_DynamicOffsets[slot] != offset)
+	{
+		m_DynamicOffsets[slot] = offset;
+		m_AreDescriptorsDirty = true;
+	}
+}
+
+void Vulkan::BindWorldMatrices(const TransientAllocation& allocation)
+{
+	assert(allocation.IsValid() && allocation.m_Size <= GetWorldMatricesRange());
+
+	const auto offset = static_cast<uint32_t>(allocation.m_Offset);
+	if (m_DynamicOffsets[s_WorldMatricesBinding] != offset)
+	{
+		m_DynamicOffsets[s_WorldMatricesBinding] = offset;
+		m_AreDescriptorsDirty = true;
+	}
+}
+
+void Vulkan::FlushUploads()
+{
+	// Host coherent memory, nothing to do
+}
+
+bool Vulkan::SaveFrame(const std::string& path)
+{
+	// Swap chain images are owned by the presentation engine, only the offscreen target is read back
+	if (!m_IsOffscreen || !m_HasRenderedFrame)
+		return false;
+
+	m_pCommand->Flush();
+
+	const VkDeviceSize byteWidth{ VkDeviceSize{ m_Extent.width } * m_Extent.height * sizeof(uint32_t) };
+	VKBuffer readback{ CreateBuffer(nullptr, byteWidth, VK_BUFFER_USAGE_TRANSFER_DST_BIT) };
+
+	VkCommandPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	poolInfo.queueFamilyIndex = m_QueueFamilyIndex;
+	VkCommandPool commandPool{};
+	PGVK_THROW_IF_FAILED(vkCreateCommandPool(m_Device, &poolInfo, nullptr, &commandPool));
+
+	VkCommandBufferAllocateInfo allocateInfo{};
+	allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocateInfo.commandPool = commandPool;
+	allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocateInfo.commandBufferCount = 1;
+	VkCommandBuffer commandBuffer{};
+	PGVK_THROW_IF_FAILED(vkAllocateCommandBuffers(m_Device, &allocateInfo, &commandBuffer));
+
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	PGVK_THROW_IF_FAILED(vkBeginCommandBuffer(commandBuffer, &beginInfo));
+
+	// The render pass leaves the image in TRANSFER_SRC_OPTIMAL
+	VkBufferImageCopy region{};
+	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	region.imageSubresource.layerCount = 1;
+	region.imageExtent = { m_Extent.width, m_Extent.height, 1 };
+	vkCmdCopyImageToBuffer(commandBuffer, m_Images.front(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readback.m_Buffer, 1, &region);
+
+	VkBufferMemoryBarrier hostBarrier{};
+	hostBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+	hostBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	hostBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	hostBarrier.buffer = readback.m_Buffer;
+	hostBarrier.size = VK_WHOLE_SIZE;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &hostBarrier, 0, nullptr);
+
+	PGVK_THROW_IF_FAILED(vkEndCommandBuffer(commandBuffer));
+
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &commandBuffer;
+	PGVK_THROW_IF_FAILED(vkQueueSubmit(m_pCommand->GetCommandQueue(), 1, &submitInfo, VK_NULL_HANDLE));
+	PGVK_THROW_IF_FAILED(vkQueueWaitIdle(m_pCommand->GetCommandQueue()));
+
+	vkDestroyCommandPool(m_Device, commandPool, nullptr);
+
+	return ImageWriter::SaveTGA(path, static_cast<const uint32_t*>(readback.m_pMapped), m_Extent.width, m_Extent.height, m_Extent.width);
+}
+
+void Vulkan::CreateDevice()
+{
+	VkApplicationInfo applicationInfo{};
+	applicationInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+	applicationInfo.pApplicationName = "PicoGine";
+	applicationInfo.pEngineName = "PicoGine";
+	applicationInfo.apiVersion = VK_API_VERSION_1_2; // Timeline semaphores
+
+	std::vector<const char*> instanceExtensions{};
+	if (!m_IsOffscreen)
+	{
+		instanceExtensions.emplace_back(VK_KHR_SURFACE_EXTENSION_NAME);
+#ifdef _WIN32
+		instanceExtensions.emplace_back(VK_KHR_WIN32_SURFACE_EXTENSION_NAME);
+#endif
+	}
+
+	std::vector<const char*> layers{};
+#ifdef _DEBUG
+	{
+		uint32_t layerCount{};
+		vkEnumerateInstanceLayerProperties(&layerCount, nullptr);
+		std::vector<VkLayerProperties> availableLayers(layerCount);
+		vkEnumerateInstanceLayerProperties(&layerCount, availableLayers.data());
+
+		constexpr const char* validationLayer{ "VK_LAYER_KHRONOS_validation" };
+		if (std::ranges::any_of(availableLayers, [validationLayer](const VkLayerProperties& layer) { return strcmp(layer.layerName, validationLayer) == 0; }))
+			layers.emplace_back(validationLayer);
+	}
+#endif
+
+	VkInstanceCreateInfo instanceInfo{};
+	instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+	instanceInfo.pApplicationInfo = &applicationInfo;
+	instanceInfo.enabledExtensionCount = static_cast<uint32_t>(instanceExtensions.size());
+	instanceInfo.ppEnabledExtensionNames = instanceExtensions.data();
+	instanceInfo.enabledLayerCount = static_cast<uint32_t>(layers.size());
+	instanceInfo.ppEnabledLayerNames = layers.data();
+	PGVK_THROW_IF_FAILED(vkCreateInstance(&instanceInfo, nullptr, &m_Instance));
+
+	// No Xlib, XCB or Wayland surface yet: the window comes from Win32, elsewhere only the offscreen target works
+	if (!m_IsOffscreen)
+	{
+#ifdef _WIN32
+		VkWin32SurfaceCreateInfoKHR surfaceInfo{};
+		surfaceInfo.sType = VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR;
+		surfaceInfo.hinstance = GetModuleHandle(nullptr);
+		surfaceInfo.hwnd = m_HWnd;
+		PGVK_THROW_IF_FAILED(vkCreateWin32SurfaceKHR(m_Instance, &surfaceInfo, nullptr, &m_Surface));
+#else
+		throw PGVK_EXCEPTION(VK_ERROR_EXTENSION_NOT_PRESENT);
+#endif
+	}
+
+	m_PhysicalDevice = FindBestPhysicalDevice(m_QueueFamilyIndex);
+	if (!m_PhysicalDevice)
+		throw PGVK_EXCEPTION(VK_ERROR_INCOMPATIBLE_DRIVER);
+
+	vkGetPhysicalDeviceMemoryProperties(m_PhysicalDevice, &m_MemoryProperties);
+
+	VkPhysicalDeviceProperties properties{};
+	vkGetPhysicalDeviceProperties(m_PhysicalDevice, &properties);
+	if (properties.limits.maxUniformBufferRange < s_ConstantBindingRange || properties.limits.minUniformBufferOffsetAlignment > Renderer::s_ConstantBufferAlignment)
+		throw PGVK_EXCEPTION(VK_ERROR_FEATURE_NOT_PRESENT);
+	if (properties.limits.maxStorageBufferRange < GetWorldMatricesRange() || properties.limits.minStorageBufferOffsetAlignment > Renderer::s_ConstantBufferAlignment)
+		throw PGVK_EXCEPTION(VK_ERROR_FEATURE_NOT_PRESENT);
+
+	constexpr float queuePriority{ 1.f };
+	VkDeviceQueueCreateInfo queueInfo{};
+	queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+	queueInfo.queueFamilyIndex = m_QueueFamilyIndex;
+	queueInfo.queueCount = 1;
+	queueInfo.pQueuePriorities = &queuePriority;
+
+	VkPhysicalDeviceVulkan12Features features12{};
+	features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+	features12.timelineSemaphore = VK_TRUE;
+
+	std::vector<const char*> deviceExtensions{};
+	if (!m_IsOffscreen)
+		deviceExtensions.emplace_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+
+	VkDeviceCreateInfo deviceInfo{};
+	deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+	deviceInfo.pNext = &features12;
+	deviceInfo.queueCreateInfoCount = 1;
+	deviceInfo.pQueueCreateInfos = &queueInfo;
+	deviceInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
+	deviceInfo.ppEnabledExtensionNames = deviceExtensions.data();
+	PGVK_THROW_IF_FAILED(vkCreateDevice(m_PhysicalDevice, &deviceInfo, nullptr, &m_Device));
+}
+
+void Vulkan::CreateSwapChain()
+{
+	VkSurfaceCapabilitiesKHR capabilities{};
+	PGVK_THROW_IF_FAILED(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_PhysicalDevice, m_Surface, &capabilities));
+
+	uint32_t formatCount{};
+	PGVK_THROW_IF_FAILED(vkGetPhysicalDeviceSurfaceFormatsKHR(m_PhysicalDevice, m_Surface, &formatCount, nullptr));
+	std::vector<VkSurfaceFormatKHR> formats(formatCount);
+	PGVK_THROW_IF_FAILED(vkGetPhysicalDeviceSurfaceFormatsKHR(m_PhysicalDevice, m_Surface, &formatCount, formats.data()));
+
+	// Same format as the DX11 swap chain when available
+	VkSurfaceFormatKHR surfaceFormat{ formats.front() };
+	for (const VkSurfaceFormatKHR& format : formats)
+	{
+		if (format.format == VK_FORMAT_B8G8R8A8_UNORM)
+		{
+			surfaceFormat = format;
+			break;
+		}
+	}
+	m_ColorFormat = surfaceFormat.format;
+
+	uint32_t presentModeCount{};
+	PGVK_THROW_IF_FAILED(vkGetPhysicalDeviceSurfacePresentModesKHR(m_PhysicalDevice, m_Surface, &presentModeCount, nullptr));
+	std::vector<VkPresentModeKHR> presentModes(presentModeCount);
+	PGVK_THROW_IF_FAILED(vkGetPhysicalDeviceSurfacePresentModesKHR(m_PhysicalDevice, m_Surface, &presentModeCount, presentModes.data()));
+
+	// FIFO is always supported
+	VkPresentModeKHR presentMode{ VK_PRESENT_MODE_FIFO_KHR };
+	if (!m_VSyncEnabled && std::ranges::find(presentModes, VK_PRESENT_MODE_IMMEDIATE_KHR) != presentModes.end())
+		presentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+
+	m_Extent = capabilities.currentExtent;
+	if (m_Extent.width == UINT32_MAX)
+		m_Extent = { GameSettings::windowWidth, GameSettings::windowHeight };
+
+	uint32_t imageCount{ std::max(capabilities.minImageCount + 1, static_cast<uint32_t>(Renderer::s_FrameCount)) };
+	if (capabilities.maxImageCount)
+		imageCount = std::min(imageCount, capabilities.maxImageCount);
+
+	VkSwapchainCreateInfoKHR swapChainInfo{};
+	swapChainInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+	swapChainInfo.surface = m_Surface;
+	swapChainInfo.minImageCount = imageCount;
+	swapChainInfo.imageFormat = surfaceFormat.format;
+	swapChainInfo.imageColorSpace = surfaceFormat.colorSpace;
+	swapChainInfo.imageExtent = m_Extent;
+	swapChainInfo.imageArrayLayers = 1;
+	swapChainInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+	swapChainInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	swapChainInfo.preTransform = capabilities.currentTransform;
+	swapChainInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+	swapChainInfo.presentMode = presentMode;
+	swapChainInfo.clipped = VK_TRUE;
+	PGVK_THROW_IF_FAILED(vkCreateSwapchainKHR(m_Device, &swapChainInfo, nullptr, &m_SwapChain));
+
+	PGVK_THROW_IF_FAILED(vkGetSwapchainImagesKHR(m_Device, m_SwapChain, &imageCount, nullptr));
+	m_Images.resize(imageCount);
+	PGVK_THROW_IF_FAILED(vkGetSwapchainImagesKHR(m_Device, m_SwapChain, &imageCount, m_Images.data()));
+
+	VkSemaphoreCreateInfo semaphoreInfo{};
+	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+	m_ImageViews.resize(imageCount);
+	m_RenderFinishedSemaphores.resize(imageCount);
+	for (uint32_t i{}; i < imageCount; ++i)
+	{
+		VkImageViewCreateInfo viewInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = m_Images[i];
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = m_ColorFormat;
+		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		viewInfo.subresourceRange.levelCount = 1;
+		viewInfo.subresourceRange.layerCount = 1;
+		PGVK_THROW_IF_FAILED(vkCreateImageView(m_Device, &viewInfo, nullptr, &m_ImageViews[i]));
+
+		PGVK_THROW_IF_FAILED(vkCreateSemaphore(m_Device, &semaphoreInfo, nullptr, &m_RenderFinishedSemaphores[i]));
+	}
+
+	for (VkSemaphore& semaphore : m_AcquireSemaphores)
+		PGVK_THROW_IF_FAILED(vkCreateSemaphore(m_Device, &semaphoreInfo, nullptr, &semaphore));
+}
+
+void Vulkan::CreateOffscreenTarget()
+{
+	m_Extent = { GameSettings::windowWidth, GameSettings::windowHeight };
+
+	VkImageCreateInfo imageInfo{};
+	imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	imageInfo.imageType = VK_IMAGE_TYPE_2D;
+	imageInfo.format = m_ColorFormat;
+	imageInfo.extent = { m_Extent.width, m_Extent.height, 1 };
+	imageInfo.mipLevels = 1;
+	imageInfo.arrayLayers = 1;
+	imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+	imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+	imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+	imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+	VkImage image{};
+	PGVK_THROW_IF_FAILED(vkCreateImage(m_Device, &imageInfo, nullptr, &image));
+	m_Images.emplace_back(image);
+
+	VkMemoryRequirements requirements{};
+	vkGetImageMemoryRequirements(m_Device, image, &requirements);
+
+	VkMemoryAllocateInfo allocateInfo{};
+	allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocateInfo.allocationSize = requirements.size;
+	allocateInfo.memoryTypeIndex = FindMemoryType(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	PGVK_THROW_IF_FAILED(vkAllocateMemory(m_Device, &allocateInfo, nullptr, &m_OffscreenMemory));
+	PGVK_THROW_IF_FAILED(vkBindImageMemory(m_Device, image, m_OffscreenMemory, 0));
+	++m_ResourceCreationCount;
+
+	VkImageViewCreateInfo viewInfo{};
+	viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	viewInfo.image = image;
+	viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	viewInfo.format = m_ColorFormat;
+	viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	viewInfo.subresourceRange.levelCount = 1;
+	viewInfo.subresourceRange.layerCount = 1;
+
+	VkImageView imageView{};
+	PGVK_THROW_IF_FAILED(vkCreateImageView(m_Device, &viewInfo, nullptr, &imageView));
+	m_ImageViews.emplace_back(imageView);
+}
+
+void Vulkan::CreateRenderPass()
+{
+	VkAttachmentDescription colorAttachment{};
+	colorAttachment.format = m_ColorFormat;
+	colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+	colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+	colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	colorAttachment.finalLayout = m_IsOffscreen ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+	constexpr VkAttachmentReference colorReference{ 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+
+	VkSubpassDescription subpass{};
+	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpass.colorAttachmentCount = 1;
+	subpass.pColorAttachments = &colorReference;
+
+	// Orders the clear after the acquire, the previous frame and the offscreen readback
+	VkSubpassDependency dependency{};
+	dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+	dependency.dstSubpass = 0;
+	dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+	dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+	VkRenderPassCreateInfo renderPassInfo{};
+	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	renderPassInfo.attachmentCount = 1;
+	renderPassInfo.pAttachments = &colorAttachment;
+	renderPassInfo.subpassCount = 1;
+	renderPassInfo.pSubpasses = &subpass;
+	renderPassInfo.dependencyCount = 1;
+	renderPassInfo.pDependencies = &dependency;
+	PGVK_THROW_IF_FAILED(vkCreateRenderPass(m_Device, &renderPassInfo, nullptr, &m_RenderPass));
+}
+
+void Vulkan::CreateDescriptors()
+{
+	// Constant buffers first, then the world matrices as a storage buffer
+	VkDescriptorSetLayoutBinding bindings[s_DynamicBindingCount]{};
+	for (uint32_t i{}; i < s_DynamicBindingCount; ++i)
+	{
+		const bool isWorldMatrices{ i == s_WorldMatricesBinding };
+		bindings[i].binding = i;
+		bindings[i].descriptorType = isWorldMatrices ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+		bindings[i].descriptorCount = 1;
+		bindings[i].stageFlags = isWorldMatrices ? VK_SHADER_STAGE_VERTEX_BIT : VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+	}
+
+	VkDescriptorSetLayoutCreateInfo layoutInfo{};
+	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	layoutInfo.bindingCount = s_DynamicBindingCount;
+	layoutInfo.pBindings = bindings;
+	PGVK_THROW_IF_FAILED(vkCreateDescriptorSetLayout(m_Device, &layoutInfo, nullptr, &m_DescriptorSetLayout));
+
+	const VkDescriptorPoolSize poolSizes[]
+	{
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, s_ConstantBindingCount },
+		{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1 }
+	};
+	VkDescriptorPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolInfo.maxSets = 1;
+	poolInfo.poolSizeCount = static_cast<uint32_t>(std::size(poolSizes));
+	poolInfo.pPoolSizes = poolSizes;
+	PGVK_THROW_IF_FAILED(vkCreateDescriptorPool(m_Device, &poolInfo, nullptr, &m_DescriptorPool));
+
+	VkDescriptorSetAllocateInfo allocateInfo{};
+	allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	allocateInfo.descriptorPool = m_DescriptorPool;
+	allocateInfo.descriptorSetCount = 1;
+	allocateInfo.pSetLayouts = &m_DescriptorSetLayout;
+	PGVK_THROW_IF_FAILED(vkAllocateDescriptorSets(m_Device, &allocateInfo, &m_DescriptorSet));
+
+	// Written once, draws only change the dynamic offsets
+	const VkDescriptorBufferInfo bufferInfo{ m_TransientBuffer.m_Buffer, 0, s_ConstantBindingRange };
+	const VkDescriptorBufferInfo worldMatricesInfo{ m_TransientBuffer.m_Buffer, 0, GetWorldMatricesRange() };
+	VkWriteDescriptorSet writes[s_DynamicBindingCount]{};
+	for (uint32_t i{}; i < s_DynamicBindingCount; ++i)
+	{
+		const bool isWorldMatrices{ i == s_WorldMatricesBinding };
+		writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		writes[i].dstSet = m_DescriptorSet;
+		writes[i].dstBinding = i;
+		writes[i].descriptorCount = 1;
+		writes[i].descriptorType = isWorldMatrices ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+		writes[i].pBufferInfo = isWorldMatrices ? &worldMatricesInfo : &bufferInfo;
+	}
+	vkUpdateDescriptorSets(m_Device, s_DynamicBindingCount, writes, 0, nullptr);
+
+	VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutInfo.setLayoutCount = 1;
+	pipelineLayoutInfo.pSetLayouts = &m_DescriptorSetLayout;
+	PGVK_THROW_IF_FAILED(vkCreatePipelineLayout(m_Device, &pipelineLayoutInfo, nullptr, &m_PipelineLayout));
+}
+
+Vulkan::VKBuffer Vulkan::CreateBuffer(const void* pData, VkDeviceSize byteWidth, VkBufferUsageFlags usage)
+{
+	VKBuffer buffer{};
+	buffer.m_Device = m_Device;
+
+	VkBufferCreateInfo bufferInfo{};
+	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferInfo.size = byteWidth;
+	bufferInfo.usage = usage;
+	bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	PGVK_THROW_IF_FAILED(vkCreateBuffer(m_Device, &bufferInfo, nullptr, &buffer.m_Buffer));
+
+	VkMemoryRequirements requirements{};
+	vkGetBufferMemoryRequirements(m_Device, buffer.m_Buffer, &requirements);
+
+	// Host visible like the DX12 upload heaps, meshes are small and read once per frame
+	VkMemoryAllocateInfo allocateInfo{};
+	allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocateInfo.allocationSize = requirements.size;
+	allocateInfo.memoryTypeIndex = FindMemoryType(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+	PGVK_THROW_IF_FAILED(vkAllocateMemory(m_Device, &allocateInfo, nullptr, &buffer.m_Memory));
+	PGVK_THROW_IF_FAILED(vkBindBufferMemory(m_Device, buffer.m_Buffer, buffer.m_Memory, 0));
+	PGVK_THROW_IF_FAILED(vkMapMemory(m_Device, buffer.m_Memory, 0, VK_WHOLE_SIZE, 0, &buffer.m_pMapped));
+	++m_ResourceCreationCount;
+
+	if (pData)
+		memcpy(buffer.m_pMapped, pData, byteWidth);
+
+	return buffer;
+}
+
+uint32_t Vulkan::FindMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties) const
+{
+	for (uint32_t i{}; i < m_MemoryProperties.memoryTypeCount; ++i)
+	{
+		if ((typeBits & (1u << i)) && (m_MemoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+			return i;
+	}
+
+	throw PGVK_EXCEPTION(VK_ERROR_OUT_OF_DEVICE_MEMORY);
+}
+
+VkPhysicalDevice Vulkan::FindBestPhysicalDevice(uint32_t& queueFamilyIndex) const
+{
+	uint32_t deviceCount{};
+	PGVK_THROW_IF_FAILED(vkEnumeratePhysicalDevices(m_Instance, &deviceCount, nullptr));
+	std::vector<VkPhysicalDevice> devices(deviceCount);
+	PGVK_THROW_IF_FAILED(vkEnumeratePhysicalDevices(m_Instance, &deviceCount, devices.data()));
+
+	// Software drivers such as lavapipe are only picked when nothing else is available
+	const auto getRank = [](VkPhysicalDeviceType type)
+	{
+		switch (type)
+		{
+		case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU: return 3;
+		case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: return 2;
+		case VK_PHYSICAL_DEVICE_TYPE_CPU: return 0;
+		default: return 1;
+		}
+	};
+
+	VkPhysicalDevice bestDevice{};
+	int bestRank{ -1 };
+	for (const VkPhysicalDevice device : devices)
+	{
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(device, &properties);
+		if (properties.apiVersion < VK_API_VERSION_1_2)
+			continue;
+
+		uint32_t familyCount{};
+		vkGetPhysicalDeviceQueueFamilyProperties(device, &familyCount, nullptr);
+		std::vector<VkQueueFamilyProperties> families(familyCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(device, &familyCount, families.data());
+
+		for (uint32_t family{}; family < familyCount; ++family)
+		{
+			if (!(families[family].queueFlags & VK_QUEUE_GRAPHICS_BIT))
+				continue;
+
+			VkBool32 canPresent{ VK_TRUE };
+			if (!m_IsOffscreen)
+				vkGetPhysicalDeviceSurfaceSupportKHR(device, family, m_Surface, &canPresent);
+			if (!canPresent)
+				continue;
+
+			const int rank{ getRank(properties.deviceType) };
+			if (rank > bestRank)
+			{
+				bestRank = rank;
+				bestDevice = device;
+				queueFamilyIndex = family;
+			}
+			break;
+		}
+	}
+
+	return bestDevice;
+}
+
+Vulkan::VKCommand::VKCommand(VkDevice device, uint32_t queueFamilyIndex)
+	: m_Device{ device }
+{
+	vkGetDeviceQueue(m_Device, queueFamilyIndex, 0, &m_Queue);
+
+	VkCommandPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	poolInfo.queueFamilyIndex = queueFamilyIndex;
+
+	for (auto& frame : m_CommandFrames)
+	{
+		PGVK_THROW_IF_FAILED(vkCreateCommandPool(m_Device, &poolInfo, nullptr, &frame.m_CommandPool));
+
+		VkCommandBufferAllocateInfo allocateInfo{};
+		allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocateInfo.commandPool = frame.m_CommandPool;
+		allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocateInfo.commandBufferCount = 1;
+		PGVK_THROW_IF_FAILED(vkAllocateCommandBuffers(m_Device, &allocateInfo, &frame.m_CommandBuffer));
+	}
+
+	VkSemaphoreTypeCreateInfo timelineInfo{};
+	timelineInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+	timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+	timelineInfo.initialValue = 0;
+
+	VkSemaphoreCreateInfo semaphoreInfo{};
+	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+	semaphoreInfo.pNext = &timelineInfo;
+	PGVK_THROW_IF_FAILED(vkCreateSemaphore(m_Device, &semaphoreInfo, nullptr, &m_Fence));
+}
+
+Vulkan::VKCommand::~VKCommand()
+{
+	Flush();
+
+	for (auto& frame : m_CommandFrames)
+		vkDestroyCommandPool(m_Device, frame.m_CommandPool, nullptr);
+	vkDestroySemaphore(m_Device, m_Fence, nullptr);
+
+	m_FrameIndex = 0;
+	m_FenceValue = 0;
+}
+
+void Vulkan::VKCommand::BeginFrame() const
+{
+	const auto& frame = m_CommandFrames[m_FrameIndex];
+	frame.Wait(m_Device, m_Fence);
+	PGVK_THROW_IF_FAILED(vkResetCommandPool(m_Device, frame.m_CommandPool, 0));
+
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	PGVK_THROW_IF_FAILED(vkBeginCommandBuffer(frame.m_CommandBuffer, &beginInfo));
+}
+
+void Vulkan::VKCommand::EndFrame(VkSemaphore waitSemaphore, VkSemaphore signalSemaphore)
+{
+	auto& frame = m_CommandFrames[m_FrameIndex];
+	PGVK_THROW_IF_FAILED(vkEndCommandBuffer(frame.m_CommandBuffer));
+
+	++m_FenceValue;
+	frame.m_FenceValue = m_FenceValue;
+
+	// Binary semaphores ignore their entry in the value arrays
+	const VkSemaphore signalSemaphores[]{ m_Fence, signalSemaphore };
+	const uint64_t signalValues[]{ m_FenceValue, 0 };
+	const uint32_t signalCount{ signalSemaphore ? 2u : 1u };
+
+	VkTimelineSemaphoreSubmitInfo timelineInfo{};
+	timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+	timelineInfo.signalSemaphoreValueCount = signalCount;
+	timelineInfo.pSignalSemaphoreValues = signalValues;
+
+	constexpr VkPipelineStageFlags waitStage{ VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.pNext = &timelineInfo;
+	submitInfo.waitSemaphoreCount = waitSemaphore ? 1u : 0u;
+	submitInfo.pWaitSemaphores = &waitSemaphore;
+	submitInfo.pWaitDstStageMask = &waitStage;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &frame.m_CommandBuffer;
+	submitInfo.signalSemaphoreCount = signalCount;
+	submitInfo.pSignalSemaphores = signalSemaphores;
+	PGVK_THROW_IF_FAILED(vkQueueSubmit(m_Queue, 1, &submitInfo, VK_NULL_HANDLE));
+
+	m_FrameIndex = (m_FrameIndex + 1) % s_BufferCount;
+}
+
+void Vulkan::VKCommand::Flush() const
+{
+	for (const auto& frame : m_CommandFrames)
+		frame.Wait(m_Device, m_Fence);
+}
+
+uint64_t Vulkan::VKCommand::GetCompletedFenceValue() const
+{
+	uint64_t value{};
+	PGVK_THROW_IF_FAILED(vkGetSemaphoreCounterValue(m_Device, m_Fence, &value));
+	return value;
+}
+
+void Vulkan::VKCommand::CommandFrame::Wait(VkDevice device, VkSemaphore fence) const
+{
+	VkSemaphoreWaitInfo waitInfo{};
+	waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+	waitInfo.semaphoreCount = 1;
+	waitInfo.pSemaphores = &fence;
+	waitInfo.pValues = &m_FenceValue;
+	PGVK_THROW_IF_FAILED(vkWaitSemaphores(device, &waitInfo, UINT64_MAX));
+}
+
+Vulkan::VKBuffer::~VKBuffer()
+{
+	Release();
+}
+
+Vulkan::VKBuffer::VKBuffer(VKBuffer&& other) noexcept
+	: m_Device{ std::exchange(other.m_Device, VK_NULL_HANDLE) }
+	, m_Buffer{ std::exchange(other.m_Buffer, VK_NULL_HANDLE) }
+	, m_Memory{ std::exchange(other.m_Memory, VK_NULL_HANDLE) }
+	, m_pMapped{ std::exchange(other.m_pMapped, nullptr) }
+{
+}
+
+Vulkan::VKBuffer& Vulkan::VKBuffer::operator=(VKBuffer&& other) noexcept
+{
+	if (this != &other)
+	{
+		Release();
+		m_Device = std::exchange(other.m_Device, VK_NULL_HANDLE);
+		m_Buffer = std::exchange(other.m_Buffer, VK_NULL_HANDLE);
+		m_Memory = std::exchange(other.m_Memory, VK_NULL_HANDLE);
+		m_pMapped = std::exchange(other.m_pMapped, nullptr);
+	}
+	return *this;
+}
+
+void Vulkan::VKBuffer::Release()
+{
+	if (!m_Device)
+		return;
+
+	vkDestroyBuffer(m_Device, m_Buffer, nullptr);
+	vkFreeMemory(m_Device, m_Memory, nullptr); // Implicitly unmapped
+	m_Device = VK_NULL_HANDLE;
+	m_Buffer = VK_NULL_HANDLE;
+	m_Memory = VK_NULL_HANDLE;
+	m_pMapped = nullptr;
+}
+
+#pragma endregion
+#endif
+
+#pragma region Software
+
+class SoftwareRenderer final : public Renderer::RendererImpl
+{
+public:
+	explicit SoftwareRenderer(HWND hwnd);
+	~SoftwareRenderer() override = default;
+
+	SoftwareRenderer(const SoftwareRenderer& other) noexcept = delete;
+	SoftwareRenderer& operator=(const SoftwareRenderer& other) noexcept = delete;
+	SoftwareRenderer(SoftwareRenderer&& other) noexcept = delete;
+	SoftwareRenderer& operator=(SoftwareRenderer&& other) noexcept = delete;
+
+	void* GetDevice() const override;
+	void* GetDeviceContext() const override;
+
+	void BeginFrame() override;
+	void EndFrame() override;
+
+	[[nodiscard]] MeshHandle CreateMesh(const MeshDesc& desc) override;
+	void DestroyMesh(MeshHandle handle) override;
+	void BindMesh(MeshHandle handle) override;
+	void DrawBoundMesh(uint32_t instanceCount) override;
+
+	void BindTransientConstants(ShaderStage stage, uint32_t slot, const TransientAllocation& allocation) override;
+	void BindWorldMatrices(const TransientAllocation& allocation) override;
+	void FlushUploads() override;
+
+	bool SaveFrame(const std::string& path) override;
+
+private:
+	/* NESTED CLASSES */
+
+	struct SoftwareMesh
+	{
+		std::vector<uint8_t> m_Vertices{};
+		std::vector<uint32_t> m_Indices{}; // Widened from 16 bit on creation
+		uint32_t m_VertexCount{};
+		uint32_t m_VertexStride{};
+	};
+
+	/* DATA MEMBERS */
+
+	SoftwareRasterizer m_Rasterizer{};
+
+	ResourceTable<MeshTag, SoftwareMesh, Renderer::s_FrameCount> m_Meshes{};
+	const SoftwareMesh* m_pBoundMesh{};
+	const void* m_pObjectConstants{}; // VS b1, points into the transient memory
+	const ViewConstants* m_pViewConstants{}; // VS b2, idem
+	const XMFLOAT3X4A* m_pWorldMatrices{}; // VS t0, idem
+	uint32_t m_FrameIndex{};
+
+	std::vector<SoftwareRasterizer::Vertex> m_TransformedVertices{};
+
+	std::unique_ptr<uint8_t[]> m_pTransientMemory{};
+	uint64_t m_FrameFenceValue{};
+
+	/* PRIVATE METHODS */
+
+	void Present() const;
+
+};
+
+SoftwareRenderer::SoftwareRenderer(HWND hwnd)
+	: RendererImpl{ hwnd }
+	, m_pTransientMemory{ std::make_unique<uint8_t[]>(GameSettings::transientUploadBufferSize) }
+{
+	m_Rasterizer.Resize(GameSettings::windowWidth, GameSettings::windowHeight);
+	m_TransientRing.Initialize(m_pTransientMemory.get(), GameSettings::transientUploadBufferSize, Renderer::s_ConstantBufferAlignment);
+}
+
+void* SoftwareRenderer::GetDevice() const
+{
+	return nullptr;
+}
+
+void* SoftwareRenderer::GetDeviceContext() const
+{
+	// Materials set the emulated shader programs on the rasterizer
+	return const_cast<SoftwareRasterizer*>(&m_Rasterizer);
+}
+
+void SoftwareRenderer::BeginFrame()
+{
+	m_Meshes.BeginFrame(m_FrameIndex);
+
+	// Rasterization completes inside EndFrame, every frame is done as soon as it ends
+	[[maybe_unused]] const bool isRegionFree{ m_TransientRing.BeginFrame(m_FrameFenceValue) };
+	assert(isRegionFree);
+	m_pObjectConstants = nullptr;
+	m_pViewConstants = nullptr;
+	m_pWorldMatrices = nullptr;
+
+	m_Rasterizer.Clear(m_DefaultBackgroundColor, 1.f);
+}
+
+void SoftwareRenderer::EndFrame()
+{
+	m_Rasterizer.Flush();
+	Present();
+
+	m_TransientRing.EndFrame(++m_FrameFenceValue);
+	m_FrameIndex = (m_FrameIndex + 1) % Renderer::s_FrameCount;
+}
+
+MeshHandle SoftwareRenderer::CreateMesh(const MeshDesc& desc)
+{
+	assert(desc.m_pVertices && desc.m_VertexCount && desc.m_VertexStride);
+	assert(desc.m_pIndices && desc.m_IndexCount);
+
+	SoftwareMesh mesh{};
+	const auto pVertexBytes = static_cast<const uint8_t*>(desc.m_pVertices);
+	mesh.m_Vertices.assign(pVertexBytes, pVertexBytes + static_cast<size_t>(desc.m_VertexCount) * desc.m_VertexStride);
+	mesh.m_VertexCount = desc.m_VertexCount;
+	mesh.m_VertexStride = desc.m_VertexStride;
+
+	if (desc.m_IndexFormat == IndexFormat::UInt16)
+	{
+		const auto pIndices = static_cast<const uint16_t*>(desc.m_pIndices);
+		mesh.m_Indices.assign(pIndices, pIndices + desc.m_IndexCount);
+	}
+	else
+	{
+		const auto pIndices = static_cast<const uint32_t*>(desc.m_pIndices);
+		mesh.m_Indices.assign(pIndices, pIndices + desc.m_IndexCount);
+	}
+
+	// Vertex and index buffer, same count as the GPU backends
+	m_ResourceCreationCount += 2;
+	return m_Meshes.Add(std::move(mesh));
+}
+
+void SoftwareRenderer::DestroyMesh(MeshHandle handle)
+{
+	m_Meshes.Remove(handle, m_FrameIndex);
+}
+
+void SoftwareRenderer::BindMesh(MeshHandle handle)
+{
+	m_pBoundMesh = m_Meshes.Get(handle);
+	assert(m_pBoundMesh);
+}
+
+void SoftwareRenderer::DrawBoundMesh(uint32_t instanceCount)
+{
+	const SoftwareRasterizer::PipelineState& state{ m_Rasterizer.GetPipelineState() };
+	if (!m_pBoundMesh || (state.m_VertexProgram != SoftwareRasterizer::VertexProgram::VertexColor && (!m_pObjectConstants || !m_pWorldMatrices)))
+		return;
+
+	const SoftwareMesh& mesh{ *m_pBoundMesh };
+	m_TransformedVertices.resize(mesh.m_VertexCount);
+
+	// Vertex colored geometry is already in clip space
+	const XMMATRIX viewProjection{ m_pViewConstants && state.m_VertexProgram != SoftwareRasterizer::VertexProgram::VertexColor
+		? XMMatrixTranspose(XMLoadFloat4x4(&m_pViewConstants->m_ViewProjection)) : XMMatrixIdentity() };
+
+	for (uint32_t instance{}; instance < instanceCount; ++instance)
+	{
+		XMMATRIX world{ XMMatrixIdentity() };
+		XMFLOAT4 color{ 1.f, 1.f, 1.f, 1.f };
+
+		switch (state.m_VertexProgram)
+		{
+		case SoftwareRasterizer::VertexProgram::Color:
+			world = XMLoadFloat3x4A(&m_pWorldMatrices[static_cast<const ObjectConstants*>(m_pObjectConstants)->m_ObjectId]);
+			break;
+
+		case SoftwareRasterizer::VertexProgram::ColorInstanced:
+		{
+			const InstanceData& constants{ static_cast<const InstanceData*>(m_pObjectConstants)[instance] };
+			world = XMLoadFloat3x4A(&m_pWorldMatrices[constants.m_ObjectId]);
+			color = constants.m_Color;
+			break;
+		}
+
+		case SoftwareRasterizer::VertexProgram::VertexColor:
+			break;
+		}
+
+		const XMMATRIX worldViewProjection{ XMMatrixMultiply(world, viewProjection) };
+		for (uint32_t i{}; i < mesh.m_VertexCount; ++i)
+		{
+			const uint8_t* pVertex{ mesh.m_Vertices.data() + static_cast<size_t>(i) * mesh.m_VertexStride };
+
+			XMFLOAT2 position{};
+			memcpy(&position, pVertex, sizeof(XMFLOAT2));
+			if (state.m_VertexProgram == SoftwareRasterizer::VertexProgram::VertexColor && mesh.m_VertexStride >= sizeof(XMFLOAT2) + sizeof(XMFLOAT4))
+				memcpy(&color, pVertex + sizeof(XMFLOAT2), sizeof(XMFLOAT4));
+
+			XMFLOAT4 clipPosition{};
+			XMStoreFloat4(&clipPosition, XMVector2Transform(XMLoadFloat2(&position), worldViewProjection));
+			m_TransformedVertices[i] = { { clipPosition.x, clipPosition.y, clipPosition.z, clipPosition.w }, { color.x, color.y, color.z, color.w } };
+		}
+
+		m_Rasterizer.SubmitTriangles(m_TransformedVertices.data(), mesh.m_VertexCount, mesh.m_Indices.data(), static_cast<uint32_t>(mesh.m_Indices.size()));
+	}
+}
+
+void SoftwareRenderer::BindTransientConstants(ShaderStage stage, uint32_t slot, const TransientAllocation& allocation)
+{
+	assert(allocation.IsValid());
+
+	if (stage != ShaderStage::Vertex)
+		return;
+
+	if (slot == s_ObjectConstantsSlot)
+		m_pObjectConstants = allocation.m_pData;
+	else if (slot == Renderer::s_ViewConstantsSlot)
+		m_pViewConstants = static_cast<const ViewConstants*>(allocation.m_pData);
+}
+
+void SoftwareRenderer::BindWorldMatrices(const TransientAllocation& allocation)
+{
+	assert(allocation.IsValid());
+	m_pWorldMatrices = static_cast<const XMFLOAT3X4A*>(allocation.m_pData);
+}
+
+void SoftwareRenderer::FlushUploads()
+{
+	// Shared memory, nothing to copy
+}
+
+bool SoftwareRenderer::SaveFrame(const std::string& path)
+{
+	return m_Rasterizer.SaveTGA(path);
+}
+
+void SoftwareRenderer::Present() const
+{
+	if (!m_HWnd)
+		return;
+
+	BITMAPINFO bitmapInfo{};
+	bitmapInfo.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+	bitmapInfo.bmiHeader.biWidth = static_cast<LONG>(m_Rasterizer.GetPitch());
+	bitmapInfo.bmiHeader.biHeight = -static_cast<LONG>(m_Rasterizer.GetHeight()); // Top-down rows
+	bitmapInfo.bmiHeader.biPlanes = 1;
+	bitmapInfo.bmiHeader.biBitCount = 32;
+	bitmapInfo.bmiHeader.biCompression = BI_RGB;
+
+	constexpr DWORD sourceCopy{ 0x00CC0020 }; // SRCCOPY, raster ops are stripped by CleanedWindows.h
+
+	const HDC hdc{ GetDC(m_HWnd) };
+	StretchDIBits(hdc,
+		0, 0, static_cast<int>(m_Rasterizer.GetWidth()), static_cast<int>(m_Rasterizer.GetHeight()),
+		0, 0, static_cast<int>(m_Rasterizer.GetWidth()), static_cast<int>(m_Rasterizer.GetHeight()),
+		m_Rasterizer.GetColorBuffer(), &bitmapInfo, DIB_RGB_COLORS, sourceCopy);
+	ReleaseDC(m_HWnd, hdc);
+}
+
+#pragma endregion
+
+#pragma region Renderer
+
+Renderer::~Renderer()
+{
+	delete m_pTestMaterial;
+	delete m_pStats;
+	delete m_pRenderGraph;
+	delete m_pRenderQueue;
+	delete m_pRendererImpl;
+}
+
+void* Renderer::GetDevice() const
+{
+	return m_pRendererImpl->GetDevice();
+}
+
+void* Renderer::GetDeviceContext() const
 {
 	return m_pRendererImpl->GetDeviceContext();
 }
@@ -717,23 +2916,216 @@ void Renderer::Init()
 	case GameSettings::RenderAPI::DirectX12:
 		m_pRendererImpl = new DirectX12{ WindowHandler::Get().GetHandle() };
 		break;
+
+	case GameSettings::RenderAPI::Null:
+		m_pRendererImpl = new NullRenderer{ WindowHandler::Get().GetHandle() };
+		break;
+
+	case GameSettings::RenderAPI::Software:
+		m_pRendererImpl = new SoftwareRenderer{ WindowHandler::Get().GetHandle() };
+		break;
+
+	case GameSettings::RenderAPI::Vulkan:
+#ifdef PICOGINE_VULKAN
+		m_pRendererImpl = new Vulkan{ WindowHandler::Get().GetHandle() };
+#else
+		// Built without the Vulkan SDK, silently rendering nothing would hide the misconfiguration
+		throw PGWND_EXCEPTION(E_NOTIMPL);
+#endif
+		break;
 	}
-	
+
+	// Past this, the draws of a full frame would fail their transient allocations and silently go missing
+	assert(RendererImpl::GetMaxSubmitTransientSize() <= m_pRendererImpl->GetTransientRegionSize()
+		&& "GameSettings::transientUploadBufferSize is too small for GameSettings::maxObjectsPerFrame");
+
+	m_pRenderQueue = new RenderQueue();
+	m_pRenderGraph = new RenderGraph();
+
+	m_pStats = new RendererStats();
+	if (GameSettings::rendererStatsLogPath)
+		m_pStats->OpenLog(GameSettings::rendererStatsLogPath, GameSettings::rendererStatsLogInterval);
+
+	// Test triangle resources are created once here and only referenced by handle every frame
+	struct TestVertex
+	{
+		float x{}, y{};
+	};
+
+	static constexpr TestVertex vertices[] =
+	{
+		{ .0f, .5f},
+		{ .5f, -.5f},
+		{ -.5f, -.5f}
+	};
+
+	static constexpr uint16_t indices[] =
+	{
+		0, 1, 2
+	};
+
+	MeshDesc desc{};
+	desc.m_pVertices = vertices;
+	desc.m_VertexCount = static_cast<uint32_t>(std::size(vertices));
+	desc.m_VertexStride = sizeof(TestVertex);
+	desc.m_pIndices = indices;
+	desc.m_IndexCount = static_cast<uint32_t>(std::size(indices));
+	desc.m_IndexFormat = IndexFormat::UInt16;
+	m_TestTriangle = m_pRendererImpl->CreateMesh(desc);
+
+	m_pTestMaterial = new ColorMaterial();
+	m_pTestMaterial->SetColor(1.0f, 0.0f, 0.0f, 1.0f);
 }
 
-void Renderer::BeginFrame() const
+void Renderer::BeginFrame()
 {
+	m_pStats->BeginFrame();
+	m_pRenderQueue->Reset();
+	m_ViewConstants = {};
+
+	m_pRenderGraph->Reset();
+	m_BackBuffer = m_pRenderGraph->ImportTexture("BackBuffer", { GameSettings::windowWidth, GameSettings::windowHeight, RenderGraph::Format::RGBA8 });
+
 	m_pRendererImpl->BeginFrame();
 }
 
 void Renderer::EndFrame() const
 {
 	m_pRendererImpl->EndFrame();
+	m_pStats->EndFrame(m_pRendererImpl->GetSubmitStats(), m_pRendererImpl->GetResourceCreationCount());
+}
+
+MeshHandle Renderer::CreateMesh(const MeshDesc& desc) const
+{
+	return m_pRendererImpl->CreateMesh(desc);
+}
+
+void Renderer::DestroyMesh(MeshHandle handle) const
+{
+	m_pRendererImpl->DestroyMesh(handle);
+}
+
+void Renderer::DrawMesh(MeshHandle handle) const
+{
+	m_pRendererImpl->DrawMesh(handle);
+}
+
+RenderQueue& Renderer::GetRenderQueue() const
+{
+	return *m_pRenderQueue;
+}
+
+void Renderer::Draw(MeshHandle mesh, BaseMaterial* pMaterial, const XMFLOAT4X4& world, uint8_t layer) const
+{
+	assert(pMaterial);
+
+	const XMVECTOR offset{ XMVectorSubtract(XMVectorSet(world._41, world._42, world._43, 0.f), XMLoadFloat4(&m_ViewConstants.m_ViewPosition)) };
+	const float depth{ XMVectorGetX(XMVector3Length(offset)) / GameSettings::farPlane };
+
+	m_pRenderQueue->GetMainCommandBuffer().Draw(SortKey::Make(layer, pMaterial->GetSortId(), mesh.m_Index, depth), mesh, pMaterial, world);
+}
+
+void Renderer::Draw(MeshHandle mesh, MaterialInstanceHandle material, const XMFLOAT4X4& world, uint8_t layer) const
+{
+	BaseMaterial* pTemplate{ MaterialManager::Get().GetInstanceTemplate(material) };
+	if (!pTemplate)
+		return;
+
+	const XMVECTOR offset{ XMVectorSubtract(XMVectorSet(world._41, world._42, world._43, 0.f), XMLoadFloat4(&m_ViewConstants.m_ViewPosition)) };
+	const float depth{ XMVectorGetX(XMVector3Length(offset)) / GameSettings::farPlane };
+
+	// The template's sort id keeps every instance of it in one run
+	m_pRenderQueue->GetMainCommandBuffer().Draw(SortKey::Make(layer, pTemplate->GetSortId(), mesh.m_Index, depth), mesh, pTemplate, world, material);
+}
+
+void Renderer::SetView(const ViewConstants& view)
+{
+	m_ViewConstants = view;
+}
+
+void Renderer::Submit() const
+{
+	m_pStats->BeginSubmit();
+
+	m_pRenderGraph->AddPass("Scene", [this](RenderGraph::PassBuilder& builder)
+	{
+		builder.Write(m_BackBuffer);
+	}, [this]()
+	{
+		m_pRendererImpl->Submit(*m_pRenderQueue, m_ViewConstants);
+	});
+
+	m_pRenderGraph->Compile();
+	m_pRenderGraph->Execute();
+
+	m_pStats->EndSubmit();
+}
+
+RenderGraph& Renderer::GetRenderGraph() const
+{
+	return *m_pRenderGraph;
+}
+
+RenderGraph::ResourceId Renderer::GetBackBuffer() const
+{
+	return m_BackBuffer;
+}
+
+TransientAllocation Renderer::AllocateTransient(uint32_t size, uint32_t alignment) const
+{
+	return m_pRendererImpl->AllocateTransient(size, alignment);
+}
+
+void Renderer::BindTransientConstants(ShaderStage stage, uint32_t slot, const TransientAllocation& allocation) const
+{
+	m_pRendererImpl->BindTransientConstants(stage, slot, allocation);
+}
+
+void Renderer::FlushUploads() const
+{
+	m_pRendererImpl->FlushUploads();
+}
+
+const SubmitStats& Renderer::GetSubmitStats() const
+{
+	return m_pRendererImpl->GetSubmitStats();
+}
+
+StateTracker& Renderer::GetStateTracker() const
+{
+	return m_pRendererImpl->GetStateTracker();
+}
+
+const RendererStats& Renderer::GetStats() const
+{
+	return *m_pStats;
+}
+
+uint32_t Renderer::GetResourceCreationCount() const
+{
+	return m_pRendererImpl->GetResourceCreationCount();
+}
+
+void Renderer::CountResourceCreation(uint32_t count) const
+{
+	m_pRendererImpl->CountResourceCreation(count);
+}
+
+std::span<const RecordedDraw> Renderer::GetRecordedDraws() const
+{
+	return m_pRendererImpl->GetRecordedDraws();
+}
+
+bool Renderer::SaveFrame(const std::string& path) const
+{
+	return m_pRendererImpl->SaveFrame(path);
 }
 
 void Renderer::RenderTestTriangle() const
 {
-	m_pRendererImpl->RenderTestTriangle();
+	XMFLOAT4X4 world{};
+	XMStoreFloat4x4(&world, XMMatrixIdentity());
+	Draw(m_TestTriangle, m_pTestMaterial, world);
 }
 
 #pragma endregion
@@ -1,6 +1,18 @@
 #pragma once
 
+#include <span>
+#include <string>
+
+#include "RenderGraph.h"
 #include "Singleton.h"
+#include "Structs.h"
+#include "ViewConstants.h"
+
+class BaseMaterial;
+class ColorMaterial;
+class RendererStats;
+class RenderQueue;
+class StateTracker;
 
 class Renderer final : public Singleton<Renderer>
 {
@@ -18,11 +30,111 @@ public:
 	void* GetDeviceContext() const;
 
 	void Init();
-	void BeginFrame() const;
+	/**
+	 * \brief Resets the render queue and the render graph, which starts the frame with only the back buffer imported
+	 */
+	void BeginFrame();
 	void EndFrame() const;
 
+	/**
+	 * \brief Uploads the mesh data once, the returned handle stays valid until DestroyMesh
+	 */
+	[[nodiscard]] MeshHandle CreateMesh(const MeshDesc& desc) const;
+	/**
+	 * \brief Invalidates the handle, GPU buffers are released once the frames in flight are done with them
+	 */
+	void DestroyMesh(MeshHandle handle) const;
+	/**
+	 * \brief Draws immediately, bypassing the render queue
+	 */
+	void DrawMesh(MeshHandle handle) const;
+
+	/**
+	 * \brief Per-frame queue of draw packets, worker threads record through RenderQueue::AcquireCommandBuffer
+	 */
+	[[nodiscard]] RenderQueue& GetRenderQueue() const;
+	/**
+	 * \brief Records a draw packet on the main thread's command buffer, nothing is issued until Submit
+	 * \param layer Lower layers are drawn first
+	 */
+	void Draw(MeshHandle mesh, BaseMaterial* pMaterial, const XMFLOAT4X4& world, uint8_t layer = 0) const;
+	/**
+	 * \brief Records a draw of a material instance, sorted and merged with the other draws of its template
+	 * \param layer Lower layers are drawn first
+	 */
+	void Draw(MeshHandle mesh, MaterialInstanceHandle material, const XMFLOAT4X4& world, uint8_t layer = 0) const;
+	/**
+	 * \brief Camera of the frame, uploaded once by Submit and bound at s_ViewConstantsSlot for every material.
+	 * Its position is also the origin used to compute the depth part of the sort keys. Reset to identity by BeginFrame.
+	 */
+	void SetView(const ViewConstants& view);
+	/**
+	 * \brief Adds the scene pass drawing the render queue to the back buffer, then compiles and executes the render graph
+	 */
+	void Submit() const;
+
+	/**
+	 * \brief Passes added between BeginFrame and Submit run before the scene pass if the scene reads their outputs
+	 */
+	[[nodiscard]] RenderGraph& GetRenderGraph() const;
+	[[nodiscard]] RenderGraph::ResourceId GetBackBuffer() const;
+
+	/**
+	 * \brief Suballocates from the per-frame upload ring, no graphics API call involved
+	 * \param size Size in bytes
+	 * \param alignment Power of two, constant buffer data needs the default 256
+	 * \return Slice valid until EndFrame, invalid if this frame's region is full
+	 */
+	[[nodiscard]] TransientAllocation AllocateTransient(uint32_t size, uint32_t alignment = s_ConstantBufferAlignment) const;
+	void BindTransientConstants(ShaderStage stage, uint32_t slot, const TransientAllocation& allocation) const;
+	/**
+	 * \brief Makes this frame's transient allocations visible to the GPU, call once after recording and before drawing
+	 */
+	void FlushUploads() const;
+
+	/**
+	 * \brief 
+	 * \return Total number of GPU resources created by the active backend since Init: buffers, images, shader objects,
+	 * input layouts and pipelines
+	 */
+	[[nodiscard]] uint32_t GetResourceCreationCount() const;
+	/**
+	 * \brief Adds to GetResourceCreationCount the objects created on the backend's device outside of it, by the
+	 * materials and the shader caches
+	 */
+	void CountResourceCreation(uint32_t count = 1) const;
+	/**
+	 * \brief Mesh, material and instance count of every draw issued since BeginFrame, in submission order.
+	 * Only recorded by the Null backend, empty for the others.
+	 */
+	[[nodiscard]] std::span<const RecordedDraw> GetRecordedDraws() const;
+	/**
+	 * \brief 
+	 * \return Draw counts of the last Submit, before and after instancing
+	 */
+	[[nodiscard]] const SubmitStats& GetSubmitStats() const;
+	/**
+	 * \brief Pipeline state bound by the active backend, materials check it before binding to skip redundant binds
+	 */
+	[[nodiscard]] StateTracker& GetStateTracker() const;
+	/**
+	 * \brief Counters and timings of the last frames with their rolling averages
+	 */
+	[[nodiscard]] const RendererStats& GetStats() const;
+
+	/**
+	 * \brief Dumps the last presented frame as a TGA image, supported by the software backend and by Vulkan when
+	 * rendering offscreen
+	 * \return False if the backend cannot read its frames back or the file could not be written
+	 */
+	bool SaveFrame(const std::string& path) const;
+
 	void RenderTestTriangle() const;
 
+	inline static constexpr int s_FrameCount{ 3 }; // Frames in flight
+	inline static constexpr uint32_t s_ConstantBufferAlignment{ 256 };
+	inline static constexpr uint32_t s_ViewConstantsSlot{ 2 }; // VS and PS, must match ViewConstants.hlsli
+
 protected:
 
 private:
@@ -32,6 +144,14 @@ private:
 	/* DATA MEMBERS */
 
 	RendererImpl* m_pRendererImpl{};
+	RenderQueue* m_pRenderQueue{};
+	RenderGraph* m_pRenderGraph{};
+	RendererStats* m_pStats{};
+	RenderGraph::ResourceId m_BackBuffer{};
+	ViewConstants m_ViewConstants{};
+
+	MeshHandle m_TestTriangle{};
+	ColorMaterial* m_pTestMaterial{};
 
 	/* PRIVATE METHODS */
 	
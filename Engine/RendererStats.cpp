@@ -0,0 +1,124 @@
+#include "RendererStats.h"
+
+#include <algorithm>
+
+void RendererStats::BeginFrame()
+{
+	m_FrameBeginTime = Clock::now();
+	m_SubmitMilliseconds = 0.f;
+}
+
+void RendererStats::BeginSubmit()
+{
+	m_SubmitBeginTime = Clock::now();
+}
+
+void RendererStats::EndSubmit()
+{
+	m_SubmitMilliseconds += std::chrono::duration<float, std::milli>(Clock::now() - m_SubmitBeginTime).count();
+}
+
+void RendererStats::EndFrame(const SubmitStats& submitStats, uint32_t totalResourceCreationCount)
+{
+	FrameStats& frame{ m_History[m_FrameCount % s_HistorySize] };
+	frame.m_PacketCount = submitStats.m_PacketCount;
+	frame.m_DrawCallCount = submitStats.m_DrawCallCount;
+	frame.m_InstancedDrawCallCount = submitStats.m_InstancedDrawCallCount;
+	frame.m_StateChangeCount = submitStats.m_StateChangeCount;
+	frame.m_FilteredStateChangeCount = submitStats.m_FilteredStateChangeCount;
+	frame.m_MapCount = submitStats.m_MapCount;
+	frame.m_UploadedBytes = submitStats.m_UploadedBytes;
+	frame.m_ResourceCreationCount = totalResourceCreationCount - m_LastResourceCreationCount;
+	frame.m_SubmitMilliseconds = m_SubmitMilliseconds;
+	frame.m_FrameMilliseconds = std::chrono::duration<float, std::milli>(Clock::now() - m_FrameBeginTime).count();
+
+	m_LastResourceCreationCount = totalResourceCreationCount;
+	++m_FrameCount;
+
+	if (m_Log.is_open() && m_FrameCount % m_LogInterval == 0)
+		WriteLogRow();
+}
+
+bool RendererStats::OpenLog(const std::string& path, uint32_t intervalFrames)
+{
+	CloseLog();
+
+	m_Log.open(path, std::ios::out | std::ios::trunc);
+	if (!m_Log)
+		return false;
+
+	m_LogInterval = std::max(intervalFrames, 1u);
+	m_Log << "Frame,Packets,DrawCalls,InstancedDrawCalls,StateChanges,FilteredStateChanges,Maps,UploadedBytes,ResourceCreations,SubmitMs,FrameMs\n";
+	return true;
+}
+
+void RendererStats::CloseLog()
+{
+	if (m_Log.is_open())
+		m_Log.close();
+}
+
+const FrameStats& RendererStats::GetLastFrame() const
+{
+	return m_History[(m_FrameCount + s_HistorySize - 1) % s_HistorySize];
+}
+
+FrameStats RendererStats::GetAverage() const
+{
+	const auto count = static_cast<uint32_t>(std::min<uint64_t>(m_FrameCount, s_HistorySize));
+	if (count == 0)
+		return {};
+
+	// Summed in doubles so the means keep their fractions until rounded
+	double sums[10]{};
+	for (uint32_t i{}; i < count; ++i)
+	{
+		const FrameStats& frame{ m_History[i] };
+		sums[0] += frame.m_PacketCount;
+		sums[1] += frame.m_DrawCallCount;
+		sums[2] += frame.m_InstancedDrawCallCount;
+		sums[3] += frame.m_StateChangeCount;
+		sums[4] += frame.m_FilteredStateChangeCount;
+		sums[5] += frame.m_MapCount;
+		sums[6] += static_cast<double>(frame.m_UploadedBytes);
+		sums[7] += frame.m_ResourceCreationCount;
+		sums[8] += frame.m_SubmitMilliseconds;
+		sums[9] += frame.m_FrameMilliseconds;
+	}
+
+	const auto mean = [count](double sum) { return sum / count; };
+
+	FrameStats average{};
+	average.m_PacketCount = static_cast<uint32_t>(mean(sums[0]) + .5);
+	average.m_DrawCallCount = static_cast<uint32_t>(mean(sums[1]) + .5);
+	average.m_InstancedDrawCallCount = static_cast<uint32_t>(mean(sums[2]) + .5);
+	average.m_StateChangeCount = static_cast<uint32_t>(mean(sums[3]) + .5);
+	average.m_FilteredStateChangeCount = static_cast<uint32_t>(mean(sums[4]) + .5);
+	average.m_MapCount = static_cast<uint32_t>(mean(sums[5]) + .5);
+	average.m_UploadedBytes = static_cast<uint64_t>(mean(sums[6]) + .5);
+	average.m_ResourceCreationCount = static_cast<uint32_t>(mean(sums[7]) + .5);
+	average.m_SubmitMilliseconds = static_cast<float>(mean(sums[8]));
+	average.m_FrameMilliseconds = static_cast<float>(mean(sums[9]));
+	return average;
+}
+
+uint64_t RendererStats::GetFrameCount() const
+{
+	return m_FrameCount;
+}
+
+void RendererStats::WriteLogRow()
+{
+	const FrameStats average{ GetAverage() };
+	m_Log << m_FrameCount << ','
+		<< average.m_PacketCount << ','
+		<< average.m_DrawCallCount << ','
+		<< average.m_InstancedDrawCallCount << ','
+		<< average.m_StateChangeCount << ','
+		<< average.m_FilteredStateChangeCount << ','
+		<< average.m_MapCount << ','
+		<< average.m_UploadedBytes << ','
+		<< average.m_ResourceCreationCount << ','
+		<< average.m_SubmitMilliseconds << ','
+		<< average.m_FrameMilliseconds << '\n';
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "Structs.h"
+
+/**
+ * \brief Renderer counters and CPU timings of one frame
+ */
+struct FrameStats
+{
+	uint32_t m_PacketCount{};
+	uint32_t m_DrawCallCount{};
+	uint32_t m_InstancedDrawCallCount{};
+	uint32_t m_StateChangeCount{};
+	uint32_t m_FilteredStateChangeCount{};
+	uint32_t m_MapCount{};
+	uint64_t m_UploadedBytes{};
+	uint32_t m_ResourceCreationCount{}; // GPU resources created during the frame
+	float m_SubmitMilliseconds{}; // CPU time spent in Renderer::Submit
+	float m_FrameMilliseconds{}; // CPU time from Renderer::BeginFrame to Renderer::EndFrame
+};
+
+/**
+ * \brief Keeps the stats of the last frames to report rolling averages, optionally written to a CSV file.
+ * The counters come from the SubmitStats of the active backend, the timers are measured by the Renderer.
+ */
+class RendererStats final
+{
+public:
+	RendererStats() noexcept = default;
+	~RendererStats() = default;
+
+	RendererStats(const RendererStats& other) noexcept = delete;
+	RendererStats& operator=(const RendererStats& other) noexcept = delete;
+	RendererStats(RendererStats&& other) noexcept = delete;
+	RendererStats& operator=(RendererStats&& other) noexcept = delete;
+
+	void BeginFrame();
+	void BeginSubmit();
+	void EndSubmit();
+	/**
+	 * \param totalResourceCreationCount Resources created by the backend since Init, the frame's share is derived from it
+	 */
+	void EndFrame(const SubmitStats& submitStats, uint32_t totalResourceCreationCount);
+
+	/**
+	 * \brief Writes a header, then a row of rolling averages every intervalFrames frames
+	 * \return False if the file could not be opened
+	 */
+	bool OpenLog(const std::string& path, uint32_t intervalFrames);
+	void CloseLog();
+
+	[[nodiscard]] const FrameStats& GetLastFrame() const;
+	/**
+	 * \brief
+	 * \return Mean of the last s_HistorySize frames, or of every frame so far if fewer
+	 */
+	[[nodiscard]] FrameStats GetAverage() const;
+	[[nodiscard]] uint64_t GetFrameCount() const;
+
+	inline static constexpr uint32_t s_HistorySize{ 120 };
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	/* DATA MEMBERS */
+
+	std::array<FrameStats, s_HistorySize> m_History{};
+	uint64_t m_FrameCount{};
+	uint32_t m_LastResourceCreationCount{};
+
+	Clock::time_point m_FrameBeginTime{};
+	Clock::time_point m_SubmitBeginTime{};
+	float m_SubmitMilliseconds{};
+
+	std::ofstream m_Log{};
+	uint32_t m_LogInterval{};
+
+	/* PRIVATE METHODS */
+
+	void WriteLogRow();
+
+};
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+#include "Structs.h"
+
+/**
+ * \brief Slot table of renderer resources addressed by generational handles.
+ * Removed resources are kept alive until the same frame index comes around again, at which point the GPU is
+ * guaranteed to be done with them (same scheme as the DX12 descriptor heap deferred release).
+ * \tparam Tag Handle tag
+ * \tparam ResourceType Backend resource, must be default constructible and movable
+ * \tparam FrameCount Number of frames in flight
+ */
+template <typename Tag, typename ResourceType, int FrameCount>
+class ResourceTable final
+{
+public:
+	using Handle = ResourceHandle<Tag>;
+
+	ResourceTable() noexcept = default;
+	~ResourceTable() = default;
+
+	ResourceTable(const ResourceTable& other) noexcept = delete;
+	ResourceTable& operator=(const ResourceTable& other) noexcept = delete;
+	ResourceTable(ResourceTable&& other) noexcept = delete;
+	ResourceTable& operator=(ResourceTable&& other) noexcept = delete;
+
+	[[nodiscard]] Handle Add(ResourceType&& resource)
+	{
+		uint32_t index;
+		if (!m_FreeSlots.empty())
+		{
+			index = m_FreeSlots.back();
+			m_FreeSlots.pop_back();
+		}
+		else
+		{
+			index = static_cast<uint32_t>(m_Slots.size());
+			m_Slots.emplace_back();
+		}
+
+		Slot& slot{ m_Slots[index] };
+		slot.m_Resource = std::move(resource);
+		slot.m_IsAlive = true;
+		++m_Size;
+
+		return Handle{ index, slot.m_Generation };
+	}
+
+	/**
+	 * \brief Invalidates the handle immediately, the resource itself is released once frameIndex is reused
+	 */
+	void Remove(Handle handle, uint32_t frameIndex)
+	{
+		assert(frameIndex < FrameCount);
+		if (!IsAlive(handle))
+			return;
+
+		Slot& slot{ m_Slots[handle.m_Index] };
+		slot.m_IsAlive = false;
+		++slot.m_Generation;
+		--m_Size;
+
+		m_DeferredRelease[frameIndex].emplace_back(handle.m_Index);
+	}
+
+	[[nodiscard]] bool IsAlive(Handle handle) const
+	{
+		return handle.m_Index < m_Slots.size()
+			&& m_Slots[handle.m_Index].m_IsAlive
+			&& m_Slots[handle.m_Index].m_Generation == handle.m_Generation;
+	}
+
+	[[nodiscard]] ResourceType* Get(Handle handle)
+	{
+		return IsAlive(handle) ? &m_Slots[handle.m_Index].m_Resource : nullptr;
+	}
+
+	[[nodiscard]] const ResourceType* Get(Handle handle) const
+	{
+		return IsAlive(handle) ? &m_Slots[handle.m_Index].m_Resource : nullptr;
+	}
+
+	/**
+	 * \brief Must be called once the GPU finished the frame that previously used frameIndex
+	 */
+	void BeginFrame(uint32_t frameIndex)
+	{
+		assert(frameIndex < FrameCount);
+		ProcessDeferredRelease(frameIndex);
+	}
+
+	void Clear()
+	{
+		m_Slots.clear();
+		m_FreeSlots.clear();
+		for (auto& deferred : m_DeferredRelease)
+			deferred.clear();
+		m_Size = 0;
+	}
+
+	[[nodiscard]] uint32_t GetSize() const { return m_Size; }
+
+private:
+	/* NESTED CLASSES */
+
+	struct Slot
+	{
+		ResourceType m_Resource{};
+		uint32_t m_Generation{};
+		bool m_IsAlive{};
+	};
+
+	/* DATA MEMBERS */
+
+	std::vector<Slot> m_Slots{};
+	std::vector<uint32_t> m_FreeSlots{};
+	std::array<std::vector<uint32_t>, FrameCount> m_DeferredRelease{};
+	uint32_t m_Size{};
+
+	/* PRIVATE METHODS */
+
+	void ProcessDeferredRelease(uint32_t frameIndex)
+	{
+		for (const auto index : m_DeferredRelease[frameIndex])
+		{
+			m_Slots[index].m_Resource = ResourceType{};
+			m_FreeSlots.emplace_back(index);
+		}
+		m_DeferredRelease[frameIndex].clear();
+	}
+};
@@ -0,0 +1,136 @@
+#include "ShaderCache.h"
+
+#include <fstream>
+
+const ShaderBytecode* ShaderCache::Load(const std::filesystem::path& path)
+{
+	std::lock_guard lock{ m_Mutex };
+
+	const std::filesystem::path::string_type key{ path.lexically_normal().native() };
+	if (const auto it{ m_PathBytecodes.find(key) }; it != m_PathBytecodes.end())
+		return it->second.get();
+
+	std::shared_ptr<ShaderBytecode> pBytecode{ LoadFromPacks(path) };
+	if (!pBytecode)
+	{
+		pBytecode = LoadFromFile(path);
+		if (!pBytecode)
+			return nullptr;
+
+		++m_FileReadCount;
+	}
+
+	// A copy of an already loaded shader under another path shares the existing bytecode
+	const auto it{ m_HashBytecodes.try_emplace(pBytecode->m_Hash, std::move(pBytecode)).first };
+	m_PathBytecodes.emplace(key, it->second);
+
+	return it->second.get();
+}
+
+void ShaderCache::Clear()
+{
+	std::lock_guard lock{ m_Mutex };
+
+	m_PathBytecodes.clear();
+	m_HashBytecodes.clear();
+}
+
+bool ShaderCache::MountPack(const std::filesystem::path& path)
+{
+	MountedPack mountedPack{ std::make_unique<AssetPack>() };
+	if (!mountedPack.m_pPack->Open(path))
+		return false;
+
+	// Shaders are decompressed once then owned by their bytecode, the block cache would only duplicate them
+	if (mountedPack.m_pPack->IsCompressed())
+		mountedPack.m_pReader = std::make_unique<AssetPackReader>(*mountedPack.m_pPack, 0);
+
+	std::lock_guard lock{ m_Mutex };
+	m_Packs.push_back(std::move(mountedPack));
+
+	return true;
+}
+
+void ShaderCache::UnmountPacks()
+{
+	std::lock_guard lock{ m_Mutex };
+
+	m_PathBytecodes.clear();
+	m_HashBytecodes.clear();
+	m_Packs.clear();
+}
+
+uint32_t ShaderCache::GetFileReadCount() const
+{
+	std::lock_guard lock{ m_Mutex };
+	return m_FileReadCount;
+}
+
+uint32_t ShaderCache::GetBytecodeCount() const
+{
+	std::lock_guard lock{ m_Mutex };
+	return static_cast<uint32_t>(m_HashBytecodes.size());
+}
+
+uint64_t ShaderCache::Hash(const void* pData, size_t size, uint64_t seed)
+{
+	return AssetPack::Hash(pData, size, seed);
+}
+
+std::shared_ptr<ShaderBytecode> ShaderCache::LoadFromPacks(const std::filesystem::path& path) const
+{
+	if (m_Packs.empty())
+		return nullptr;
+
+	// Packs store their names the way the packer was given them, normalized with forward slashes
+	const std::string name{ path.lexically_normal().generic_string() };
+	for (auto it{ m_Packs.rbegin() }; it != m_Packs.rend(); ++it)
+	{
+		const AssetPack& pack{ *it->m_pPack };
+		const AssetPackEntry* pEntry{ pack.Find(name) };
+		if (!pEntry)
+			continue;
+
+		// The hash comes from the table of contents either way
+		auto pBytecode{ std::make_shared<ShaderBytecode>() };
+		pBytecode->m_Size = static_cast<size_t>(pEntry->m_Size);
+		pBytecode->m_Hash = pEntry->m_ContentHash;
+
+		if (it->m_pReader)
+		{
+			if (!it->m_pReader->Read(*pEntry, pBytecode->m_Storage))
+				return nullptr;
+
+			pBytecode->m_pData = pBytecode->m_Storage.data();
+		}
+		else
+		{
+			// No read nor copy, the bytecode points into the mapping
+			pBytecode->m_pData = pack.GetData(*pEntry);
+		}
+
+		return pBytecode;
+	}
+
+	return nullptr;
+}
+
+std::shared_ptr<ShaderBytecode> ShaderCache::LoadFromFile(const std::filesystem::path& path)
+{
+	std::ifstream file{ path, std::ios::binary | std::ios::ate };
+	if (!file)
+		return nullptr;
+
+	auto pBytecode{ std::make_shared<ShaderBytecode>() };
+	pBytecode->m_Storage.resize(static_cast<size_t>(file.tellg()));
+	file.seekg(0);
+	file.read(reinterpret_cast<char*>(pBytecode->m_Storage.data()), static_cast<std::streamsize>(pBytecode->m_Storage.size()));
+	if (!file)
+		return nullptr;
+
+	pBytecode->m_pData = pBytecode->m_Storage.data();
+	pBytecode->m_Size = pBytecode->m_Storage.size();
+	pBytecode->m_Hash = Hash(pBytecode->GetData(), pBytecode->GetSize());
+
+	return pBytecode;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "AssetPack.h"
+#include "AssetPackReader.h"
+#include "Singleton.h"
+
+/**
+ * \brief Compiled shader loaded by the ShaderCache, identical files share one instance.
+ * Points either into its own storage or straight into a mounted uncompressed AssetPack.
+ */
+struct ShaderBytecode
+{
+	std::vector<uint8_t> m_Storage{}; // Empty for bytecode living in an uncompressed pack
+	const void* m_pData{};
+	size_t m_Size{};
+	uint64_t m_Hash{}; // Of the content, identifies the shader independently of the file it came from
+
+	[[nodiscard]] const void* GetData() const { return m_pData; }
+	[[nodiscard]] size_t GetSize() const { return m_Size; }
+};
+
+/**
+ * \brief Loads every compiled shader file once, whatever the graphics API.
+ * Bytecode is keyed by path, and files with the same content resolve to the same bytecode so backends can key
+ * their shader objects on the content hash. Thread safe.
+ */
+class ShaderCache final : public Singleton<ShaderCache>
+{
+public:
+	~ShaderCache() override = default;
+
+	ShaderCache(const ShaderCache& other) noexcept = delete;
+	ShaderCache& operator=(const ShaderCache& other) noexcept = delete;
+	ShaderCache(ShaderCache&& other) noexcept = delete;
+	ShaderCache& operator=(ShaderCache&& other) noexcept = delete;
+
+	/**
+	 * \brief Looks the path up in the mounted packs first, then reads the file, on the first request only
+	 * \return Stays valid until Clear, nullptr if the file could not be read
+	 */
+	[[nodiscard]] const ShaderBytecode* Load(const std::filesystem::path& path);
+	/**
+	 * \brief Forgets every bytecode, objects created from them by the backends are not affected
+	 */
+	void Clear();
+
+	/**
+	 * \brief Maps a pack built with the AssetPacker tool. Shaders of uncompressed packs are then used without being
+	 * read nor copied, those of compressed packs are decompressed on first use. Packs mounted later take precedence.
+	 * \return False if the pack could not be opened
+	 */
+	bool MountPack(const std::filesystem::path& path);
+	/**
+	 * \brief Also clears the bytecodes, since some point into the packs
+	 */
+	void UnmountPacks();
+
+	[[nodiscard]] uint32_t GetFileReadCount() const;
+	[[nodiscard]] uint32_t GetBytecodeCount() const;
+
+	/**
+	 * \brief 64-bit FNV-1a, the same as AssetPack so content hashes from packs and files match
+	 * \param seed Hash of the preceding data, to hash several ranges as one
+	 */
+	[[nodiscard]] static uint64_t Hash(const void* pData, size_t size, uint64_t seed = s_HashSeed);
+
+	inline static constexpr uint64_t s_HashSeed{ 0xCBF29CE484222325ull };
+
+private:
+	friend class Singleton<ShaderCache>;
+	ShaderCache() noexcept = default;
+
+	/* NESTED CLASSES */
+
+	struct MountedPack
+	{
+		std::unique_ptr<AssetPack> m_pPack{};
+		std::unique_ptr<AssetPackReader> m_pReader{}; // Compressed packs only
+	};
+
+	/* DATA MEMBERS */
+
+	mutable std::mutex m_Mutex{};
+	std::unordered_map<std::filesystem::path::string_type, std::shared_ptr<const ShaderBytecode>> m_PathBytecodes{};
+	std::unordered_map<uint64_t, std::shared_ptr<const ShaderBytecode>> m_HashBytecodes{};
+	std::vector<MountedPack> m_Packs{};
+	uint32_t m_FileReadCount{};
+
+	/* PRIVATE METHODS */
+
+	std::shared_ptr<ShaderBytecode> LoadFromPacks(const std::filesystem::path& path) const;
+	static std::shared_ptr<ShaderBytecode> LoadFromFile(const std::filesystem::path& path);
+
+};
@@ -0,0 +1,392 @@
+#include "SoftwareRasterizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <emmintrin.h>
+
+#include "ImageWriter.h"
+#include "JobSystem.h"
+
+namespace
+{
+	constexpr float g_MinClipW{ 1e-5f };
+
+	uint32_t PackColor(float r, float g, float b, float a)
+	{
+		const auto toByte{ [](float value)
+		{
+			return static_cast<uint32_t>(std::clamp(value, 0.f, 1.f) * 255.f + .5f);
+		} };
+
+		return toByte(a) << 24 | toByte(r) << 16 | toByte(g) << 8 | toByte(b);
+	}
+
+	__m128i PackColors(__m128 r, __m128 g, __m128 b, __m128 a)
+	{
+		const __m128 zero{ _mm_setzero_ps() };
+		const __m128 one{ _mm_set1_ps(1.f) };
+		const __m128 scale{ _mm_set1_ps(255.f) };
+		const __m128 half{ _mm_set1_ps(.5f) };
+
+		const auto toByte{ [&](__m128 value)
+		{
+			return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(value, zero), one), scale), half));
+		} };
+
+		__m128i packed{ _mm_slli_epi32(toByte(a), 24) };
+		packed = _mm_or_si128(packed, _mm_slli_epi32(toByte(r), 16));
+		packed = _mm_or_si128(packed, _mm_slli_epi32(toByte(g), 8));
+		return _mm_or_si128(packed, toByte(b));
+	}
+}
+
+void SoftwareRasterizer::Resize(uint32_t width, uint32_t height)
+{
+	m_Width = width;
+	m_Height = height;
+	m_Pitch = (width + 3) & ~3u;
+	m_TileCountX = (width + s_TileSize - 1) / s_TileSize;
+	m_TileCountY = (height + s_TileSize - 1) / s_TileSize;
+
+	const size_t pixelCount{ static_cast<size_t>(m_Pitch) * height };
+	m_pColorBuffer = std::make_unique<uint32_t[]>(pixelCount);
+	m_pDepthBuffer = std::make_unique<float[]>(pixelCount);
+
+	m_Bins.clear();
+	m_Bins.resize(static_cast<size_t>(m_TileCountX) * m_TileCountY);
+}
+
+void SoftwareRasterizer::Clear(const float color[4], float depth)
+{
+	const size_t pixelCount{ static_cast<size_t>(m_Pitch) * m_Height };
+	std::fill_n(m_pColorBuffer.get(), pixelCount, PackColor(color[0], color[1], color[2], color[3]));
+	std::fill_n(m_pDepthBuffer.get(), pixelCount, depth);
+}
+
+void SoftwareRasterizer::SetPipelineState(const PipelineState& state)
+{
+	m_PipelineState = state;
+}
+
+const SoftwareRasterizer::PipelineState& SoftwareRasterizer::GetPipelineState() const
+{
+	return m_PipelineState;
+}
+
+void SoftwareRasterizer::SubmitTriangles(const Vertex* pVertices, uint32_t vertexCount, const uint32_t* pIndices, uint32_t indexCount)
+{
+	const bool isConstantColor{ m_PipelineState.m_PixelProgram == PixelProgram::ConstantColor };
+
+	for (uint32_t i{}; i + 2 < indexCount; i += 3)
+	{
+		if (pIndices[i] >= vertexCount || pIndices[i + 1] >= vertexCount || pIndices[i + 2] >= vertexCount)
+			continue;
+
+		Triangle triangle{ { pVertices[pIndices[i]], pVertices[pIndices[i + 1]], pVertices[pIndices[i + 2]] }, isConstantColor };
+		if (isConstantColor)
+		{
+			for (Vertex& vertex : triangle.m_Vertices)
+				vertex.m_Color = m_PipelineState.m_ConstantColor;
+		}
+
+		m_Triangles.emplace_back(triangle);
+	}
+}
+
+void SoftwareRasterizer::Flush()
+{
+	if (m_Bins.empty())
+	{
+		m_Triangles.clear();
+		return;
+	}
+
+	SetupTriangles();
+	BinTriangles();
+
+	JobSystem::Get().ParallelFor(static_cast<uint32_t>(m_Bins.size()), [this](uint32_t tileIndex)
+	{
+		RasterizeTile(tileIndex);
+	});
+
+	m_Triangles.clear();
+	m_Setups.clear();
+	for (std::vector<uint32_t>& bin : m_Bins)
+		bin.clear();
+}
+
+const uint32_t* SoftwareRasterizer::GetColorBuffer() const
+{
+	return m_pColorBuffer.get();
+}
+
+const float* SoftwareRasterizer::GetDepthBuffer() const
+{
+	return m_pDepthBuffer.get();
+}
+
+uint32_t SoftwareRasterizer::GetWidth() const
+{
+	return m_Width;
+}
+
+uint32_t SoftwareRasterizer::GetHeight() const
+{
+	return m_Height;
+}
+
+uint32_t SoftwareRasterizer::GetPitch() const
+{
+	return m_Pitch;
+}
+
+bool SoftwareRasterizer::SaveTGA(const std::string& path) const
+{
+	return ImageWriter::SaveTGA(path, m_pColorBuffer.get(), m_Width, m_Height, m_Pitch);
+}
+
+void SoftwareRasterizer::SetupTriangles()
+{
+	m_Setups.reserve(m_Triangles.size());
+
+	const __m128 halfWidth{ _mm_set1_ps(static_cast<float>(m_Width) * .5f) };
+	const __m128 halfHeight{ _mm_set1_ps(static_cast<float>(m_Height) * .5f) };
+	const __m128 minW{ _mm_set1_ps(g_MinClipW) };
+	const __m128 zero{ _mm_setzero_ps() };
+
+	// Four triangles per iteration, one per SSE lane
+	for (size_t first{}; first < m_Triangles.size(); first += 4)
+	{
+		const size_t laneCount{ std::min<size_t>(4, m_Triangles.size() - first) };
+
+		alignas(16) float clip[3][4][4]{}; // [vertex][component][lane]
+		for (size_t lane{}; lane < 4; ++lane)
+		{
+			// Unused lanes repeat the last triangle and are ignored
+			const Triangle& triangle{ m_Triangles[first + std::min(lane, laneCount - 1)] };
+			for (int v{}; v < 3; ++v)
+			{
+				const Float4& position{ triangle.m_Vertices[v].m_Position };
+				clip[v][0][lane] = position.x;
+				clip[v][1][lane] = position.y;
+				clip[v][2][lane] = position.z;
+				clip[v][3][lane] = position.w;
+			}
+		}
+
+		__m128 x[3], y[3], z[3], invW[3];
+		__m128 isVisible{ _mm_castsi128_ps(_mm_set1_epi32(-1)) };
+		for (int v{}; v < 3; ++v)
+		{
+			const __m128 w{ _mm_load_ps(clip[v][3]) };
+			isVisible = _mm_and_ps(isVisible, _mm_cmpgt_ps(w, minW)); // No near plane clipping, drop the triangle instead
+
+			invW[v] = _mm_div_ps(_mm_set1_ps(1.f), w);
+			x[v] = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_load_ps(clip[v][0]), invW[v]), _mm_set1_ps(1.f)), halfWidth);
+			y[v] = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(1.f), _mm_mul_ps(_mm_load_ps(clip[v][1]), invW[v])), halfHeight);
+			z[v] = _mm_mul_ps(_mm_load_ps(clip[v][2]), invW[v]);
+		}
+
+		// Edge i is opposite to vertex i, E(p) = A * p.x + B * p.y + C
+		__m128 a[3], b[3], c[3];
+		for (int e{}; e < 3; ++e)
+		{
+			const int from{ (e + 1) % 3 };
+			const int to{ (e + 2) % 3 };
+			a[e] = _mm_sub_ps(y[from], y[to]);
+			b[e] = _mm_sub_ps(x[to], x[from]);
+			c[e] = _mm_sub_ps(_mm_mul_ps(x[from], y[to]), _mm_mul_ps(x[to], y[from]));
+		}
+
+		// Positive area is clockwise in screen space, the D3D front face
+		const __m128 area{ _mm_add_ps(_mm_add_ps(_mm_mul_ps(a[0], x[0]), _mm_mul_ps(b[0], y[0])), c[0]) };
+		isVisible = _mm_and_ps(isVisible, _mm_cmpgt_ps(area, zero));
+
+		const __m128 minX{ _mm_min_ps(_mm_min_ps(x[0], x[1]), x[2]) };
+		const __m128 minY{ _mm_min_ps(_mm_min_ps(y[0], y[1]), y[2]) };
+		const __m128 maxX{ _mm_max_ps(_mm_max_ps(x[0], x[1]), x[2]) };
+		const __m128 maxY{ _mm_max_ps(_mm_max_ps(y[0], y[1]), y[2]) };
+
+		alignas(16) float laneArea[4], laneMinX[4], laneMinY[4], laneMaxX[4], laneMaxY[4];
+		alignas(16) float laneA[3][4], laneB[3][4], laneC[3][4], laneZ[3][4], laneInvW[3][4];
+		_mm_store_ps(laneArea, _mm_and_ps(area, isVisible));
+		_mm_store_ps(laneMinX, minX);
+		_mm_store_ps(laneMinY, minY);
+		_mm_store_ps(laneMaxX, maxX);
+		_mm_store_ps(laneMaxY, maxY);
+		for (int i{}; i < 3; ++i)
+		{
+			_mm_store_ps(laneA[i], a[i]);
+			_mm_store_ps(laneB[i], b[i]);
+			_mm_store_ps(laneC[i], c[i]);
+			_mm_store_ps(laneZ[i], z[i]);
+			_mm_store_ps(laneInvW[i], invW[i]);
+		}
+
+		for (size_t lane{}; lane < laneCount; ++lane)
+		{
+			if (!(laneArea[lane] > 0.f))
+				continue;
+
+			// Pixel centers at +.5, clamped to the render target
+			const float width{ static_cast<float>(m_Width) };
+			const float height{ static_cast<float>(m_Height) };
+
+			TriangleSetup setup{};
+			setup.m_MinX = static_cast<int>(std::ceil(std::clamp(laneMinX[lane] - .5f, 0.f, width)));
+			setup.m_MinY = static_cast<int>(std::ceil(std::clamp(laneMinY[lane] - .5f, 0.f, height)));
+			setup.m_MaxX = static_cast<int>(std::floor(std::clamp(laneMaxX[lane] - .5f, -1.f, width - 1.f)));
+			setup.m_MaxY = static_cast<int>(std::floor(std::clamp(laneMaxY[lane] - .5f, -1.f, height - 1.f)));
+			if (setup.m_MinX > setup.m_MaxX || setup.m_MinY > setup.m_MaxY)
+				continue;
+
+			const Triangle& triangle{ m_Triangles[first + lane] };
+			for (int i{}; i < 3; ++i)
+			{
+				setup.m_EdgeA[i] = laneA[i][lane];
+				setup.m_EdgeB[i] = laneB[i][lane];
+				setup.m_EdgeC[i] = laneC[i][lane];
+
+				// Top-left rule: pixels exactly on an edge belong to top and left edges only
+				const bool isTopLeft{ setup.m_EdgeA[i] > 0.f || (setup.m_EdgeA[i] == 0.f && setup.m_EdgeB[i] > 0.f) };
+				setup.m_EdgeBias[i] = isTopLeft ? 0.f : std::numeric_limits<float>::denorm_min();
+
+				setup.m_Z[i] = laneZ[i][lane];
+				setup.m_InvW[i] = laneInvW[i][lane];
+
+				const Float4& color{ triangle.m_Vertices[i].m_Color };
+				setup.m_ColorOverW[i] = { color.x * setup.m_InvW[i], color.y * setup.m_InvW[i], color.z * setup.m_InvW[i], color.w * setup.m_InvW[i] };
+			}
+			setup.m_InvArea = 1.f / laneArea[lane];
+			setup.m_IsConstantColor = triangle.m_IsConstantColor;
+			if (setup.m_IsConstantColor)
+				setup.m_ColorOverW[0] = triangle.m_Vertices[0].m_Color;
+
+			m_Setups.emplace_back(setup);
+		}
+	}
+}
+
+void SoftwareRasterizer::BinTriangles()
+{
+	for (uint32_t setupIndex{}; setupIndex < static_cast<uint32_t>(m_Setups.size()); ++setupIndex)
+	{
+		const TriangleSetup& setup{ m_Setups[setupIndex] };
+		const uint32_t firstTileX{ static_cast<uint32_t>(setup.m_MinX) / s_TileSize };
+		const uint32_t firstTileY{ static_cast<uint32_t>(setup.m_MinY) / s_TileSize };
+		const uint32_t lastTileX{ static_cast<uint32_t>(setup.m_MaxX) / s_TileSize };
+		const uint32_t lastTileY{ static_cast<uint32_t>(setup.m_MaxY) / s_TileSize };
+
+		for (uint32_t tileY{ firstTileY }; tileY <= lastTileY; ++tileY)
+		{
+			for (uint32_t tileX{ firstTileX }; tileX <= lastTileX; ++tileX)
+				m_Bins[tileY * m_TileCountX + tileX].emplace_back(setupIndex);
+		}
+	}
+}
+
+void SoftwareRasterizer::RasterizeTile(uint32_t tileIndex)
+{
+	const std::vector<uint32_t>& bin{ m_Bins[tileIndex] };
+	if (bin.empty())
+		return;
+
+	const int tileMinX{ static_cast<int>(tileIndex % m_TileCountX * s_TileSize) };
+	const int tileMinY{ static_cast<int>(tileIndex / m_TileCountX * s_TileSize) };
+	const int tileMaxX{ std::min(tileMinX + static_cast<int>(s_TileSize), static_cast<int>(m_Width)) - 1 };
+	const int tileMaxY{ std::min(tileMinY + static_cast<int>(s_TileSize), static_cast<int>(m_Height)) - 1 };
+
+	const __m128 laneOffsets{ _mm_set_ps(3.5f, 2.5f, 1.5f, .5f) };
+	const __m128i laneIndices{ _mm_set_epi32(3, 2, 1, 0) };
+	const __m128 zero{ _mm_setzero_ps() };
+	const __m128 one{ _mm_set1_ps(1.f) };
+
+	for (const uint32_t setupIndex : bin)
+	{
+		const TriangleSetup& setup{ m_Setups[setupIndex] };
+
+		const int minX{ std::max(setup.m_MinX, tileMinX) };
+		const int minY{ std::max(setup.m_MinY, tileMinY) };
+		const int maxX{ std::min(setup.m_MaxX, tileMaxX) };
+		const int maxY{ std::min(setup.m_MaxY, tileMaxY) };
+
+		__m128 edgeA[3], edgeB[3], edgeC[3], edgeBias[3], z[3], invW[3];
+		for (int i{}; i < 3; ++i)
+		{
+			edgeA[i] = _mm_set1_ps(setup.m_EdgeA[i]);
+			edgeB[i] = _mm_set1_ps(setup.m_EdgeB[i]);
+			edgeC[i] = _mm_set1_ps(setup.m_EdgeC[i]);
+			edgeBias[i] = _mm_set1_ps(setup.m_EdgeBias[i]);
+			z[i] = _mm_set1_ps(setup.m_Z[i] * setup.m_InvArea);
+			invW[i] = _mm_set1_ps(setup.m_InvW[i] * setup.m_InvArea);
+		}
+
+		const Float4& constantColor{ setup.m_ColorOverW[0] };
+		const __m128i constantPacked{ _mm_set1_epi32(static_cast<int>(PackColor(constantColor.x, constantColor.y, constantColor.z, constantColor.w))) };
+
+		const __m128i minXVector{ _mm_set1_epi32(minX) };
+		const __m128i maxXVector{ _mm_set1_epi32(maxX) };
+
+		// Quads start 4 pixel aligned, tiles are a multiple of 4 wide and the pitch is padded
+		const int firstQuadX{ minX & ~3 };
+
+		for (int y{ minY }; y <= maxY; ++y)
+		{
+			const __m128 pixelY{ _mm_set1_ps(static_cast<float>(y) + .5f) };
+			uint32_t* pColorRow{ m_pColorBuffer.get() + static_cast<size_t>(y) * m_Pitch };
+			float* pDepthRow{ m_pDepthBuffer.get() + static_cast<size_t>(y) * m_Pitch };
+
+			for (int x{ firstQuadX }; x <= maxX; x += 4)
+			{
+				const __m128 pixelX{ _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets) };
+				const __m128i pixelIndex{ _mm_add_epi32(_mm_set1_epi32(x), laneIndices) };
+
+				__m128 mask{ _mm_castsi128_ps(_mm_andnot_si128(_mm_or_si128(_mm_cmplt_epi32(pixelIndex, minXVector), _mm_cmpgt_epi32(pixelIndex, maxXVector)), _mm_set1_epi32(-1))) };
+
+				__m128 edge[3];
+				for (int i{}; i < 3; ++i)
+				{
+					edge[i] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(edgeA[i], pixelX), _mm_mul_ps(edgeB[i], pixelY)), edgeC[i]);
+					mask = _mm_and_ps(mask, _mm_cmpge_ps(edge[i], edgeBias[i]));
+				}
+				if (_mm_movemask_ps(mask) == 0)
+					continue;
+
+				// Edge values are barycentric weights scaled by the area, already folded into the attributes
+				const __m128 depth{ _mm_add_ps(_mm_add_ps(_mm_mul_ps(edge[0], z[0]), _mm_mul_ps(edge[1], z[1])), _mm_mul_ps(edge[2], z[2])) };
+				const __m128 oldDepth{ _mm_loadu_ps(pDepthRow + x) };
+				mask = _mm_and_ps(mask, _mm_cmple_ps(depth, oldDepth));
+				mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpge_ps(depth, zero), _mm_cmple_ps(depth, one)));
+				if (_mm_movemask_ps(mask) == 0)
+					continue;
+
+				_mm_storeu_ps(pDepthRow + x, _mm_or_ps(_mm_and_ps(mask, depth), _mm_andnot_ps(mask, oldDepth)));
+
+				__m128i color{ constantPacked };
+				if (!setup.m_IsConstantColor)
+				{
+					const __m128 w{ _mm_div_ps(one, _mm_add_ps(_mm_add_ps(_mm_mul_ps(edge[0], invW[0]), _mm_mul_ps(edge[1], invW[1])), _mm_mul_ps(edge[2], invW[2]))) };
+					const __m128 weight0{ _mm_mul_ps(_mm_mul_ps(edge[0], _mm_set1_ps(setup.m_InvArea)), w) };
+					const __m128 weight1{ _mm_mul_ps(_mm_mul_ps(edge[1], _mm_set1_ps(setup.m_InvArea)), w) };
+					const __m128 weight2{ _mm_mul_ps(_mm_mul_ps(edge[2], _mm_set1_ps(setup.m_InvArea)), w) };
+
+					const auto interpolate{ [&](float Float4::* channel)
+					{
+						return _mm_add_ps(_mm_add_ps(
+							_mm_mul_ps(weight0, _mm_set1_ps(setup.m_ColorOverW[0].*channel)),
+							_mm_mul_ps(weight1, _mm_set1_ps(setup.m_ColorOverW[1].*channel))),
+							_mm_mul_ps(weight2, _mm_set1_ps(setup.m_ColorOverW[2].*channel)));
+					} };
+
+					color = PackColors(interpolate(&Float4::x), interpolate(&Float4::y), interpolate(&Float4::z), interpolate(&Float4::w));
+				}
+
+				const __m128i writeMask{ _mm_castps_si128(mask) };
+				const __m128i oldColor{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(pColorRow + x)) };
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(pColorRow + x), _mm_or_si128(_mm_and_si128(writeMask, color), _mm_andnot_si128(writeMask, oldColor)));
+			}
+		}
+	}
+}
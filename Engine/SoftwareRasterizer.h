@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * \brief CPU triangle rasterizer with a color and depth buffer.
+ * Triangles are buffered until Flush, which sets them up four at a time with SSE, bins them into screen tiles
+ * and rasterizes the tiles in parallel on the JobSystem. Tiles never share pixels, so no locking is needed and
+ * the submission order is preserved within every tile.
+ * Only depends on the standard library and the JobSystem, so it also renders outside the engine.
+ */
+class SoftwareRasterizer final
+{
+public:
+	/**
+	 * \brief Laid out like an HLSL float4, so the rasterizer does not depend on a math library
+	 */
+	struct Float4
+	{
+		float x{};
+		float y{};
+		float z{};
+		float w{};
+	};
+
+	/**
+	 * \brief Post vertex shader vertex
+	 */
+	struct Vertex
+	{
+		Float4 m_Position{}; // Clip space
+		Float4 m_Color{};
+	};
+
+	/**
+	 * \brief Emulated shader programs, bound by the materials like on a GPU device context
+	 */
+	enum class VertexProgram
+	{
+		Color,          // ColorVS, float2 position, world matrix in the object constants
+		ColorInstanced, // ColorInstancedVS, float2 position, world matrix and color in the instance array
+		VertexColor     // TestVS, float2 position followed by a float4 color
+	};
+
+	enum class PixelProgram
+	{
+		ConstantColor, // ColorPS
+		VertexColor    // TestPS
+	};
+
+	struct PipelineState
+	{
+		VertexProgram m_VertexProgram{ VertexProgram::Color };
+		PixelProgram m_PixelProgram{ PixelProgram::ConstantColor };
+		Float4 m_ConstantColor{};
+	};
+
+	SoftwareRasterizer() noexcept = default;
+	~SoftwareRasterizer() = default;
+
+	SoftwareRasterizer(const SoftwareRasterizer& other) noexcept = delete;
+	SoftwareRasterizer& operator=(const SoftwareRasterizer& other) noexcept = delete;
+	SoftwareRasterizer(SoftwareRasterizer&& other) noexcept = delete;
+	SoftwareRasterizer& operator=(SoftwareRasterizer&& other) noexcept = delete;
+
+	void Resize(uint32_t width, uint32_t height);
+	void Clear(const float color[4], float depth);
+
+	void SetPipelineState(const PipelineState& state);
+	[[nodiscard]] const PipelineState& GetPipelineState() const;
+
+	/**
+	 * \brief Buffers indexed triangles, shaded with the currently bound pixel program
+	 * \param pVertices Clip space vertices
+	 * \param pIndices Triangle list
+	 */
+	void SubmitTriangles(const Vertex* pVertices, uint32_t vertexCount, const uint32_t* pIndices, uint32_t indexCount);
+	/**
+	 * \brief Rasterizes every buffered triangle, blocks until the framebuffer is complete
+	 */
+	void Flush();
+
+	/**
+	 * \brief
+	 * \return Row major BGRA8 pixels (0xAARRGGBB), GetPitch pixels per row
+	 */
+	[[nodiscard]] const uint32_t* GetColorBuffer() const;
+	[[nodiscard]] const float* GetDepthBuffer() const;
+	[[nodiscard]] uint32_t GetWidth() const;
+	[[nodiscard]] uint32_t GetHeight() const;
+	[[nodiscard]] uint32_t GetPitch() const;
+
+	/**
+	 * \brief Writes the color buffer as an uncompressed 32-bit TGA
+	 * \return False if the file could not be written
+	 */
+	bool SaveTGA(const std::string& path) const;
+
+	inline static constexpr uint32_t s_TileSize{ 64 };
+
+private:
+	/* NESTED CLASSES */
+
+	struct Triangle
+	{
+		Vertex m_Vertices[3];
+		bool m_IsConstantColor{};
+	};
+
+	struct TriangleSetup
+	{
+		float m_EdgeA[3]{};
+		float m_EdgeB[3]{};
+		float m_EdgeC[3]{};
+		float m_EdgeBias[3]{}; // Top-left fill rule
+		float m_Z[3]{};
+		float m_InvW[3]{};
+		Float4 m_ColorOverW[3]{}; // Perspective correct interpolation
+		float m_InvArea{};
+		int m_MinX{}, m_MinY{}, m_MaxX{}, m_MaxY{};
+		bool m_IsConstantColor{};
+	};
+
+	/* DATA MEMBERS */
+
+	uint32_t m_Width{};
+	uint32_t m_Height{};
+	uint32_t m_Pitch{}; // Width rounded up to 4 pixels so rows can be processed in SSE quads
+	uint32_t m_TileCountX{};
+	uint32_t m_TileCountY{};
+
+	std::unique_ptr<uint32_t[]> m_pColorBuffer{};
+	std::unique_ptr<float[]> m_pDepthBuffer{};
+
+	PipelineState m_PipelineState{};
+
+	std::vector<Triangle> m_Triangles{};
+	std::vector<TriangleSetup> m_Setups{};
+	std::vector<std::vector<uint32_t>> m_Bins{}; // Setup indices per tile, in submission order
+
+	/* PRIVATE METHODS */
+
+	void SetupTriangles();
+	void BinTriangles();
+	void RasterizeTile(uint32_t tileIndex);
+
+};
@@ -0,0 +1,81 @@
+#include "StateTracker.h"
+
+#include <cassert>
+
+void StateTracker::Invalidate()
+{
+	m_VertexShader = {};
+	m_PixelShader = {};
+	m_InputLayout = {};
+	m_Pipeline = {};
+	m_PrimitiveTopology = {};
+	m_VertexBuffer = {};
+	m_IndexBuffer = {};
+	m_ConstantBuffers = {};
+}
+
+void StateTracker::ResetStats()
+{
+	m_Stats = {};
+}
+
+bool StateTracker::SetVertexShader(const void* pShader)
+{
+	return Apply(m_VertexShader, pShader, 0, 0);
+}
+
+bool StateTracker::SetPixelShader(const void* pShader)
+{
+	return Apply(m_PixelShader, pShader, 0, 0);
+}
+
+bool StateTracker::SetInputLayout(const void* pLayout)
+{
+	return Apply(m_InputLayout, pLayout, 0, 0);
+}
+
+bool StateTracker::SetPipeline(const void* pPipeline)
+{
+	return Apply(m_Pipeline, pPipeline, 0, 0);
+}
+
+bool StateTracker::SetPrimitiveTopology(uint32_t topology)
+{
+	return Apply(m_PrimitiveTopology, nullptr, 0, topology);
+}
+
+bool StateTracker::SetVertexBuffer(const void* pBuffer, uint32_t stride, uint64_t offset)
+{
+	return Apply(m_VertexBuffer, pBuffer, offset, stride);
+}
+
+bool StateTracker::SetIndexBuffer(const void* pBuffer, uint32_t format, uint64_t offset)
+{
+	return Apply(m_IndexBuffer, pBuffer, offset, format);
+}
+
+bool StateTracker::SetConstantBuffer(ShaderStage stage, uint32_t slot, const void* pBuffer, uint64_t offset, uint64_t size)
+{
+	const auto stageIndex = static_cast<uint32_t>(stage);
+	assert(stageIndex < s_StageCount && slot < s_ConstantBufferSlotCount);
+
+	return Apply(m_ConstantBuffers[stageIndex][slot], pBuffer, offset, size);
+}
+
+const StateTracker::Stats& StateTracker::GetStats() const
+{
+	return m_Stats;
+}
+
+bool StateTracker::Apply(Binding& binding, const void* pObject, uint64_t offset, uint64_t size)
+{
+	if (binding.m_IsKnown && binding.m_pObject == pObject && binding.m_Offset == offset && binding.m_Size == size)
+	{
+		++m_Stats.m_FilteredCount;
+		return false;
+	}
+
+	binding = { pObject, offset, size, true };
+	++m_Stats.m_IssuedCount;
+	return true;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "Structs.h"
+
+/**
+ * \brief Shadow of the pipeline state bound on a command stream, independent of the graphics API.
+ * Backends and materials ask it before every bind: a Set call returns true and records the new state when the
+ * bind has to reach the API, false when the same object is already bound. Objects are identified by address, the
+ * tracker never dereferences them. Invalidate whenever the API state is reset or changed behind its back.
+ */
+class StateTracker final
+{
+public:
+	struct Stats
+	{
+		uint32_t m_IssuedCount{}; // Binds that reached the API
+		uint32_t m_FilteredCount{}; // Redundant binds skipped
+	};
+
+	StateTracker() noexcept = default;
+	~StateTracker() = default;
+
+	StateTracker(const StateTracker& other) noexcept = delete;
+	StateTracker& operator=(const StateTracker& other) noexcept = delete;
+	StateTracker(StateTracker&& other) noexcept = delete;
+	StateTracker& operator=(StateTracker&& other) noexcept = delete;
+
+	/**
+	 * \brief Forget every bound state, the next bind of each kind is always issued
+	 */
+	void Invalidate();
+	void ResetStats();
+
+	[[nodiscard]] bool SetVertexShader(const void* pShader);
+	[[nodiscard]] bool SetPixelShader(const void* pShader);
+	[[nodiscard]] bool SetInputLayout(const void* pLayout);
+	/**
+	 * \brief Whole pipeline object, for APIs folding shaders, layout and topology into one
+	 */
+	[[nodiscard]] bool SetPipeline(const void* pPipeline);
+	/**
+	 * \param topology Value of the API enumeration
+	 */
+	[[nodiscard]] bool SetPrimitiveTopology(uint32_t topology);
+	[[nodiscard]] bool SetVertexBuffer(const void* pBuffer, uint32_t stride, uint64_t offset = 0);
+	/**
+	 * \param format Value of the API enumeration
+	 */
+	[[nodiscard]] bool SetIndexBuffer(const void* pBuffer, uint32_t format, uint64_t offset = 0);
+	/**
+	 * \param offset Start of the bound range, in the unit of the API
+	 * \param size Size of the bound range, in the unit of the API, 0 for the whole buffer
+	 */
+	[[nodiscard]] bool SetConstantBuffer(ShaderStage stage, uint32_t slot, const void* pBuffer, uint64_t offset = 0, uint64_t size = 0);
+
+	[[nodiscard]] const Stats& GetStats() const;
+
+	inline static constexpr uint32_t s_ConstantBufferSlotCount{ 14 }; // D3D11 limit per stage
+	inline static constexpr uint32_t s_StageCount{ 2 };
+
+private:
+	/* NESTED CLASSES */
+
+	struct Binding
+	{
+		const void* m_pObject{};
+		uint64_t m_Offset{};
+		uint64_t m_Size{}; // Or stride, format, topology, whatever else the bind depends on
+		bool m_IsKnown{};
+	};
+
+	/* DATA MEMBERS */
+
+	Binding m_VertexShader{};
+	Binding m_PixelShader{};
+	Binding m_InputLayout{};
+	Binding m_Pipeline{};
+	Binding m_PrimitiveTopology{};
+	Binding m_VertexBuffer{};
+	Binding m_IndexBuffer{};
+	std::array<std::array<Binding, s_ConstantBufferSlotCount>, s_StageCount> m_ConstantBuffers{};
+
+	Stats m_Stats{};
+
+	/* PRIVATE METHODS */
+
+	bool Apply(Binding& binding, const void* pObject, uint64_t offset, uint64_t size);
+
+};
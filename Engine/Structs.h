@@ -1,2 +1,88 @@
 #pragma once
 
+#include <cstdint>
+
+/**
+ * \brief Generational handle to a renderer owned resource. The generation is bumped every time a slot is
+ * released, so a stale handle never resolves to the resource that reused its slot.
+ * \tparam Tag Empty tag type, only used to make handles of different resource kinds incompatible
+ */
+template <typename Tag>
+struct ResourceHandle
+{
+	inline static constexpr uint32_t s_InvalidIndex{ 0xFFFFFFFFu };
+
+	uint32_t m_Index{ s_InvalidIndex };
+	uint32_t m_Generation{};
+
+	[[nodiscard]] constexpr bool IsValid() const { return m_Index != s_InvalidIndex; }
+	constexpr bool operator==(const ResourceHandle& other) const = default;
+};
+
+struct MeshTag;
+using MeshHandle = ResourceHandle<MeshTag>;
+
+struct MaterialTemplateTag;
+using MaterialTemplateHandle = ResourceHandle<MaterialTemplateTag>;
+
+struct MaterialInstanceTag;
+using MaterialInstanceHandle = ResourceHandle<MaterialInstanceTag>;
+
+enum class IndexFormat
+{
+	UInt16,
+	UInt32
+};
+
+struct MeshDesc
+{
+	const void* m_pVertices{};
+	uint32_t m_VertexCount{};
+	uint32_t m_VertexStride{};
+
+	const void* m_pIndices{};
+	uint32_t m_IndexCount{};
+	IndexFormat m_IndexFormat{ IndexFormat::UInt16 };
+};
+
+/**
+ * \brief Slice of the per-frame upload buffer, only valid until the end of the frame it was allocated in
+ */
+struct TransientAllocation
+{
+	void* m_pData{};
+	uint64_t m_Offset{}; // From the start of the whole upload buffer
+	uint64_t m_Size{};
+
+	[[nodiscard]] constexpr bool IsValid() const { return m_pData != nullptr; }
+};
+
+enum class ShaderStage
+{
+	Vertex,
+	Pixel
+};
+
+class BaseMaterial;
+
+/**
+ * \brief Draw call captured by the Null backend, lets tests check what a frame submitted without a GPU
+ */
+struct RecordedDraw
+{
+	MeshHandle m_Mesh{};
+	const BaseMaterial* m_pMaterial{};
+	uint32_t m_InstanceCount{};
+};
+
+struct SubmitStats
+{
+	uint32_t m_PacketCount{}; // Draws recorded, one per object
+	uint32_t m_DroppedPacketCount{}; // Draws whose object is past GameSettings::maxObjectsPerFrame, not issued
+	uint32_t m_DrawCallCount{}; // Draws issued to the API once instancing merged the runs
+	uint32_t m_InstancedDrawCallCount{};
+	uint32_t m_MapCount{}; // Buffers mapped to upload the frame's data, material parameters included
+	uint64_t m_UploadedBytes{}; // Transient data and material parameters
+	uint32_t m_StateChangeCount{}; // Binds that reached the API
+	uint32_t m_FilteredStateChangeCount{}; // Redundant binds skipped by the StateTracker
+};
@@ -0,0 +1,279 @@
+#include "TextureResidencyManager.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+TextureResidencyManager::TextureResidencyManager(uint64_t budget, uint64_t uploadBudget) noexcept
+	: m_Budget{ budget }
+	, m_UploadBudget{ uploadBudget }
+{
+}
+
+uint32_t TextureResidencyManager::Register(const TextureResidencyDesc& desc)
+{
+	assert(desc.m_Width > 0 && desc.m_Height > 0 && desc.m_MipCount > 0);
+
+	uint32_t index;
+	if (!m_FreeTextures.empty())
+	{
+		index = m_FreeTextures.back();
+		m_FreeTextures.pop_back();
+	}
+	else
+	{
+		index = static_cast<uint32_t>(m_Textures.size());
+		m_Textures.emplace_back();
+	}
+
+	Texture& texture{ m_Textures[index] };
+	texture = {};
+	texture.m_Desc = desc;
+	texture.m_ResidentMip = texture.m_CommittedMip = texture.m_DesiredMip = GetCoarsestMip(texture);
+	texture.m_IsAlive = true;
+
+	const uint64_t size{ GetMipChainSize(desc, texture.m_ResidentMip) };
+	m_CommittedBytes += size;
+	m_ResidentBytes += size;
+
+	return index;
+}
+
+void TextureResidencyManager::Unregister(uint32_t texture)
+{
+	assert(texture < m_Textures.size() && m_Textures[texture].m_IsAlive && !IsLoadPending(texture));
+
+	Texture& entry{ m_Textures[texture] };
+	const uint64_t size{ GetMipChainSize(entry.m_Desc, entry.m_ResidentMip) };
+	m_CommittedBytes -= size;
+	m_ResidentBytes -= size;
+
+	entry.m_IsAlive = false;
+	m_FreeTextures.push_back(texture);
+}
+
+void TextureResidencyManager::BeginFrame()
+{
+	++m_Frame;
+}
+
+void TextureResidencyManager::ReportUsage(uint32_t texture, float screenPixels)
+{
+	assert(texture < m_Textures.size() && m_Textures[texture].m_IsAlive);
+
+	Texture& entry{ m_Textures[texture] };
+	if (entry.m_LastNeededFrame != m_Frame)
+	{
+		entry.m_LastNeededFrame = m_Frame;
+		entry.m_ScreenPixels = screenPixels;
+	}
+	else
+		entry.m_ScreenPixels = std::max(entry.m_ScreenPixels, screenPixels);
+
+	entry.m_DesiredMip = ComputeDesiredMip(entry.m_Desc, entry.m_ScreenPixels);
+}
+
+std::span<const ResidencyCommand> TextureResidencyManager::Update()
+{
+	m_Commands.clear();
+	m_LoadCandidates.clear();
+	m_EvictionCandidates.clear();
+
+	for (uint32_t i{}; i < m_Textures.size(); ++i)
+	{
+		Texture& texture{ m_Textures[i] };
+		if (!texture.m_IsAlive)
+			continue;
+
+		// Out of view, only the coarsest mip is needed
+		if (texture.m_LastNeededFrame != m_Frame)
+			texture.m_DesiredMip = GetCoarsestMip(texture);
+
+		if (texture.m_DesiredMip < texture.m_CommittedMip)
+			m_LoadCandidates.push_back(i);
+		else if (texture.m_ResidentMip < texture.m_DesiredMip && texture.m_CommittedMip == texture.m_ResidentMip)
+			m_EvictionCandidates.push_back(i);
+	}
+
+	// Blurriest first, the largest on screen among equals
+	std::sort(m_LoadCandidates.begin(), m_LoadCandidates.end(), [this](uint32_t a, uint32_t b) {
+		const Texture& textureA{ m_Textures[a] };
+		const Texture& textureB{ m_Textures[b] };
+		const uint32_t missingA{ textureA.m_CommittedMip - textureA.m_DesiredMip };
+		const uint32_t missingB{ textureB.m_CommittedMip - textureB.m_DesiredMip };
+		return missingA != missingB ? missingA > missingB : textureA.m_ScreenPixels > textureB.m_ScreenPixels;
+	});
+
+	// Least recently needed first
+	std::sort(m_EvictionCandidates.begin(), m_EvictionCandidates.end(),
+		[this](uint32_t a, uint32_t b) { return m_Textures[a].m_LastNeededFrame < m_Textures[b].m_LastNeededFrame; });
+
+	size_t nextEviction{};
+	uint64_t uploadedBytes{};
+	for (const uint32_t index : m_LoadCandidates)
+	{
+		const Texture& texture{ m_Textures[index] };
+		const uint64_t committedSize{ GetMipChainSize(texture.m_Desc, texture.m_CommittedMip) };
+
+		// Degrades to coarser mips until the load fits, the finer ones are retried on later frames
+		for (uint32_t firstMip{ texture.m_DesiredMip }; firstMip < texture.m_CommittedMip; ++firstMip)
+		{
+			const uint64_t extraSize{ GetMipChainSize(texture.m_Desc, firstMip) - committedSize };
+			if (m_UploadBudget > 0 && uploadedBytes + extraSize > m_UploadBudget)
+				continue;
+
+			while (m_CommittedBytes + extraSize > m_Budget && nextEviction < m_EvictionCandidates.size())
+			{
+				const uint32_t evicted{ m_EvictionCandidates[nextEviction++] };
+				Evict(evicted, m_Textures[evicted].m_DesiredMip);
+			}
+
+			if (m_CommittedBytes + extraSize <= m_Budget)
+			{
+				Load(index, firstMip);
+				uploadedBytes += extraSize;
+				break;
+			}
+		}
+	}
+
+	if (m_CommittedBytes <= m_Budget)
+		return m_Commands;
+
+	// Over budget, it was lowered or the needs outgrew it: the unneeded mips go first, then the least recently needed
+	// textures lose their finest mips
+	for (; nextEviction < m_EvictionCandidates.size() && m_CommittedBytes > m_Budget; ++nextEviction)
+	{
+		const uint32_t evicted{ m_EvictionCandidates[nextEviction] };
+		Evict(evicted, m_Textures[evicted].m_DesiredMip);
+	}
+
+	m_EvictionCandidates.clear();
+	for (uint32_t i{}; i < m_Textures.size(); ++i)
+	{
+		const Texture& texture{ m_Textures[i] };
+		if (texture.m_IsAlive && texture.m_CommittedMip == texture.m_ResidentMip && texture.m_ResidentMip < GetCoarsestMip(texture))
+			m_EvictionCandidates.push_back(i);
+	}
+	std::sort(m_EvictionCandidates.begin(), m_EvictionCandidates.end(),
+		[this](uint32_t a, uint32_t b) { return m_Textures[a].m_LastNeededFrame < m_Textures[b].m_LastNeededFrame; });
+
+	for (const uint32_t index : m_EvictionCandidates)
+	{
+		if (m_CommittedBytes <= m_Budget)
+			break;
+
+		const Texture& texture{ m_Textures[index] };
+		const uint64_t excessBytes{ m_CommittedBytes - m_Budget };
+		const uint64_t residentSize{ GetMipChainSize(texture.m_Desc, texture.m_ResidentMip) };
+
+		uint32_t firstMip{ texture.m_ResidentMip + 1 };
+		while (firstMip < GetCoarsestMip(texture) && residentSize - GetMipChainSize(texture.m_Desc, firstMip) < excessBytes)
+			++firstMip;
+
+		Evict(index, firstMip);
+	}
+
+	return m_Commands;
+}
+
+void TextureResidencyManager::OnMipsLoaded(uint32_t texture)
+{
+	assert(texture < m_Textures.size() && IsLoadPending(texture));
+
+	Texture& entry{ m_Textures[texture] };
+	m_ResidentBytes += GetMipChainSize(entry.m_Desc, entry.m_CommittedMip) - GetMipChainSize(entry.m_Desc, entry.m_ResidentMip);
+	entry.m_ResidentMip = entry.m_CommittedMip;
+}
+
+void TextureResidencyManager::SetBudget(uint64_t budget)
+{
+	m_Budget = budget;
+}
+
+uint64_t TextureResidencyManager::GetBudget() const
+{
+	return m_Budget;
+}
+
+uint64_t TextureResidencyManager::GetCommittedBytes() const
+{
+	return m_CommittedBytes;
+}
+
+uint64_t TextureResidencyManager::GetResidentBytes() const
+{
+	return m_ResidentBytes;
+}
+
+uint32_t TextureResidencyManager::GetResidentMip(uint32_t texture) const
+{
+	return m_Textures[texture].m_ResidentMip;
+}
+
+uint32_t TextureResidencyManager::GetDesiredMip(uint32_t texture) const
+{
+	return m_Textures[texture].m_DesiredMip;
+}
+
+bool TextureResidencyManager::IsLoadPending(uint32_t texture) const
+{
+	return m_Textures[texture].m_CommittedMip != m_Textures[texture].m_ResidentMip;
+}
+
+uint64_t TextureResidencyManager::GetMipChainSize(const TextureResidencyDesc& desc, uint32_t firstMip)
+{
+	uint64_t size{};
+	for (uint32_t mip{ firstMip }; mip < desc.m_MipCount; ++mip)
+	{
+		uint64_t width{ std::max(desc.m_Width >> mip, 1u) };
+		uint64_t height{ std::max(desc.m_Height >> mip, 1u) };
+		if (desc.m_IsBlockCompressed)
+		{
+			width = (width + 3) & ~3ull;
+			height = (height + 3) & ~3ull;
+		}
+
+		size += width * height * desc.m_BitsPerPixel / 8;
+	}
+
+	return size;
+}
+
+uint32_t TextureResidencyManager::ComputeDesiredMip(const TextureResidencyDesc& desc, float screenPixels)
+{
+	const uint32_t coarsestMip{ desc.m_MipCount - 1 };
+	if (screenPixels <= 0.f)
+		return coarsestMip;
+
+	// Every mip halves the resolution, the finest one still having at least a texel per pixel
+	const float texelsPerPixel{ static_cast<float>(std::max(desc.m_Width, desc.m_Height)) / screenPixels };
+	if (texelsPerPixel <= 1.f)
+		return 0;
+
+	return std::min(static_cast<uint32_t>(std::log2(texelsPerPixel)), coarsestMip);
+}
+
+void TextureResidencyManager::Evict(uint32_t textureIndex, uint32_t firstMip)
+{
+	Texture& texture{ m_Textures[textureIndex] };
+	assert(texture.m_CommittedMip == texture.m_ResidentMip && firstMip > texture.m_ResidentMip && firstMip <= GetCoarsestMip(texture));
+
+	const uint64_t releasedSize{ GetMipChainSize(texture.m_Desc, texture.m_ResidentMip) - GetMipChainSize(texture.m_Desc, firstMip) };
+	m_CommittedBytes -= releasedSize;
+	m_ResidentBytes -= releasedSize;
+	texture.m_ResidentMip = texture.m_CommittedMip = firstMip;
+
+	m_Commands.push_back({ ResidencyCommand::Type::Evict, textureIndex, firstMip });
+}
+
+void TextureResidencyManager::Load(uint32_t textureIndex, uint32_t firstMip)
+{
+	Texture& texture{ m_Textures[textureIndex] };
+	assert(firstMip < texture.m_CommittedMip);
+
+	m_CommittedBytes += GetMipChainSize(texture.m_Desc, firstMip) - GetMipChainSize(texture.m_Desc, texture.m_CommittedMip);
+	texture.m_CommittedMip = firstMip;
+
+	m_Commands.push_back({ ResidencyCommand::Type::Load, textureIndex, firstMip });
+}
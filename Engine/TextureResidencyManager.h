@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+struct TextureResidencyDesc
+{
+	uint32_t m_Width{};
+	uint32_t m_Height{};
+	uint32_t m_MipCount{ 1 };
+	uint32_t m_BitsPerPixel{ 32 };
+	bool m_IsBlockCompressed{}; // Mips are padded to 4x4 blocks
+};
+
+/**
+ * \brief Change of the resident mips of a texture, carried out by the backend.
+ * Loads upload the mips from m_FirstMip up to the previous first mip, then report back with OnMipsLoaded.
+ * Evictions release every mip finer than m_FirstMip and take effect immediately.
+ */
+struct ResidencyCommand
+{
+	enum class Type
+	{
+		Load,
+		Evict
+	};
+
+	Type m_Type{};
+	uint32_t m_Texture{};
+	uint32_t m_FirstMip{}; // Finest mip resident once the command completes
+};
+
+/**
+ * \brief Decides which mips of every texture stay in memory. Each frame the scene reports how large every visible
+ * texture is on screen, which gives the mip it needs. Update then loads the missing mips of the most needed textures
+ * while committed memory, resident and in flight, stays within the budget. Room is made by evicting the mips nothing
+ * needs anymore, least recently needed first, and loads that still do not fit are degraded to coarser mips.
+ * The coarsest mip of a texture is never evicted so there is always something to sample.
+ * Backend neutral, only emits commands, so it runs on the CPU alone with simulated uploads.
+ */
+class TextureResidencyManager final
+{
+public:
+	/**
+	 * \param budget Bytes of texture memory
+	 * \param uploadBudget Bytes of mips loaded per Update, spreads large loads over several frames, 0 is unlimited
+	 */
+	explicit TextureResidencyManager(uint64_t budget, uint64_t uploadBudget = 0) noexcept;
+	~TextureResidencyManager() = default;
+
+	TextureResidencyManager(const TextureResidencyManager& other) noexcept = delete;
+	TextureResidencyManager& operator=(const TextureResidencyManager& other) noexcept = delete;
+	TextureResidencyManager(TextureResidencyManager&& other) noexcept = delete;
+	TextureResidencyManager& operator=(TextureResidencyManager&& other) noexcept = delete;
+
+	/**
+	 * \brief Only the coarsest mip is considered resident, the backend creates the texture with it
+	 * \return Identifier, reused once unregistered
+	 */
+	[[nodiscard]] uint32_t Register(const TextureResidencyDesc& desc);
+	/**
+	 * \brief Only once no load is in flight for the texture, see IsLoadPending
+	 */
+	void Unregister(uint32_t texture);
+
+	void BeginFrame();
+	/**
+	 * \brief Called for every use of a texture in view during the frame, the largest coverage wins
+	 * \param screenPixels On screen extent of the whole texture along its larger side, in pixels
+	 */
+	void ReportUsage(uint32_t texture, float screenPixels);
+	/**
+	 * \brief Decides the loads and evictions of the frame
+	 * \return Valid until the next Update
+	 */
+	std::span<const ResidencyCommand> Update();
+	/**
+	 * \brief The upload of a Load command completed, its mips can be sampled
+	 */
+	void OnMipsLoaded(uint32_t texture);
+
+	void SetBudget(uint64_t budget);
+	[[nodiscard]] uint64_t GetBudget() const;
+	[[nodiscard]] uint64_t GetCommittedBytes() const; // Resident mips and loads in flight
+	[[nodiscard]] uint64_t GetResidentBytes() const;
+
+	[[nodiscard]] uint32_t GetResidentMip(uint32_t texture) const;
+	[[nodiscard]] uint32_t GetDesiredMip(uint32_t texture) const;
+	[[nodiscard]] bool IsLoadPending(uint32_t texture) const;
+
+	/**
+	 * \return Bytes of the mips from firstMip to the coarsest
+	 */
+	[[nodiscard]] static uint64_t GetMipChainSize(const TextureResidencyDesc& desc, uint32_t firstMip);
+	/**
+	 * \return Mip whose resolution matches the screen coverage, a texel per pixel
+	 */
+	[[nodiscard]] static uint32_t ComputeDesiredMip(const TextureResidencyDesc& desc, float screenPixels);
+
+	inline static constexpr uint32_t s_InvalidTexture{ 0xFFFFFFFFu };
+
+private:
+	/* NESTED CLASSES */
+
+	struct Texture
+	{
+		TextureResidencyDesc m_Desc{};
+		uint32_t m_ResidentMip{}; // Finest resident mip
+		uint32_t m_CommittedMip{}; // Finest mip once the load in flight lands, m_ResidentMip without one
+		uint32_t m_DesiredMip{};
+		float m_ScreenPixels{}; // Largest coverage reported this frame
+		uint64_t m_LastNeededFrame{};
+		bool m_IsAlive{};
+	};
+
+	/* DATA MEMBERS */
+
+	std::vector<Texture> m_Textures{};
+	std::vector<uint32_t> m_FreeTextures{};
+	std::vector<ResidencyCommand> m_Commands{};
+	std::vector<uint32_t> m_LoadCandidates{}; // Scratch of Update
+	std::vector<uint32_t> m_EvictionCandidates{};
+
+	uint64_t m_Budget;
+	uint64_t m_UploadBudget;
+	uint64_t m_CommittedBytes{};
+	uint64_t m_ResidentBytes{};
+	uint64_t m_Frame{};
+
+	/* PRIVATE METHODS */
+
+	[[nodiscard]] static uint32_t GetCoarsestMip(const Texture& texture) { return texture.m_Desc.m_MipCount - 1; }
+	void Evict(uint32_t textureIndex, uint32_t firstMip);
+	void Load(uint32_t textureIndex, uint32_t firstMip);
+
+};
@@ -4,26 +4,41 @@ using namespace std::chrono;
 
 void TimeManager::Init()
 {
-	m_StartTime = high_resolution_clock::now();
-	m_FrameBeginTime = high_resolution_clock::now();
+	m_StartTime = steady_clock::now();
+	m_FrameBeginTime = m_StartTime;
+	m_DeltaTime = {};
+	m_TotalTime = {};
+	m_FixedStepLag = {};
+	m_FixedStepCount = 0;
 }
 
 void TimeManager::Update()
 {
 	m_LastFrameBeginTime = m_FrameBeginTime;
-	m_FrameBeginTime = high_resolution_clock::now();
-	m_DeltaTime = duration<float>(m_FrameBeginTime - m_LastFrameBeginTime).count();
-	m_TotalTime = duration<float>(m_FrameBeginTime - m_StartTime).count();
+	m_FrameBeginTime = steady_clock::now();
+	m_DeltaTime = duration_cast<Ticks>(m_FrameBeginTime - m_LastFrameBeginTime);
+	m_TotalTime = duration_cast<Ticks>(m_FrameBeginTime - m_StartTime);
+	m_FixedStepLag += m_DeltaTime;
+}
+
+bool TimeManager::ConsumeFixedStep()
+{
+	if (m_FixedStepLag < m_FixedTimeStep)
+		return false;
+
+	m_FixedStepLag -= m_FixedTimeStep;
+	++m_FixedStepCount;
+	return true;
 }
 
 float TimeManager::GetElapsedTime() const
 {
-	return m_DeltaTime;
+	return duration<float>(m_DeltaTime).count();
 }
 
-float TimeManager::GetTotalTime() const
+double TimeManager::GetTotalTime() const
 {
-	return m_TotalTime;
+	return duration<double>(m_TotalTime).count();
 }
 
 //std::chrono::duration<float> TimeManager::GetTimeToNextFrame()
@@ -33,6 +48,31 @@ float TimeManager::GetTotalTime() const
 //}
 
 float TimeManager::GetFixedTimeStep() const
+{
+	return duration<float>(m_FixedTimeStep).count();
+}
+
+float TimeManager::GetFixedStepAlpha() const
+{
+	return static_cast<float>(static_cast<double>(m_FixedStepLag.count()) / static_cast<double>(m_FixedTimeStep.count()));
+}
+
+TimeManager::Ticks TimeManager::GetElapsedTicks() const
+{
+	return m_DeltaTime;
+}
+
+TimeManager::Ticks TimeManager::GetTotalTicks() const
+{
+	return m_TotalTime;
+}
+
+TimeManager::Ticks TimeManager::GetFixedTimeStepTicks() const
 {
 	return m_FixedTimeStep;
 }
+
+uint64_t TimeManager::GetFixedStepCount() const
+{
+	return m_FixedStepCount;
+}
@@ -1,28 +1,50 @@
 #pragma once
 #include <chrono>
+#include <cstdint>
 
 #include "Singleton.h"
 
 class TimeManager final : public Singleton<TimeManager>
 {
 public:
+	// Time is kept as integer nanosecond ticks so it never loses precision, float/double views are derived on demand
+	using Ticks = std::chrono::nanoseconds;
+
 	void Init();
 	void Update();
 
+	/**
+	 * \brief Consumes one fixed step from the tick accumulator
+	 * \return True while a full fixed step is available, call in a loop to run all pending fixed updates
+	 */
+	[[nodiscard]] bool ConsumeFixedStep();
+
 	[[nodiscard]] float GetElapsedTime() const;
-	[[nodiscard]] float GetTotalTime() const;
+	[[nodiscard]] double GetTotalTime() const;
 	//[[nodiscard]] std::chrono::duration<float> GetTimeToNextFrame();
 	[[nodiscard]] float GetFixedTimeStep() const;
+	/**
+	 * \brief 
+	 * \return Fraction of a fixed step left in the accumulator, in [0, 1[, to interpolate between fixed states
+	 */
+	[[nodiscard]] float GetFixedStepAlpha() const;
+
+	[[nodiscard]] Ticks GetElapsedTicks() const;
+	[[nodiscard]] Ticks GetTotalTicks() const;
+	[[nodiscard]] Ticks GetFixedTimeStepTicks() const;
+	[[nodiscard]] uint64_t GetFixedStepCount() const;
 
 private:
 	friend class Singleton<TimeManager>;
 	TimeManager() noexcept = default;
 
-	const float m_FixedTimeStep{ 0.002f };
+	const Ticks m_FixedTimeStep{ std::chrono::microseconds{ 2000 } };
 	float m_TimePerFrame{ 1.f / 144.f };
 
-	float m_DeltaTime{};
-	float m_TotalTime{};
+	Ticks m_DeltaTime{};
+	Ticks m_TotalTime{};
+	Ticks m_FixedStepLag{};
+	uint64_t m_FixedStepCount{};
 
 	std::chrono::steady_clock::time_point m_StartTime{};
 	std::chrono::steady_clock::time_point m_FrameBeginTime{};
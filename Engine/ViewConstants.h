@@ -0,0 +1,19 @@
+#pragma once
+
+/**
+ * \brief Camera data of one view, uploaded once per view and bound at Renderer::s_ViewConstantsSlot for every
+ * material. Layout must match ViewConstants.hlsli, the matrices are stored transposed for HLSL.
+ */
+struct ViewConstants
+{
+	inline static constexpr XMFLOAT4X4 s_Identity{ 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f };
+
+	// Identity by default, so draws without a camera stay in clip space
+	XMFLOAT4X4 m_View{ s_Identity };
+	XMFLOAT4X4 m_Projection{ s_Identity };
+	XMFLOAT4X4 m_ViewProjection{ s_Identity };
+	XMFLOAT4X4 m_ViewInverse{ s_Identity };
+	XMFLOAT4X4 m_ProjectionInverse{ s_Identity };
+	XMFLOAT4X4 m_ViewProjectionInverse{ s_Identity };
+	XMFLOAT4 m_ViewPosition{}; // w unused
+};
@@ -0,0 +1,12 @@
+// Must match ViewConstants in ViewConstants.h and Renderer::s_ViewConstantsSlot
+
+cbuffer ViewConstants : register(b2)
+{
+	float4x4 g_View;
+	float4x4 g_Projection;
+	float4x4 g_ViewProjection;
+	float4x4 g_ViewInverse;
+	float4x4 g_ProjectionInverse;
+	float4x4 g_ViewProjectionInverse;
+	float4 g_ViewPosition;
+};
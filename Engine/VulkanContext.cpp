@@ -0,0 +1,158 @@
+#include "VulkanContext.h"
+
+#include <cassert>
+
+#include "ShaderCache.h"
+#include "VulkanException.h"
+
+VulkanContext::VulkanContext(VkDevice device, VkRenderPass renderPass, VkPipelineLayout pipelineLayout)
+	: m_Device{ device }
+	, m_RenderPass{ renderPass }
+	, m_PipelineLayout{ pipelineLayout }
+{
+	VkPipelineCacheCreateInfo cacheInfo{};
+	cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	PGVK_THROW_IF_FAILED(vkCreatePipelineCache(m_Device, &cacheInfo, nullptr, &m_PipelineCache));
+}
+
+VulkanContext::~VulkanContext()
+{
+	// The device is idle by the time the backend destroys the context
+	for (auto& pipelines : m_DeferredPipelines)
+	{
+		for (const VkPipeline pipeline : pipelines)
+			vkDestroyPipeline(m_Device, pipeline, nullptr);
+		pipelines.clear();
+	}
+
+	vkDestroyPipelineCache(m_Device, m_PipelineCache, nullptr);
+}
+
+VkPipeline VulkanContext::CreateGraphicsPipeline(const std::filesystem::path& vertexShaderPath, const std::filesystem::path& pixelShaderPath, uint32_t vertexStride) const
+{
+	const VkShaderModule vertexShader{ LoadShaderModule(vertexShaderPath) };
+	const VkShaderModule pixelShader{ LoadShaderModule(pixelShaderPath) };
+
+	VkPipelineShaderStageCreateInfo stages[2]{};
+	stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+	stages[0].module = vertexShader;
+	stages[0].pName = "main";
+	stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+	stages[1].module = pixelShader;
+	stages[1].pName = "main";
+
+	VkVertexInputBindingDescription vertexBinding{};
+	vertexBinding.binding = 0;
+	vertexBinding.stride = vertexStride;
+	vertexBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+	VkVertexInputAttributeDescription positionAttribute{};
+	positionAttribute.location = 0;
+	positionAttribute.binding = 0;
+	positionAttribute.format = VK_FORMAT_R32G32_SFLOAT;
+	positionAttribute.offset = 0;
+
+	VkPipelineVertexInputStateCreateInfo vertexInput{};
+	vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+	vertexInput.vertexBindingDescriptionCount = 1;
+	vertexInput.pVertexBindingDescriptions = &vertexBinding;
+	vertexInput.vertexAttributeDescriptionCount = 1;
+	vertexInput.pVertexAttributeDescriptions = &positionAttribute;
+
+	VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+	inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+	inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+	// Viewport and scissor are set by the backend every frame
+	VkPipelineViewportStateCreateInfo viewport{};
+	viewport.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+	viewport.viewportCount = 1;
+	viewport.scissorCount = 1;
+
+	constexpr VkDynamicState dynamicStates[]{ VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+	VkPipelineDynamicStateCreateInfo dynamicState{};
+	dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	dynamicState.dynamicStateCount = static_cast<uint32_t>(std::size(dynamicStates));
+	dynamicState.pDynamicStates = dynamicStates;
+
+	// Shaders are compiled with -fvk-invert-y, clockwise triangles are front facing like the D3D11 defaults
+	VkPipelineRasterizationStateCreateInfo rasterization{};
+	rasterization.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+	rasterization.polygonMode = VK_POLYGON_MODE_FILL;
+	rasterization.cullMode = VK_CULL_MODE_BACK_BIT;
+	rasterization.frontFace = VK_FRONT_FACE_CLOCKWISE;
+	rasterization.lineWidth = 1.f;
+
+	VkPipelineMultisampleStateCreateInfo multisample{};
+	multisample.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+	multisample.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+	VkPipelineColorBlendAttachmentState blendAttachment{};
+	blendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+	VkPipelineColorBlendStateCreateInfo blend{};
+	blend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+	blend.attachmentCount = 1;
+	blend.pAttachments = &blendAttachment;
+
+	VkGraphicsPipelineCreateInfo pipelineInfo{};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	pipelineInfo.stageCount = static_cast<uint32_t>(std::size(stages));
+	pipelineInfo.pStages = stages;
+	pipelineInfo.pVertexInputState = &vertexInput;
+	pipelineInfo.pInputAssemblyState = &inputAssembly;
+	pipelineInfo.pViewportState = &viewport;
+	pipelineInfo.pRasterizationState = &rasterization;
+	pipelineInfo.pMultisampleState = &multisample;
+	pipelineInfo.pColorBlendState = &blend;
+	pipelineInfo.pDynamicState = &dynamicState;
+	pipelineInfo.layout = m_PipelineLayout;
+	pipelineInfo.renderPass = m_RenderPass;
+	pipelineInfo.subpass = 0;
+
+	VkPipeline pipeline{};
+	const VkResult result{ vkCreateGraphicsPipelines(m_Device, m_PipelineCache, 1, &pipelineInfo, nullptr, &pipeline) };
+
+	vkDestroyShaderModule(m_Device, vertexShader, nullptr);
+	vkDestroyShaderModule(m_Device, pixelShader, nullptr);
+	PGVK_THROW_IF_FAILED(result);
+	Renderer::Get().CountResourceCreation();
+
+	return pipeline;
+}
+
+void VulkanContext::DestroyPipeline(VkPipeline pipeline)
+{
+	if (pipeline)
+		m_DeferredPipelines[m_FrameIndex].emplace_back(pipeline);
+}
+
+void VulkanContext::BeginFrame(uint32_t frameIndex)
+{
+	assert(frameIndex < Renderer::s_FrameCount);
+	m_FrameIndex = frameIndex;
+
+	for (const VkPipeline pipeline : m_DeferredPipelines[frameIndex])
+		vkDestroyPipeline(m_Device, pipeline, nullptr);
+	m_DeferredPipelines[frameIndex].clear();
+}
+
+VkShaderModule VulkanContext::LoadShaderModule(const std::filesystem::path& path) const
+{
+	// Shared with every pipeline using the same file, read only once
+	const ShaderBytecode* pBytecode{ ShaderCache::Get().Load(path) };
+	if (!pBytecode)
+		throw PGVK_EXCEPTION(VK_ERROR_INITIALIZATION_FAILED);
+
+	// SPIR-V is a stream of 32-bit words, the bytecode storage is allocated with at least that alignment
+	VkShaderModuleCreateInfo moduleInfo{};
+	moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+	moduleInfo.codeSize = pBytecode->GetSize();
+	moduleInfo.pCode = static_cast<const uint32_t*>(pBytecode->GetData());
+
+	VkShaderModule shaderModule{};
+	PGVK_THROW_IF_FAILED(vkCreateShaderModule(m_Device, &moduleInfo, nullptr, &shaderModule));
+	return shaderModule;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <filesystem>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "Renderer.h"
+
+/**
+ * \brief Vulkan objects the materials build and bind their pipelines with.
+ * Returned by Renderer::GetDevice when the Vulkan backend is active, Renderer::GetDeviceContext then returns the
+ * VkCommandBuffer of the frame being recorded.
+ */
+class VulkanContext final
+{
+public:
+	VulkanContext(VkDevice device, VkRenderPass renderPass, VkPipelineLayout pipelineLayout);
+	~VulkanContext();
+
+	VulkanContext(const VulkanContext& other) noexcept = delete;
+	VulkanContext& operator=(const VulkanContext& other) noexcept = delete;
+	VulkanContext(VulkanContext&& other) noexcept = delete;
+	VulkanContext& operator=(VulkanContext&& other) noexcept = delete;
+
+	/**
+	 * \brief Builds a triangle list pipeline reading a float2 POSITION at offset 0 of each vertex
+	 * \param vertexShaderPath SPIR-V compiled from the HLSL vertex shader
+	 * \param pixelShaderPath SPIR-V compiled from the HLSL pixel shader
+	 * \param vertexStride Size of a whole vertex, must match MeshDesc::m_VertexStride of the meshes drawn with it
+	 */
+	[[nodiscard]] VkPipeline CreateGraphicsPipeline(const std::filesystem::path& vertexShaderPath, const std::filesystem::path& pixelShaderPath, uint32_t vertexStride) const;
+	/**
+	 * \brief Destroys the pipeline once the frames in flight are done with it
+	 */
+	void DestroyPipeline(VkPipeline pipeline);
+
+	/**
+	 * \brief Must be called once the GPU finished the frame that previously used frameIndex
+	 */
+	void BeginFrame(uint32_t frameIndex);
+
+	[[nodiscard]] VkDevice GetDevice() const { return m_Device; }
+	[[nodiscard]] VkPipelineLayout GetPipelineLayout() const { return m_PipelineLayout; }
+
+private:
+	/* DATA MEMBERS */
+
+	VkDevice m_Device{};
+	VkRenderPass m_RenderPass{};
+	VkPipelineLayout m_PipelineLayout{};
+	VkPipelineCache m_PipelineCache{};
+
+	std::array<std::vector<VkPipeline>, Renderer::s_FrameCount> m_DeferredPipelines{};
+	uint32_t m_FrameIndex{};
+
+	/* PRIVATE METHODS */
+
+	[[nodiscard]] VkShaderModule LoadShaderModule(const std::filesystem::path& path) const;
+
+};
@@ -0,0 +1,53 @@
+#include "VulkanException.h"
+#include <sstream>
+
+using std::wstring, std::endl;
+typedef std::wstringstream wsstream;
+
+VulkanException::VulkanException(int line, const wchar_t* file, VkResult result) noexcept
+	: PicoGineException(line, file)
+	, m_Result{ result }
+{
+}
+
+const wchar_t* VulkanException::wwhat() const noexcept
+{
+	wsstream wss;
+	wss << GetType() << endl
+		<< "[Error Code] " << GetErrorCode() << endl
+		<< "[Description] " << TranslateErrorCode(m_Result) << endl
+		<< GetOriginString();
+	m_WhatBuffer = wss.str();
+	return m_WhatBuffer.c_str();
+}
+
+const wchar_t* VulkanException::GetType() const noexcept
+{
+	return L"PicoGine Vulkan Exception";
+}
+
+std::wstring VulkanException::TranslateErrorCode(VkResult result) noexcept
+{
+	switch (result)
+	{
+	case VK_ERROR_OUT_OF_HOST_MEMORY: return L"Out of host memory";
+	case VK_ERROR_OUT_OF_DEVICE_MEMORY: return L"Out of device memory";
+	case VK_ERROR_INITIALIZATION_FAILED: return L"Initialization failed";
+	case VK_ERROR_DEVICE_LOST: return L"Device lost";
+	case VK_ERROR_MEMORY_MAP_FAILED: return L"Memory map failed";
+	case VK_ERROR_LAYER_NOT_PRESENT: return L"Layer not present";
+	case VK_ERROR_EXTENSION_NOT_PRESENT: return L"Extension not present";
+	case VK_ERROR_FEATURE_NOT_PRESENT: return L"Feature not present";
+	case VK_ERROR_INCOMPATIBLE_DRIVER: return L"Incompatible driver";
+	case VK_ERROR_TOO_MANY_OBJECTS: return L"Too many objects";
+	case VK_ERROR_FORMAT_NOT_SUPPORTED: return L"Format not supported";
+	case VK_ERROR_SURFACE_LOST_KHR: return L"Surface lost";
+	case VK_ERROR_OUT_OF_DATE_KHR: return L"Swap chain out of date";
+	default: return L"Unidentified error code";
+	}
+}
+
+VkResult VulkanException::GetErrorCode() const noexcept
+{
+	return m_Result;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <vulkan/vulkan.h>
+
+#include "PicoGineException.h"
+
+#define PGVK_EXCEPTION(result) VulkanException(__LINE__, __WFILE__, result)
+#define PGVK_THROW_IF_FAILED(result) if (const VkResult vkResult{ result }; vkResult < VK_SUCCESS) throw VulkanException(__LINE__, __WFILE__, vkResult)
+
+class VulkanException : public PicoGineException
+{
+public:
+	VulkanException(int line, const wchar_t* file, VkResult result) noexcept;
+	~VulkanException() override = default;
+
+	VulkanException(const VulkanException& other) = delete;
+	VulkanException& operator=(const VulkanException& other) noexcept = delete;
+	VulkanException(VulkanException&& other) = delete;
+	VulkanException& operator=(VulkanException&& other) noexcept = delete;
+
+	[[nodiscard]] const wchar_t* wwhat() const noexcept override;
+	[[nodiscard]] const wchar_t* GetType() const noexcept override;
+	static std::wstring TranslateErrorCode(VkResult result) noexcept;
+	VkResult GetErrorCode() const noexcept;
+
+protected:
+private:
+	/* DATA MEMBERS */
+	VkResult m_Result;
+
+	/* PRIVATE METHODS */
+	
+};
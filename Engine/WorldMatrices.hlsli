@@ -0,0 +1,16 @@
+// Must match Renderer::RendererImpl::s_WorldMatricesSlot, filled once per frame with every recorded object
+
+struct WorldMatrix
+{
+	float4 Rows[3]; // Transposed world matrix without its constant last row
+};
+
+StructuredBuffer<WorldMatrix> g_WorldMatrices : register(t0);
+
+float3 TransformToWorld(uint objectId, float3 position)
+{
+	const WorldMatrix world = g_WorldMatrices[objectId];
+	const float4 point4 = float4(position, 1.f);
+
+	return float3(dot(world.Rows[0], point4), dot(world.Rows[1], point4), dot(world.Rows[2], point4));
+}
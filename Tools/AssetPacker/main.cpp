@@ -0,0 +1,317 @@
+#include "AssetPack.h"
+#include "AssetPackReader.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Builds and inspects the asset packs the engine maps at load time, and measures how mapping a pack compares to
+// reading its assets with streams, or how fast compressed packs decompress.
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	void PrintUsage()
+	{
+		std::printf(
+			"Usage: AssetPacker build <pack> [--alignment <bytes>] [--lz4] [--block-size <bytes>] <files...>\n"
+			"       AssetPacker list <pack>\n"
+			"       AssetPacker bench <pack> [iterations]\n"
+			"Assets are named after their path as given, normalized with forward slashes, so run the build from the\n"
+			"folder the game loads its assets relative to.\n");
+	}
+
+	[[nodiscard]] double ToMilliseconds(Clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	[[nodiscard]] AssetType GuessType(const std::filesystem::path& path)
+	{
+		const std::filesystem::path extension{ path.extension() };
+		if (extension == ".cso" || extension == ".spv")
+			return AssetType::Shader;
+
+		return AssetType::Raw;
+	}
+
+	[[nodiscard]] const char* GetTypeName(AssetType type)
+	{
+		switch (type)
+		{
+		case AssetType::Shader:
+			return "shader";
+		case AssetType::Raw:
+		default:
+			return "raw";
+		}
+	}
+
+	int Build(int argc, char* argv[])
+	{
+		if (argc < 4)
+		{
+			PrintUsage();
+			return 1;
+		}
+
+		const std::filesystem::path outputPath{ argv[2] };
+		uint32_t alignment{ AssetPackBuilder::s_DefaultAlignment };
+		AssetCompression compression{ AssetCompression::None };
+		uint32_t blockSize{ AssetPackBuilder::s_DefaultBlockSize };
+
+		AssetPackBuilder builder{};
+		for (int i{ 3 }; i < argc; ++i)
+		{
+			if (std::strcmp(argv[i], "--alignment") == 0 && i + 1 < argc)
+			{
+				alignment = static_cast<uint32_t>(std::stoul(argv[++i]));
+				continue;
+			}
+			if (std::strcmp(argv[i], "--lz4") == 0)
+			{
+				compression = AssetCompression::LZ4;
+				continue;
+			}
+			if (std::strcmp(argv[i], "--block-size") == 0 && i + 1 < argc)
+			{
+				blockSize = static_cast<uint32_t>(std::stoul(argv[++i]));
+				continue;
+			}
+
+			const std::filesystem::path path{ argv[i] };
+			const std::string name{ path.lexically_normal().generic_string() };
+			if (!builder.AddFile(name, GuessType(path), path))
+			{
+				std::fprintf(stderr, "Could not add %s, unreadable or already added\n", argv[i]);
+				return 1;
+			}
+		}
+
+		if (!builder.Write(outputPath, alignment, compression, blockSize))
+		{
+			std::fprintf(stderr, "Could not write %s\n", outputPath.string().c_str());
+			return 1;
+		}
+
+		std::printf("%u assets written to %s\n", builder.GetAssetCount(), outputPath.string().c_str());
+		return 0;
+	}
+
+	int List(const std::filesystem::path& path)
+	{
+		AssetPack pack{};
+		if (!pack.Open(path))
+		{
+			std::fprintf(stderr, "Could not open %s\n", path.string().c_str());
+			return 1;
+		}
+
+		for (const AssetPackEntry& entry : pack.GetEntries())
+		{
+			const std::string_view name{ pack.GetName(entry) };
+			std::printf("%-8s %10llu  %016llx  %.*s\n", GetTypeName(entry.m_Type), static_cast<unsigned long long>(entry.m_Size),
+				static_cast<unsigned long long>(entry.m_ContentHash), static_cast<int>(name.size()), name.data());
+		}
+		std::printf("%zu assets, %llu bytes\n", pack.GetEntries().size(), static_cast<unsigned long long>(pack.GetFileSize()));
+
+		if (pack.IsCompressed())
+		{
+			uint64_t uncompressedSize{};
+			uint64_t storedSize{};
+			for (uint32_t i{}; i < pack.GetBlocks().size(); ++i)
+			{
+				uncompressedSize += pack.GetBlockUncompressedSize(i);
+				storedSize += pack.GetBlocks()[i].m_StoredSize;
+			}
+			std::printf("%zu LZ4 blocks of %u bytes, %llu bytes stored for %llu (%.1f%%)\n", pack.GetBlocks().size(), pack.GetBlockSize(),
+				static_cast<unsigned long long>(storedSize), static_cast<unsigned long long>(uncompressedSize),
+				100. * static_cast<double>(storedSize) / static_cast<double>(uncompressedSize));
+		}
+
+		return 0;
+	}
+
+	void PrintReadStats(const char* pLabel, const AssetPackReadStats& stats, uint32_t iterations)
+	{
+		std::printf("%-28s %10.3f ms per load, %8.1f MB/s decompression, %.1f%% block hits, %llu bytes read\n", pLabel,
+			stats.m_DecompressionSeconds * 1000. / iterations, stats.GetDecompressionThroughput() / (1024. * 1024.), stats.GetHitRate() * 100.,
+			static_cast<unsigned long long>(stats.m_BytesRead / iterations));
+	}
+
+	/**
+	 * \brief Reads every asset of a compressed pack each iteration, without block cache then with a cache large enough
+	 * to keep the whole pack
+	 */
+	int BenchCompressed(const AssetPack& pack, uint32_t iterations)
+	{
+		uint64_t streamSize{};
+		for (uint32_t i{}; i < pack.GetBlocks().size(); ++i)
+			streamSize += pack.GetBlockUncompressedSize(i);
+
+		// Every read is checked against the content hash of the table of contents
+		std::vector<uint8_t> data{};
+		const auto readAll{ [&](AssetPackReader& reader) {
+			for (const AssetPackEntry& entry : pack.GetEntries())
+			{
+				if (!reader.Read(entry, data) || AssetPack::Hash(data.data(), data.size()) != entry.m_ContentHash)
+					return false;
+			}
+			return true;
+		} };
+
+		AssetPackReadStats coldStats{};
+		for (uint32_t i{}; i < iterations; ++i)
+		{
+			AssetPackReader reader{ pack, 0 };
+			if (!readAll(reader))
+			{
+				std::fprintf(stderr, "Corrupted pack\n");
+				return 1;
+			}
+
+			const AssetPackReadStats stats{ reader.GetStats() };
+			coldStats.m_BytesRead += stats.m_BytesRead;
+			coldStats.m_BytesDecompressed += stats.m_BytesDecompressed;
+			coldStats.m_DecompressionSeconds += stats.m_DecompressionSeconds;
+			coldStats.m_BlockHitCount += stats.m_BlockHitCount;
+			coldStats.m_BlockMissCount += stats.m_BlockMissCount;
+		}
+
+		AssetPackReader warmReader{ pack, streamSize };
+		readAll(warmReader);
+		warmReader.ResetStats();
+		for (uint32_t i{}; i < iterations; ++i)
+			readAll(warmReader);
+
+		std::printf("%zu assets in %zu blocks, %u iterations\n", pack.GetEntries().size(), pack.GetBlocks().size(), iterations);
+		PrintReadStats("No cache", coldStats, iterations);
+		PrintReadStats("Whole pack cached", warmReader.GetStats(), iterations);
+
+		return 0;
+	}
+
+	/**
+	 * \brief Loads every asset of the pack each iteration, with a fresh mapping against reading the file with streams
+	 * and copying every asset out of it, the way the engine loaded its files before. Assets are looked up by name in
+	 * both cases. The OS file cache is warm after the first iteration, so this measures the CPU side of loading.
+	 */
+	int Bench(const std::filesystem::path& path, uint32_t iterations)
+	{
+		std::vector<std::string> names{};
+		{
+			AssetPack pack{};
+			if (!pack.Open(path))
+			{
+				std::fprintf(stderr, "Could not open %s\n", path.string().c_str());
+				return 1;
+			}
+
+			if (pack.IsCompressed())
+				return BenchCompressed(pack, iterations);
+
+			for (const AssetPackEntry& entry : pack.GetEntries())
+				names.emplace_back(pack.GetName(entry));
+		}
+
+		uint64_t checksum{};
+		Clock::duration mappedTime{};
+		Clock::duration mappedTouchedTime{};
+		Clock::duration streamTime{};
+
+		for (uint32_t i{}; i < iterations; ++i)
+		{
+			// Zero-copy, only the table of contents is read
+			{
+				const Clock::time_point start{ Clock::now() };
+				AssetPack pack{};
+				pack.Open(path);
+				for (const std::string& name : names)
+				{
+					const AssetPackEntry* pEntry{ pack.Find(name) };
+					checksum += reinterpret_cast<uintptr_t>(pack.GetData(*pEntry)) + pEntry->m_Size;
+				}
+				mappedTime += Clock::now() - start;
+			}
+
+			// Same, but every byte is read once, as a consumer uploading the data would
+			{
+				const Clock::time_point start{ Clock::now() };
+				AssetPack pack{};
+				pack.Open(path);
+				for (const std::string& name : names)
+				{
+					const AssetPackEntry* pEntry{ pack.Find(name) };
+					checksum += AssetPack::Hash(pack.GetData(*pEntry), static_cast<size_t>(pEntry->m_Size));
+				}
+				mappedTouchedTime += Clock::now() - start;
+			}
+
+			// Stream read of the whole file, then one copy per asset
+			{
+				const Clock::time_point start{ Clock::now() };
+				std::ifstream file{ path, std::ios::binary | std::ios::ate };
+				std::vector<uint8_t> fileData(static_cast<size_t>(file.tellg()));
+				file.seekg(0);
+				file.read(reinterpret_cast<char*>(fileData.data()), static_cast<std::streamsize>(fileData.size()));
+
+				AssetPackHeader header{};
+				std::memcpy(&header, fileData.data(), sizeof(header));
+				std::vector<AssetPackEntry> entries(header.m_EntryCount);
+				std::memcpy(entries.data(), fileData.data() + header.m_TocOffset, entries.size() * sizeof(AssetPackEntry));
+
+				for (const std::string& name : names)
+				{
+					for (const AssetPackEntry& entry : entries)
+					{
+						const std::string_view entryName{ reinterpret_cast<const char*>(fileData.data() + header.m_NamesOffset + entry.m_NameOffset), entry.m_NameSize };
+						if (entryName != name)
+							continue;
+
+						const uint8_t* pData{ fileData.data() + entry.m_Offset };
+						const std::vector<uint8_t> asset(pData, pData + entry.m_Size);
+						checksum += AssetPack::Hash(asset.data(), asset.size());
+						break;
+					}
+				}
+				streamTime += Clock::now() - start;
+			}
+		}
+
+		const auto printResult{ [iterations](const char* pLabel, Clock::duration time) {
+			std::printf("%-28s %10.3f ms per load\n", pLabel, ToMilliseconds(time) / iterations);
+		} };
+
+		std::printf("%zu assets, %u iterations\n", names.size(), iterations);
+		printResult("Mapped, zero-copy", mappedTime);
+		printResult("Mapped, every byte read", mappedTouchedTime);
+		printResult("Stream read and copies", streamTime);
+		std::printf("Checksum %016llx\n", static_cast<unsigned long long>(checksum));
+
+		return 0;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	const std::string command{ argv[1] };
+	if (command == "build")
+		return Build(argc, argv);
+	if (command == "list")
+		return List(argv[2]);
+	if (command == "bench")
+		return Bench(argv[2], argc > 3 ? static_cast<uint32_t>(std::stoul(argv[3])) : 100u);
+
+	PrintUsage();
+	return 1;
+}
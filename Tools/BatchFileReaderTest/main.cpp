@@ -0,0 +1,133 @@
+#include "BatchFileReader.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Writes a few hundred files of varied sizes, reads them back in batches larger than the queue depth and checks
+// every byte. Runs through io_uring where the kernel allows it, exits with 77 so ctest reports a skip otherwise.
+
+namespace
+{
+	constexpr uint32_t g_FileCount{ 300 };
+	constexpr uint32_t g_QueueDepth{ 16 };
+	constexpr int g_SkipReturnCode{ 77 };
+
+	int g_FailureCount{};
+
+	void Check(bool condition, const char* pExpression, int line)
+	{
+		if (condition)
+			return;
+
+		std::fprintf(stderr, "Line %d: %s failed\n", line, pExpression);
+		++g_FailureCount;
+	}
+
+#define CHECK(condition) Check((condition), #condition, __LINE__)
+
+	const std::filesystem::path g_Folder{ "BatchFileReaderTestData" };
+
+	/**
+	 * \brief Content depends on the file and the position, so a read landing in the wrong buffer or offset is caught
+	 */
+	std::vector<uint8_t> MakeContent(uint32_t file)
+	{
+		// Empty files, files below and above a page, and a few of several megabytes
+		size_t size{ (file * 7919u) % 20000u };
+		if (file % 50 == 7)
+			size = (1u << 22) + file;
+		else if (file % 37 == 0)
+			size = 0;
+
+		std::vector<uint8_t> content(size);
+		for (size_t i{}; i < size; ++i)
+			content[i] = static_cast<uint8_t>((i * 31u + file * 17u) ^ (i >> 8));
+
+		return content;
+	}
+
+	std::filesystem::path GetPath(uint32_t file)
+	{
+		return g_Folder / ("File" + std::to_string(file) + ".bin");
+	}
+
+	void WriteFiles()
+	{
+		std::filesystem::create_directories(g_Folder);
+		for (uint32_t file{}; file < g_FileCount; ++file)
+		{
+			const std::vector<uint8_t> content{ MakeContent(file) };
+			std::ofstream stream{ GetPath(file), std::ios::binary | std::ios::trunc };
+			stream.write(reinterpret_cast<const char*>(content.data()), static_cast<std::streamsize>(content.size()));
+		}
+	}
+
+	void TestReadAll(BatchFileReader& reader)
+	{
+		std::vector<BatchFileReader::Read> reads{};
+		for (uint32_t file{}; file < g_FileCount; ++file)
+		{
+			reads.emplace_back(BatchFileReader::Read{ GetPath(file) });
+
+			// A missing file in the middle of the batch fails on its own
+			if (file == g_FileCount / 2)
+				reads.emplace_back(BatchFileReader::Read{ g_Folder / "Missing.bin" });
+		}
+
+		reader.ReadAll(reads);
+
+		uint32_t succeededCount{};
+		for (const BatchFileReader::Read& read : reads)
+		{
+			if (read.m_Path.filename() == "Missing.bin")
+			{
+				CHECK(!read.m_Succeeded);
+				continue;
+			}
+
+			CHECK(read.m_Succeeded);
+			succeededCount += read.m_Succeeded ? 1 : 0;
+
+			const uint32_t file{ static_cast<uint32_t>(std::stoul(read.m_Path.stem().string().substr(4))) };
+			CHECK(read.m_Data == MakeContent(file));
+		}
+		CHECK(succeededCount == g_FileCount);
+
+		// The reader is reused for the next batch, the way an IO thread does
+		std::vector<BatchFileReader::Read> secondBatch{ BatchFileReader::Read{ GetPath(7) }, BatchFileReader::Read{ GetPath(1) } };
+		reader.ReadAll(secondBatch);
+		CHECK(secondBatch[0].m_Succeeded && secondBatch[0].m_Data == MakeContent(7));
+		CHECK(secondBatch[1].m_Succeeded && secondBatch[1].m_Data == MakeContent(1));
+
+		std::vector<BatchFileReader::Read> emptyBatch{};
+		reader.ReadAll(emptyBatch);
+	}
+}
+
+int main()
+{
+	WriteFiles();
+
+	BatchFileReader reader{ g_QueueDepth };
+	const bool isUsingIoUring{ reader.IsUsingIoUring() };
+	TestReadAll(reader);
+
+	std::filesystem::remove_all(g_Folder);
+
+	if (g_FailureCount > 0)
+	{
+		std::fprintf(stderr, "%d checks failed\n", g_FailureCount);
+		return 1;
+	}
+
+	if (!isUsingIoUring)
+	{
+		std::printf("io_uring unavailable, only the blocking fallback was checked\n");
+		return g_SkipReturnCode;
+	}
+
+	std::printf("All checks passed\n");
+	return 0;
+}
@@ -0,0 +1,156 @@
+#include "FrameRingAllocator.h"
+
+#include <cstdio>
+#include <vector>
+
+// Drives the FrameRingAllocator through many frames against a simulated GPU queue that completes fences late, and
+// checks that a region is never handed out again before the fence of its previous frame completed.
+
+namespace
+{
+	constexpr int g_FrameCount{ 3 };
+	constexpr uint64_t g_Capacity{ 3u * 1024u };
+
+	int g_FailureCount{};
+
+	void Check(bool condition, const char* pExpression, int line)
+	{
+		if (condition)
+			return;
+
+		std::fprintf(stderr, "Line %d: %s failed\n", line, pExpression);
+		++g_FailureCount;
+	}
+
+#define CHECK(condition) Check((condition), #condition, __LINE__)
+
+	/**
+	 * \brief Stands in for a command queue and its fence, frames complete in order but only when told to
+	 */
+	struct SimulatedQueue
+	{
+		uint64_t m_LastSignaledValue{};
+		uint64_t m_CompletedValue{};
+
+		uint64_t Signal() { return ++m_LastSignaledValue; }
+		void CompleteOne()
+		{
+			if (m_CompletedValue < m_LastSignaledValue)
+				++m_CompletedValue;
+		}
+	};
+
+	void TestRegions()
+	{
+		std::vector<uint8_t> buffer(g_Capacity);
+		FrameRingAllocator<g_FrameCount> allocator{};
+		allocator.Initialize(buffer.data(), buffer.size());
+
+		CHECK(allocator.GetRegionSize() == 1024);
+
+		for (uint32_t frame{}; frame < g_FrameCount; ++frame)
+		{
+			CHECK(allocator.BeginFrame(0));
+			CHECK(allocator.GetFrameIndex() == frame);
+
+			const FrameRingAllocator<g_FrameCount>::Allocation allocation{ allocator.Allocate(16, 16) };
+			CHECK(allocation.IsValid());
+			CHECK(allocation.m_Offset == frame * allocator.GetRegionSize());
+			CHECK(allocation.m_pData == buffer.data() + allocation.m_Offset);
+
+			allocator.EndFrame(0);
+		}
+
+		// Back to the first region
+		CHECK(allocator.GetFrameIndex() == 0);
+	}
+
+	void TestAlignmentAndOverflow()
+	{
+		std::vector<uint8_t> buffer(g_Capacity);
+		FrameRingAllocator<g_FrameCount> allocator{};
+		allocator.Initialize(buffer.data(), buffer.size());
+
+		CHECK(allocator.BeginFrame(0));
+
+		const FrameRingAllocator<g_FrameCount>::Allocation first{ allocator.Allocate(4, 4) };
+		const FrameRingAllocator<g_FrameCount>::Allocation second{ allocator.Allocate(64, 256) };
+		CHECK(first.m_Offset == 0);
+		CHECK(second.m_Offset == 256);
+		CHECK(allocator.GetUsedSize() == 320);
+
+		// Does not fit in what is left of the region, nothing is allocated
+		const FrameRingAllocator<g_FrameCount>::Allocation overflow{ allocator.Allocate(1024, 4) };
+		CHECK(!overflow.IsValid());
+		CHECK(allocator.GetFailedAllocationCount() == 1);
+		CHECK(allocator.GetUsedSize() == 320);
+
+		// Exactly fills the region
+		const FrameRingAllocator<g_FrameCount>::Allocation last{ allocator.Allocate(1024 - 320, 4) };
+		CHECK(last.IsValid());
+		CHECK(allocator.GetUsedSize() == allocator.GetRegionSize());
+
+		allocator.EndFrame(1);
+	}
+
+	void TestWraparoundWithFences()
+	{
+		std::vector<uint8_t> buffer(g_Capacity);
+		FrameRingAllocator<g_FrameCount> allocator{};
+		allocator.Initialize(buffer.data(), buffer.size());
+
+		SimulatedQueue queue{};
+
+		// Fence value that last used each region, to check the allocator never reuses one too early
+		std::vector<uint64_t> regionFenceValues(g_FrameCount);
+		uint32_t stallCount{};
+
+		for (uint32_t frame{}; frame < 100; ++frame)
+		{
+			// The GPU is two frames behind on even frames, one frame behind otherwise
+			if (frame % 2)
+				queue.CompleteOne();
+
+			while (!allocator.BeginFrame(queue.m_CompletedValue))
+			{
+				// What a backend does, wait on the fence and try again
+				CHECK(allocator.GetRequiredFenceValue() > queue.m_CompletedValue);
+				++stallCount;
+				queue.CompleteOne();
+			}
+
+			const uint32_t region{ allocator.GetFrameIndex() };
+			CHECK(region == frame % g_FrameCount);
+			CHECK(queue.m_CompletedValue >= regionFenceValues[region]);
+
+			const FrameRingAllocator<g_FrameCount>::Allocation allocation{ allocator.Allocate(512, 256) };
+			CHECK(allocation.IsValid());
+			CHECK(allocation.m_Offset >= allocator.GetRegionOffset());
+			CHECK(allocation.m_Offset + allocation.m_Size <= allocator.GetRegionOffset() + allocator.GetRegionSize());
+
+			const uint64_t fenceValue{ queue.Signal() };
+			regionFenceValues[region] = fenceValue;
+			allocator.EndFrame(fenceValue);
+		}
+
+		// The queue fell behind by more than the frames in flight, so BeginFrame must have refused some regions
+		CHECK(stallCount > 0);
+		CHECK(allocator.GetFailedAllocationCount() == 0);
+	}
+}
+
+int main()
+{
+	TestRegions();
+	TestAlignmentAndOverflow();
+	TestWraparoundWithFences();
+
+	if (g_FailureCount > 0)
+	{
+		std::fprintf(stderr, "%d checks failed\n", g_FailureCount);
+		return 1;
+	}
+
+	std::printf("All checks passed\n");
+	return 0;
+}
@@ -0,0 +1,158 @@
+#include "FrustumCuller.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// Culls a large set of random bounds against a perspective frustum with every code path of the FrustumCuller: AVX2
+// or scalar, on the calling thread or across the JobSystem. Checks every path gives the same visible list as the
+// scalar single threaded one and reports the time each takes.
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	struct Options
+	{
+		uint32_t m_BoundsCount{ 1000000 };
+		uint32_t m_Iterations{ 20 };
+		float m_WorldSize{ 1000.f }; // Bounds are spread in a cube of this size centered on the camera
+	};
+
+	struct CodePath
+	{
+		const char* m_pName{};
+		bool m_IsAVX2{};
+		bool m_IsParallel{};
+	};
+
+	void PrintUsage()
+	{
+		std::printf(
+			"Usage: FrustumCullerBench [options]\n"
+			"  --bounds <count>      Bounds culled (default 1000000)\n"
+			"  --iterations <count>  Culls timed per code path (default 20)\n");
+	}
+
+	bool ParseOptions(int argc, char* argv[], Options& options)
+	{
+		for (int i{ 1 }; i < argc; ++i)
+		{
+			const std::string argument{ argv[i] };
+			const bool hasValue{ i + 1 < argc };
+
+			if (argument == "--bounds" && hasValue)
+				options.m_BoundsCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+			else if (argument == "--iterations" && hasValue)
+				options.m_Iterations = static_cast<uint32_t>(std::stoul(argv[++i]));
+			else
+				return false;
+		}
+
+		return options.m_Iterations > 0;
+	}
+
+	/**
+	 * \brief Row major, row vector view projection of a camera at the origin looking down +z with a [0, 1] depth
+	 * range, the layout XMMatrixPerspectiveFovLH produces
+	 */
+	void BuildViewProjection(float (&matrix)[4][4], float verticalFov, float aspectRatio, float nearPlane, float farPlane)
+	{
+		const float yScale{ 1.f / std::tan(verticalFov * .5f) };
+		const float depthScale{ farPlane / (farPlane - nearPlane) };
+
+		matrix[0][0] = yScale / aspectRatio;
+		matrix[1][1] = yScale;
+		matrix[2][2] = depthScale;
+		matrix[2][3] = 1.f;
+		matrix[3][2] = -nearPlane * depthScale;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options{};
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	float viewProjection[4][4]{};
+	BuildViewProjection(viewProjection, 1.0471976f, 16.f / 9.f, .1f, options.m_WorldSize * .5f);
+	const FrustumCuller::Frustum frustum{ FrustumCuller::ExtractFrustum(viewProjection) };
+
+	std::mt19937 random{ 42 };
+	std::uniform_real_distribution<float> positionDistribution{ -options.m_WorldSize * .5f, options.m_WorldSize * .5f };
+	std::uniform_real_distribution<float> extentDistribution{ .1f, 5.f };
+
+	FrustumCuller culler{};
+	culler.Reserve(options.m_BoundsCount);
+	for (uint32_t i{}; i < options.m_BoundsCount; ++i)
+	{
+		FrustumCuller::Bounds bounds{};
+		for (uint32_t axis{}; axis < 3; ++axis)
+		{
+			bounds.m_Center[axis] = positionDistribution(random);
+			bounds.m_Extents[axis] = extentDistribution(random);
+		}
+		bounds.m_Radius = std::sqrt(bounds.m_Extents[0] * bounds.m_Extents[0] + bounds.m_Extents[1] * bounds.m_Extents[1] + bounds.m_Extents[2] * bounds.m_Extents[2]);
+
+		culler.Add(bounds);
+	}
+
+	// The scalar single threaded path is the reference
+	culler.SetAVX2Enabled(false);
+	culler.SetParallelEnabled(false);
+	const std::vector<uint32_t> reference{ culler.Cull(frustum) };
+
+	std::printf("%u bounds, %zu visible, %u iterations, AVX2 %s, %u JobSystem threads\n", options.m_BoundsCount, reference.size(), options.m_Iterations,
+		FrustumCuller::IsAVX2Supported() ? "supported" : "not supported", JobSystem::Get().GetThreadCount());
+
+	const CodePath codePaths[]{
+		{ "Scalar", false, false },
+		{ "Scalar, JobSystem", false, true },
+		{ "AVX2", true, false },
+		{ "AVX2, JobSystem", true, true },
+	};
+
+	bool isValid{ true };
+	for (const CodePath& codePath : codePaths)
+	{
+		if (codePath.m_IsAVX2 && !FrustumCuller::IsAVX2Supported())
+			continue;
+
+		culler.SetAVX2Enabled(codePath.m_IsAVX2);
+		culler.SetParallelEnabled(codePath.m_IsParallel);
+
+		if (culler.Cull(frustum) != reference)
+		{
+			std::fprintf(stderr, "%s: %zu visible, the visible list differs from the scalar one\n", codePath.m_pName, culler.GetVisible().size());
+			isValid = false;
+			continue;
+		}
+
+		// Best of the iterations, the least disturbed by the rest of the system
+		double bestMilliseconds{ 1e30 };
+		double totalMilliseconds{};
+		for (uint32_t i{}; i < options.m_Iterations; ++i)
+		{
+			const Clock::time_point start{ Clock::now() };
+			culler.Cull(frustum);
+			const double milliseconds{ std::chrono::duration<double, std::milli>(Clock::now() - start).count() };
+
+			bestMilliseconds = std::min(bestMilliseconds, milliseconds);
+			totalMilliseconds += milliseconds;
+		}
+
+		std::printf("%-20s %10.3f ms best %10.3f ms average %8.2f ns per bounds\n", codePath.m_pName, bestMilliseconds,
+			totalMilliseconds / options.m_Iterations, bestMilliseconds * 1e6 / std::max(options.m_BoundsCount, 1u));
+	}
+
+	return isValid ? 0 : 1;
+}
@@ -0,0 +1,328 @@
+#include "IndexAllocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Hammers the lock-free IndexAllocator from several threads while frames are reclaimed concurrently, checks no index
+// is ever handed out twice and that every index comes back, then times it against the mutex and free list allocator
+// the DX12 descriptor heaps used before.
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr int s_FrameCount{ 3 }; // DX12Command::s_BufferCount
+
+	struct Options
+	{
+		uint32_t m_ThreadCount{ std::max(std::thread::hardware_concurrency(), 2u) };
+		uint32_t m_StressCapacity{ 1024 }; // Small so threads regularly run out of indices
+		uint32_t m_StressOperations{ 200000 }; // Per thread
+		uint32_t m_BenchFrames{ 2000 };
+		uint32_t m_BenchBatchSize{ 64 }; // Indices allocated then freed per thread and frame
+	};
+
+	void PrintUsage()
+	{
+		std::printf(
+			"Usage: IndexAllocatorStress [options]\n"
+			"  --threads <count>     Threads allocating concurrently (default hardware threads)\n"
+			"  --operations <count>  Stress operations per thread (default 200000)\n"
+			"  --frames <count>      Benchmark frames (default 2000)\n"
+			"  --batch <count>       Benchmark indices per thread and frame (default 64)\n");
+	}
+
+	bool ParseOptions(int argc, char* argv[], Options& options)
+	{
+		for (int i{ 1 }; i < argc; ++i)
+		{
+			const std::string argument{ argv[i] };
+			const bool hasValue{ i + 1 < argc };
+
+			if (argument == "--threads" && hasValue)
+				options.m_ThreadCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+			else if (argument == "--operations" && hasValue)
+				options.m_StressOperations = static_cast<uint32_t>(std::stoul(argv[++i]));
+			else if (argument == "--frames" && hasValue)
+				options.m_BenchFrames = static_cast<uint32_t>(std::stoul(argv[++i]));
+			else if (argument == "--batch" && hasValue)
+				options.m_BenchBatchSize = static_cast<uint32_t>(std::stoul(argv[++i]));
+			else
+				return false;
+		}
+
+		return options.m_ThreadCount > 0 && options.m_BenchBatchSize > 0;
+	}
+
+	/**
+	 * \brief The DX12DescriptorHeap allocator before IndexAllocator replaced it: a free list and per-frame deferred
+	 * lists behind one mutex
+	 */
+	class MutexIndexAllocator final
+	{
+	public:
+		explicit MutexIndexAllocator(uint32_t capacity)
+			: m_FreeHandles{ std::make_unique<uint32_t[]>(capacity) }
+			, m_Capacity{ capacity }
+		{
+			for (uint32_t i{}; i < capacity; ++i)
+				m_FreeHandles[i] = i;
+		}
+
+		[[nodiscard]] uint32_t Allocate()
+		{
+			std::lock_guard lock{ m_Mutex };
+			if (m_Size == m_Capacity)
+				return s_InvalidIndex;
+
+			return m_FreeHandles[m_Size++];
+		}
+
+		void Free(uint32_t index, uint32_t frameIndex)
+		{
+			std::lock_guard lock{ m_Mutex };
+			m_DeferredFreeHandles[frameIndex].emplace_back(index);
+		}
+
+		void ReclaimFrame(uint32_t frameIndex)
+		{
+			std::lock_guard lock{ m_Mutex };
+			for (const uint32_t index : m_DeferredFreeHandles[frameIndex])
+				m_FreeHandles[--m_Size] = index;
+			m_DeferredFreeHandles[frameIndex].clear();
+		}
+
+		inline static constexpr uint32_t s_InvalidIndex{ 0xFFFFFFFFu };
+
+	private:
+		std::unique_ptr<uint32_t[]> m_FreeHandles{};
+		std::vector<uint32_t> m_DeferredFreeHandles[s_FrameCount]{};
+		std::mutex m_Mutex{};
+		uint32_t m_Capacity;
+		uint32_t m_Size{};
+	};
+
+	/**
+	 * \brief Random allocations and frees on every thread while a driver thread advances the frames and reclaims the
+	 * frame that comes around again, like the renderer's BeginFrame
+	 * \return False if an index was handed out twice or did not come back
+	 */
+	bool Stress(const Options& options)
+	{
+		IndexAllocator<s_FrameCount> allocator{};
+		allocator.Initialize(options.m_StressCapacity);
+
+		// Set while a thread owns the index, a second owner means it was handed out twice
+		const auto pIsOwned{ std::make_unique<std::atomic<uint8_t>[]>(options.m_StressCapacity) };
+		std::atomic<uint32_t> currentFrame{};
+		std::atomic<uint32_t> runningCount{ options.m_ThreadCount };
+		std::atomic<uint64_t> duplicateCount{};
+		std::atomic<uint64_t> allocationCount{};
+		std::atomic<uint64_t> exhaustedCount{};
+
+		std::vector<std::thread> threads{};
+		for (uint32_t thread{}; thread < options.m_ThreadCount; ++thread)
+		{
+			threads.emplace_back([&, thread]
+			{
+				std::mt19937 random{ thread + 1 };
+				std::uniform_int_distribution<uint32_t> operationDistribution{ 0, 99 };
+				std::vector<uint32_t> held{};
+
+				const auto free{ [&](size_t position)
+				{
+					const uint32_t index{ held[position] };
+					held[position] = held.back();
+					held.pop_back();
+
+					// Released before Free, another thread may get it back as soon as its frame is reclaimed
+					pIsOwned[index].store(0, std::memory_order_relaxed);
+					allocator.Free(index, currentFrame.load(std::memory_order_relaxed));
+				} };
+
+				// Together the threads hold up to every index, the retired ones make them run out regularly
+				const size_t maxHeldCount{ std::max(options.m_StressCapacity / options.m_ThreadCount, 1u) };
+				for (uint32_t i{}; i < options.m_StressOperations; ++i)
+				{
+					if (held.empty() || (held.size() < maxHeldCount && operationDistribution(random) < 50))
+					{
+						const uint32_t index{ allocator.Allocate() };
+						if (index == allocator.s_InvalidIndex)
+						{
+							exhaustedCount.fetch_add(1, std::memory_order_relaxed);
+							if (!held.empty())
+								free(random() % held.size());
+
+							// Lets the driver reclaim a frame
+							std::this_thread::yield();
+							continue;
+						}
+
+						if (index >= options.m_StressCapacity || pIsOwned[index].exchange(1, std::memory_order_relaxed) != 0)
+							duplicateCount.fetch_add(1, std::memory_order_relaxed);
+
+						held.emplace_back(index);
+						allocationCount.fetch_add(1, std::memory_order_relaxed);
+					}
+					else
+						free(random() % held.size());
+				}
+
+				while (!held.empty())
+					free(held.size() - 1);
+
+				runningCount.fetch_sub(1, std::memory_order_release);
+			});
+		}
+
+		// With three frames in flight, the frame about to start is the one the GPU completed
+		uint64_t frameCount{};
+		while (runningCount.load(std::memory_order_acquire) > 0)
+		{
+			const uint32_t nextFrame{ (currentFrame.load(std::memory_order_relaxed) + 1) % s_FrameCount };
+			allocator.ReclaimFrame(nextFrame);
+			currentFrame.store(nextFrame, std::memory_order_relaxed);
+			++frameCount;
+			std::this_thread::yield();
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		allocator.ReclaimAll();
+
+		bool isValid{ true };
+		if (duplicateCount > 0)
+		{
+			std::fprintf(stderr, "%llu indices handed out twice\n", static_cast<unsigned long long>(duplicateCount.load()));
+			isValid = false;
+		}
+
+		if (allocator.GetSize() != 0)
+		{
+			std::fprintf(stderr, "%u indices still in use after ReclaimAll\n", allocator.GetSize());
+			isValid = false;
+		}
+
+		// Every index must be allocatable again, exactly once
+		std::vector<uint8_t> isSeen(options.m_StressCapacity);
+		uint32_t recoveredCount{};
+		for (uint32_t index{ allocator.Allocate() }; index != allocator.s_InvalidIndex; index = allocator.Allocate())
+		{
+			if (index >= options.m_StressCapacity || isSeen[index])
+			{
+				std::fprintf(stderr, "Index %u returned twice after ReclaimAll\n", index);
+				isValid = false;
+				break;
+			}
+
+			isSeen[index] = 1;
+			++recoveredCount;
+		}
+
+		if (recoveredCount != options.m_StressCapacity)
+		{
+			std::fprintf(stderr, "%u of %u indices recovered after ReclaimAll\n", recoveredCount, options.m_StressCapacity);
+			isValid = false;
+		}
+
+		std::printf("Stress: %u threads, %llu allocations, %llu while exhausted, %llu frames reclaimed, %u of %u indices recovered\n",
+			options.m_ThreadCount, static_cast<unsigned long long>(allocationCount.load()), static_cast<unsigned long long>(exhaustedCount.load()),
+			static_cast<unsigned long long>(frameCount), recoveredCount, options.m_StressCapacity);
+
+		return isValid;
+	}
+
+	/**
+	 * \brief Every frame each thread allocates a batch of indices then frees them, the way descriptors of transient
+	 * views are churned. The last thread to finish a frame reclaims the next one.
+	 * \return Seconds taken
+	 */
+	template <typename Allocator>
+	double Bench(Allocator& allocator, const Options& options)
+	{
+		uint32_t frameIndex{};
+		std::barrier frameEnd{ static_cast<std::ptrdiff_t>(options.m_ThreadCount), [&]() noexcept
+		{
+			frameIndex = (frameIndex + 1) % s_FrameCount;
+			allocator.ReclaimFrame(frameIndex);
+		} };
+
+		std::atomic<uint64_t> failedCount{};
+		const Clock::time_point start{ Clock::now() };
+
+		std::vector<std::thread> threads{};
+		for (uint32_t thread{}; thread < options.m_ThreadCount; ++thread)
+		{
+			threads.emplace_back([&]
+			{
+				std::vector<uint32_t> indices(options.m_BenchBatchSize);
+				for (uint32_t frame{}; frame < options.m_BenchFrames; ++frame)
+				{
+					for (uint32_t& index : indices)
+					{
+						index = allocator.Allocate();
+						if (index == Allocator::s_InvalidIndex)
+							failedCount.fetch_add(1, std::memory_order_relaxed);
+					}
+
+					for (const uint32_t index : indices)
+					{
+						if (index != Allocator::s_InvalidIndex)
+							allocator.Free(index, frameIndex);
+					}
+
+					frameEnd.arrive_and_wait();
+				}
+			});
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		const double seconds{ std::chrono::duration<double>(Clock::now() - start).count() };
+		if (failedCount > 0)
+			std::fprintf(stderr, "%llu allocations failed, the capacity is too small\n", static_cast<unsigned long long>(failedCount.load()));
+
+		return seconds;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options{};
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	if (!Stress(options))
+		return 1;
+
+	// Room for every batch of the frames in flight
+	const uint32_t benchCapacity{ options.m_ThreadCount * options.m_BenchBatchSize * (s_FrameCount + 1) };
+	const double operationCount{ 2. * options.m_ThreadCount * options.m_BenchBatchSize * options.m_BenchFrames };
+
+	IndexAllocator<s_FrameCount> lockFreeAllocator{};
+	lockFreeAllocator.Initialize(benchCapacity);
+	const double lockFreeSeconds{ Bench(lockFreeAllocator, options) };
+
+	MutexIndexAllocator mutexAllocator{ benchCapacity };
+	const double mutexSeconds{ Bench(mutexAllocator, options) };
+
+	std::printf("Bench: %u threads, %u frames of %u indices per thread\n", options.m_ThreadCount, options.m_BenchFrames, options.m_BenchBatchSize);
+	std::printf("%-24s %10.2f ms %10.1f ns per Allocate or Free\n", "Lock-free", lockFreeSeconds * 1000., lockFreeSeconds * 1e9 / operationCount);
+	std::printf("%-24s %10.2f ms %10.1f ns per Allocate or Free\n", "Mutex and free list", mutexSeconds * 1000., mutexSeconds * 1e9 / operationCount);
+
+	return 0;
+}
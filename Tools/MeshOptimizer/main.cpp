@@ -0,0 +1,345 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Offline mesh processing: reads a Wavefront OBJ (or generates a shuffled grid), optimizes it for the vertex cache,
+// overdraw and vertex fetch, quantizes the attributes and reports the cache efficiency before and after.
+
+namespace
+{
+	struct Vertex
+	{
+		float m_Position[3]{};
+		float m_Normal[3]{};
+	};
+
+	struct QuantizedVertex
+	{
+		uint16_t m_Position[4]{}; // R16G16B16A16_UNORM, w unused
+		int16_t m_Normal[2]{}; // R16G16_SNORM, octahedral
+	};
+
+	struct Mesh
+	{
+		std::vector<Vertex> m_Vertices{};
+		std::vector<uint32_t> m_Indices{};
+	};
+
+	struct Options
+	{
+		std::string m_InputPath{};
+		std::string m_OutputPath{};
+		uint32_t m_GridSize{};
+		uint32_t m_CacheSize{ MeshOptimizer::s_DefaultCacheSize };
+		float m_OverdrawThreshold{ 1.05f };
+	};
+
+	void PrintUsage()
+	{
+		std::printf(
+			"Usage: MeshOptimizer (<input.obj> | --grid <size>) [options]\n"
+			"  -o <file>             Write the optimized, quantized mesh\n"
+			"  --cache <size>        Simulated post-transform cache size (default %u)\n"
+			"  --threshold <ratio>   ACMR degradation accepted for overdraw ordering (default 1.05)\n",
+			MeshOptimizer::s_DefaultCacheSize);
+	}
+
+	bool ParseOptions(int argc, char* argv[], Options& options)
+	{
+		for (int i{ 1 }; i < argc; ++i)
+		{
+			const std::string argument{ argv[i] };
+			const bool hasValue{ i + 1 < argc };
+
+			if (argument == "-o" && hasValue)
+				options.m_OutputPath = argv[++i];
+			else if (argument == "--grid" && hasValue)
+				options.m_GridSize = static_cast<uint32_t>(std::stoul(argv[++i]));
+			else if (argument == "--cache" && hasValue)
+				options.m_CacheSize = static_cast<uint32_t>(std::stoul(argv[++i]));
+			else if (argument == "--threshold" && hasValue)
+				options.m_OverdrawThreshold = std::stof(argv[++i]);
+			else if (argument[0] != '-' && options.m_InputPath.empty())
+				options.m_InputPath = argument;
+			else
+				return false;
+		}
+
+		return (options.m_GridSize > 0) != !options.m_InputPath.empty() && options.m_CacheSize > 0;
+	}
+
+	void ComputeNormals(Mesh& mesh)
+	{
+		for (Vertex& vertex : mesh.m_Vertices)
+			std::memset(vertex.m_Normal, 0, sizeof(vertex.m_Normal));
+
+		// Area weighted face normals
+		for (size_t i{}; i + 2 < mesh.m_Indices.size(); i += 3)
+		{
+			Vertex* pCorners[3]{ &mesh.m_Vertices[mesh.m_Indices[i]], &mesh.m_Vertices[mesh.m_Indices[i + 1]], &mesh.m_Vertices[mesh.m_Indices[i + 2]] };
+			float e1[3]{}, e2[3]{};
+			for (int axis{}; axis < 3; ++axis)
+			{
+				e1[axis] = pCorners[1]->m_Position[axis] - pCorners[0]->m_Position[axis];
+				e2[axis] = pCorners[2]->m_Position[axis] - pCorners[0]->m_Position[axis];
+			}
+
+			const float normal[3]{ e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+			for (Vertex* pCorner : pCorners)
+				for (int axis{}; axis < 3; ++axis)
+					pCorner->m_Normal[axis] += normal[axis];
+		}
+
+		for (Vertex& vertex : mesh.m_Vertices)
+		{
+			const float length{ std::sqrt(vertex.m_Normal[0] * vertex.m_Normal[0] + vertex.m_Normal[1] * vertex.m_Normal[1] + vertex.m_Normal[2] * vertex.m_Normal[2]) };
+			if (length > 0.f)
+				for (float& value : vertex.m_Normal)
+					value /= length;
+			else
+				vertex.m_Normal[2] = 1.f;
+		}
+	}
+
+	/**
+	 * \brief Resolves a 1-based, possibly negative OBJ index
+	 */
+	bool ResolveIndex(const std::string& token, size_t count, uint32_t& index)
+	{
+		if (token.empty())
+			return false;
+
+		const long value{ std::stol(token) };
+		const long resolved{ value < 0 ? static_cast<long>(count) + value : value - 1 };
+		if (resolved < 0 || static_cast<size_t>(resolved) >= count)
+			return false;
+
+		index = static_cast<uint32_t>(resolved);
+		return true;
+	}
+
+	bool LoadOBJ(const std::string& path, Mesh& mesh)
+	{
+		std::ifstream file{ path };
+		if (!file)
+			return false;
+
+		std::vector<std::array<float, 3>> positions{};
+		std::vector<std::array<float, 3>> normals{};
+		std::unordered_map<uint64_t, uint32_t> vertexIds{}; // Position and normal index pairs already emitted
+		bool hasNormals{ true };
+
+		std::string line;
+		std::vector<uint32_t> polygon{};
+		while (std::getline(file, line))
+		{
+			std::istringstream stream{ line };
+			std::string type;
+			stream >> type;
+
+			if (type == "v" || type == "vn")
+			{
+				std::array<float, 3> value{};
+				stream >> value[0] >> value[1] >> value[2];
+				(type == "v" ? positions : normals).emplace_back(value);
+			}
+			else if (type == "f")
+			{
+				polygon.clear();
+
+				// v, v/vt, v//vn or v/vt/vn
+				std::string corner;
+				while (stream >> corner)
+				{
+					const size_t firstSlash{ corner.find('/') };
+					const size_t lastSlash{ corner.rfind('/') };
+
+					uint32_t position{}, normal{ 0xFFFFFFFFu };
+					if (!ResolveIndex(corner.substr(0, firstSlash), positions.size(), position))
+						return false;
+					if (firstSlash == std::string::npos || lastSlash == firstSlash || !ResolveIndex(corner.substr(lastSlash + 1), normals.size(), normal))
+						hasNormals = false;
+
+					const uint64_t key{ uint64_t(normal) << 32 | position };
+					const auto [it, isNew] = vertexIds.try_emplace(key, static_cast<uint32_t>(mesh.m_Vertices.size()));
+					if (isNew)
+					{
+						Vertex vertex{};
+						std::memcpy(vertex.m_Position, positions[position].data(), sizeof(vertex.m_Position));
+						if (normal != 0xFFFFFFFFu)
+							std::memcpy(vertex.m_Normal, normals[normal].data(), sizeof(vertex.m_Normal));
+						mesh.m_Vertices.emplace_back(vertex);
+					}
+					polygon.emplace_back(it->second);
+				}
+
+				// Fan triangulation, faces are expected convex
+				for (size_t i{ 2 }; i < polygon.size(); ++i)
+					mesh.m_Indices.insert(mesh.m_Indices.end(), { polygon[0], polygon[i - 1], polygon[i] });
+			}
+		}
+
+		if (!hasNormals)
+			ComputeNormals(mesh);
+
+		return !mesh.m_Indices.empty();
+	}
+
+	/**
+	 * \brief Wavy grid with shuffled triangles, the worst case for the vertex cache
+	 */
+	Mesh GenerateGrid(uint32_t size)
+	{
+		Mesh mesh{};
+		for (uint32_t y{}; y <= size; ++y)
+		{
+			for (uint32_t x{}; x <= size; ++x)
+			{
+				Vertex vertex{};
+				vertex.m_Position[0] = static_cast<float>(x);
+				vertex.m_Position[1] = std::sin(static_cast<float>(x) * .3f) * std::cos(static_cast<float>(y) * .3f) * 2.f;
+				vertex.m_Position[2] = static_cast<float>(y);
+				mesh.m_Vertices.emplace_back(vertex);
+			}
+		}
+
+		std::vector<std::array<uint32_t, 3>> triangles{};
+		for (uint32_t y{}; y < size; ++y)
+		{
+			for (uint32_t x{}; x < size; ++x)
+			{
+				const uint32_t corner{ y * (size + 1) + x };
+				triangles.push_back({ corner, corner + size + 1, corner + 1 });
+				triangles.push_back({ corner + 1, corner + size + 1, corner + size + 2 });
+			}
+		}
+
+		std::shuffle(triangles.begin(), triangles.end(), std::mt19937{ 42 });
+		for (const auto& triangle : triangles)
+			mesh.m_Indices.insert(mesh.m_Indices.end(), triangle.begin(), triangle.end());
+
+		ComputeNormals(mesh);
+		return mesh;
+	}
+
+	void PrintStats(const char* pStage, const Mesh& mesh, uint32_t cacheSize)
+	{
+		const auto stats = MeshOptimizer::AnalyzeVertexCache(mesh.m_Indices.data(), static_cast<uint32_t>(mesh.m_Indices.size()), static_cast<uint32_t>(mesh.m_Vertices.size()), cacheSize);
+		std::printf("%-10s ACMR %.3f  ATVR %.3f  (%u transformed vertices)\n", pStage, stats.m_ACMR, stats.m_ATVR, stats.m_TransformedCount);
+	}
+
+	/**
+	 * \brief Header, dequantization constants, vertices, then 16 or 32-bit indices
+	 */
+	bool WriteMesh(const std::string& path, const std::vector<QuantizedVertex>& vertices, const std::vector<uint32_t>& indices, const float scale[3], const float offset[3])
+	{
+		std::ofstream file{ path, std::ios::binary };
+		if (!file)
+			return false;
+
+		const uint32_t header[4]{ 0x534D4750u /* PGMS */, 1u, static_cast<uint32_t>(vertices.size()), static_cast<uint32_t>(indices.size()) };
+		file.write(reinterpret_cast<const char*>(header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(scale), 3 * sizeof(float));
+		file.write(reinterpret_cast<const char*>(offset), 3 * sizeof(float));
+		file.write(reinterpret_cast<const char*>(vertices.data()), static_cast<std::streamsize>(vertices.size() * sizeof(QuantizedVertex)));
+
+		if (vertices.size() <= 0x10000)
+		{
+			const std::vector<uint16_t> narrowIndices{ indices.begin(), indices.end() };
+			file.write(reinterpret_cast<const char*>(narrowIndices.data()), static_cast<std::streamsize>(narrowIndices.size() * sizeof(uint16_t)));
+		}
+		else
+			file.write(reinterpret_cast<const char*>(indices.data()), static_cast<std::streamsize>(indices.size() * sizeof(uint32_t)));
+
+		return static_cast<bool>(file);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options{};
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	Mesh mesh{};
+	if (options.m_GridSize > 0)
+		mesh = GenerateGrid(options.m_GridSize);
+	else if (!LoadOBJ(options.m_InputPath, mesh))
+	{
+		std::fprintf(stderr, "Could not load %s\n", options.m_InputPath.c_str());
+		return 1;
+	}
+
+	const auto vertexCount = static_cast<uint32_t>(mesh.m_Vertices.size());
+	const auto indexCount = static_cast<uint32_t>(mesh.m_Indices.size());
+	std::printf("%u vertices, %u triangles, cache size %u\n", vertexCount, indexCount / 3, options.m_CacheSize);
+	PrintStats("Input", mesh, options.m_CacheSize);
+
+	const auto start = std::chrono::steady_clock::now();
+
+	MeshOptimizer::OptimizeVertexCache(mesh.m_Indices.data(), mesh.m_Indices.data(), indexCount, vertexCount, options.m_CacheSize);
+	PrintStats("Cache", mesh, options.m_CacheSize);
+
+	MeshOptimizer::OptimizeOverdraw(mesh.m_Indices.data(), mesh.m_Indices.data(), indexCount, mesh.m_Vertices[0].m_Position, sizeof(Vertex), vertexCount,
+		options.m_OverdrawThreshold, options.m_CacheSize);
+	PrintStats("Overdraw", mesh, options.m_CacheSize);
+
+	std::vector<Vertex> fetchOrdered(vertexCount);
+	const uint32_t usedCount{ MeshOptimizer::OptimizeVertexFetch(fetchOrdered.data(), mesh.m_Indices.data(), indexCount, mesh.m_Vertices.data(), vertexCount, sizeof(Vertex)) };
+	fetchOrdered.resize(usedCount);
+	mesh.m_Vertices.swap(fetchOrdered);
+	PrintStats("Fetch", mesh, options.m_CacheSize);
+
+	// Attributes go from 24 to 12 bytes per vertex
+	std::vector<uint16_t> positions(static_cast<size_t>(usedCount) * 4);
+	std::vector<int16_t> normals(static_cast<size_t>(usedCount) * 2);
+	float scale[3]{}, offset[3]{};
+	MeshOptimizer::QuantizePositions(positions.data(), mesh.m_Vertices[0].m_Position, sizeof(Vertex), usedCount, scale, offset);
+	MeshOptimizer::EncodeOctahedralNormals(normals.data(), mesh.m_Vertices[0].m_Normal, sizeof(Vertex), usedCount);
+
+	const float elapsedMilliseconds{ std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() };
+
+	std::vector<QuantizedVertex> quantized(usedCount);
+	float maxPositionError{}, maxNormalError{};
+	for (uint32_t v{}; v < usedCount; ++v)
+	{
+		QuantizedVertex& vertex{ quantized[v] };
+		std::memcpy(vertex.m_Position, &positions[static_cast<size_t>(v) * 4], sizeof(vertex.m_Position));
+		std::memcpy(vertex.m_Normal, &normals[static_cast<size_t>(v) * 2], sizeof(vertex.m_Normal));
+
+		float normal[3]{};
+		MeshOptimizer::DecodeOctahedralNormal(vertex.m_Normal, normal);
+		for (int axis{}; axis < 3; ++axis)
+		{
+			const float position{ vertex.m_Position[axis] * scale[axis] + offset[axis] };
+			maxPositionError = std::max(maxPositionError, std::abs(position - mesh.m_Vertices[v].m_Position[axis]));
+			maxNormalError = std::max(maxNormalError, std::abs(normal[axis] - mesh.m_Vertices[v].m_Normal[axis]));
+		}
+	}
+
+	std::printf("Vertices %zu -> %zu bytes, max position error %g, max normal error %g\n",
+		static_cast<size_t>(vertexCount) * sizeof(Vertex), static_cast<size_t>(usedCount) * sizeof(QuantizedVertex), maxPositionError, maxNormalError);
+	std::printf("Processed in %.2f ms\n", elapsedMilliseconds);
+
+	if (!options.m_OutputPath.empty() && !WriteMesh(options.m_OutputPath, quantized, mesh.m_Indices, scale, offset))
+	{
+		std::fprintf(stderr, "Could not write %s\n", options.m_OutputPath.c_str());
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,175 @@
+#include "RenderGraph.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Builds a small deferred frame with a few dead branches, and checks the pass order, which passes are culled and
+// how the transient textures are placed in the aliased heap.
+
+namespace
+{
+	int g_FailureCount{};
+
+	void Check(bool condition, const char* pExpression, int line)
+	{
+		if (condition)
+			return;
+
+		std::fprintf(stderr, "Line %d: %s failed\n", line, pExpression);
+		++g_FailureCount;
+	}
+
+#define CHECK(condition) Check((condition), #condition, __LINE__)
+
+	constexpr RenderGraph::TextureDesc g_ColorDesc{ 1280, 720, RenderGraph::Format::RGBA8 };
+	constexpr RenderGraph::TextureDesc g_HdrDesc{ 1280, 720, RenderGraph::Format::RGBA16F };
+	constexpr RenderGraph::TextureDesc g_DepthDesc{ 1280, 720, RenderGraph::Format::D32 };
+
+	bool Overlaps(const RenderGraph& graph, RenderGraph::ResourceId a, RenderGraph::ResourceId b)
+	{
+		const uint64_t aBegin{ graph.GetHeapOffset(a) };
+		const uint64_t bBegin{ graph.GetHeapOffset(b) };
+		return aBegin < bBegin + RenderGraph::GetTextureSize(graph.GetTextureDesc(b))
+			&& bBegin < aBegin + RenderGraph::GetTextureSize(graph.GetTextureDesc(a));
+	}
+
+	void TestTextureSize()
+	{
+		CHECK(RenderGraph::GetTextureSize(g_ColorDesc) == 57 * RenderGraph::s_PlacementAlignment);
+		CHECK(RenderGraph::GetTextureSize(g_HdrDesc) == 113 * RenderGraph::s_PlacementAlignment);
+		CHECK(RenderGraph::GetTextureSize({ 128, 128, RenderGraph::Format::R32F }) == RenderGraph::s_PlacementAlignment);
+	}
+
+	void TestDeferredFrame()
+	{
+		RenderGraph graph{};
+		std::vector<std::string> executed{};
+
+		const auto record{ [&](const char* pName) { return [&executed, pName] { executed.emplace_back(pName); }; } };
+
+		const RenderGraph::ResourceId backBuffer{ graph.ImportTexture("BackBuffer", g_ColorDesc) };
+		RenderGraph::ResourceId albedo{}, normal{}, depth{}, hdr{}, blur{}, ldr{};
+
+		graph.AddPass("GBuffer", [&](RenderGraph::PassBuilder& builder)
+		{
+			albedo = builder.CreateTexture("Albedo", g_ColorDesc);
+			normal = builder.CreateTexture("Normal", g_HdrDesc);
+			depth = builder.CreateTexture("Depth", g_DepthDesc);
+		}, record("GBuffer"));
+
+		// Nothing reads its output
+		graph.AddPass("DebugNormals", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder.Read(normal);
+			builder.CreateTexture("DebugView", g_ColorDesc);
+		}, record("DebugNormals"));
+
+		graph.AddPass("Lighting", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder.Read(albedo);
+			builder.Read(normal);
+			builder.Read(depth);
+			hdr = builder.CreateTexture("Hdr", g_HdrDesc);
+		}, record("Lighting"));
+
+		// Dead chain, culling the second pass must cull the first
+		graph.AddPass("BlurHorizontal", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder.Read(hdr);
+			blur = builder.CreateTexture("BlurHorizontal", g_HdrDesc);
+		}, record("BlurHorizontal"));
+		graph.AddPass("BlurVertical", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder.Read(blur);
+			builder.CreateTexture("BlurVertical", g_HdrDesc);
+		}, record("BlurVertical"));
+
+		graph.AddPass("ToneMap", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder.Read(hdr);
+			ldr = builder.CreateTexture("Ldr", g_ColorDesc);
+		}, record("ToneMap"));
+
+		// Writes the imported back buffer, kept
+		graph.AddPass("Composite", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder.Read(ldr);
+			builder.Write(backBuffer);
+		}, record("Composite"));
+
+		// Only reads, kept for its side effect
+		graph.AddPass("Screenshot", [&](RenderGraph::PassBuilder& builder)
+		{
+			builder.Read(backBuffer);
+			builder.SetSideEffect();
+		}, record("Screenshot"));
+
+		graph.Compile();
+
+		const RenderGraph::CompileStats& stats{ graph.GetStats() };
+		CHECK(stats.m_PassCount == 8);
+		CHECK(stats.m_CulledPassCount == 3);
+
+		const std::vector<uint32_t> expectedOrder{ 0, 2, 5, 6, 7 };
+		CHECK(graph.GetExecutionOrder() == expectedOrder);
+		CHECK(graph.IsPassCulled(1));
+		CHECK(graph.IsPassCulled(3));
+		CHECK(graph.IsPassCulled(4));
+		CHECK(!graph.IsPassCulled(7));
+		CHECK(graph.GetPassName(5) == "ToneMap");
+
+		graph.Execute();
+		const std::vector<std::string> expectedExecution{ "GBuffer", "Lighting", "ToneMap", "Composite", "Screenshot" };
+		CHECK(executed == expectedExecution);
+
+		// Albedo, normal and depth live until lighting, hdr from lighting to tone mapping, ldr until composite.
+		// Outputs of culled passes take no memory.
+		const uint64_t colorSize{ RenderGraph::GetTextureSize(g_ColorDesc) };
+		const uint64_t hdrSize{ RenderGraph::GetTextureSize(g_HdrDesc) };
+		const uint64_t depthSize{ RenderGraph::GetTextureSize(g_DepthDesc) };
+
+		CHECK(stats.m_TransientCount == 5);
+		CHECK(stats.m_TransientMemory == 2 * colorSize + 2 * hdrSize + depthSize);
+		CHECK(stats.m_PeakMemory == colorSize + 2 * hdrSize + depthSize);
+		CHECK(graph.GetHeapSize() == stats.m_PeakMemory);
+
+		// Ldr only starts once the gbuffer is dead, it reuses the normal memory
+		CHECK(graph.GetHeapOffset(normal) == 0);
+		CHECK(graph.GetHeapOffset(ldr) == 0);
+
+		// Textures alive at the same time never share memory
+		const std::vector<RenderGraph::ResourceId> gbuffer{ albedo, normal, depth };
+		for (const RenderGraph::ResourceId a : gbuffer)
+		{
+			CHECK(!Overlaps(graph, a, hdr));
+			for (const RenderGraph::ResourceId b : gbuffer)
+				CHECK(a == b || !Overlaps(graph, a, b));
+		}
+		CHECK(!Overlaps(graph, hdr, ldr));
+
+		for (const RenderGraph::ResourceId resource : { albedo, normal, depth, hdr, ldr })
+			CHECK(graph.GetHeapOffset(resource) % RenderGraph::s_PlacementAlignment == 0);
+
+		// Everything is rebuilt from scratch every frame
+		graph.Reset();
+		graph.Compile();
+		CHECK(graph.GetExecutionOrder().empty());
+		CHECK(graph.GetHeapSize() == 0);
+	}
+}
+
+int main()
+{
+	TestTextureSize();
+	TestDeferredFrame();
+
+	if (g_FailureCount > 0)
+	{
+		std::fprintf(stderr, "%d checks failed\n", g_FailureCount);
+		return 1;
+	}
+
+	std::printf("All checks passed\n");
+	return 0;
+}
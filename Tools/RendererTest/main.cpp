@@ -0,0 +1,181 @@
+#include "ColorMaterial.h"
+#include "GameSettings.h"
+#include "Renderer.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// Runs frames through the Renderer on a backend needing no GPU, selected on the command line, and checks what the
+// frames submitted: the draws the Null backend recorded, in order, with their instance counts, and that once warm a
+// frame creates no GPU resource on any backend.
+
+namespace
+{
+	int g_FailureCount{};
+
+	void Check(bool condition, const char* pExpression, int line)
+	{
+		if (condition)
+			return;
+
+		std::fprintf(stderr, "Line %d: %s failed\n", line, pExpression);
+		++g_FailureCount;
+	}
+
+#define CHECK(condition) Check((condition), #condition, __LINE__)
+
+	struct Vertex
+	{
+		float x{}, y{};
+	};
+
+	MeshHandle CreateTriangle(float scale)
+	{
+		const Vertex vertices[]{ { 0.f, scale }, { scale, -scale }, { -scale, -scale } };
+		constexpr uint16_t indices[]{ 0, 1, 2 };
+
+		MeshDesc desc{};
+		desc.m_pVertices = vertices;
+		desc.m_VertexCount = static_cast<uint32_t>(std::size(vertices));
+		desc.m_VertexStride = sizeof(Vertex);
+		desc.m_pIndices = indices;
+		desc.m_IndexCount = static_cast<uint32_t>(std::size(indices));
+		desc.m_IndexFormat = IndexFormat::UInt16;
+
+		return Renderer::Get().CreateMesh(desc);
+	}
+
+	XMFLOAT4X4 MakeWorld(float distance)
+	{
+		XMFLOAT4X4 world{};
+		XMStoreFloat4x4(&world, XMMatrixTranslation(0.f, 0.f, distance));
+		return world;
+	}
+
+	bool IsDraw(const RecordedDraw& draw, MeshHandle mesh, const BaseMaterial* pMaterial, uint32_t instanceCount)
+	{
+		return draw.m_Mesh == mesh && draw.m_pMaterial == pMaterial && draw.m_InstanceCount == instanceCount;
+	}
+
+	void TestDrawOrder()
+	{
+		Renderer& renderer{ Renderer::Get() };
+
+		const MeshHandle meshA{ CreateTriangle(.5f) };
+		const MeshHandle meshB{ CreateTriangle(.25f) };
+
+		// Created first, sorts before green
+		ColorMaterial red{};
+		red.SetColor(1.f, 0.f, 0.f);
+		ColorMaterial green{};
+		green.SetColor(0.f, 1.f, 0.f);
+
+		renderer.BeginFrame();
+
+		// Recorded out of order on purpose
+		renderer.Draw(meshA, &red, MakeWorld(5.f), 1);
+		renderer.Draw(meshB, &green, MakeWorld(1.f));
+		renderer.Draw(meshA, &green, MakeWorld(3.f));
+		renderer.Draw(meshA, &red, MakeWorld(4.f));
+		renderer.Draw(meshA, &red, MakeWorld(2.f));
+
+		renderer.Submit();
+
+		// Layer first, then material, then mesh. The two red A of layer 0 merge into one instanced draw.
+		const std::span<const RecordedDraw> draws{ renderer.GetRecordedDraws() };
+		CHECK(draws.size() == 4);
+		if (draws.size() == 4)
+		{
+			CHECK(IsDraw(draws[0], meshA, &red, 2));
+			CHECK(IsDraw(draws[1], meshA, &green, 1));
+			CHECK(IsDraw(draws[2], meshB, &green, 1));
+			CHECK(IsDraw(draws[3], meshA, &red, 1));
+		}
+
+		const SubmitStats& stats{ renderer.GetSubmitStats() };
+		CHECK(stats.m_PacketCount == 5);
+		CHECK(stats.m_DroppedPacketCount == 0);
+		CHECK(stats.m_DrawCallCount == 4);
+		CHECK(stats.m_InstancedDrawCallCount == 1);
+
+		renderer.EndFrame();
+
+		// Nothing carries over to the next frame
+		renderer.BeginFrame();
+		renderer.Submit();
+		CHECK(renderer.GetRecordedDraws().empty());
+		renderer.EndFrame();
+
+		renderer.DestroyMesh(meshA);
+		renderer.DestroyMesh(meshB);
+	}
+
+	void TestSteadyStateCreatesNothing()
+	{
+		Renderer& renderer{ Renderer::Get() };
+
+		// Vertex and index buffer, whatever the backend
+		const uint32_t initialCount{ renderer.GetResourceCreationCount() };
+		const MeshHandle mesh{ CreateTriangle(.5f) };
+		CHECK(renderer.GetResourceCreationCount() == initialCount + 2);
+
+		constexpr uint32_t materialCount{ 3 };
+		ColorMaterial materials[materialCount]{};
+		for (uint32_t i{}; i < materialCount; ++i)
+			materials[i].SetColor(float(i) / float(materialCount), 0.f, 1.f);
+
+		const auto drawFrame{ [&](uint32_t frame)
+		{
+			renderer.BeginFrame();
+
+			// Instanced runs, single draws and the test triangle, with parameters changing every frame
+			for (uint32_t i{}; i < 64; ++i)
+				renderer.Draw(mesh, &materials[i % materialCount], MakeWorld(float(i)), uint8_t(i % 2));
+			materials[frame % materialCount].SetColor(0.f, float(frame % 2), 0.f);
+			renderer.RenderTestTriangle();
+
+			renderer.Submit();
+			renderer.EndFrame();
+		} };
+
+		// Materials may create their objects on their first bind
+		drawFrame(0);
+		const uint32_t warmCount{ renderer.GetResourceCreationCount() };
+
+		// More frames than the frames in flight, so every transient region gets reused
+		for (uint32_t frame{ 1 }; frame <= 4 * Renderer::s_FrameCount; ++frame)
+			drawFrame(frame);
+
+		CHECK(renderer.GetResourceCreationCount() == warmCount);
+
+		renderer.DestroyMesh(mesh);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2 || (std::strcmp(argv[1], "null") != 0 && std::strcmp(argv[1], "software") != 0))
+	{
+		std::fprintf(stderr, "Usage: RendererTest null|software\n");
+		return 1;
+	}
+
+	const bool isNull{ std::strcmp(argv[1], "null") == 0 };
+	GameSettings::renderAPI = isNull ? GameSettings::RenderAPI::Null : GameSettings::RenderAPI::Software;
+	Renderer::Get().Init();
+
+	// Only the Null backend records its draws
+	if (isNull)
+		TestDrawOrder();
+	TestSteadyStateCreatesNothing();
+
+	if (g_FailureCount > 0)
+	{
+		std::fprintf(stderr, "%d checks failed\n", g_FailureCount);
+		return 1;
+	}
+
+	std::printf("All checks passed\n");
+	return 0;
+}
@@ -0,0 +1,135 @@
+#include "AssetPack.h"
+#include "ShaderCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+// Loads fake shader files through the ShaderCache without any graphics device, and checks that each file is read
+// once, that copies share their bytecode through the content hash, and that mounted packs take precedence.
+
+namespace
+{
+	int g_FailureCount{};
+
+	void Check(bool condition, const char* pExpression, int line)
+	{
+		if (condition)
+			return;
+
+		std::fprintf(stderr, "Line %d: %s failed\n", line, pExpression);
+		++g_FailureCount;
+	}
+
+#define CHECK(condition) Check((condition), #condition, __LINE__)
+
+	const std::filesystem::path g_Folder{ "ShaderCacheTestData" };
+
+	void WriteFile(const std::filesystem::path& path, const std::string& content)
+	{
+		std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+		file.write(content.data(), static_cast<std::streamsize>(content.size()));
+	}
+
+	bool HasContent(const ShaderBytecode* pBytecode, const std::string& content)
+	{
+		return pBytecode && pBytecode->GetSize() == content.size() && std::memcmp(pBytecode->GetData(), content.data(), content.size()) == 0;
+	}
+
+	void TestFiles()
+	{
+		ShaderCache& cache{ ShaderCache::Get() };
+
+		const std::string vertexShader{ "vertex shader bytecode" };
+		const std::string pixelShader{ "pixel shader bytecode" };
+		WriteFile(g_Folder / "VS.cso", vertexShader);
+		WriteFile(g_Folder / "PS.cso", pixelShader);
+		WriteFile(g_Folder / "VSCopy.cso", vertexShader);
+
+		const ShaderBytecode* pVertexShader{ cache.Load(g_Folder / "VS.cso") };
+		CHECK(HasContent(pVertexShader, vertexShader));
+		CHECK(pVertexShader && pVertexShader->m_Hash == ShaderCache::Hash(vertexShader.data(), vertexShader.size()));
+		CHECK(cache.GetFileReadCount() == 1);
+
+		// Same path, spelled differently, is not read again
+		CHECK(cache.Load(g_Folder / "VS.cso") == pVertexShader);
+		CHECK(cache.Load(g_Folder / "." / "VS.cso") == pVertexShader);
+		CHECK(cache.GetFileReadCount() == 1);
+
+		const ShaderBytecode* pPixelShader{ cache.Load(g_Folder / "PS.cso") };
+		CHECK(HasContent(pPixelShader, pixelShader));
+		CHECK(pPixelShader != pVertexShader);
+		CHECK(pPixelShader && pVertexShader && pPixelShader->m_Hash != pVertexShader->m_Hash);
+
+		// A copy under another name is read once, then resolves to the bytecode already loaded
+		CHECK(cache.Load(g_Folder / "VSCopy.cso") == pVertexShader);
+		CHECK(cache.GetFileReadCount() == 3);
+		CHECK(cache.GetBytecodeCount() == 2);
+
+		CHECK(cache.Load(g_Folder / "Missing.cso") == nullptr);
+		CHECK(cache.GetBytecodeCount() == 2);
+
+		cache.Clear();
+		CHECK(cache.GetBytecodeCount() == 0);
+		CHECK(HasContent(cache.Load(g_Folder / "PS.cso"), pixelShader));
+		CHECK(cache.GetFileReadCount() == 4);
+
+		cache.Clear();
+	}
+
+	void TestPack(AssetCompression compression)
+	{
+		ShaderCache& cache{ ShaderCache::Get() };
+
+		const std::string packedShader{ "packed pixel shader bytecode" };
+		const std::string fileShader{ "loose pixel shader bytecode" };
+		const std::filesystem::path path{ g_Folder / "Packed.cso" };
+		WriteFile(path, fileShader);
+
+		AssetPackBuilder builder{};
+		CHECK(builder.Add(path.lexically_normal().generic_string(), AssetType::Shader, packedShader.data(), packedShader.size()));
+		CHECK(builder.Write(g_Folder / "Shaders.pgpk", AssetPackBuilder::s_DefaultAlignment, compression));
+
+		CHECK(cache.MountPack(g_Folder / "Shaders.pgpk"));
+
+		// Found in the pack, the file on disk is never read
+		const uint32_t fileReadCount{ cache.GetFileReadCount() };
+		const ShaderBytecode* pBytecode{ cache.Load(path) };
+		CHECK(HasContent(pBytecode, packedShader));
+		CHECK(pBytecode && pBytecode->m_Hash == ShaderCache::Hash(packedShader.data(), packedShader.size()));
+		CHECK(cache.GetFileReadCount() == fileReadCount);
+
+		// Uncompressed packs are used in place, compressed ones are decompressed into the bytecode
+		CHECK(pBytecode && pBytecode->m_Storage.empty() == (compression == AssetCompression::None));
+
+		// Without the pack the loose file is used again
+		cache.UnmountPacks();
+		CHECK(HasContent(cache.Load(path), fileShader));
+		CHECK(cache.GetFileReadCount() == fileReadCount + 1);
+
+		CHECK(!cache.MountPack(g_Folder / "Missing.pgpk"));
+
+		cache.Clear();
+	}
+}
+
+int main()
+{
+	std::filesystem::create_directories(g_Folder);
+
+	TestFiles();
+	TestPack(AssetCompression::None);
+	TestPack(AssetCompression::LZ4);
+
+	std::filesystem::remove_all(g_Folder);
+
+	if (g_FailureCount > 0)
+	{
+		std::fprintf(stderr, "%d checks failed\n", g_FailureCount);
+		return 1;
+	}
+
+	std::printf("All checks passed\n");
+	return 0;
+}
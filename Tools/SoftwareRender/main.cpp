@@ -0,0 +1,150 @@
+#include "SoftwareRasterizer.h"
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Renders the frame the software backend draws at startup without a window, so it runs on machines without a
+// display: the engine's test triangle and every color path of the materials. The vertex programs are emulated the
+// way SoftwareRenderer::DrawBoundMesh does, then the framebuffer is written to a TGA and sampled to check the result.
+
+namespace
+{
+	using Float4 = SoftwareRasterizer::Float4;
+
+	constexpr uint32_t s_Width{ 640 };
+	constexpr uint32_t s_Height{ 360 };
+	constexpr float s_BackgroundColor[4]{ .5f, .5f, .5f, 1.f }; // Renderer default
+
+	struct Vertex2D
+	{
+		float x{}, y{};
+	};
+
+	/**
+	 * \brief Scale, then offset in clip space, the world matrices of the scene
+	 */
+	struct Placement
+	{
+		float m_OffsetX{};
+		float m_OffsetY{};
+		float m_Scale{ 1.f };
+		float m_Depth{};
+	};
+
+	// Same mesh as Renderer::InitTestTriangle
+	constexpr Vertex2D s_TriangleVertices[]{ { .0f, .5f }, { .5f, -.5f }, { -.5f, -.5f } };
+	constexpr uint32_t s_TriangleIndices[]{ 0, 1, 2 };
+
+	constexpr Vertex2D s_QuadVertices[]{ { -.5f, .5f }, { .5f, .5f }, { .5f, -.5f }, { -.5f, -.5f } };
+	constexpr uint32_t s_QuadIndices[]{ 0, 1, 2, 0, 2, 3 };
+
+	/**
+	 * \brief ColorVS, ColorInstancedVS and TestVS with a 2D placement instead of the world view projection matrix
+	 */
+	void Draw(SoftwareRasterizer& rasterizer, const Vertex2D* pPositions, uint32_t vertexCount, const uint32_t* pIndices, uint32_t indexCount,
+		const Placement& placement, const Float4* pVertexColors = nullptr, const Float4& instanceColor = { 1.f, 1.f, 1.f, 1.f })
+	{
+		std::vector<SoftwareRasterizer::Vertex> vertices(vertexCount);
+		for (uint32_t i{}; i < vertexCount; ++i)
+		{
+			vertices[i].m_Position = { pPositions[i].x * placement.m_Scale + placement.m_OffsetX, pPositions[i].y * placement.m_Scale + placement.m_OffsetY, placement.m_Depth, 1.f };
+			vertices[i].m_Color = pVertexColors ? pVertexColors[i] : instanceColor;
+		}
+
+		rasterizer.SubmitTriangles(vertices.data(), vertexCount, pIndices, indexCount);
+	}
+
+	[[nodiscard]] uint32_t PackColor(const Float4& color)
+	{
+		const auto toByte{ [](float value) { return static_cast<uint32_t>(value * 255.f + .5f); } };
+		return toByte(color.w) << 24 | toByte(color.x) << 16 | toByte(color.y) << 8 | toByte(color.z);
+	}
+
+	int g_FailureCount{};
+
+	/**
+	 * \param x Clip space
+	 * \param y Clip space
+	 * \param tolerance Per channel, for interpolated colors
+	 */
+	void CheckPixel(const SoftwareRasterizer& rasterizer, const char* pLabel, float x, float y, const Float4& expected, int tolerance = 0)
+	{
+		const auto pixelX = static_cast<uint32_t>((x + 1.f) * .5f * static_cast<float>(rasterizer.GetWidth()));
+		const auto pixelY = static_cast<uint32_t>((1.f - y) * .5f * static_cast<float>(rasterizer.GetHeight()));
+		const uint32_t actual{ rasterizer.GetColorBuffer()[static_cast<size_t>(pixelY) * rasterizer.GetPitch() + pixelX] };
+		const uint32_t expectedPacked{ PackColor(expected) };
+
+		for (uint32_t shift{}; shift < 32; shift += 8)
+		{
+			const int difference{ static_cast<int>(actual >> shift & 0xFF) - static_cast<int>(expectedPacked >> shift & 0xFF) };
+			if (std::abs(difference) > tolerance)
+			{
+				std::fprintf(stderr, "%s: pixel (%u, %u) is %08x, expected %08x\n", pLabel, pixelX, pixelY, actual, expectedPacked);
+				++g_FailureCount;
+				return;
+			}
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const std::string outputPath{ argc > 1 ? argv[1] : "SoftwareRender.tga" };
+
+	SoftwareRasterizer rasterizer{};
+	rasterizer.Resize(s_Width, s_Height);
+	rasterizer.Clear(s_BackgroundColor, 1.f);
+
+	// Test triangle, ColorMaterial: ColorVS and ColorPS with a red constant color
+	constexpr Float4 s_Red{ 1.f, 0.f, 0.f, 1.f };
+	rasterizer.SetPipelineState({ SoftwareRasterizer::VertexProgram::Color, SoftwareRasterizer::PixelProgram::ConstantColor, s_Red });
+	Draw(rasterizer, s_TriangleVertices, 3, s_TriangleIndices, 3, { -.5f, .4f, .8f, .5f });
+
+	// TestVS and TestPS, colors interpolated from the vertices
+	constexpr Float4 s_VertexColors[]{ { 1.f, 0.f, 0.f, 1.f }, { 0.f, 1.f, 0.f, 1.f }, { 0.f, 0.f, 1.f, 1.f } };
+	rasterizer.SetPipelineState({ SoftwareRasterizer::VertexProgram::VertexColor, SoftwareRasterizer::PixelProgram::VertexColor });
+	Draw(rasterizer, s_TriangleVertices, 3, s_TriangleIndices, 3, { .5f, .4f, .8f, .5f }, s_VertexColors);
+
+	// Instanced ColorMaterial: ColorInstancedVS and TestPS, one color per instance
+	constexpr Float4 s_InstanceColors[]{ { 1.f, 1.f, 0.f, 1.f }, { 0.f, 1.f, 1.f, 1.f }, { 1.f, 0.f, 1.f, 1.f }, { 1.f, 1.f, 1.f, 1.f } };
+	rasterizer.SetPipelineState({ SoftwareRasterizer::VertexProgram::ColorInstanced, SoftwareRasterizer::PixelProgram::VertexColor, s_Red });
+	for (uint32_t instance{}; instance < 4; ++instance)
+		Draw(rasterizer, s_QuadVertices, 4, s_QuadIndices, 6, { -.75f + .5f * instance, -.55f, .3f, .5f }, nullptr, s_InstanceColors[instance]);
+
+	// Depth test: the nearer quad is drawn first and must stay in front of the farther one drawn over it
+	constexpr Float4 s_Green{ 0.f, 1.f, 0.f, 1.f };
+	constexpr Float4 s_Blue{ 0.f, 0.f, 1.f, 1.f };
+	rasterizer.SetPipelineState({ SoftwareRasterizer::VertexProgram::Color, SoftwareRasterizer::PixelProgram::ConstantColor, s_Green });
+	Draw(rasterizer, s_QuadVertices, 4, s_QuadIndices, 6, { .05f, .05f, .2f, .2f });
+	rasterizer.SetPipelineState({ SoftwareRasterizer::VertexProgram::Color, SoftwareRasterizer::PixelProgram::ConstantColor, s_Blue });
+	Draw(rasterizer, s_QuadVertices, 4, s_QuadIndices, 6, { -.05f, -.05f, .2f, .7f });
+
+	rasterizer.Flush();
+
+	if (!rasterizer.SaveTGA(outputPath))
+	{
+		std::fprintf(stderr, "Could not write %s\n", outputPath.c_str());
+		return 1;
+	}
+
+	const Float4 background{ s_BackgroundColor[0], s_BackgroundColor[1], s_BackgroundColor[2], s_BackgroundColor[3] };
+	CheckPixel(rasterizer, "Background", -.95f, .95f, background);
+	CheckPixel(rasterizer, "Test triangle", -.5f, .3f, s_Red);
+	CheckPixel(rasterizer, "Vertex colors centroid", .5f, .4f - .4f / 3.f, { 1.f / 3.f, 1.f / 3.f, 1.f / 3.f, 1.f }, 2);
+	CheckPixel(rasterizer, "Vertex colors top", .5f, .75f, { .9375f, .03125f, .03125f, 1.f }, 3);
+	for (uint32_t instance{}; instance < 4; ++instance)
+		CheckPixel(rasterizer, "Instance", -.75f + .5f * instance, -.55f, s_InstanceColors[instance]);
+	CheckPixel(rasterizer, "Depth, near quad", .05f, .05f, s_Green);
+	CheckPixel(rasterizer, "Depth, far quad", -.12f, -.12f, s_Blue);
+
+	if (g_FailureCount > 0)
+	{
+		std::fprintf(stderr, "%d checks failed, see %s\n", g_FailureCount, outputPath.c_str());
+		return 1;
+	}
+
+	std::printf("%ux%u frame written to %s, all checks passed\n", s_Width, s_Height, outputPath.c_str());
+	return 0;
+}
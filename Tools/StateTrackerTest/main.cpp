@@ -0,0 +1,209 @@
+#include "StateTracker.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Binds through the StateTracker the way the backends do, into a device that records every call reaching it, and
+// checks which binds were issued or filtered.
+
+namespace
+{
+	/**
+	 * \brief Stands in for a device context, only records the calls it receives
+	 */
+	struct RecordingDevice
+	{
+		std::vector<std::string> m_Calls{};
+
+		void Record(const char* pCall) { m_Calls.emplace_back(pCall); }
+	};
+
+	/**
+	 * \brief Forwards a bind to the device when the tracker lets it through, like the backends and materials do
+	 */
+	void Bind(RecordingDevice& device, bool isIssued, const char* pCall)
+	{
+		if (isIssued)
+			device.Record(pCall);
+	}
+
+	int g_FailureCount{};
+
+	void Check(bool condition, const char* pExpression, int line)
+	{
+		if (condition)
+			return;
+
+		std::fprintf(stderr, "Line %d: %s failed\n", line, pExpression);
+		++g_FailureCount;
+	}
+
+#define CHECK(condition) Check((condition), #condition, __LINE__)
+
+	void CheckCounts(const StateTracker& tracker, const RecordingDevice& device, uint32_t issuedCount, uint32_t filteredCount, int line)
+	{
+		Check(tracker.GetStats().m_IssuedCount == issuedCount, "issued count", line);
+		Check(tracker.GetStats().m_FilteredCount == filteredCount, "filtered count", line);
+		Check(device.m_Calls.size() == issuedCount, "calls reaching the device", line);
+	}
+
+#define CHECK_COUNTS(tracker, device, issuedCount, filteredCount) CheckCounts(tracker, device, issuedCount, filteredCount, __LINE__)
+
+	// Addresses only identify the objects, the tracker never dereferences them
+	const int g_VertexShaderA{};
+	const int g_VertexShaderB{};
+	const int g_PixelShader{};
+	const int g_InputLayout{};
+	const int g_Pipeline{};
+	const int g_VertexBuffer{};
+	const int g_IndexBuffer{};
+	const int g_ConstantBufferA{};
+	const int g_ConstantBufferB{};
+
+	void TestShadersAndLayout()
+	{
+		StateTracker tracker{};
+		RecordingDevice device{};
+
+		Bind(device, tracker.SetVertexShader(&g_VertexShaderA), "VSSetShader A");
+		Bind(device, tracker.SetPixelShader(&g_PixelShader), "PSSetShader");
+		Bind(device, tracker.SetInputLayout(&g_InputLayout), "IASetInputLayout");
+		CHECK_COUNTS(tracker, device, 3, 0);
+
+		// Same material again, nothing reaches the device
+		Bind(device, tracker.SetVertexShader(&g_VertexShaderA), "VSSetShader A");
+		Bind(device, tracker.SetPixelShader(&g_PixelShader), "PSSetShader");
+		Bind(device, tracker.SetInputLayout(&g_InputLayout), "IASetInputLayout");
+		CHECK_COUNTS(tracker, device, 3, 3);
+
+		// Only the vertex shader changes
+		Bind(device, tracker.SetVertexShader(&g_VertexShaderB), "VSSetShader B");
+		Bind(device, tracker.SetPixelShader(&g_PixelShader), "PSSetShader");
+		CHECK_COUNTS(tracker, device, 4, 4);
+		CHECK(device.m_Calls.back() == "VSSetShader B");
+
+		// A null bind is a state of its own, unbinding is issued once
+		Bind(device, tracker.SetPixelShader(nullptr), "PSSetShader null");
+		Bind(device, tracker.SetPixelShader(nullptr), "PSSetShader null");
+		CHECK_COUNTS(tracker, device, 5, 5);
+
+		// Pipelines are tracked apart from the individual shaders
+		Bind(device, tracker.SetPipeline(&g_Pipeline), "BindPipeline");
+		Bind(device, tracker.SetPipeline(&g_Pipeline), "BindPipeline");
+		CHECK_COUNTS(tracker, device, 6, 6);
+	}
+
+	void TestGeometry()
+	{
+		StateTracker tracker{};
+		RecordingDevice device{};
+
+		Bind(device, tracker.SetVertexBuffer(&g_VertexBuffer, 8), "IASetVertexBuffers");
+		Bind(device, tracker.SetIndexBuffer(&g_IndexBuffer, 57), "IASetIndexBuffer");
+		Bind(device, tracker.SetPrimitiveTopology(4), "IASetPrimitiveTopology");
+		CHECK_COUNTS(tracker, device, 3, 0);
+
+		Bind(device, tracker.SetVertexBuffer(&g_VertexBuffer, 8), "IASetVertexBuffers");
+		Bind(device, tracker.SetIndexBuffer(&g_IndexBuffer, 57), "IASetIndexBuffer");
+		Bind(device, tracker.SetPrimitiveTopology(4), "IASetPrimitiveTopology");
+		CHECK_COUNTS(tracker, device, 3, 3);
+
+		// Same buffer with another stride, offset or format still has to be bound
+		Bind(device, tracker.SetVertexBuffer(&g_VertexBuffer, 24), "IASetVertexBuffers stride");
+		Bind(device, tracker.SetVertexBuffer(&g_VertexBuffer, 24, 256), "IASetVertexBuffers offset");
+		Bind(device, tracker.SetIndexBuffer(&g_IndexBuffer, 42), "IASetIndexBuffer format");
+		Bind(device, tracker.SetPrimitiveTopology(5), "IASetPrimitiveTopology");
+		CHECK_COUNTS(tracker, device, 7, 3);
+	}
+
+	void TestConstantBuffers()
+	{
+		StateTracker tracker{};
+		RecordingDevice device{};
+
+		Bind(device, tracker.SetConstantBuffer(ShaderStage::Vertex, 1, &g_ConstantBufferA, 0, 16), "VSSetConstantBuffers1 b1");
+		Bind(device, tracker.SetConstantBuffer(ShaderStage::Vertex, 1, &g_ConstantBufferA, 0, 16), "VSSetConstantBuffers1 b1");
+		CHECK_COUNTS(tracker, device, 1, 1);
+
+		// Transient ranges of one buffer differ by offset or size
+		Bind(device, tracker.SetConstantBuffer(ShaderStage::Vertex, 1, &g_ConstantBufferA, 16, 16), "VSSetConstantBuffers1 b1 offset");
+		Bind(device, tracker.SetConstantBuffer(ShaderStage::Vertex, 1, &g_ConstantBufferA, 16, 32), "VSSetConstantBuffers1 b1 size");
+		Bind(device, tracker.SetConstantBuffer(ShaderStage::Vertex, 1, &g_ConstantBufferA, 16, 32), "VSSetConstantBuffers1 b1 size");
+		CHECK_COUNTS(tracker, device, 3, 2);
+
+		// Slots and stages are independent
+		Bind(device, tracker.SetConstantBuffer(ShaderStage::Vertex, 2, &g_ConstantBufferA, 16, 32), "VSSetConstantBuffers1 b2");
+		Bind(device, tracker.SetConstantBuffer(ShaderStage::Pixel, 1, &g_ConstantBufferA, 16, 32), "PSSetConstantBuffers1 b1");
+		CHECK_COUNTS(tracker, device, 5, 2);
+
+		// Whole buffer binds, size 0
+		Bind(device, tracker.SetConstantBuffer(ShaderStage::Pixel, 0, &g_ConstantBufferB), "PSSetConstantBuffers b0");
+		Bind(device, tracker.SetConstantBuffer(ShaderStage::Pixel, 0, &g_ConstantBufferB), "PSSetConstantBuffers b0");
+		Bind(device, tracker.SetConstantBuffer(ShaderStage::Pixel, 0, &g_ConstantBufferB, 0, 16), "PSSetConstantBuffers1 b0 range");
+		CHECK_COUNTS(tracker, device, 7, 3);
+
+		Bind(device, tracker.SetConstantBuffer(ShaderStage::Pixel, StateTracker::s_ConstantBufferSlotCount - 1, &g_ConstantBufferB), "PSSetConstantBuffers b13");
+		CHECK_COUNTS(tracker, device, 8, 3);
+	}
+
+	void TestInvalidate()
+	{
+		StateTracker tracker{};
+		RecordingDevice device{};
+
+		const auto bindAll{ [&] {
+			Bind(device, tracker.SetVertexShader(&g_VertexShaderA), "VSSetShader");
+			Bind(device, tracker.SetPixelShader(&g_PixelShader), "PSSetShader");
+			Bind(device, tracker.SetInputLayout(&g_InputLayout), "IASetInputLayout");
+			Bind(device, tracker.SetPipeline(&g_Pipeline), "BindPipeline");
+			Bind(device, tracker.SetPrimitiveTopology(4), "IASetPrimitiveTopology");
+			Bind(device, tracker.SetVertexBuffer(&g_VertexBuffer, 8), "IASetVertexBuffers");
+			Bind(device, tracker.SetIndexBuffer(&g_IndexBuffer, 57), "IASetIndexBuffer");
+			Bind(device, tracker.SetConstantBuffer(ShaderStage::Vertex, 1, &g_ConstantBufferA, 0, 16), "VSSetConstantBuffers1");
+			Bind(device, tracker.SetConstantBuffer(ShaderStage::Pixel, 0, &g_ConstantBufferB), "PSSetConstantBuffers");
+		} };
+
+		bindAll();
+		CHECK_COUNTS(tracker, device, 9, 0);
+		bindAll();
+		CHECK_COUNTS(tracker, device, 9, 9);
+
+		// The API state was reset behind the tracker's back, every bind goes through once
+		tracker.Invalidate();
+		bindAll();
+		CHECK_COUNTS(tracker, device, 18, 9);
+		bindAll();
+		CHECK_COUNTS(tracker, device, 18, 18);
+
+		// Invalidate also forgets null binds, a null state is not the same as an unknown one
+		Bind(device, tracker.SetPixelShader(nullptr), "PSSetShader null");
+		tracker.Invalidate();
+		Bind(device, tracker.SetPixelShader(nullptr), "PSSetShader null");
+		CHECK_COUNTS(tracker, device, 20, 18);
+
+		// Statistics restart, the bound state stays
+		tracker.ResetStats();
+		device.m_Calls.clear();
+		Bind(device, tracker.SetPixelShader(nullptr), "PSSetShader null");
+		Bind(device, tracker.SetVertexShader(&g_VertexShaderB), "VSSetShader B");
+		CHECK_COUNTS(tracker, device, 1, 1);
+	}
+}
+
+int main()
+{
+	TestShadersAndLayout();
+	TestGeometry();
+	TestConstantBuffers();
+	TestInvalidate();
+
+	if (g_FailureCount > 0)
+	{
+		std::fprintf(stderr, "%d checks failed\n", g_FailureCount);
+		return 1;
+	}
+
+	std::printf("All checks passed\n");
+	return 0;
+}
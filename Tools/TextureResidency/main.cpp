@@ -0,0 +1,192 @@
+#include "TextureResidencyManager.h"
+
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+// Drives the TextureResidencyManager with a camera flying down a corridor of textured objects and uploads that
+// complete a few frames after they were requested. Checks the budget holds every frame and reports how close the
+// resident mips stay to the desired ones.
+
+namespace
+{
+	constexpr uint64_t s_MegaByte{ 1024 * 1024 };
+
+	struct Options
+	{
+		uint32_t m_TextureCount{ 2000 };
+		uint32_t m_FrameCount{ 2000 };
+		uint64_t m_Budget{ 256 * s_MegaByte };
+		uint64_t m_UploadBudget{ 8 * s_MegaByte };
+		uint32_t m_Latency{ 3 }; // Frames between a load command and its completion
+		uint32_t m_ReportInterval{ 100 };
+	};
+
+	struct SceneObject
+	{
+		float m_Position{}; // Along the corridor
+		float m_Size{}; // World size the texture is mapped on
+		uint32_t m_Texture{};
+	};
+
+	struct PendingUpload
+	{
+		uint32_t m_Frame{};
+		uint32_t m_Texture{};
+	};
+
+	void PrintUsage()
+	{
+		std::printf(
+			"Usage: TextureResidency [options]\n"
+			"  --textures <count>    Textures in the scene (default 2000)\n"
+			"  --frames <count>      Frames simulated (default 2000)\n"
+			"  --budget <MiB>        Texture memory budget (default 256)\n"
+			"  --upload <MiB>        Mips loaded per frame, 0 is unlimited (default 8)\n"
+			"  --latency <frames>    Frames an upload takes (default 3)\n");
+	}
+
+	bool ParseOptions(int argc, char* argv[], Options& options)
+	{
+		for (int i{ 1 }; i < argc; ++i)
+		{
+			const std::string argument{ argv[i] };
+			const bool hasValue{ i + 1 < argc };
+
+			if (argument == "--textures" && hasValue)
+				options.m_TextureCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+			else if (argument == "--frames" && hasValue)
+				options.m_FrameCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+			else if (argument == "--budget" && hasValue)
+				options.m_Budget = std::stoull(argv[++i]) * s_MegaByte;
+			else if (argument == "--upload" && hasValue)
+				options.m_UploadBudget = std::stoull(argv[++i]) * s_MegaByte;
+			else if (argument == "--latency" && hasValue)
+				options.m_Latency = static_cast<uint32_t>(std::stoul(argv[++i]));
+			else
+				return false;
+		}
+
+		return options.m_TextureCount > 0;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options{};
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	TextureResidencyManager manager{ options.m_Budget, options.m_UploadBudget };
+
+	// BC7 textures from 256 to 4096 texels with full mip chains, spread along the corridor
+	constexpr float s_CorridorLength{ 2000.f };
+	constexpr float s_ViewDistance{ 200.f };
+	constexpr float s_ScreenHeight{ 1080.f };
+	constexpr float s_Speed{ 1.5f }; // Per frame, the camera loops over the corridor
+
+	std::mt19937 random{ 42 };
+	std::uniform_real_distribution<float> positionDistribution{ 0.f, s_CorridorLength };
+	std::uniform_real_distribution<float> sizeDistribution{ .5f, 8.f };
+	std::uniform_int_distribution<uint32_t> resolutionDistribution{ 8, 12 };
+
+	std::vector<SceneObject> objects(options.m_TextureCount);
+	for (SceneObject& object : objects)
+	{
+		const uint32_t resolution{ 1u << resolutionDistribution(random) };
+
+		TextureResidencyDesc desc{};
+		desc.m_Width = desc.m_Height = resolution;
+		desc.m_MipCount = static_cast<uint32_t>(std::log2(resolution)) + 1;
+		desc.m_BitsPerPixel = 8;
+		desc.m_IsBlockCompressed = true;
+
+		object.m_Position = positionDistribution(random);
+		object.m_Size = sizeDistribution(random);
+		object.m_Texture = manager.Register(desc);
+	}
+
+	std::printf("%u textures, budget %llu MiB, upload %llu MiB per frame, latency %u frames, pinned mips %.1f MiB\n", options.m_TextureCount,
+		static_cast<unsigned long long>(options.m_Budget / s_MegaByte), static_cast<unsigned long long>(options.m_UploadBudget / s_MegaByte),
+		options.m_Latency, static_cast<double>(manager.GetCommittedBytes()) / s_MegaByte);
+	std::printf("%8s %12s %12s %8s %10s %12s %14s\n", "Frame", "Resident MiB", "Committed", "Loads", "Evictions", "At desired", "Mean deficit");
+
+	std::deque<PendingUpload> uploads{};
+	uint64_t loadCount{};
+	uint64_t evictionCount{};
+	uint64_t visibleCount{};
+	uint64_t atDesiredCount{};
+	uint64_t deficitSum{};
+
+	for (uint32_t frame{}; frame < options.m_FrameCount; ++frame)
+	{
+		// Simulated uploads land in order after the latency
+		while (!uploads.empty() && uploads.front().m_Frame <= frame)
+		{
+			manager.OnMipsLoaded(uploads.front().m_Texture);
+			uploads.pop_front();
+		}
+
+		manager.BeginFrame();
+
+		const float cameraPosition{ std::fmod(frame * s_Speed, s_CorridorLength) };
+		for (const SceneObject& object : objects)
+		{
+			const float distance{ object.m_Position - cameraPosition };
+			if (distance < 1.f || distance > s_ViewDistance)
+				continue;
+
+			// Perspective with a 90 degree vertical field of view
+			manager.ReportUsage(object.m_Texture, object.m_Size / distance * s_ScreenHeight * .5f);
+		}
+
+		for (const ResidencyCommand& command : manager.Update())
+		{
+			if (command.m_Type == ResidencyCommand::Type::Load)
+			{
+				uploads.push_back({ frame + options.m_Latency, command.m_Texture });
+				++loadCount;
+			}
+			else
+				++evictionCount;
+		}
+
+		if (manager.GetCommittedBytes() > manager.GetBudget() || manager.GetResidentBytes() > manager.GetCommittedBytes())
+		{
+			std::fprintf(stderr, "Frame %u: %llu bytes committed over a budget of %llu\n", frame,
+				static_cast<unsigned long long>(manager.GetCommittedBytes()), static_cast<unsigned long long>(manager.GetBudget()));
+			return 1;
+		}
+
+		for (const SceneObject& object : objects)
+		{
+			const float distance{ object.m_Position - cameraPosition };
+			if (distance < 1.f || distance > s_ViewDistance)
+				continue;
+
+			const uint32_t residentMip{ manager.GetResidentMip(object.m_Texture) };
+			const uint32_t desiredMip{ manager.GetDesiredMip(object.m_Texture) };
+			++visibleCount;
+			atDesiredCount += residentMip <= desiredMip;
+			deficitSum += residentMip > desiredMip ? residentMip - desiredMip : 0;
+		}
+
+		if ((frame + 1) % options.m_ReportInterval == 0)
+		{
+			std::printf("%8u %12.1f %12.1f %8llu %10llu %11.1f%% %14.2f\n", frame + 1, static_cast<double>(manager.GetResidentBytes()) / s_MegaByte,
+				static_cast<double>(manager.GetCommittedBytes()) / s_MegaByte, static_cast<unsigned long long>(loadCount),
+				static_cast<unsigned long long>(evictionCount), visibleCount ? 100. * atDesiredCount / visibleCount : 100.,
+				visibleCount ? static_cast<double>(deficitSum) / visibleCount : 0.);
+
+			loadCount = evictionCount = visibleCount = atDesiredCount = deficitSum = 0;
+		}
+	}
+
+	return 0;
+}